@@ -69,6 +69,38 @@
 // Max portal HTML capture size (bytes)
 #define MAX_PORTAL_CAPTURE_SIZE 32768
 
+// ==========================================
+// Enumeration Settings
+// ==========================================
+
+// Background enumeration task
+#define ENUM_TASK_STACK 8192
+#define ENUM_TASK_PRIORITY 1
+#define ENUM_TASK_CORE 0       // WiFi core; keeps loop() and the UI responsive
+
+// Valid combinations kept per job (fixed buffer, no heap growth)
+#define ENUM_MAX_HITS 32
+
+// Checkpointing: progress is saved to NVS at most once per interval
+// (plus on finish, cancel and before deep sleep) so a reset loses at most
+// one interval of attempts while keeping flash writes negligible
+#define ENUM_CHECKPOINT_INTERVAL 10000  // ms
+#define ENUM_CHECKPOINT_TARGET "/enum/target.html"
+
+// Binary enumeration attempt logs on SD, one per job:
+// <dir>/attempts-<jobId>.bin (decode with tools/decode_attempts.py)
+#define ENUM_LOG_DIR "/logs"
+
+// Attempt pacing (AIMD): speeds up while the portal answers normally and
+// backs off on 429/5xx, timeouts or rising latency. ENUM_MAX_RATE is the
+// default ceiling; /api/enumerate?rate= can lower it per job.
+#define ENUM_MAX_RATE 4.0f     // attempts/sec
+#define ENUM_MIN_RATE 0.2f     // attempts/sec floor when backing off
+
+// Candidate priors: floor, room and surname hit statistics from earlier
+// engagements. When present, the most likely candidates are tried first.
+#define ENUM_PRIORS_PATH "/wordlists/priors.txt"
+
 // ==========================================
 // Web Server Settings
 // ==========================================
@@ -94,11 +126,55 @@
 // Options: "tinyllama", "phi2-tiny", "custom"
 #define LLM_MODEL "tinyllama"
 
+// Weights are memory-mapped in place from this flash partition
+// (partitions_model.csv, written by tools/pack_model.py). Boards without
+// it read a packed model, or a llama2.c int8 checkpoint (export.py
+// --version 2), from SPIFFS into PSRAM instead. The tokenizer file is
+// only needed when the model doesn't carry its vocab.
+#define LLM_MODEL_PARTITION "model"
+#define LLM_MODEL_PATH "/models/" LLM_MODEL ".bin"
+#define LLM_TOKENIZER_PATH "/models/tokenizer.bin"
+
+// Packed models are checked at load: header and tensor table checksums
+// every time, and every tensor's checksum once per model file (the header
+// checksum of the last fully verified file is kept at LLM_VERIFIED_PATH)
+#define LLM_VERIFY_TENSORS true
+#define LLM_VERIFIED_PATH "/models/verified"
+
 // Inference settings
 #define LLM_MAX_TOKENS 256
+#define LLM_RESPONSE_BYTES (LLM_MAX_TOKENS * 8 + 1)  // Text of one answer, in the arena
 #define LLM_TEMPERATURE 0.7
+#define LLM_TOP_P 0.9          // Nucleus sampling; 0 or 1 disables
+
+// Matvec rows are split between the inferring task and LLM_THREADS - 1
+// worker tasks pinned to LLM_WORKER_CORE (loop() runs on core 1)
+#define LLM_THREADS 2
+#define LLM_WORKER_CORE 0
 #define LLM_CONTEXT_SIZE 512
 
+// All generation runs on one worker task fed by the inference queue,
+// next to loop() so the UI keeps drawing tokens as they arrive
+#define LLM_TASK_STACK 8192
+#define LLM_TASK_PRIORITY 1
+#define LLM_TASK_CORE 1
+
+// Inference jobs are admitted only with this much PSRAM (heap without
+// PSRAM) free for prompt, digest and response buffers
+#define LLM_MIN_FREE_MEMORY 65536
+
+// Longest LLMEngine::infer() waits for its queued job
+#define LLM_INFER_TIMEOUT_MS 120000
+
+// Keep the KV state of the fixed prompt preambles (llm/prompts.h) after
+// load, so each analysis only runs its variable part through the model
+#define LLM_PREFIX_CACHE true
+
+// The portal classifier (core/portal_classifier.h) answers venue and login
+// type without the model when both of its predictions are at least this
+// confident; below it the page goes to the LLM
+#define CLASSIFIER_MIN_CONFIDENCE 0.7f
+
 // ==========================================
 // Logging & Storage
 // ==========================================
@@ -111,6 +187,17 @@
 #define MAX_LOG_ENTRIES 1000
 #define LOG_ROTATION_SIZE 1048576  // 1MB
 
+// Portal analyses are cached by page hash (core/analysis_cache.h). With
+// persistence on, they are also written to fixed-size slots in a SPIFFS
+// file, so a portal analysed before a reboot is answered from flash.
+#define ANALYSIS_CACHE_PERSIST true
+#define ANALYSIS_CACHE_PATH "/cache/analysis.bin"
+#define ANALYSIS_CACHE_SLOTS 32    // ~33KB of flash
+
+// Pattern-based analysis rules (format in core/portal_rules.h). Replaces
+// the built-in rule set when present.
+#define PORTAL_RULES_PATH "/rules/portal.rules"
+
 // ==========================================
 // Hardware Pin Definitions
 // ==========================================
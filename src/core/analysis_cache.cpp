@@ -0,0 +1,146 @@
+#include "analysis_cache.h"
+#include <string.h>
+#include <stddef.h>
+
+static uint32_t fnv1a32(const void* data, size_t len, uint32_t hash = 2166136261u) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+AnalysisCache::AnalysisCache()
+    : store(nullptr), clock(0), hits(0), storeHits(0), misses(0), evictions(0) {
+    for (auto& e : entries) {
+        e.lastUsed = 0;
+        e.length = 0;
+    }
+}
+
+void AnalysisCache::setStore(const AnalysisStore* s) {
+    std::lock_guard<std::mutex> guard(lock);
+    store = s && s->slots > 0 ? s : nullptr;
+}
+
+uint64_t AnalysisCache::hashPage(const char* html, size_t len) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (uint8_t)html[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+uint32_t AnalysisCache::checksum(const AnalysisRecord& record) {
+    uint32_t hash = fnv1a32(&record, offsetof(AnalysisRecord, checksum));
+    return fnv1a32(record.value, record.length, hash);
+}
+
+AnalysisCache::Entry* AnalysisCache::find(uint64_t pageHash, uint32_t analyzer) {
+    for (auto& e : entries) {
+        if (e.lastUsed && e.pageHash == pageHash && e.analyzer == analyzer) return &e;
+    }
+    return nullptr;
+}
+
+// Into a free entry, or over the least recently used one
+AnalysisCache::Entry& AnalysisCache::place(uint64_t pageHash, uint32_t analyzer,
+                                           const char* value, size_t len) {
+    Entry* slot = find(pageHash, analyzer);
+    if (!slot) {
+        slot = &entries[0];
+        for (auto& e : entries) {
+            if (e.lastUsed < slot->lastUsed) slot = &e;
+        }
+        if (slot->lastUsed) evictions++;
+    }
+
+    slot->pageHash = pageHash;
+    slot->analyzer = analyzer;
+    slot->length = len;
+    memcpy(slot->value, value, len);
+    slot->lastUsed = ++clock;
+    return *slot;
+}
+
+int AnalysisCache::lookup(uint64_t pageHash, uint32_t analyzer, char* out, size_t outLen) {
+    std::lock_guard<std::mutex> guard(lock);
+
+    Entry* e = find(pageHash, analyzer);
+    if (!e && store) {
+        AnalysisRecord record;
+        uint32_t slot = (uint32_t)(pageHash % store->slots);
+        if (store->read(store->ctx, slot, record) && record.magic == ANALYSIS_CACHE_MAGIC &&
+            record.version == ANALYSIS_CACHE_VERSION && record.pageHash == pageHash &&
+            record.analyzer == analyzer && record.length <= ANALYSIS_CACHE_VALUE &&
+            record.checksum == checksum(record)) {
+            e = &place(pageHash, analyzer, record.value, record.length);
+            storeHits++;
+        }
+    }
+
+    if (!e || e->length >= outLen) {
+        misses++;
+        return -1;
+    }
+
+    e->lastUsed = ++clock;
+    memcpy(out, e->value, e->length);
+    out[e->length] = '\0';
+    hits++;
+    return e->length;
+}
+
+bool AnalysisCache::insert(uint64_t pageHash, uint32_t analyzer, const char* value, size_t len) {
+    if (len > ANALYSIS_CACHE_VALUE) return false;
+    std::lock_guard<std::mutex> guard(lock);
+    place(pageHash, analyzer, value, len);
+
+    if (!store) return true;
+    AnalysisRecord record;
+    memset(&record, 0, sizeof(record));
+    record.magic = ANALYSIS_CACHE_MAGIC;
+    record.version = ANALYSIS_CACHE_VERSION;
+    record.length = len;
+    record.pageHash = pageHash;
+    record.analyzer = analyzer;
+    memcpy(record.value, value, len);
+    record.checksum = checksum(record);
+    return store->write(store->ctx, (uint32_t)(pageHash % store->slots), record);
+}
+
+void AnalysisCache::clear() {
+    std::lock_guard<std::mutex> guard(lock);
+    for (auto& e : entries) e.lastUsed = 0;
+}
+
+int AnalysisCache::getCount() const {
+    std::lock_guard<std::mutex> guard(lock);
+    int count = 0;
+    for (const auto& e : entries) {
+        if (e.lastUsed) count++;
+    }
+    return count;
+}
+
+uint32_t AnalysisCache::getHits() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return hits;
+}
+
+uint32_t AnalysisCache::getStoreHits() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return storeHits;
+}
+
+uint32_t AnalysisCache::getMisses() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return misses;
+}
+
+uint32_t AnalysisCache::getEvictions() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return evictions;
+}
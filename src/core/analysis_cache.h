@@ -0,0 +1,97 @@
+#ifndef ANALYSIS_CACHE_H
+#define ANALYSIS_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <mutex>
+
+// Longest cached result (a serialized /api/llm response, or model text)
+#define ANALYSIS_CACHE_VALUE 1024
+
+// Entries held in RAM
+#define ANALYSIS_CACHE_MAX_ENTRIES 8
+
+#define ANALYSIS_CACHE_MAGIC   0x43415043  // "CPAC"
+#define ANALYSIS_CACHE_VERSION 1
+
+// Which analysis a value holds, combined with that analyzer's version so
+// a change to prompts or rules never serves results made by older code
+#define ANALYZER_ID(kind, version) (((uint32_t)(kind) << 16) | ((version) & 0xFFFF))
+
+// One persisted entry, fixed size and little-endian on disk
+struct AnalysisRecord {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t length;                    // Bytes used in value
+    uint64_t pageHash;
+    uint32_t analyzer;                  // ANALYZER_ID
+    uint32_t checksum;                  // FNV-1a over everything above and value
+    char value[ANALYSIS_CACHE_VALUE];
+};
+
+// Persisted tier: `slots` fixed-size records (a file on flash or SD on the
+// device). A page maps to one slot, so a newer result for another page in
+// the same slot replaces the older one.
+struct AnalysisStore {
+    void* ctx;
+    uint32_t slots;
+    bool (*read)(void* ctx, uint32_t slot, AnalysisRecord& out);
+    bool (*write)(void* ctx, uint32_t slot, const AnalysisRecord& record);
+};
+
+// Analysis results keyed by a 64-bit hash of the portal HTML and the
+// analyzer that produced them. The RAM tier is a small LRU table; on a
+// miss the persisted tier (if any) is read and the entry promoted, so
+// results survive reboots. Lookups copy the value out under a lock and
+// never allocate, so any task may use the cache.
+class AnalysisCache {
+public:
+    AnalysisCache();
+
+    // store may be null (RAM only); it must outlive the cache
+    void setStore(const AnalysisStore* store);
+
+    // 64-bit FNV-1a of the page
+    static uint64_t hashPage(const char* html, size_t len);
+
+    // Copy the cached value (NUL-terminated) into out. Returns its length,
+    // or -1 on a miss. A value longer than outLen - 1 is a miss.
+    int lookup(uint64_t pageHash, uint32_t analyzer, char* out, size_t outLen);
+
+    // Insert or replace; values beyond ANALYSIS_CACHE_VALUE are not cached.
+    // Written through to the store.
+    bool insert(uint64_t pageHash, uint32_t analyzer, const char* value, size_t len);
+
+    // Drop the RAM tier (the store is kept)
+    void clear();
+
+    int getCount() const;
+    uint32_t getHits() const;           // RAM and store hits
+    uint32_t getStoreHits() const;      // Of which read back from the store
+    uint32_t getMisses() const;
+    uint32_t getEvictions() const;
+
+private:
+    struct Entry {
+        uint64_t pageHash;
+        uint32_t analyzer;
+        uint32_t lastUsed;              // Use clock; 0 = empty
+        uint16_t length;
+        char value[ANALYSIS_CACHE_VALUE];
+    };
+
+    Entry entries[ANALYSIS_CACHE_MAX_ENTRIES];
+    const AnalysisStore* store;
+    mutable std::mutex lock;
+    uint32_t clock;
+    uint32_t hits;
+    uint32_t storeHits;
+    uint32_t misses;
+    uint32_t evictions;
+
+    Entry* find(uint64_t pageHash, uint32_t analyzer);
+    Entry& place(uint64_t pageHash, uint32_t analyzer, const char* value, size_t len);
+    static uint32_t checksum(const AnalysisRecord& record);
+};
+
+#endif // ANALYSIS_CACHE_H
@@ -0,0 +1,86 @@
+#include "attempt_log.h"
+
+static_assert(sizeof(AttemptRecord) == 24, "AttemptRecord is an on-disk format");
+static_assert(sizeof(AttemptLogHeader) == 16, "AttemptLogHeader is an on-disk format");
+
+AttemptLog::AttemptLog() : appended(0), spilled(0), dropped(0), hasSink(false) {
+    sink.ctx = nullptr;
+    sink.write = nullptr;
+}
+
+void AttemptLog::begin(uint32_t jobId, const AttemptSink* newSink, bool append) {
+    appended = 0;
+    spilled = 0;
+    dropped = 0;
+    hasSink = newSink && newSink->write;
+    if (hasSink) sink = *newSink;
+
+    if (hasSink && !append) {
+        AttemptLogHeader header = {ATTEMPT_LOG_MAGIC, ATTEMPT_LOG_VERSION,
+                                   sizeof(AttemptRecord), jobId, 0};
+        hasSink = sink.write(sink.ctx, &header, sizeof(header));
+    }
+}
+
+void AttemptLog::append(const AttemptRecord& record) {
+    // Ring full of unspilled records: the oldest one is lost
+    if (appended - spilled >= ATTEMPT_LOG_RING) {
+        spilled++;
+        if (hasSink) dropped++;
+    }
+
+    ring[appended % ATTEMPT_LOG_RING] = record;
+    appended++;
+
+    if (hasSink && appended - spilled >= ATTEMPT_LOG_BATCH) {
+        spill(ATTEMPT_LOG_BATCH);
+    } else if (!hasSink) {
+        spilled = appended;  // Nothing to wait for; keep the ring rolling
+    }
+}
+
+bool AttemptLog::flush() {
+    if (!hasSink) return false;
+    return spill(appended - spilled);
+}
+
+bool AttemptLog::spill(uint32_t count) {
+    while (count > 0 && hasSink) {
+        // Contiguous run up to the end of the ring
+        uint32_t index = spilled % ATTEMPT_LOG_RING;
+        uint32_t run = ATTEMPT_LOG_RING - index;
+        if (run > count) run = count;
+
+        if (!sink.write(sink.ctx, &ring[index], run * sizeof(AttemptRecord))) {
+            // Stop trying (e.g. card removed); the ring keeps recent records
+            hasSink = false;
+            spilled = appended;
+            return false;
+        }
+
+        spilled += run;
+        count -= run;
+    }
+    return hasSink;
+}
+
+uint32_t AttemptLog::getCount() const {
+    return appended;
+}
+
+uint32_t AttemptLog::getDropped() const {
+    return dropped;
+}
+
+bool AttemptLog::isSpilling() const {
+    return hasSink;
+}
+
+uint32_t AttemptLog::hashBody(const char* body, size_t len) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (uint8_t)body[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
@@ -0,0 +1,84 @@
+#ifndef ATTEMPT_LOG_H
+#define ATTEMPT_LOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Records kept in RAM (24 bytes each)
+#define ATTEMPT_LOG_RING 256
+
+// Records written to the sink per spill
+#define ATTEMPT_LOG_BATCH 64
+
+#define ATTEMPT_LOG_MAGIC   0x4C415043  // "CPAL"
+#define ATTEMPT_LOG_VERSION 1
+
+// Attempt record flags
+#define ATTEMPT_SUCCESS     0x01  // Verdict: credentials accepted
+#define ATTEMPT_RETRY_AFTER 0x02  // Server sent Retry-After
+
+// One enumeration attempt, fixed size and little-endian on disk.
+// Candidate strings are not stored; ordinals index the job's candidate
+// sets (ENUM_NO_CANDIDATE when a field is unused).
+struct AttemptRecord {
+    uint32_t roomOrdinal;
+    uint32_t nameOrdinal;
+    uint32_t startMs;       // Clock time the attempt started (millis())
+    uint32_t bodyHash;      // FNV-1a of the response body
+    int16_t httpCode;       // <= 0 for transport errors
+    uint16_t latencyMs;     // Saturates at 65535
+    uint16_t bodyLen;       // Saturates at 65535
+    uint8_t flags;          // ATTEMPT_* bits
+    uint8_t reserved;
+};
+
+// File header, followed by AttemptRecords back to back
+struct AttemptLogHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint32_t jobId;
+    uint32_t reserved;
+};
+
+// Destination for spilled records (an SD file on the device)
+struct AttemptSink {
+    void* ctx;
+    bool (*write)(void* ctx, const void* data, size_t len);
+};
+
+// Fixed-size ring of attempt records. append() never allocates; once a
+// batch is pending it is written to the sink in one call. Without a sink,
+// or after the sink fails, the ring simply keeps the latest records.
+class AttemptLog {
+public:
+    AttemptLog();
+
+    // Start a job's log. Writes the header unless appending to an
+    // existing log (resumed job). sink may be null.
+    void begin(uint32_t jobId, const AttemptSink* sink, bool append);
+
+    void append(const AttemptRecord& record);
+
+    // Write everything not yet spilled; false if the sink failed
+    bool flush();
+
+    uint32_t getCount() const;      // Records appended since begin()
+    uint32_t getDropped() const;    // Overwritten before they were spilled
+    bool isSpilling() const;        // Sink present and healthy
+
+    // FNV-1a over a response body, as stored in bodyHash
+    static uint32_t hashBody(const char* body, size_t len);
+
+private:
+    AttemptRecord ring[ATTEMPT_LOG_RING];
+    uint32_t appended;
+    uint32_t spilled;       // Records written out (or dropped)
+    uint32_t dropped;
+    AttemptSink sink;
+    bool hasSink;
+
+    bool spill(uint32_t count);
+};
+
+#endif // ATTEMPT_LOG_H
@@ -0,0 +1,323 @@
+#include "candidate_order.h"
+#include <algorithm>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// ==========================================
+// CandidatePriors
+// ==========================================
+
+static uint32_t fnv1a(const void* data, size_t len, uint32_t hash = 2166136261u) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+CandidatePriors::CandidatePriors() {
+    clear();
+}
+
+void CandidatePriors::clear() {
+    for (auto& w : floors) w = 0;
+    for (auto& w : rooms) w = 0;
+    floorTotal = 0;
+    roomTotal = 0;
+    names.clear();
+    nameTotal = 0;
+}
+
+bool CandidatePriors::parseLine(const char* line) {
+    while (isspace((unsigned char)*line)) line++;
+    if (*line == '\0' || *line == '#') return true;
+
+    // "<kind> <key...> <weight>": the key may contain spaces
+    const char* kindEnd = line;
+    while (*kindEnd && !isspace((unsigned char)*kindEnd)) kindEnd++;
+
+    const char* end = line + strlen(line);
+    while (end > kindEnd && isspace((unsigned char)end[-1])) end--;
+    const char* weightStart = end;
+    while (weightStart > kindEnd && !isspace((unsigned char)weightStart[-1])) weightStart--;
+
+    const char* key = kindEnd;
+    while (key < weightStart && isspace((unsigned char)*key)) key++;
+    const char* keyEnd = weightStart;
+    while (keyEnd > key && isspace((unsigned char)keyEnd[-1])) keyEnd--;
+
+    size_t keyLen = keyEnd - key;
+    if (keyLen == 0 || keyLen >= CANDIDATE_MAX_LEN) return false;
+
+    char* parsed;
+    float weight = strtof(weightStart, &parsed);
+    if (parsed != end || weight < 0) return false;
+
+    char keyBuf[CANDIDATE_MAX_LEN];
+    memcpy(keyBuf, key, keyLen);
+    keyBuf[keyLen] = '\0';
+
+    size_t kindLen = kindEnd - line;
+    if (kindLen == 4 && strncasecmp(line, "name", 4) == 0) {
+        addName(keyBuf, weight);
+        return true;
+    }
+
+    long index = strtol(keyBuf, &parsed, 10);
+    if (*parsed != '\0' || index < 0) return false;
+
+    if (kindLen == 5 && strncasecmp(line, "floor", 5) == 0 && index < PRIOR_FLOORS) {
+        floors[index] += weight;
+        floorTotal += weight;
+        return true;
+    }
+    if (kindLen == 4 && strncasecmp(line, "room", 4) == 0 && index < PRIOR_ROOMS) {
+        rooms[index] += weight;
+        roomTotal += weight;
+        return true;
+    }
+
+    return false;
+}
+
+void CandidatePriors::recordHit(const char* room, const char* name) {
+    uint16_t floor, position;
+    if (room && splitRoom(room, floor, position)) {
+        floors[floor] += 1;
+        floorTotal += 1;
+        rooms[position] += 1;
+        roomTotal += 1;
+    }
+
+    if (name && name[0] && strlen(name) < CANDIDATE_MAX_LEN) {
+        addName(name, 1);
+    }
+}
+
+bool CandidatePriors::hasRoomPriors() const {
+    return floorTotal > 0 || roomTotal > 0;
+}
+
+bool CandidatePriors::hasNamePriors() const {
+    return nameTotal > 0;
+}
+
+uint32_t CandidatePriors::nameCount() const {
+    return names.size();
+}
+
+uint32_t CandidatePriors::getHash() const {
+    uint32_t hash = fnv1a(floors, sizeof(floors));
+    hash = fnv1a(rooms, sizeof(rooms), hash);
+    for (const NamePrior& prior : names) {
+        hash = fnv1a(prior.name, strlen(prior.name) + 1, hash);
+        hash = fnv1a(&prior.weight, sizeof(prior.weight), hash);
+    }
+    return hash;
+}
+
+float CandidatePriors::roomScore(const char* room) const {
+    uint16_t floor, position;
+    if (!splitRoom(room, floor, position)) {
+        return 1.0f / (PRIOR_FLOORS * PRIOR_ROOMS);
+    }
+
+    float floorP = (floors[floor] + PRIOR_SMOOTHING) /
+                   (floorTotal + PRIOR_SMOOTHING * PRIOR_FLOORS);
+    float roomP = (rooms[position] + PRIOR_SMOOTHING) /
+                  (roomTotal + PRIOR_SMOOTHING * PRIOR_ROOMS);
+    return floorP * roomP;
+}
+
+float CandidatePriors::nameScore(const char* name) const {
+    const NamePrior* prior = findName(name);
+    float weight = prior ? prior->weight : 0;
+
+    // One extra pseudo-count stands for every surname not in the table
+    return (weight + PRIOR_SMOOTHING) /
+           (nameTotal + PRIOR_SMOOTHING * (names.size() + 1));
+}
+
+CandidateScore CandidatePriors::roomScorer() const {
+    CandidateScore score = {this, scoreRoom};
+    return score;
+}
+
+CandidateScore CandidatePriors::nameScorer() const {
+    CandidateScore score = {this, scoreName};
+    return score;
+}
+
+float CandidatePriors::scoreRoom(const void* ctx, const char* value) {
+    return ((const CandidatePriors*)ctx)->roomScore(value);
+}
+
+float CandidatePriors::scoreName(const void* ctx, const char* value) {
+    return ((const CandidatePriors*)ctx)->nameScore(value);
+}
+
+bool CandidatePriors::splitRoom(const char* room, uint16_t& floor, uint16_t& position) {
+    // Last run of digits in the value
+    const char* digits = nullptr;
+    size_t len = 0;
+    for (const char* p = room; *p; p++) {
+        if (isdigit((unsigned char)*p)) {
+            if (p == room || !isdigit((unsigned char)p[-1])) {
+                digits = p;
+                len = 0;
+            }
+            len++;
+        }
+    }
+    if (!digits || len > 9) return false;
+
+    uint32_t number = strtoul(digits, nullptr, 10);
+    if (number >= (uint32_t)PRIOR_FLOORS * PRIOR_ROOMS) return false;
+
+    floor = number / PRIOR_ROOMS;
+    position = number % PRIOR_ROOMS;
+    return true;
+}
+
+static bool nameLess(const char* a, const char* b) {
+    return strcasecmp(a, b) < 0;
+}
+
+void CandidatePriors::addName(const char* name, float weight) {
+    auto it = std::lower_bound(names.begin(), names.end(), name,
+        [](const NamePrior& prior, const char* key) { return nameLess(prior.name, key); });
+
+    if (it != names.end() && strcasecmp(it->name, name) == 0) {
+        it->weight += weight;
+    } else if (names.size() < PRIOR_MAX_NAMES) {
+        NamePrior prior;
+        strncpy(prior.name, name, sizeof(prior.name) - 1);
+        prior.name[sizeof(prior.name) - 1] = '\0';
+        prior.weight = weight;
+        names.insert(it, prior);
+    } else {
+        return;  // Table full
+    }
+
+    nameTotal += weight;
+}
+
+const CandidatePriors::NamePrior* CandidatePriors::findName(const char* name) const {
+    auto it = std::lower_bound(names.begin(), names.end(), name,
+        [](const NamePrior& prior, const char* key) { return nameLess(prior.name, key); });
+
+    if (it != names.end() && strcasecmp(it->name, name) == 0) return &*it;
+    return nullptr;
+}
+
+// ==========================================
+// CandidateOrder
+// ==========================================
+
+CandidateOrder::CandidateOrder()
+    : set(nullptr), heapSize(0), truncated(false), tailRank(0), tailOrdinal(0) {
+    scorer.ctx = nullptr;
+    scorer.score = nullptr;
+    worst.score = 0;
+    worst.ordinal = 0;
+}
+
+// Higher score first; equal scores keep set order
+bool CandidateOrder::better(const Entry& a, const Entry& b) {
+    if (a.score != b.score) return a.score > b.score;
+    return a.ordinal < b.ordinal;
+}
+
+bool CandidateOrder::worse(const Entry& a, const Entry& b) {
+    return better(b, a);
+}
+
+float CandidateOrder::scoreOf(uint32_t ordinal) const {
+    char value[CANDIDATE_MAX_LEN];
+    if (set->at(ordinal, value, sizeof(value)) == 0) return -1;  // Skipped by the runner
+    return scorer.score(scorer.ctx, value);
+}
+
+void CandidateOrder::build(const CandidateSet& candidates, const CandidateScore& score) {
+    clear();
+    set = &candidates;
+    scorer = score;
+
+    uint32_t count = set->size();
+    truncated = count > CANDIDATE_ORDER_MAX;
+    heap.reserve(truncated ? CANDIDATE_ORDER_MAX : count);
+
+    for (uint32_t ordinal = 0; ordinal < count; ordinal++) {
+        Entry entry = {scoreOf(ordinal), ordinal};
+
+        if (!truncated) {
+            heap.push_back(entry);
+        } else if (heap.size() < CANDIDATE_ORDER_MAX) {
+            // Bounded selection: a heap with the worst kept entry on top
+            heap.push_back(entry);
+            std::push_heap(heap.begin(), heap.end(), better);
+        } else if (better(entry, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), better);
+            heap.back() = entry;
+            std::push_heap(heap.begin(), heap.end(), better);
+        }
+    }
+
+    if (truncated) {
+        worst = heap.front();
+        tailRank = heap.size();
+        tailOrdinal = 0;
+    }
+
+    // Best entry on top; ranks are popped on demand
+    std::make_heap(heap.begin(), heap.end(), worse);
+    heapSize = heap.size();
+}
+
+void CandidateOrder::clear() {
+    std::vector<Entry>().swap(heap);
+    set = nullptr;
+    heapSize = 0;
+    truncated = false;
+    tailRank = 0;
+    tailOrdinal = 0;
+}
+
+bool CandidateOrder::isRanked() const {
+    return set != nullptr;
+}
+
+uint32_t CandidateOrder::at(uint32_t rank) {
+    if (!set) return rank;
+
+    uint32_t ranked = heap.size();
+    if (rank >= ranked) return truncated ? tailAt(rank) : rank;
+
+    // Pop until `rank` has been placed; popped entries collect at the back
+    while (ranked - heapSize <= rank) {
+        std::pop_heap(heap.begin(), heap.begin() + heapSize, worse);
+        heapSize--;
+    }
+    return heap[ranked - 1 - rank].ordinal;
+}
+
+uint32_t CandidateOrder::tailAt(uint32_t rank) {
+    // Ranks past the heap walk the set in order, skipping ranked values
+    if (rank < tailRank) {
+        tailRank = heap.size();
+        tailOrdinal = 0;
+    }
+
+    uint32_t count = set->size();
+    for (; tailOrdinal < count; tailOrdinal++) {
+        Entry entry = {scoreOf(tailOrdinal), tailOrdinal};
+        if (!worse(entry, worst)) continue;  // Already in the heap
+
+        if (tailRank == rank) return tailOrdinal;
+        tailRank++;
+    }
+    return count;  // Past the end; the set's at() rejects it
+}
@@ -0,0 +1,126 @@
+#ifndef CANDIDATE_ORDER_H
+#define CANDIDATE_ORDER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "candidates.h"
+
+// Ranked entries held in RAM per order (8 bytes each). Larger sets rank
+// their best CANDIDATE_ORDER_MAX values and try the rest in set order.
+#define CANDIDATE_ORDER_MAX 4096
+
+// Prior table sizes: floors 0-99, room-on-floor 00-99
+#define PRIOR_FLOORS 100
+#define PRIOR_ROOMS 100
+#define PRIOR_MAX_NAMES 256
+
+// Laplace pseudo-count, so values never seen still get tried
+#define PRIOR_SMOOTHING 1.0f
+
+// Scores a candidate value; higher scores are tried first
+struct CandidateScore {
+    const void* ctx;
+    float (*score)(const void* ctx, const char* value);
+};
+
+// Hit statistics from earlier engagements: how often each floor, room
+// position on a floor and surname turned out valid. Loaded from a text
+// file, one entry per line:
+//
+//   floor <n> <weight>      e.g. "floor 3 12"
+//   room <n> <weight>       position on the floor, "room 1 20" for x01
+//   name <surname> <weight> e.g. "name Smith 2442977"
+//
+// Repeated entries add up, so tables from several engagements can simply
+// be concatenated. Blank lines and '#' comments are ignored.
+class CandidatePriors {
+public:
+    CandidatePriors();
+
+    void clear();
+    bool parseLine(const char* line);   // False for a malformed entry
+    void recordHit(const char* room, const char* name);
+
+    bool hasRoomPriors() const;
+    bool hasNamePriors() const;
+    uint32_t nameCount() const;
+
+    // Fingerprint of the tables: equal hashes rank candidates the same
+    uint32_t getHash() const;
+
+    // Smoothed probability of a room value (floor x position) and of a
+    // surname. Room values without a number score as an average room.
+    float roomScore(const char* room) const;
+    float nameScore(const char* name) const;
+
+    CandidateScore roomScorer() const;
+    CandidateScore nameScorer() const;
+
+    // Split a room value into floor and position ("1203" -> 12, 3;
+    // "A12" -> 0, 12). False if it holds no number or the floor is out of
+    // the table's range.
+    static bool splitRoom(const char* room, uint16_t& floor, uint16_t& position);
+
+private:
+    struct NamePrior {
+        char name[CANDIDATE_MAX_LEN];
+        float weight;
+    };
+
+    float floors[PRIOR_FLOORS];
+    float rooms[PRIOR_ROOMS];
+    float floorTotal;
+    float roomTotal;
+    std::vector<NamePrior> names;      // Sorted, case-insensitive
+    float nameTotal;
+
+    void addName(const char* name, float weight);
+    const NamePrior* findName(const char* name) const;
+
+    static float scoreRoom(const void* ctx, const char* value);
+    static float scoreName(const void* ctx, const char* value);
+};
+
+// Candidates of a set in descending score order (ties keep set order).
+//
+// build() scores every value once and heapifies in O(n); at() then pops
+// lazily, so the first k ranks cost O(k log n) and a run that stops early
+// never sorts the rest. Popped entries stay at the back of the heap array,
+// so earlier ranks (e.g. when resuming from a checkpoint) are O(1).
+class CandidateOrder {
+public:
+    CandidateOrder();
+
+    // Rank `set` by `score`. The set and the scorer's context must outlive
+    // the order (and stay unchanged while it is in use).
+    void build(const CandidateSet& set, const CandidateScore& score);
+    void clear();                       // Back to set order, frees memory
+
+    bool isRanked() const;
+
+    // Candidate ordinal at `rank` (rank < set size)
+    uint32_t at(uint32_t rank);
+
+private:
+    struct Entry {
+        float score;
+        uint32_t ordinal;
+    };
+
+    const CandidateSet* set;
+    CandidateScore scorer;
+    std::vector<Entry> heap;
+    uint32_t heapSize;                  // Entries not yet popped
+    bool truncated;                     // Set larger than the heap
+    Entry worst;                        // Lowest ranked entry in the heap
+    uint32_t tailRank;                  // Scan position past the heap
+    uint32_t tailOrdinal;
+
+    static bool better(const Entry& a, const Entry& b);
+    static bool worse(const Entry& a, const Entry& b);
+    float scoreOf(uint32_t ordinal) const;
+    uint32_t tailAt(uint32_t rank);
+};
+
+#endif // CANDIDATE_ORDER_H
@@ -0,0 +1,298 @@
+#include "candidates.h"
+#include <string.h>
+#include <stdlib.h>
+
+static uint32_t fnv1a(const void* data, size_t len, uint32_t hash = 2166136261u) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Append an unsigned number, zero-padded to minDigits. Returns new position
+// or bufLen on overflow.
+static size_t appendNumber(char* buf, size_t pos, size_t bufLen,
+                           uint32_t value, uint8_t minDigits) {
+    char digits[10];
+    uint8_t n = 0;
+    do {
+        digits[n++] = '0' + (value % 10);
+        value /= 10;
+    } while (value > 0 && n < sizeof(digits));
+
+    while (n < minDigits && n < sizeof(digits)) {
+        digits[n++] = '0';
+    }
+
+    if (pos + n >= bufLen) return bufLen;
+    while (n > 0) {
+        buf[pos++] = digits[--n];
+    }
+    return pos;
+}
+
+// Parse "a-b" or "a" into a numeric range. Advances *p past the range.
+static bool parseRange(const char** p, uint16_t& first, uint16_t& last) {
+    char* end;
+    unsigned long a = strtoul(*p, &end, 10);
+    if (end == *p || a > 0xFFFF) return false;
+
+    unsigned long b = a;
+    if (*end == '-') {
+        const char* bStart = end + 1;
+        b = strtoul(bStart, &end, 10);
+        if (end == bStart || b > 0xFFFF || b < a) return false;
+    }
+
+    first = (uint16_t)a;
+    last = (uint16_t)b;
+    *p = end;
+    return true;
+}
+
+// Parse "A-C" or "A" into a letter range. Advances *p past the range.
+static bool parseLetters(const char** p, char& first, char& last) {
+    const char* s = *p;
+    if (s[0] == '\0' || s[0] == ':') return false;
+
+    first = s[0];
+    last = s[0];
+    s++;
+    if (s[0] == '-' && s[1] != '\0') {
+        last = s[1];
+        s += 2;
+    }
+
+    if (last < first) return false;
+    *p = s;
+    return true;
+}
+
+static bool validMask(const char* mask) {
+    for (const char* c = mask; *c; c++) {
+        if (*c != '%') continue;
+        c++;
+        if (*c >= '1' && *c <= '9') c++;  // Width only applies to %R
+        if (*c == 'R') continue;
+        if (c[-1] != '%') return false;   // Width given for non-room token
+        if (*c != 'F' && *c != 'L' && *c != '%') return false;
+    }
+    return true;
+}
+
+bool CandidateGen::make(CandidateSpec& out, const char* mask,
+                        uint16_t floorFirst, uint16_t floorLast,
+                        uint16_t roomFirst, uint16_t roomLast,
+                        char letterFirst, char letterLast) {
+    size_t maskLen = strlen(mask);
+    if (maskLen == 0 || maskLen >= sizeof(out.mask) || !validMask(mask)) {
+        return false;
+    }
+
+    memcpy(out.mask, mask, maskLen + 1);
+    out.floorFirst = floorFirst;
+    out.floorLast = floorLast;
+    out.roomFirst = roomFirst;
+    out.roomLast = roomLast;
+    out.letterFirst = letterFirst;
+    out.letterLast = letterLast;
+    return true;
+}
+
+bool CandidateGen::parse(const char* text, CandidateSpec& out) {
+    const char* colon = strchr(text, ':');
+    if (!colon) return false;
+
+    size_t maskLen = colon - text;
+    if (maskLen == 0 || maskLen >= sizeof(out.mask)) return false;
+
+    char mask[CANDIDATE_MASK_LEN];
+    memcpy(mask, text, maskLen);
+    mask[maskLen] = '\0';
+
+    const char* p = colon + 1;
+    uint16_t floorFirst, floorLast, roomFirst, roomLast;
+    if (!parseRange(&p, floorFirst, floorLast) || *p != ':') return false;
+    p++;
+    if (!parseRange(&p, roomFirst, roomLast)) return false;
+
+    char letterFirst = 'A';
+    char letterLast = 'A';
+    if (*p == ':') {
+        p++;
+        if (!parseLetters(&p, letterFirst, letterLast)) return false;
+    }
+    if (*p != '\0') return false;
+
+    return make(out, mask, floorFirst, floorLast, roomFirst, roomLast,
+                letterFirst, letterLast);
+}
+
+uint32_t CandidateGen::count(const CandidateSpec& spec) {
+    if (spec.floorLast < spec.floorFirst || spec.roomLast < spec.roomFirst ||
+        spec.letterLast < spec.letterFirst) {
+        return 0;
+    }
+
+    uint64_t letters = (uint64_t)(spec.letterLast - spec.letterFirst) + 1;
+    uint64_t floors = (uint64_t)(spec.floorLast - spec.floorFirst) + 1;
+    uint64_t rooms = (uint64_t)(spec.roomLast - spec.roomFirst) + 1;
+    uint64_t total = letters * floors * rooms;
+
+    return total > 0xFFFFFFFFull ? 0xFFFFFFFFu : (uint32_t)total;
+}
+
+size_t CandidateGen::at(const CandidateSpec& spec, uint32_t ordinal,
+                        char* buf, size_t bufLen) {
+    if (bufLen == 0 || ordinal >= count(spec)) return 0;
+
+    uint32_t rooms = (uint32_t)(spec.roomLast - spec.roomFirst) + 1;
+    uint32_t floors = (uint32_t)(spec.floorLast - spec.floorFirst) + 1;
+
+    uint32_t room = spec.roomFirst + ordinal % rooms;
+    uint32_t rest = ordinal / rooms;
+    uint32_t floor = spec.floorFirst + rest % floors;
+    char letter = spec.letterFirst + (char)(rest / floors);
+
+    size_t pos = 0;
+    for (const char* c = spec.mask; *c && pos < bufLen; c++) {
+        if (*c != '%') {
+            buf[pos++] = *c;
+            continue;
+        }
+
+        c++;
+        uint8_t width = 0;
+        if (*c >= '1' && *c <= '9') {
+            width = *c - '0';
+            c++;
+        }
+
+        switch (*c) {
+            case 'F':
+                pos = appendNumber(buf, pos, bufLen, floor, 0);
+                break;
+            case 'R':
+                pos = appendNumber(buf, pos, bufLen, room, width);
+                break;
+            case 'L':
+                buf[pos++] = letter;
+                break;
+            case '%':
+                buf[pos++] = '%';
+                break;
+            default:
+                return 0;
+        }
+    }
+
+    if (pos >= bufLen) return 0;
+    buf[pos] = '\0';
+    return pos;
+}
+
+CandidateSet::CandidateSet() : sourceCount(0) {}
+
+void CandidateSet::clear() {
+    sourceCount = 0;
+}
+
+bool CandidateSet::addPattern(const CandidateSpec& spec) {
+    if (sourceCount >= CANDIDATE_MAX_SOURCES) return false;
+
+    Source& src = sources[sourceCount++];
+    src.kind = SOURCE_PATTERN;
+    src.spec = spec;
+    return true;
+}
+
+bool CandidateSet::addArray(const char* const* words, uint32_t count) {
+    if (sourceCount >= CANDIDATE_MAX_SOURCES) return false;
+
+    Source& src = sources[sourceCount++];
+    src.kind = SOURCE_ARRAY;
+    src.array = words;
+    src.arrayCount = count;
+    return true;
+}
+
+bool CandidateSet::addWords(const CandidateWords& words) {
+    if (sourceCount >= CANDIDATE_MAX_SOURCES) return false;
+
+    Source& src = sources[sourceCount++];
+    src.kind = SOURCE_WORDS;
+    src.words = words;
+    return true;
+}
+
+uint32_t CandidateSet::sourceSize(const Source& src) {
+    switch (src.kind) {
+        case SOURCE_PATTERN: return CandidateGen::count(src.spec);
+        case SOURCE_ARRAY:   return src.arrayCount;
+        case SOURCE_WORDS:   return src.words.count(src.words.ctx);
+    }
+    return 0;
+}
+
+uint32_t CandidateSet::size() const {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < sourceCount; i++) {
+        total += sourceSize(sources[i]);
+    }
+    return total;
+}
+
+uint32_t CandidateSet::getHash() const {
+    uint32_t hash = 2166136261u;
+    for (uint8_t i = 0; i < sourceCount; i++) {
+        const Source& src = sources[i];
+        hash = fnv1a(&src.kind, sizeof(src.kind), hash);
+
+        if (src.kind == SOURCE_PATTERN) {
+            // The spec determines every value; the mask only up to its end
+            const CandidateSpec& spec = src.spec;
+            hash = fnv1a(spec.mask, strnlen(spec.mask, CANDIDATE_MASK_LEN), hash);
+            uint16_t ranges[4] = {spec.floorFirst, spec.floorLast, spec.roomFirst, spec.roomLast};
+            hash = fnv1a(ranges, sizeof(ranges), hash);
+            hash = fnv1a(&spec.letterFirst, 1, hash);
+            hash = fnv1a(&spec.letterLast, 1, hash);
+            continue;
+        }
+
+        uint32_t n = sourceSize(src);
+        for (uint32_t k = 0; k < n; k++) {
+            const char* word = src.kind == SOURCE_ARRAY ?
+                src.array[k] : src.words.get(src.words.ctx, k);
+            if (!word) word = "";
+            hash = fnv1a(word, strlen(word) + 1, hash);     // NUL separates words
+        }
+    }
+    return hash;
+}
+
+size_t CandidateSet::at(uint32_t ordinal, char* buf, size_t bufLen) const {
+    for (uint8_t i = 0; i < sourceCount; i++) {
+        const Source& src = sources[i];
+        uint32_t n = sourceSize(src);
+        if (ordinal >= n) {
+            ordinal -= n;
+            continue;
+        }
+
+        if (src.kind == SOURCE_PATTERN) {
+            return CandidateGen::at(src.spec, ordinal, buf, bufLen);
+        }
+
+        const char* word = src.kind == SOURCE_ARRAY ?
+            src.array[ordinal] : src.words.get(src.words.ctx, ordinal);
+        size_t len = word ? strlen(word) : 0;
+        if (len == 0 || len >= bufLen) return 0;
+
+        memcpy(buf, word, len + 1);
+        return len;
+    }
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+#ifndef CANDIDATES_H
+#define CANDIDATES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Longest value a generator will produce, including the terminator
+#define CANDIDATE_MAX_LEN 32
+
+// Maximum mask length for a pattern spec (including terminator)
+#define CANDIDATE_MASK_LEN 16
+
+// Maximum number of sources chained into one candidate set
+#define CANDIDATE_MAX_SOURCES 8
+
+// Compact description of a family of room-style candidates.
+//
+// Values are produced on demand from three nested axes (letter, floor, room),
+// so "floors 1-40 x rooms 1-60" costs a few bytes instead of 2400 Strings.
+// Ordinals walk letters outermost and rooms innermost.
+//
+// Mask tokens:
+//   %F   floor number
+//   %R   room number, unpadded
+//   %nR  room number zero-padded to n digits (n = 1..9)
+//   %L   prefix letter
+//   %%   literal '%'
+// Any other character is copied verbatim. Axes not referenced by the mask
+// should span a single value (first == last).
+struct CandidateSpec {
+    char mask[CANDIDATE_MASK_LEN];
+    uint16_t floorFirst;
+    uint16_t floorLast;
+    uint16_t roomFirst;
+    uint16_t roomLast;
+    char letterFirst;
+    char letterLast;
+};
+
+// Callback-backed word list (e.g. wordlist lines already held in RAM)
+struct CandidateWords {
+    const void* ctx;
+    uint32_t (*count)(const void* ctx);
+    const char* (*get)(const void* ctx, uint32_t index);
+};
+
+class CandidateGen {
+public:
+    // Build a spec from its parts; returns false if the mask doesn't fit
+    static bool make(CandidateSpec& out, const char* mask,
+                     uint16_t floorFirst, uint16_t floorLast,
+                     uint16_t roomFirst, uint16_t roomLast,
+                     char letterFirst = 'A', char letterLast = 'A');
+
+    // Parse "mask:floors:rooms[:letters]", e.g. "%F%2R:1-40:1-60" or
+    // "%L%R:0-0:1-3:A-C". Single values ("7") are accepted for any range.
+    static bool parse(const char* text, CandidateSpec& out);
+
+    // Number of values the spec describes
+    static uint32_t count(const CandidateSpec& spec);
+
+    // Write the value at `ordinal` into buf. Returns its length, or 0 if the
+    // ordinal is out of range or the value doesn't fit.
+    static size_t at(const CandidateSpec& spec, uint32_t ordinal, char* buf, size_t bufLen);
+};
+
+// Ordered chain of candidate sources addressed by a single ordinal.
+// Lookups are random access, so a run can resume from any ordinal.
+class CandidateSet {
+public:
+    CandidateSet();
+
+    void clear();
+    bool addPattern(const CandidateSpec& spec);
+    bool addArray(const char* const* words, uint32_t count);
+    bool addWords(const CandidateWords& words);
+
+    uint32_t size() const;
+    size_t at(uint32_t ordinal, char* buf, size_t bufLen) const;
+
+    // Fingerprint of the values in ordinal order: every word of a list,
+    // the spec of a pattern. Equal hashes map ordinals to equal values.
+    uint32_t getHash() const;
+
+private:
+    enum SourceKind : uint8_t {
+        SOURCE_PATTERN,
+        SOURCE_ARRAY,
+        SOURCE_WORDS
+    };
+
+    struct Source {
+        SourceKind kind;
+        CandidateSpec spec;
+        const char* const* array;
+        uint32_t arrayCount;
+        CandidateWords words;
+    };
+
+    Source sources[CANDIDATE_MAX_SOURCES];
+    uint8_t sourceCount;
+
+    static uint32_t sourceSize(const Source& src);
+};
+
+#endif // CANDIDATES_H
@@ -0,0 +1,559 @@
+#include "enum_job.h"
+#include "power.h"
+#include <Preferences.h>
+#include <SPIFFS.h>
+#include <SD.h>
+#include <stddef.h>
+
+#define CHECKPOINT_MAGIC   0x504B4345  // "ECKP"
+#define CHECKPOINT_VERSION 4
+#define CHECKPOINT_NS      "enumjob"
+#define CHECKPOINT_KEY     "ckpt"
+#define JOB_ID_KEY         "lastid"    // Kept when the checkpoint goes
+
+// Static member initialization
+TaskHandle_t EnumJob::task = nullptr;
+SemaphoreHandle_t EnumJob::checkpointLock = nullptr;
+NetworkInfo EnumJob::target;
+int EnumJob::maxAttempts = 0;
+EnumCursor EnumJob::cursor = {0, 0, 0};
+EnumResult EnumJob::result;
+EnumHit EnumJob::hits[ENUM_MAX_HITS];
+int EnumJob::restoredHits = 0;
+bool EnumJob::resumed = false;
+EnumCheckpoint EnumJob::saved;
+bool EnumJob::savedValid = false;
+unsigned long EnumJob::lastCheckpoint = 0;
+EnumProgress EnumJob::progress;
+EnumProgressSnapshot EnumJob::live;
+AttemptLog EnumJob::attemptLog;
+File EnumJob::logFile;
+
+std::atomic<uint32_t> EnumJob::jobId(0);
+std::atomic<uint8_t> EnumJob::state(JOB_IDLE);
+std::atomic<bool> EnumJob::cancelFlag(false);
+std::atomic<bool> EnumJob::dirty(false);
+std::atomic<int> EnumJob::hitCount(0);
+
+static uint32_t fnv1a(const void* data, size_t len, uint32_t hash = 2166136261u) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t checkpointChecksum(const EnumCheckpoint& ckpt) {
+    return fnv1a(&ckpt, offsetof(EnumCheckpoint, checksum));
+}
+
+void EnumJob::init() {
+    if (!checkpointLock) {
+        checkpointLock = xSemaphoreCreateMutex();
+    }
+
+    // Flush progress before Power::checkIdle() puts us into deep sleep
+    Power::setSleepCallback(flushCheckpoint);
+
+    Preferences prefs;
+    savedValid = false;
+    if (prefs.begin(CHECKPOINT_NS, true)) {
+        // Keep job ids monotonic across reboots, so a new job never
+        // reuses (and truncates) an earlier job's attempt log
+        jobId.store(prefs.getUInt(JOB_ID_KEY, 0));
+
+        if (prefs.getBytesLength(CHECKPOINT_KEY) == sizeof(saved) &&
+            prefs.getBytes(CHECKPOINT_KEY, &saved, sizeof(saved)) == sizeof(saved)) {
+            savedValid = saved.magic == CHECKPOINT_MAGIC &&
+                         saved.version == CHECKPOINT_VERSION &&
+                         saved.checksum == checkpointChecksum(saved) &&
+                         (saved.state == JOB_RUNNING || saved.state == JOB_CANCELLED);
+        }
+        prefs.end();
+    }
+
+    if (savedValid) {
+        if (saved.jobId > jobId.load()) jobId.store(saved.jobId);
+
+        #if DEBUG_SERIAL
+        Serial.printf("[ENUM] Resumable job %u: %d/%d attempts, %d hits\n",
+            saved.jobId, saved.attempts, saved.maxAttempts, saved.successes);
+        #endif
+    }
+}
+
+uint32_t EnumJob::start(const NetworkInfo& portal, int attempts) {
+    uint8_t expected = state.load();
+    if (expected == JOB_RUNNING ||
+        !state.compare_exchange_strong(expected, JOB_RUNNING)) {
+        return 0;
+    }
+
+    // The task works on its own copy; the scanner may reshuffle its list
+    target = portal;
+    maxAttempts = attempts;
+    cursor = {0, 0, 0};
+    restoredHits = 0;
+    hitCount.store(0);
+    resumed = false;
+
+    uint32_t id = jobId.load() + 1;
+    if (id == 0) id = 1;
+    return launch(id);
+}
+
+uint32_t EnumJob::resume() {
+    if (!savedValid) return 0;
+
+    uint8_t expected = state.load();
+    if (expected == JOB_RUNNING ||
+        !state.compare_exchange_strong(expected, JOB_RUNNING)) {
+        return 0;
+    }
+
+    if (saved.hasPattern) {
+        Enumerator::useRoomPattern(saved.pattern);
+    } else {
+        Enumerator::useDefaultRoomPatterns();
+    }
+
+    // The target is read back and checked against the checkpoint on the
+    // job task (taskMain); a mismatch ends the job as JOB_FAILED
+    maxAttempts = saved.maxAttempts;
+    Enumerator::setMaxRate(saved.maxRate);
+    cursor.next = saved.next;
+    cursor.attempts = saved.attempts;
+    cursor.successes = saved.successes;
+    restoredHits = 0;
+    hitCount.store(0);
+    resumed = true;
+
+    #if DEBUG_SERIAL
+    Serial.printf("[ENUM] Resuming job %u at ordinal %u\n", saved.jobId, saved.next);
+    #endif
+
+    return launch(saved.jobId);
+}
+
+uint32_t EnumJob::launch(uint32_t id) {
+    result = EnumResult();
+
+    cancelFlag.store(false);
+    memset(&live, 0, sizeof(live));
+    live.next = cursor.next;
+    live.current = cursor.attempts;
+    live.total = maxAttempts;
+    live.successes = cursor.successes;
+    progress.publish(live);
+    jobId.store(id);
+
+    Enumerator::setProgressCallback(onProgress);
+    Enumerator::setSuccessCallback(onSuccess);
+    Enumerator::setAttemptCallback(onAttempt);
+
+    // Flash and SD writes happen on the job task (taskMain), never on the
+    // caller's, which is usually the web server's
+    BaseType_t created = xTaskCreatePinnedToCore(
+        taskMain, "enum_job", ENUM_TASK_STACK, nullptr,
+        ENUM_TASK_PRIORITY, &task, ENUM_TASK_CORE);
+
+    if (created != pdPASS) {
+        #if DEBUG_SERIAL
+        Serial.println("[ENUM] Failed to create job task");
+        #endif
+        task = nullptr;
+        state.store(JOB_IDLE);
+        return 0;
+    }
+
+    return id;
+}
+
+bool EnumJob::cancel(uint32_t id) {
+    if (id != jobId.load() || state.load() != JOB_RUNNING) {
+        return false;
+    }
+
+    cancelFlag.store(true);
+    return true;
+}
+
+void EnumJob::taskMain(void* param) {
+    if (resumed) {
+        // The candidate sets must match the ones the ordinals refer to
+        if (!loadTarget() || planHash() != saved.planHash) {
+            #if DEBUG_SERIAL
+            Serial.println("[ENUM] Checkpoint no longer matches target/wordlists/priors");
+            #endif
+            // The checkpoint stays: the wordlists may come back (SD card)
+            result.venueInsights = "Checkpoint no longer matches the portal, wordlists or priors";
+            task = nullptr;
+            state.store(JOB_FAILED);
+            vTaskDelete(nullptr);
+            return;
+        }
+        restoreHits();
+    } else {
+        Preferences prefs;
+        if (prefs.begin(CHECKPOINT_NS, false)) {
+            prefs.putUInt(JOB_ID_KEY, jobId.load());
+            prefs.end();
+        }
+
+        if (!saveTarget()) {
+            #if DEBUG_SERIAL
+            Serial.println("[ENUM] Could not save job target, resume disabled");
+            #endif
+        }
+    }
+
+    // A resumed job keeps appending to its own log
+    openLog(jobId.load(), resumed);
+
+    // Initial record so a reset straight after starting is resumable
+    writeCheckpoint(JOB_RUNNING);
+
+    #if DEBUG_SERIAL
+    Serial.printf("[ENUM] Job %u started on %s (max %d)\n",
+        jobId.load(), target.ssid.c_str(), maxAttempts);
+    #endif
+
+    result = Enumerator::enumerate(&target, maxAttempts, &cancelFlag, &cursor);
+
+    // Fold in hits from before a resume; counters already include them
+    if (restoredHits > 0) {
+        for (int i = 0; i < restoredHits; i++) {
+            Enumerator::recordSuccess(result, hits[i].room, hits[i].name);
+        }
+        Enumerator::summarize(result);
+    }
+
+    live.next = cursor.next;
+    live.current = cursor.attempts;
+    live.successes = cursor.successes;
+    live.status[0] = '\0';
+    progress.publish(live);
+
+    closeLog();
+
+    bool cancelled = cancelFlag.load();
+    if (cancelled) {
+        // Keep the record so a cancelled job can be resumed later
+        writeCheckpoint(JOB_CANCELLED);
+    } else {
+        discardCheckpoint();
+    }
+
+    #if DEBUG_SERIAL
+    Serial.printf("[ENUM] Job %u %s\n", jobId.load(), cancelled ? "cancelled" : "complete");
+    #endif
+
+    // Publish the result before the state flip so readers see it complete.
+    // Nothing shared is touched after it: start() may launch the next job
+    // (and store its handle in `task`) as soon as the state leaves RUNNING.
+    task = nullptr;
+    state.store(cancelled ? JOB_CANCELLED : JOB_COMPLETE);
+    vTaskDelete(nullptr);
+}
+
+// Re-render the hits found before the interruption
+void EnumJob::restoreHits() {
+    const CandidateSet& rooms = Enumerator::getRoomCandidates();
+    const CandidateSet& names = Enumerator::getSurnameCandidates();
+    int n = min((int)saved.hitCount, ENUM_MAX_HITS);
+    for (int i = 0; i < n; i++) {
+        EnumHit& hit = hits[i];
+        hit.roomOrdinal = saved.hitRooms[i];
+        hit.nameOrdinal = saved.hitNames[i];
+        hit.room[0] = '\0';
+        hit.name[0] = '\0';
+        if (hit.roomOrdinal != ENUM_NO_CANDIDATE) {
+            rooms.at(hit.roomOrdinal, hit.room, sizeof(hit.room));
+        }
+        if (hit.nameOrdinal != ENUM_NO_CANDIDATE) {
+            names.at(hit.nameOrdinal, hit.name, sizeof(hit.name));
+        }
+    }
+    restoredHits = n;
+    hitCount.store(n, std::memory_order_release);
+}
+
+void EnumJob::onProgress(int cur, int tot, const char* room, const char* name) {
+    if (live.next != cursor.next) {
+        dirty.store(true);
+    }
+
+    live.next = cursor.next;
+    live.current = cur;
+    live.total = tot;
+    EnumProgress::formatStatus(live.status, sizeof(live.status), room, name);
+    progress.publish(live);
+
+    // Batched: at most one flash write per interval
+    if (dirty.load() && millis() - lastCheckpoint >= ENUM_CHECKPOINT_INTERVAL) {
+        writeCheckpoint(JOB_RUNNING);
+    }
+}
+
+void EnumJob::onSuccess(const char* room, const char* name,
+                        uint32_t roomOrdinal, uint32_t nameOrdinal) {
+    // The runner advances cursor.next after this returns. Publish the
+    // position past this attempt together with its hit, under the
+    // checkpoint lock, so a flush from another task (sleep) records both
+    // or neither and a resume never retries it or counts the hit twice.
+    if (checkpointLock) xSemaphoreTake(checkpointLock, portMAX_DELAY);
+
+    live.next = cursor.next + 1;
+    live.current = cursor.attempts;
+    live.successes = cursor.successes;
+    progress.publish(live);
+    dirty.store(true);
+
+    int n = hitCount.load(std::memory_order_relaxed);
+    if (n < ENUM_MAX_HITS) {
+        strlcpy(hits[n].room, room, sizeof(hits[n].room));
+        strlcpy(hits[n].name, name, sizeof(hits[n].name));
+        hits[n].roomOrdinal = roomOrdinal;
+        hits[n].nameOrdinal = nameOrdinal;
+
+        // Release: the slot is fully written before it becomes visible
+        hitCount.store(n + 1, std::memory_order_release);
+    }
+
+    if (checkpointLock) xSemaphoreGive(checkpointLock);
+}
+
+void EnumJob::onAttempt(const AttemptRecord& record) {
+    attemptLog.append(record);
+}
+
+String EnumJob::logPath(uint32_t id) {
+    return String(ENUM_LOG_DIR) + "/attempts-" + String(id) + ".bin";
+}
+
+void EnumJob::openLog(uint32_t id, bool append) {
+    AttemptSink sink = {nullptr, writeLog};
+
+    #if USE_SD_CARD_IF_AVAILABLE && defined(SD_CS)
+    static bool mounted = false;
+    if (!mounted) {
+        mounted = SD.begin(SD_CS);
+        if (mounted) SD.mkdir(ENUM_LOG_DIR);
+    }
+
+    String path = logPath(id);
+    if (mounted) {
+        append = append && SD.exists(path);
+        logFile = SD.open(path, append ? FILE_APPEND : FILE_WRITE);
+    }
+    #endif
+
+    attemptLog.begin(id, logFile ? &sink : nullptr, append);
+
+    #if DEBUG_SERIAL
+    Serial.printf("[ENUM] Attempt log: %s\n", logFile ? logFile.name() : "RAM only (no SD)");
+    #endif
+}
+
+void EnumJob::closeLog() {
+    attemptLog.flush();
+    if (logFile) logFile.close();
+
+    #if DEBUG_SERIAL
+    if (attemptLog.getDropped() > 0) {
+        Serial.printf("[ENUM] Attempt log dropped %u records\n", attemptLog.getDropped());
+    }
+    #endif
+}
+
+bool EnumJob::writeLog(void*, const void* data, size_t len) {
+    bool ok = logFile.write((const uint8_t*)data, len) == len;
+    logFile.flush();
+    return ok;
+}
+
+String EnumJob::getLogPath() {
+    #if USE_SD_CARD_IF_AVAILABLE && defined(SD_CS)
+    String path = logPath(getId());
+    if (SD.exists(path)) return path;
+    #endif
+    return "";
+}
+
+uint32_t EnumJob::getLoggedCount() {
+    return attemptLog.getCount();
+}
+
+uint32_t EnumJob::planHash() {
+    uint32_t hash = fnv1a(target.ssid.c_str(), target.ssid.length());
+    hash = fnv1a(target.portalUrl.c_str(), target.portalUrl.length(), hash);
+    hash = fnv1a(target.portalHtml.c_str(), target.portalHtml.length(), hash);
+
+    // Saved ordinals (cursor and hits) only mean the same values if the
+    // candidate sets hold the same values: a same-length wordlist edit or
+    // custom room changes the contents, not the sizes
+    const CandidateSet& rooms = Enumerator::getRoomCandidates();
+    const CandidateSet& names = Enumerator::getSurnameCandidates();
+    uint32_t sets[4] = {rooms.size(), rooms.getHash(), names.size(), names.getHash()};
+    hash = fnv1a(sets, sizeof(sets), hash);
+
+    // Ordinals are ranks in the prior order, so new priors re-map them
+    uint32_t priors = Enumerator::getPriors().getHash();
+    return fnv1a(&priors, sizeof(priors), hash);
+}
+
+bool EnumJob::saveTarget() {
+    // Written once per job; checkpoints only carry the cursor
+    File f = SPIFFS.open(ENUM_CHECKPOINT_TARGET, FILE_WRITE);
+    if (!f) return false;
+
+    f.print(target.ssid);
+    f.print("\n");
+    f.print(target.portalUrl);
+    f.print("\n");
+    f.print(target.portalHtml);
+    f.close();
+    return true;
+}
+
+bool EnumJob::loadTarget() {
+    File f = SPIFFS.open(ENUM_CHECKPOINT_TARGET, FILE_READ);
+    if (!f) return false;
+
+    target = NetworkInfo();
+    target.ssid = f.readStringUntil('\n');
+    target.portalUrl = f.readStringUntil('\n');
+    target.portalHtml = f.readString();
+    target.hasPortal = true;
+    target.isOpen = true;
+    f.close();
+
+    return target.portalHtml.length() > 0;
+}
+
+void EnumJob::writeCheckpoint(uint8_t jobState) {
+    if (!checkpointLock || xSemaphoreTake(checkpointLock, portMAX_DELAY) != pdTRUE) {
+        return;
+    }
+
+    EnumCheckpoint ckpt;
+    memset(&ckpt, 0, sizeof(ckpt));
+    ckpt.magic = CHECKPOINT_MAGIC;
+    ckpt.version = CHECKPOINT_VERSION;
+    ckpt.state = jobState;
+    ckpt.jobId = jobId.load();
+    ckpt.maxAttempts = maxAttempts;
+    ckpt.maxRate = Enumerator::getMaxRate();
+    // May run on another task (sleep callback); take one consistent view
+    EnumProgressSnapshot snap;
+    progress.read(snap);
+    ckpt.next = snap.next;
+    ckpt.attempts = snap.current;
+    ckpt.successes = snap.successes;
+    ckpt.hasPattern = Enumerator::getRoomPattern(ckpt.pattern) ? 1 : 0;
+
+    int n = hitCount.load(std::memory_order_acquire);
+    ckpt.hitCount = n;
+    for (int i = 0; i < n; i++) {
+        ckpt.hitRooms[i] = hits[i].roomOrdinal;
+        ckpt.hitNames[i] = hits[i].nameOrdinal;
+    }
+
+    // Only the first record of a job pays for hashing the target
+    ckpt.planHash = (savedValid && saved.jobId == ckpt.jobId) ? saved.planHash : planHash();
+    ckpt.checksum = checkpointChecksum(ckpt);
+
+    Preferences prefs;
+    if (prefs.begin(CHECKPOINT_NS, false)) {
+        prefs.putBytes(CHECKPOINT_KEY, &ckpt, sizeof(ckpt));
+        prefs.end();
+    }
+
+    saved = ckpt;
+    savedValid = true;
+    lastCheckpoint = millis();
+    dirty.store(false);
+
+    xSemaphoreGive(checkpointLock);
+}
+
+void EnumJob::flushCheckpoint() {
+    if (isRunning() && dirty.load()) {
+        writeCheckpoint(JOB_RUNNING);
+    }
+}
+
+bool EnumJob::hasCheckpoint() {
+    return savedValid && !isRunning();
+}
+
+void EnumJob::discardCheckpoint() {
+    if (checkpointLock) xSemaphoreTake(checkpointLock, portMAX_DELAY);
+
+    Preferences prefs;
+    if (prefs.begin(CHECKPOINT_NS, false)) {
+        prefs.remove(CHECKPOINT_KEY);
+        prefs.end();
+    }
+    SPIFFS.remove(ENUM_CHECKPOINT_TARGET);
+    savedValid = false;
+
+    if (checkpointLock) xSemaphoreGive(checkpointLock);
+}
+
+uint32_t EnumJob::getId() {
+    return jobId.load();
+}
+
+EnumJobState EnumJob::getState() {
+    return (EnumJobState)state.load();
+}
+
+bool EnumJob::isRunning() {
+    return state.load() == JOB_RUNNING;
+}
+
+const char* EnumJob::getStateName() {
+    switch (getState()) {
+        case JOB_RUNNING:   return "running";
+        case JOB_COMPLETE:  return "complete";
+        case JOB_CANCELLED: return "cancelled";
+        case JOB_FAILED:    return "failed";
+        default:            return "idle";
+    }
+}
+
+void EnumJob::getProgress(EnumProgressSnapshot& out) {
+    progress.read(out);
+}
+
+int EnumJob::getCurrent() {
+    EnumProgressSnapshot snap;
+    progress.read(snap);
+    return snap.current;
+}
+
+int EnumJob::getTotal() {
+    EnumProgressSnapshot snap;
+    progress.read(snap);
+    return snap.total;
+}
+
+int EnumJob::getSuccessCount() {
+    EnumProgressSnapshot snap;
+    progress.read(snap);
+    return snap.successes;
+}
+
+int EnumJob::getHitCount() {
+    return hitCount.load(std::memory_order_acquire);
+}
+
+const EnumHit& EnumJob::getHit(int index) {
+    return hits[index];
+}
+
+const EnumResult& EnumJob::getResult() {
+    return result;
+}
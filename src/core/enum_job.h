@@ -0,0 +1,140 @@
+#ifndef ENUM_JOB_H
+#define ENUM_JOB_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <atomic>
+#include "config.h"
+#include "enumerator.h"
+#include "enum_progress.h"
+#include "attempt_log.h"
+
+// Background enumeration job lifecycle
+enum EnumJobState : uint8_t {
+    JOB_IDLE,
+    JOB_RUNNING,
+    JOB_COMPLETE,
+    JOB_CANCELLED,
+    JOB_FAILED               // Resume refused: checkpoint doesn't match
+};
+
+// Valid combination found by a job (fixed size, no heap)
+struct EnumHit {
+    char room[CANDIDATE_MAX_LEN];
+    char name[CANDIDATE_MAX_LEN];
+    uint32_t roomOrdinal;
+    uint32_t nameOrdinal;
+};
+
+// Compact persisted job record. Hits are stored as candidate ordinals and
+// re-rendered on resume, so the record stays a few hundred bytes.
+struct EnumCheckpoint {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t state;           // EnumJobState when written
+    uint8_t hasPattern;      // User room pattern in effect
+    uint32_t jobId;
+    uint32_t planHash;       // Target, candidate sets and priors
+    int32_t maxAttempts;
+    float maxRate;           // Pacing ceiling, attempts/sec
+    uint32_t next;           // EnumCursor
+    int32_t attempts;
+    int32_t successes;
+    uint32_t hitCount;
+    CandidateSpec pattern;
+    uint32_t hitRooms[ENUM_MAX_HITS];
+    uint32_t hitNames[ENUM_MAX_HITS];
+    uint32_t checksum;       // FNV-1a over everything above
+};
+
+// Runs Enumerator::enumerate() on its own FreeRTOS task so callers
+// (web handlers, UI) never block for the length of a run. Progress is
+// published through a seqlock and can be read from any task or core, and
+// is checkpointed to NVS so an interrupted job can be resumed.
+class EnumJob {
+public:
+    // Load any checkpoint left by a previous boot or sleep
+    static void init();
+
+    // Start a job against a copy of the portal. Returns the new job id,
+    // or 0 if a job is already running or the task couldn't be created.
+    static uint32_t start(const NetworkInfo& portal, int maxAttempts);
+    static bool cancel(uint32_t jobId);
+
+    // Continue the checkpointed job from its saved cursor. Returns its
+    // job id, or 0 if there is no checkpoint. The target and wordlists are
+    // checked against it on the job task; if they changed, the job ends
+    // as JOB_FAILED with the reason in getResult().venueInsights.
+    static uint32_t resume();
+    static bool hasCheckpoint();
+    static void discardCheckpoint();
+
+    // Write pending progress immediately (e.g. before deep sleep)
+    static void flushCheckpoint();
+
+    static uint32_t getId();
+    static EnumJobState getState();
+    static bool isRunning();
+    static const char* getStateName();
+
+    // Lock-free progress: one consistent snapshot, or single fields
+    static void getProgress(EnumProgressSnapshot& out);
+    static int getCurrent();
+    static int getTotal();
+    static int getSuccessCount();
+
+    // Hits recorded so far (bounded by ENUM_MAX_HITS)
+    static int getHitCount();
+    static const EnumHit& getHit(int index);
+
+    // Final summary, valid once the job has left JOB_RUNNING
+    static const EnumResult& getResult();
+
+    // Binary attempt log of the current/last job on SD ("" if none)
+    static String getLogPath();
+    static uint32_t getLoggedCount();
+
+private:
+    static TaskHandle_t task;
+    static SemaphoreHandle_t checkpointLock;
+    static NetworkInfo target;
+    static int maxAttempts;
+    static EnumCursor cursor;
+    static EnumResult result;
+    static EnumHit hits[ENUM_MAX_HITS];
+    static int restoredHits;           // Hits carried over from a checkpoint
+    static bool resumed;               // Job continues the checkpointed one
+    static EnumCheckpoint saved;
+    static bool savedValid;
+    static unsigned long lastCheckpoint;
+    static EnumProgress progress;
+    static EnumProgressSnapshot live;  // Writer's copy (job task only)
+    static AttemptLog attemptLog;
+    static File logFile;
+
+    static std::atomic<uint32_t> jobId;
+    static std::atomic<uint8_t> state;
+    static std::atomic<bool> cancelFlag;
+    static std::atomic<bool> dirty;
+    static std::atomic<int> hitCount;
+
+    static uint32_t launch(uint32_t id);
+    static void taskMain(void* param);
+    static void onProgress(int current, int total, const char* room, const char* name);
+    static void onSuccess(const char* room, const char* name,
+                          uint32_t roomOrdinal, uint32_t nameOrdinal);
+    static void onAttempt(const AttemptRecord& record);
+    static void restoreHits();
+
+    static String logPath(uint32_t id);
+    static void openLog(uint32_t id, bool append);
+    static void closeLog();
+    static bool writeLog(void* ctx, const void* data, size_t len);
+
+    static uint32_t planHash();
+    static bool saveTarget();
+    static bool loadTarget();
+    static void writeCheckpoint(uint8_t jobState);
+};
+
+#endif // ENUM_JOB_H
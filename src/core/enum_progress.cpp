@@ -0,0 +1,73 @@
+#include "enum_progress.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef HOST_BUILD
+#include <thread>
+#define PROGRESS_YIELD() std::this_thread::yield()
+#else
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+// A reader on the writer's core would otherwise spin until its timeslice ends
+#define PROGRESS_YIELD() vTaskDelay(1)
+#endif
+
+EnumProgress::EnumProgress() : sequence(0) {
+    for (auto& w : words) {
+        w.store(0, std::memory_order_relaxed);
+    }
+}
+
+void EnumProgress::publish(const EnumProgressSnapshot& snapshot) {
+    uint32_t buf[WORDS] = {0};
+    memcpy(buf, &snapshot, sizeof(snapshot));
+
+    uint32_t seq = sequence.load(std::memory_order_relaxed);
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < WORDS; i++) {
+        words[i].store(buf[i], std::memory_order_relaxed);
+    }
+
+    sequence.store(seq + 2, std::memory_order_release);
+}
+
+void EnumProgress::read(EnumProgressSnapshot& out) const {
+    uint32_t buf[WORDS];
+    int spins = 0;
+
+    while (true) {
+        uint32_t before = sequence.load(std::memory_order_acquire);
+        if ((before & 1) == 0) {
+            for (size_t i = 0; i < WORDS; i++) {
+                buf[i] = words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (sequence.load(std::memory_order_relaxed) == before) break;
+        }
+
+        if (++spins >= ENUM_PROGRESS_SPINS) {
+            PROGRESS_YIELD();
+            spins = 0;
+        }
+    }
+
+    memcpy(&out, buf, sizeof(out));
+    out.status[ENUM_STATUS_LEN - 1] = '\0';
+}
+
+uint32_t EnumProgress::getSequence() const {
+    return sequence.load(std::memory_order_acquire);
+}
+
+void EnumProgress::formatStatus(char* buf, size_t len, const char* room, const char* name) {
+    if (room[0] && name[0]) {
+        snprintf(buf, len, "Room %s / %s", room, name);
+    } else if (room[0]) {
+        snprintf(buf, len, "Testing room %s", room);
+    } else {
+        snprintf(buf, len, "Testing name %s", name);
+    }
+}
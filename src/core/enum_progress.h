@@ -0,0 +1,53 @@
+#ifndef ENUM_PROGRESS_H
+#define ENUM_PROGRESS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Longest status line, e.g. "Room 1204 / Smith"
+#define ENUM_STATUS_LEN 80
+
+// Failed reads before a reader yields to let a preempted writer finish
+#define ENUM_PROGRESS_SPINS 64
+
+// One consistent view of a running job
+struct EnumProgressSnapshot {
+    uint32_t next;                 // Next plan ordinal
+    int32_t current;               // Attempts made
+    int32_t total;                 // Attempt budget
+    int32_t successes;             // Valid combinations found
+    char status[ENUM_STATUS_LEN];  // What is being tried right now
+};
+
+// Single-writer seqlock around an EnumProgressSnapshot. The job task
+// publishes after every attempt; web handlers and the UI read from any
+// task or core and always get all fields from the same publish. Nothing
+// is allocated or locked; readers retry only if they overlap a publish.
+//
+// The payload is held as relaxed atomic words so concurrent copies are
+// well defined; the sequence number provides the ordering.
+class EnumProgress {
+public:
+    EnumProgress();
+
+    // Writer side: exactly one task at a time
+    void publish(const EnumProgressSnapshot& snapshot);
+
+    // Reader side: any task
+    void read(EnumProgressSnapshot& out) const;
+
+    // Even while idle, odd while a publish is in progress
+    uint32_t getSequence() const;
+
+    // Render the status line for an attempt without touching the heap
+    static void formatStatus(char* buf, size_t len, const char* room, const char* name);
+
+private:
+    static const size_t WORDS = (sizeof(EnumProgressSnapshot) + 3) / 4;
+
+    std::atomic<uint32_t> sequence;
+    std::atomic<uint32_t> words[WORDS];
+};
+
+#endif // ENUM_PROGRESS_H
@@ -0,0 +1,167 @@
+#include "enum_runner.h"
+#include <ctype.h>
+#include <string.h>
+#include <strings.h>
+
+// Response wording that marks a login as accepted / rejected
+static const char* const successWords[] = {
+    "success", "welcome", "connected", "authenticated", "thank you"
+};
+
+static const char* const failureWords[] = {
+    "invalid", "error", "incorrect", "failed", "wrong", "not found"
+};
+
+// Case-insensitive substring search; `word` must be lowercase
+static bool containsWord(const char* text, const char* word) {
+    for (const char* start = text; *start; start++) {
+        const char* t = start;
+        const char* w = word;
+        while (*w && *t && tolower((unsigned char)*t) == *w) {
+            t++;
+            w++;
+        }
+        if (!*w) return true;
+    }
+    return false;
+}
+
+// Last path segment of a URL or reference, without query or fragment:
+// "http://10.0.0.1/portal/login?e=1" -> "login", "/" -> ""
+static void lastSegment(const char* url, const char** start, size_t* len) {
+    size_t end = strcspn(url, "?#");
+    size_t from = 0;
+    for (size_t i = 0; i < end; i++) {
+        if (url[i] == '/') from = i + 1;
+    }
+    *start = url + from;
+    *len = end - from;
+}
+
+// Whether a redirect points back at the form (same page, any host/query)
+static bool sameForm(const char* location, const char* formUrl) {
+    const char* a;
+    const char* b;
+    size_t aLen, bLen;
+    lastSegment(location, &a, &aLen);
+    lastSegment(formUrl, &b, &bLen);
+    return aLen == bLen && strncasecmp(a, b, aLen) == 0;
+}
+
+// Candidate ordinal at `rank` of an optional order
+static uint32_t ranked(CandidateOrder* order, uint32_t rank) {
+    return order ? order->at(rank) : rank;
+}
+
+uint32_t EnumRunner::planSize(const EnumPlan& plan) {
+    if (plan.rooms && plan.names) return plan.rooms->size() * plan.nameCount;
+    if (plan.rooms) return plan.rooms->size();
+    if (plan.names) return plan.names->size();
+    return 0;
+}
+
+void EnumRunner::run(const EnumPlan& plan, FormTemplate& form, Pacer& pacer,
+                     const EnumTransport& transport, const EnumClock& clock,
+                     const EnumHooks& hooks, int maxAttempts,
+                     const std::atomic<bool>* cancel, EnumCursor& cur) {
+    uint32_t size = planSize(plan);
+    bool both = plan.rooms && plan.names;
+
+    for (uint32_t k = cur.next; k < size; k++) {
+        if (cur.attempts >= maxAttempts) break;
+        if (cancel && cancel->load()) break;
+
+        uint32_t roomOrdinal = ENUM_NO_CANDIDATE;
+        uint32_t nameOrdinal = ENUM_NO_CANDIDATE;
+        if (both) {
+            roomOrdinal = ranked(plan.roomOrder, k / plan.nameCount);
+            nameOrdinal = ranked(plan.nameOrder, k % plan.nameCount);
+        } else if (plan.rooms) {
+            roomOrdinal = ranked(plan.roomOrder, k);
+        } else {
+            nameOrdinal = ranked(plan.nameOrder, k);
+        }
+
+        char room[CANDIDATE_MAX_LEN] = "";
+        char name[CANDIDATE_MAX_LEN] = "";
+        if ((roomOrdinal != ENUM_NO_CANDIDATE &&
+             plan.rooms->at(roomOrdinal, room, sizeof(room)) == 0) ||
+            (nameOrdinal != ENUM_NO_CANDIDATE &&
+             plan.names->at(nameOrdinal, name, sizeof(name)) == 0)) {
+            cur.next = k + 1;
+            continue;
+        }
+
+        if (hooks.progress) hooks.progress(hooks.ctx, cur.attempts, maxAttempts, room, name);
+
+        size_t bodyLen;
+        const char* body = form.fill(room, name, &bodyLen);
+        if (!body) {
+            cur.next = k + 1;
+            continue;
+        }
+
+        if (!waitForPacer(pacer, clock, cancel)) break;
+
+        EnumResponse response = {0, 0, false, 0, 0};
+        uint32_t start = clock.now(clock.ctx);
+        pacer.onAttemptStart(start);
+        transport.submit(transport.ctx, body, bodyLen, response);
+        uint32_t end = clock.now(clock.ctx);
+        pacer.onResponse(end, response.httpCode, response.retryAfterMs);
+
+        if (hooks.attempt) {
+            AttemptRecord record;
+            record.roomOrdinal = roomOrdinal;
+            record.nameOrdinal = nameOrdinal;
+            record.startMs = start;
+            record.bodyHash = response.bodyHash;
+            record.httpCode = response.httpCode < -32768 ? -32768 :
+                              response.httpCode > 32767 ? 32767 : response.httpCode;
+            record.latencyMs = end - start > 0xFFFF ? 0xFFFF : end - start;
+            record.bodyLen = response.bodyLen > 0xFFFF ? 0xFFFF : response.bodyLen;
+            record.flags = (response.success ? ATTEMPT_SUCCESS : 0) |
+                           (response.retryAfterMs ? ATTEMPT_RETRY_AFTER : 0);
+            record.reserved = 0;
+            hooks.attempt(hooks.ctx, record);
+        }
+
+        cur.attempts++;
+        if (response.success) {
+            cur.successes++;
+            if (hooks.success) hooks.success(hooks.ctx, room, name, roomOrdinal, nameOrdinal);
+        }
+        cur.next = k + 1;
+    }
+}
+
+bool EnumRunner::waitForPacer(const Pacer& pacer, const EnumClock& clock,
+                              const std::atomic<bool>* cancel) {
+    // Sleep in short slices so a long Retry-After hold stays cancellable
+    uint32_t wait;
+    while ((wait = pacer.delayBefore(clock.now(clock.ctx))) > 0) {
+        if (cancel && cancel->load()) return false;
+        clock.sleep(clock.ctx, wait < 100 ? wait : 100);
+    }
+    return !(cancel && cancel->load());
+}
+
+bool EnumRunner::isSuccessResponse(int httpCode, const char* body,
+                                   const char* location, const char* formUrl) {
+    if (httpCode != 200 && httpCode != 302) return false;
+    if (!body) body = "";
+    if (!location) location = "";
+
+    for (const char* word : successWords) {
+        if (containsWord(body, word)) return true;
+    }
+
+    for (const char* word : failureWords) {
+        if (containsWord(body, word) || containsWord(location, word)) return false;
+    }
+
+    // A bare 302 is a success only if it leads somewhere else than the
+    // form; many portals redirect failed attempts back to the login page
+    if (httpCode != 302 || location[0] == '\0') return false;
+    return !formUrl || !sameForm(location, formUrl);
+}
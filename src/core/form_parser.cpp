@@ -0,0 +1,429 @@
+#include "form_parser.h"
+#include "config.h"
+#include <ctype.h>
+#include <limits.h>
+
+// Field detection keywords
+static const char* roomKeywords[] = {"room", "zimmer", "chambre", "habitacion", "number", "num", "rm"};
+static const char* lastNameKeywords[] = {"last", "surname", "family", "nachname", "apellido", "nom"};
+static const char* firstNameKeywords[] = {"first", "given", "vorname", "nombre", "prenom"};
+static const char* emailKeywords[] = {"email", "mail", "correo"};
+static const char* phoneKeywords[] = {"phone", "tel", "mobile", "cell", "telefon"};
+static const char* codeKeywords[] = {"code", "access", "pin", "password", "pwd", "pass"};
+
+// Words in a form action that hint at its purpose
+static const char* loginActionWords[] = {"login", "auth", "connect", "portal", "guest", "signin", "access"};
+static const char* otherActionWords[] = {"lang", "locale", "search", "newsletter", "subscribe", "feedback"};
+
+static bool startsWithNoCase(const char* p, const char* word) {
+    for (; *word; p++, word++) {
+        if (tolower((unsigned char)*p) != *word) return false;
+    }
+    return true;
+}
+
+// Position after the '>' closing the tag at p (quotes may contain '>')
+static const char* findTagEnd(const char* p, const char* end) {
+    char quote = 0;
+    for (; p < end; p++) {
+        if (quote) {
+            if (*p == quote) quote = 0;
+        } else if (*p == '"' || *p == '\'') {
+            quote = *p;
+        } else if (*p == '>') {
+            return p + 1;
+        }
+    }
+    return end;
+}
+
+// Skip past the closing tag of a raw-text element (script/style)
+static const char* skipRawText(const char* p, const char* end, const char* closeTag) {
+    for (; p < end; p++) {
+        if (*p == '<' && p[1] == '/' && startsWithNoCase(p + 2, closeTag)) {
+            return p;
+        }
+    }
+    return end;
+}
+
+bool FormParser::tagIs(const char* p, const char* name) {
+    if (!startsWithNoCase(p, name)) return false;
+    char next = p[strlen(name)];
+    return next == '>' || next == '/' || isspace((unsigned char)next);
+}
+
+bool FormParser::readAttr(const char* tag, const char* tagEnd, const char* name, String& out) {
+    const char* p = tag + 1;
+
+    // Skip the tag name
+    while (p < tagEnd && !isspace((unsigned char)*p) && *p != '>' && *p != '/') p++;
+
+    size_t nameLen = strlen(name);
+    while (p < tagEnd) {
+        while (p < tagEnd && (isspace((unsigned char)*p) || *p == '/')) p++;
+        if (p >= tagEnd || *p == '>') break;
+
+        const char* attr = p;
+        while (p < tagEnd && !isspace((unsigned char)*p) && *p != '=' && *p != '>' && *p != '/') p++;
+        size_t attrLen = p - attr;
+
+        while (p < tagEnd && isspace((unsigned char)*p)) p++;
+
+        const char* value = p;
+        size_t valueLen = 0;
+        if (p < tagEnd && *p == '=') {
+            p++;
+            while (p < tagEnd && isspace((unsigned char)*p)) p++;
+            if (p < tagEnd && (*p == '"' || *p == '\'')) {
+                char quote = *p++;
+                value = p;
+                while (p < tagEnd && *p != quote) p++;
+                valueLen = p - value;
+                if (p < tagEnd) p++;
+            } else {
+                value = p;
+                while (p < tagEnd && !isspace((unsigned char)*p) && *p != '>') p++;
+                valueLen = p - value;
+            }
+        }
+
+        if (attrLen == nameLen && startsWithNoCase(attr, name)) {
+            String raw;
+            raw.reserve(valueLen);
+            for (size_t i = 0; i < valueLen; i++) raw += value[i];
+            out = decodeEntities(raw);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+String FormParser::decodeEntities(const String& text) {
+    if (text.indexOf('&') < 0) return text;
+
+    String out = text;
+    out.replace("&amp;", "&");
+    out.replace("&quot;", "\"");
+    out.replace("&#39;", "'");
+    out.replace("&#x27;", "'");
+    out.replace("&lt;", "<");
+    out.replace("&gt;", ">");
+    return out;
+}
+
+std::vector<PortalForm> FormParser::parse(const String& html, const String& pageUrl) {
+    std::vector<PortalForm> forms;
+
+    PortalForm orphan;
+    orphan.action = pageUrl;
+    orphan.method = "POST";
+    orphan.enctype = "application/x-www-form-urlencoded";
+    orphan.score = 0;
+
+    int current = -1;             // Index into forms, -1 = outside any form
+    int selectField = -1;         // Field index of an open <select>
+    bool selectChosen = false;    // A "selected" option was seen
+
+    const char* start = html.c_str();
+    const char* end = start + html.length();
+    const char* p = start;
+
+    while (p < end) {
+        p = (const char*)memchr(p, '<', end - p);
+        if (!p) break;
+
+        // Comments
+        if (p + 3 < end && p[1] == '!' && p[2] == '-' && p[3] == '-') {
+            const char* close = strstr(p + 4, "-->");
+            p = close ? close + 3 : end;
+            continue;
+        }
+
+        const char* tagEnd = findTagEnd(p, end);
+        const char* name = p + 1;
+        PortalForm& form = current >= 0 ? forms[current] : orphan;
+
+        // Script and style bodies may contain markup-looking strings
+        if (tagIs(name, "script")) {
+            p = skipRawText(tagEnd, end, "script");
+            continue;
+        }
+        if (tagIs(name, "style")) {
+            p = skipRawText(tagEnd, end, "style");
+            continue;
+        }
+
+        if (tagIs(name, "form")) {
+            PortalForm next;
+            String action;
+            readAttr(p, tagEnd, "action", action);
+            next.action = resolveUrl(pageUrl, action);
+
+            if (readAttr(p, tagEnd, "method", next.method)) next.method.toUpperCase();
+            if (next.method != "GET") next.method = "POST";
+
+            if (!readAttr(p, tagEnd, "enctype", next.enctype)) {
+                next.enctype = "application/x-www-form-urlencoded";
+            }
+            next.score = 0;
+
+            forms.push_back(next);
+            current = forms.size() - 1;
+            selectField = -1;
+        } else if (tagIs(name, "/form")) {
+            current = -1;
+            selectField = -1;
+        } else if (tagIs(name, "input") || tagIs(name, "select") ||
+                   tagIs(name, "textarea") || tagIs(name, "button")) {
+            FormField field;
+            readAttr(p, tagEnd, "name", field.name);
+            readAttr(p, tagEnd, "id", field.id);
+            readAttr(p, tagEnd, "placeholder", field.placeholder);
+            readAttr(p, tagEnd, "value", field.value);
+            String ignored;
+            field.required = readAttr(p, tagEnd, "required", ignored);
+
+            char kind = tolower((unsigned char)name[0]);
+            if (kind == 's') {
+                field.type = "select";
+            } else if (kind == 't') {
+                field.type = "textarea";
+            } else if (!readAttr(p, tagEnd, "type", field.type)) {
+                field.type = kind == 'b' ? "submit" : "text";  // Defaults
+            }
+            field.type.toLowerCase();
+
+            bool checked = readAttr(p, tagEnd, "checked", ignored);
+            bool keep = field.name.length() > 0 && field.type != "reset";
+
+            // Radio groups submit one value per name
+            if (keep && field.type == "radio") {
+                for (auto& existing : form.fields) {
+                    if (existing.name == field.name) {
+                        if (checked) existing.value = field.value;
+                        keep = false;
+                        break;
+                    }
+                }
+            }
+
+            if (keep) {
+                field.detectedType = detectFieldType(field);
+                form.fields.push_back(field);
+                if (kind == 's') {
+                    selectField = form.fields.size() - 1;
+                    selectChosen = false;
+                }
+            }
+        } else if (tagIs(name, "option") && selectField >= 0) {
+            // A select submits its selected option, else the first one
+            FormField& select = form.fields[selectField];
+            String ignored;
+            bool selected = readAttr(p, tagEnd, "selected", ignored);
+            if (!selectChosen && (selected || select.value.length() == 0)) {
+                String value;
+                if (!readAttr(p, tagEnd, "value", value)) {
+                    // No value attribute: the option text is submitted
+                    const char* text = tagEnd;
+                    while (text < end && *text != '<') value += *text++;
+                    value.trim();
+                }
+                select.value = value;
+                selectChosen = selected;
+            }
+        } else if (tagIs(name, "/select")) {
+            selectField = -1;
+        }
+
+        p = tagEnd;
+    }
+
+    if (orphan.fields.size() > 0) {
+        forms.push_back(orphan);
+    }
+
+    for (auto& form : forms) {
+        form.score = scoreForm(form);
+    }
+
+    #if DEBUG_SERIAL && DEBUG_PORTAL
+    Serial.printf("[FORM] Parsed %d forms\n", forms.size());
+    for (const auto& form : forms) {
+        Serial.printf("  - %s %s: %d fields, score %d\n", form.method.c_str(),
+            form.action.c_str(), form.fields.size(), form.score);
+    }
+    #endif
+
+    return forms;
+}
+
+int FormParser::scoreForm(const PortalForm& form) {
+    if (form.fields.empty()) return INT_MIN;
+
+    int score = 0;
+    bool credential = false;
+
+    for (const auto& field : form.fields) {
+        switch (field.detectedType) {
+            case FIELD_ROOM_NUMBER: score += 4; credential = true; break;
+            case FIELD_LAST_NAME:   score += 4; credential = true; break;
+            case FIELD_CODE:        score += 3; credential = true; break;
+            case FIELD_EMAIL:       score += 2; credential = true; break;
+            case FIELD_PHONE:       score += 1; credential = true; break;
+            case FIELD_FIRST_NAME:  score += 1; break;
+            case FIELD_CHECKBOX:    score += 1; break;  // Usually "accept terms"
+            default: break;
+        }
+    }
+
+    // Language switchers, search boxes etc. ask for nothing to log in with
+    if (!credential) score -= 5;
+
+    String action = form.action;
+    action.toLowerCase();
+    for (const char* word : loginActionWords) {
+        if (action.indexOf(word) >= 0) {
+            score += 2;
+            break;
+        }
+    }
+    for (const char* word : otherActionWords) {
+        if (action.indexOf(word) >= 0) {
+            score -= 3;
+            break;
+        }
+    }
+
+    return score;
+}
+
+const PortalForm* FormParser::pickLogin(const std::vector<PortalForm>& forms) {
+    const PortalForm* best = nullptr;
+    for (const auto& form : forms) {
+        if (form.fields.empty()) continue;
+        if (!best || form.score > best->score) best = &form;
+    }
+    return best;
+}
+
+FieldType FormParser::detectFieldType(const FormField& field) {
+    // The input type settles it for non-text controls
+    if (field.type == "hidden") return FIELD_UNKNOWN;
+    if (field.type == "checkbox") return FIELD_CHECKBOX;
+    if (field.type == "submit" || field.type == "button" || field.type == "image") {
+        return FIELD_BUTTON;
+    }
+    if (field.type == "email") return FIELD_EMAIL;
+    if (field.type == "tel") return FIELD_PHONE;
+    if (field.type == "password") return FIELD_CODE;
+
+    // Keywords only classify free-text inputs: enumeration fills room and
+    // name slots with arbitrary text, which a select, radio group or
+    // textarea ("room_type", "guest_name_title") doesn't take. Those keep
+    // their fixed value. A number input can only be a room number.
+    bool number = field.type == "number";
+    if (field.type != "text" && field.type != "search" && field.type.length() > 0 && !number) {
+        return FIELD_UNKNOWN;
+    }
+
+    String combined = field.name + " " + field.id + " " + field.placeholder;
+    combined.toLowerCase();
+
+    // Check for room number
+    for (const char* kw : roomKeywords) {
+        if (combined.indexOf(kw) >= 0) {
+            return FIELD_ROOM_NUMBER;
+        }
+    }
+    if (number) return FIELD_UNKNOWN;
+
+    // Check for last name
+    for (const char* kw : lastNameKeywords) {
+        if (combined.indexOf(kw) >= 0) {
+            return FIELD_LAST_NAME;
+        }
+    }
+
+    // Check for first name
+    for (const char* kw : firstNameKeywords) {
+        if (combined.indexOf(kw) >= 0) {
+            return FIELD_FIRST_NAME;
+        }
+    }
+
+    // Check for email
+    for (const char* kw : emailKeywords) {
+        if (combined.indexOf(kw) >= 0) {
+            return FIELD_EMAIL;
+        }
+    }
+
+    // Check for phone
+    for (const char* kw : phoneKeywords) {
+        if (combined.indexOf(kw) >= 0) {
+            return FIELD_PHONE;
+        }
+    }
+
+    // Check for code/password
+    for (const char* kw : codeKeywords) {
+        if (combined.indexOf(kw) >= 0) {
+            return FIELD_CODE;
+        }
+    }
+
+    return FIELD_UNKNOWN;
+}
+
+String FormParser::resolveUrl(const String& base, const String& ref) {
+    String target = ref;
+    target.trim();
+
+    int hash = target.indexOf('#');
+    if (hash >= 0) target = target.substring(0, hash);
+
+    String page = base;
+    hash = page.indexOf('#');
+    if (hash >= 0) page = page.substring(0, hash);
+
+    if (target.length() == 0) return page;
+
+    String lower = target;
+    lower.toLowerCase();
+    if (lower.startsWith("http://") || lower.startsWith("https://")) return target;
+
+    // Scheme and authority of the page
+    int schemeEnd = page.indexOf("://");
+    int pathStart = schemeEnd >= 0 ? page.indexOf('/', schemeEnd + 3) : -1;
+    String origin = pathStart >= 0 ? page.substring(0, pathStart) : page;
+
+    if (target.startsWith("//")) {
+        return (schemeEnd >= 0 ? page.substring(0, schemeEnd + 1) : String("http:")) + target;
+    }
+
+    if (target.startsWith("/")) return origin + target;
+
+    int query = page.indexOf('?');
+    String pagePath = query >= 0 ? page.substring(0, query) : page;
+
+    if (target.startsWith("?")) return pagePath + target;
+
+    // Relative path: replace the last segment, then fold ./ and ../
+    String dir = "/";
+    if (pathStart >= 0) {
+        String path = pagePath.substring(pathStart);
+        dir = path.substring(0, path.lastIndexOf('/') + 1);
+    }
+
+    String path = dir + target;
+    while (path.indexOf("/./") >= 0) path.replace("/./", "/");
+    int up;
+    while ((up = path.indexOf("/../")) >= 0) {
+        int parent = up > 0 ? path.lastIndexOf('/', (unsigned)(up - 1)) : -1;
+        path = (parent >= 0 ? path.substring(0, parent) : String("")) + path.substring(up + 3);
+    }
+
+    return origin + path;
+}
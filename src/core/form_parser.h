@@ -0,0 +1,63 @@
+#ifndef FORM_PARSER_H
+#define FORM_PARSER_H
+
+#include <Arduino.h>
+#include <vector>
+
+// Form field types detected in portal
+enum FieldType {
+    FIELD_UNKNOWN,
+    FIELD_ROOM_NUMBER,
+    FIELD_LAST_NAME,
+    FIELD_FIRST_NAME,
+    FIELD_EMAIL,
+    FIELD_PHONE,
+    FIELD_CODE,
+    FIELD_CHECKBOX,
+    FIELD_BUTTON
+};
+
+// Detected form field
+struct FormField {
+    String name;
+    String id;
+    String type;             // Input type, or "select" / "textarea"
+    String placeholder;
+    String value;            // Default value (hidden tokens, selected option)
+    FieldType detectedType;
+    bool required;
+};
+
+// One <form> on a portal page
+struct PortalForm {
+    String action;           // Absolute URL (the page itself if none)
+    String method;           // "GET" or "POST"
+    String enctype;
+    std::vector<FormField> fields;
+    int score;               // Login likelihood, higher is better
+};
+
+// Single-pass portal page parser. Walks the HTML once, tracking form
+// boundaries, and builds every form with its own fields; inputs outside
+// any <form> go into an extra implicit form that posts to the page URL.
+class FormParser {
+public:
+    static std::vector<PortalForm> parse(const String& html, const String& pageUrl);
+
+    // Highest-scoring form, or nullptr if none has usable fields
+    static const PortalForm* pickLogin(const std::vector<PortalForm>& forms);
+
+    static FieldType detectFieldType(const FormField& field);
+
+    // Resolve an action/href against the page URL (absolute, //host,
+    // /path, relative path, ?query, empty)
+    static String resolveUrl(const String& base, const String& ref);
+
+private:
+    static int scoreForm(const PortalForm& form);
+    static bool readAttr(const char* tag, const char* tagEnd, const char* name, String& out);
+    static bool tagIs(const char* p, const char* name);
+    static String decodeEntities(const String& text);
+};
+
+#endif // FORM_PARSER_H
@@ -0,0 +1,148 @@
+#include "form_template.h"
+#include <string.h>
+
+FormTemplate::FormTemplate() : staticLen(0), slotCount(0), prefixReady(false) {
+    statics[0] = '\0';
+    out[0] = '\0';
+}
+
+void FormTemplate::clear() {
+    staticLen = 0;
+    slotCount = 0;
+    prefixReady = false;
+}
+
+size_t FormTemplate::encode(const char* in, char* outBuf, size_t outLen) {
+    static const char hex[] = "0123456789ABCDEF";
+
+    size_t pos = 0;
+    for (const char* c = in; *c; c++) {
+        unsigned char ch = (unsigned char)*c;
+
+        bool unreserved = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') ||
+                          (ch >= '0' && ch <= '9') ||
+                          ch == '-' || ch == '_' || ch == '.' || ch == '*';
+
+        if (unreserved || ch == ' ') {
+            if (pos + 1 >= outLen) return 0;
+            outBuf[pos++] = ch == ' ' ? '+' : (char)ch;
+        } else {
+            if (pos + 3 >= outLen) return 0;
+            outBuf[pos++] = '%';
+            outBuf[pos++] = hex[ch >> 4];
+            outBuf[pos++] = hex[ch & 0x0F];
+        }
+    }
+
+    if (pos < outLen) outBuf[pos] = '\0';
+    return pos;
+}
+
+bool FormTemplate::appendRaw(const char* data, size_t len) {
+    if (staticLen + len >= sizeof(statics)) return false;
+    memcpy(statics + staticLen, data, len);
+    staticLen += len;
+    statics[staticLen] = '\0';
+    return true;
+}
+
+bool FormTemplate::appendSeparator() {
+    return staticLen == 0 || appendRaw("&", 1);
+}
+
+bool FormTemplate::addStatic(const char* name, const char* value) {
+    uint16_t mark = staticLen;
+
+    bool ok = appendSeparator();
+    if (ok) {
+        size_t n = encode(name, statics + staticLen, sizeof(statics) - staticLen);
+        ok = n > 0 || !name[0];
+        staticLen += n;
+    }
+    ok = ok && appendRaw("=", 1);
+    if (ok) {
+        size_t n = encode(value, statics + staticLen, sizeof(statics) - staticLen);
+        ok = n > 0 || !value[0];
+        staticLen += n;
+    }
+
+    if (!ok) {
+        // Roll back the partial field
+        staticLen = mark;
+        statics[staticLen] = '\0';
+        return false;
+    }
+
+    prefixReady = false;
+    return true;
+}
+
+bool FormTemplate::addSlot(const char* name, FormSlotSource source) {
+    if (slotCount >= FORM_TEMPLATE_MAX_SLOTS) return false;
+
+    uint16_t mark = staticLen;
+    if (!appendSeparator()) return false;
+
+    size_t n = encode(name, statics + staticLen, sizeof(statics) - staticLen);
+    if ((n == 0 && name[0]) || staticLen + n + 1 >= sizeof(statics)) {
+        staticLen = mark;
+        statics[staticLen] = '\0';
+        return false;
+    }
+    staticLen += n;
+    appendRaw("=", 1);
+
+    slots[slotCount].offset = staticLen;
+    slots[slotCount].source = source;
+    slotCount++;
+
+    prefixReady = false;
+    return true;
+}
+
+const char* FormTemplate::fill(const char* room, const char* name, size_t* len) {
+    uint16_t first = slotCount > 0 ? slots[0].offset : staticLen;
+
+    // Everything before the first slot never changes between attempts
+    if (!prefixReady) {
+        memcpy(out, statics, first);
+        prefixReady = true;
+    }
+
+    size_t pos = first;
+    uint16_t staticPos = first;
+
+    for (uint8_t i = 0; i < slotCount; i++) {
+        const Slot& slot = slots[i];
+
+        // Static bytes between the previous slot and this one
+        size_t gap = slot.offset - staticPos;
+        if (pos + gap >= sizeof(out)) return nullptr;
+        memcpy(out + pos, statics + staticPos, gap);
+        pos += gap;
+        staticPos = slot.offset;
+
+        const char* value = slot.source == SLOT_ROOM ? room : name;
+        size_t n = encode(value, out + pos, sizeof(out) - pos);
+        if (n == 0 && value[0]) return nullptr;
+        pos += n;
+    }
+
+    // Static tail after the last slot
+    size_t tail = staticLen - staticPos;
+    if (pos + tail >= sizeof(out)) return nullptr;
+    memcpy(out + pos, statics + staticPos, tail);
+    pos += tail;
+    out[pos] = '\0';
+
+    if (len) *len = pos;
+    return out;
+}
+
+uint8_t FormTemplate::getSlotCount() const {
+    return slotCount;
+}
+
+size_t FormTemplate::getStaticLength() const {
+    return staticLen;
+}
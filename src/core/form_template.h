@@ -0,0 +1,66 @@
+#ifndef FORM_TEMPLATE_H
+#define FORM_TEMPLATE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Longest urlencoded body a template can produce
+#define FORM_TEMPLATE_MAX 1024
+
+// Maximum number of per-attempt fields in one form
+#define FORM_TEMPLATE_MAX_SLOTS 4
+
+// Where a variable field gets its value from on each attempt
+enum FormSlotSource : uint8_t {
+    SLOT_ROOM,
+    SLOT_NAME
+};
+
+// A form submission compiled once per job: one static byte segment with
+// fixed fields already urlencoded, plus slot offsets for the fields that
+// change per attempt. fill() writes the slots (and the static bytes that
+// follow them) into the template's own buffer, with no heap allocation.
+class FormTemplate {
+public:
+    FormTemplate();
+
+    void clear();
+
+    // Append "name=value" with a fixed value
+    bool addStatic(const char* name, const char* value);
+
+    // Append "name=" whose value is supplied per attempt
+    bool addSlot(const char* name, FormSlotSource source);
+
+    // Render the body for one attempt. Returns a pointer to the reused
+    // internal buffer (valid until the next fill) or nullptr if the
+    // encoded values don't fit. *len receives the body length.
+    const char* fill(const char* room, const char* name, size_t* len);
+
+    uint8_t getSlotCount() const;
+    size_t getStaticLength() const;
+
+    // application/x-www-form-urlencoded escaping; returns bytes written
+    // or 0 if the result (plus terminator) doesn't fit
+    static size_t encode(const char* in, char* out, size_t outLen);
+
+private:
+    struct Slot {
+        uint16_t offset;          // Position in the static segment
+        FormSlotSource source;
+    };
+
+    char statics[FORM_TEMPLATE_MAX];
+    uint16_t staticLen;
+    Slot slots[FORM_TEMPLATE_MAX_SLOTS];
+    uint8_t slotCount;
+
+    // Output buffer; the prefix before the first slot is written once
+    char out[FORM_TEMPLATE_MAX];
+    bool prefixReady;
+
+    bool appendRaw(const char* data, size_t len);
+    bool appendSeparator();
+};
+
+#endif // FORM_TEMPLATE_H
@@ -0,0 +1,128 @@
+#include "pacer.h"
+
+#define NO_BASELINE 0xFFFFFFFFu
+
+Pacer::Pacer() {
+    PacerConfig defaults = {2.0f, 0.2f, 2.0f};
+    configure(defaults);
+    reset(0);
+}
+
+void Pacer::configure(const PacerConfig& cfg) {
+    config = cfg;
+    if (config.maxRate <= 0.0f) config.maxRate = 1.0f;
+    if (config.minRate <= 0.0f || config.minRate > config.maxRate) {
+        config.minRate = config.maxRate;
+    }
+    if (config.startRate > config.maxRate) config.startRate = config.maxRate;
+    if (config.startRate < config.minRate) config.startRate = config.minRate;
+}
+
+void Pacer::reset(uint32_t nowMs) {
+    rate = config.startRate;
+    lastStart = nowMs;
+    holdUntil = nowMs;
+    started = false;
+    holding = false;
+    baseline = NO_BASELINE;
+    smoothed = 0;
+    attemptsSinceSlowdown = PACER_LATENCY_HOLD;
+    backoffs = 0;
+}
+
+uint32_t Pacer::getInterval() const {
+    // Round up so the ceiling is never exceeded by truncation
+    return (uint32_t)(1000.0f / rate + 0.999f);
+}
+
+uint32_t Pacer::delayBefore(uint32_t nowMs) const {
+    uint32_t wait = 0;
+
+    if (started) {
+        uint32_t elapsed = nowMs - lastStart;
+        uint32_t interval = getInterval();
+        if (elapsed < interval) wait = interval - elapsed;
+    }
+
+    if (holding) {
+        int32_t remaining = (int32_t)(holdUntil - nowMs);
+        if (remaining > 0 && (uint32_t)remaining > wait) wait = remaining;
+    }
+
+    return wait;
+}
+
+void Pacer::onAttemptStart(uint32_t nowMs) {
+    lastStart = nowMs;
+    started = true;
+    if (holding && (int32_t)(holdUntil - nowMs) <= 0) holding = false;
+}
+
+void Pacer::onResponse(uint32_t nowMs, int httpCode, uint32_t retryAfterMs) {
+    uint32_t latency = nowMs - lastStart;
+
+    // Explicit "slow down": back off and respect the server's hold time
+    if (httpCode == 429 || httpCode == 503) {
+        uint32_t hold = retryAfterMs > 0 ? retryAfterMs : PACER_DEFAULT_HOLD;
+        if (hold > PACER_MAX_HOLD) hold = PACER_MAX_HOLD;
+        holdUntil = nowMs + hold;
+        holding = true;
+        slowDown();
+        return;
+    }
+
+    // Server errors and failed requests
+    if (httpCode <= 0 || httpCode >= 500) {
+        slowDown();
+        return;
+    }
+
+    // Track the lowest latency seen, drifting slowly towards the current
+    // one so a portal that is simply slower settles on a new baseline.
+    // Single samples are too noisy to act on; compare the 1/8 EWMA.
+    bool slow = false;
+    if (baseline == NO_BASELINE) {
+        baseline = latency;
+        smoothed = latency;
+    } else {
+        smoothed = latency > smoothed ? smoothed + (latency - smoothed) / 8
+                                      : smoothed - (smoothed - latency) / 8;
+        if (latency < baseline) {
+            baseline = latency;
+        } else {
+            baseline += (latency - baseline) / 16;
+        }
+        slow = smoothed > baseline * PACER_LATENCY_FACTOR &&
+               smoothed > baseline + PACER_LATENCY_SLACK;
+    }
+
+    attemptsSinceSlowdown++;
+    if (slow) {
+        if (attemptsSinceSlowdown > PACER_LATENCY_HOLD) slowDown();
+        return;
+    }
+
+    // Additive increase, scaled so the rate grows by PACER_INCREASE per
+    // second of healthy responses regardless of the current rate
+    rate += PACER_INCREASE / rate;
+    if (rate > config.maxRate) rate = config.maxRate;
+}
+
+void Pacer::slowDown() {
+    rate *= PACER_DECREASE;
+    if (rate < config.minRate) rate = config.minRate;
+    attemptsSinceSlowdown = 0;
+    backoffs++;
+}
+
+float Pacer::getRate() const {
+    return rate;
+}
+
+uint32_t Pacer::getBaselineLatency() const {
+    return baseline == NO_BASELINE ? 0 : baseline;
+}
+
+uint32_t Pacer::getBackoffs() const {
+    return backoffs;
+}
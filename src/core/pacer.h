@@ -0,0 +1,75 @@
+#ifndef PACER_H
+#define PACER_H
+
+#include <stdint.h>
+
+// Additive increase per second of healthy responses (attempts/sec)
+#define PACER_INCREASE 0.5f
+
+// Rate multiplier applied on a congestion signal
+#define PACER_DECREASE 0.5f
+
+// Latency counts as risen when the smoothed latency reaches this many times
+// the baseline (and at least PACER_LATENCY_SLACK ms more), so jitter on a
+// fast local portal doesn't count as congestion
+#define PACER_LATENCY_FACTOR 2.0f
+#define PACER_LATENCY_SLACK 50
+
+// Attempts between two latency-triggered slowdowns (errors always count)
+#define PACER_LATENCY_HOLD 3
+
+// Longest Retry-After we honour, and the hold used when a 429/503 has none
+#define PACER_MAX_HOLD 60000
+#define PACER_DEFAULT_HOLD 5000
+
+struct PacerConfig {
+    float maxRate;      // Ceiling, attempts/sec (never exceeded)
+    float minRate;      // Floor when backing off
+    float startRate;    // Rate for the first attempts
+};
+
+// AIMD pacing for enumeration attempts. The rate grows linearly while the
+// portal answers normally and is cut multiplicatively on 429/5xx, transport
+// errors or a latency rise, always staying within [minRate, maxRate].
+//
+// The pacer never sleeps or reads a clock itself: callers pass the current
+// time in ms (millis() on the device, a simulated clock on the host) and
+// wait for whatever delayBefore() returns. Spacing is measured start to
+// start, so slow responses don't push the request rate over the ceiling.
+class Pacer {
+public:
+    Pacer();
+
+    void configure(const PacerConfig& config);
+    void reset(uint32_t nowMs);
+
+    // Milliseconds to wait before the next attempt may start
+    uint32_t delayBefore(uint32_t nowMs) const;
+
+    void onAttemptStart(uint32_t nowMs);
+
+    // httpCode <= 0 means the request failed (timeout, connection refused).
+    // retryAfterMs is the server's Retry-After, or 0 if it sent none.
+    void onResponse(uint32_t nowMs, int httpCode, uint32_t retryAfterMs = 0);
+
+    float getRate() const;
+    uint32_t getInterval() const;          // Current start-to-start spacing
+    uint32_t getBaselineLatency() const;
+    uint32_t getBackoffs() const;          // Slowdowns since reset()
+
+private:
+    PacerConfig config;
+    float rate;
+    uint32_t lastStart;
+    uint32_t holdUntil;         // No attempts before this (Retry-After)
+    bool started;
+    bool holding;
+    uint32_t baseline;          // Lowest recent latency, ms
+    uint32_t smoothed;          // EWMA of latency, ms
+    uint32_t attemptsSinceSlowdown;
+    uint32_t backoffs;
+
+    void slowDown();
+};
+
+#endif // PACER_H
@@ -0,0 +1,172 @@
+#include "portal_classifier.h"
+#include "portal_classifier_model.h"
+#include "config.h"
+#include <string.h>
+#include <math.h>
+
+#define FNV_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+static inline uint8_t lower(uint8_t c) {
+    return c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c;
+}
+
+static inline bool isWordChar(uint8_t c) {
+    return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9');
+}
+
+// Case-insensitive match of lowercase `word` at text[pos]
+static bool matchAt(const char* text, size_t len, size_t pos, const char* word) {
+    for (size_t i = 0; word[i]; i++) {
+        if (pos + i >= len || lower(text[pos + i]) != (uint8_t)word[i]) return false;
+    }
+    return true;
+}
+
+// Position after the next "</tag" from `pos`, or len
+static size_t skipBlock(const char* text, size_t len, size_t pos, const char* tag) {
+    size_t tagLen = strlen(tag);
+    for (; pos + 2 + tagLen <= len; pos++) {
+        if (text[pos] == '<' && text[pos + 1] == '/' && matchAt(text, len, pos + 2, tag)) {
+            return pos + 2 + tagLen;
+        }
+    }
+    return len;
+}
+
+static void addWord(const char* text, size_t start, size_t end, bool inInput, uint32_t* bits) {
+    if (end - start < 2 || end - start > CLASSIFIER_MAX_WORD) return;
+    uint32_t hash = FNV_BASIS;
+    if (inInput) hash = (hash ^ '@') * FNV_PRIME;
+    for (size_t i = start; i < end; i++) {
+        hash = (hash ^ lower(text[i])) * FNV_PRIME;
+    }
+    uint32_t bucket = hash & (CLASSIFIER_FEATURES - 1);
+    bits[bucket >> 5] |= 1u << (bucket & 31);
+}
+
+// Mirrors features() in tools/train_classifier.py
+int PortalClassifier::extract(const char* text, size_t len, uint32_t* bits) {
+    memset(bits, 0, CLASSIFIER_FEATURES / 8);
+
+    size_t pos = 0;
+    size_t start = 0;
+    bool inWord = false;
+    bool inInput = false;
+    while (pos < len) {
+        uint8_t c = lower(text[pos]);
+        if (isWordChar(c)) {
+            if (!inWord) {
+                start = pos;
+                inWord = true;
+            }
+            pos++;
+            continue;
+        }
+        if (inWord) {
+            addWord(text, start, pos, inInput, bits);
+            inWord = false;
+        }
+        if (c == '>') {
+            inInput = false;
+        } else if (c == '<') {
+            if (matchAt(text, len, pos + 1, "script")) {
+                pos = skipBlock(text, len, pos + 7, "script");
+                continue;
+            }
+            if (matchAt(text, len, pos + 1, "style")) {
+                pos = skipBlock(text, len, pos + 6, "style");
+                continue;
+            }
+            inInput = matchAt(text, len, pos + 1, "input");
+        }
+        pos++;
+    }
+    if (inWord) addWord(text, start, len, inInput, bits);
+
+    int count = 0;
+    for (int i = 0; i < CLASSIFIER_FEATURES / 32; i++) {
+        count += __builtin_popcount(bits[i]);
+    }
+    return count;
+}
+
+void PortalClassifier::score(const uint32_t* bits, const int8_t* weights, float scale,
+                             const float* bias, int classes, int* best, float* confidence) {
+    int32_t sums[CLASSIFIER_VENUES > CLASSIFIER_AUTHS ? CLASSIFIER_VENUES : CLASSIFIER_AUTHS] = {};
+    for (int word = 0; word < CLASSIFIER_FEATURES / 32; word++) {
+        uint32_t set = bits[word];
+        while (set) {
+            int bucket = word * 32 + __builtin_ctz(set);
+            set &= set - 1;
+            const int8_t* row = weights + bucket * classes;
+            for (int c = 0; c < classes; c++) sums[c] += row[c];
+        }
+    }
+
+    float logits[CLASSIFIER_VENUES > CLASSIFIER_AUTHS ? CLASSIFIER_VENUES : CLASSIFIER_AUTHS];
+    int top = 0;
+    for (int c = 0; c < classes; c++) {
+        logits[c] = bias[c] + sums[c] * scale;
+        if (logits[c] > logits[top]) top = c;
+    }
+    float total = 0;
+    for (int c = 0; c < classes; c++) total += expf(logits[c] - logits[top]);
+    *best = top;
+    *confidence = 1.0f / total;
+}
+
+void PortalClassifier::classify(const char* html, size_t len, ClassifierResult& out) {
+    uint32_t bits[CLASSIFIER_FEATURES / 32];
+    out.features = extract(html, len, bits);
+    score(bits, classifierVenueWeights, classifierVenueScale, classifierVenueBias,
+          CLASSIFIER_VENUES, &out.venue, &out.venueConfidence);
+    score(bits, classifierAuthWeights, classifierAuthScale, classifierAuthBias,
+          CLASSIFIER_AUTHS, &out.auth, &out.authConfidence);
+}
+
+bool PortalClassifier::isConfident(const ClassifierResult& result) {
+    return result.confidence() >= CLASSIFIER_MIN_CONFIDENCE;
+}
+
+int PortalClassifier::getVenueCount() {
+    return CLASSIFIER_VENUES;
+}
+
+int PortalClassifier::getAuthCount() {
+    return CLASSIFIER_AUTHS;
+}
+
+const char* PortalClassifier::getVenueLabel(int venue) {
+    return venue >= 0 && venue < CLASSIFIER_VENUES ? classifierVenueLabels[venue] : "Unknown";
+}
+
+const char* PortalClassifier::getAuthLabel(int auth) {
+    return auth >= 0 && auth < CLASSIFIER_AUTHS ? classifierAuthLabels[auth] : "Unknown";
+}
+
+int PortalClassifier::getUnknownVenue() {
+    for (int v = 0; v < CLASSIFIER_VENUES; v++) {
+        if (strcmp(classifierVenueLabels[v], "Unknown") == 0) return v;
+    }
+    return -1;
+}
+
+size_t PortalClassifier::getWeightBytes() {
+    return sizeof(classifierVenueWeights) + sizeof(classifierAuthWeights) +
+           sizeof(classifierVenueBias) + sizeof(classifierAuthBias);
+}
+
+uint32_t PortalClassifier::getModelHash() {
+    return CLASSIFIER_MODEL_HASH;
+}
+
+bool PortalClassifier::checkFeatures() {
+    uint32_t bits[CLASSIFIER_FEATURES / 32];
+    int count = extract(CLASSIFIER_CHECK_TEXT, strlen(CLASSIFIER_CHECK_TEXT), bits);
+    uint32_t sum = 0;
+    for (int bucket = 0; bucket < CLASSIFIER_FEATURES; bucket++) {
+        if ((bits[bucket >> 5] >> (bucket & 31)) & 1) sum += bucket;
+    }
+    return count == CLASSIFIER_CHECK_COUNT && sum == CLASSIFIER_CHECK_SUM;
+}
@@ -0,0 +1,54 @@
+#ifndef PORTAL_CLASSIFIER_H
+#define PORTAL_CLASSIFIER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// One page's predictions. Labels index getVenueLabel()/getAuthLabel().
+struct ClassifierResult {
+    int venue;
+    float venueConfidence;          // Softmax probability of the label
+    int auth;
+    float authConfidence;
+    int features;                   // Distinct feature buckets in the page
+
+    float confidence() const { return venueConfidence < authConfidence ? venueConfidence : authConfidence; }
+};
+
+// Venue type and login type of a portal page from a small trained model,
+// for answering without the LLM when it is sure.
+//
+// Features are the words of the page (lowercase [a-z0-9] runs of 2 to
+// CLASSIFIER_MAX_WORD characters, outside <script> and <style>), hashed
+// with FNV-1a into CLASSIFIER_FEATURES buckets and counted once; words
+// inside an <input> tag hash apart from body text. Each head is softmax
+// regression with int8 weights and one float scale, trained and exported
+// by tools/train_classifier.py (core/portal_classifier_model.h, a few KB
+// of flash). A page costs one pass plus an add per bucket and class, and
+// classify() does not allocate.
+class PortalClassifier {
+public:
+    static void classify(const char* html, size_t len, ClassifierResult& out);
+    static bool isConfident(const ClassifierResult& result);   // CLASSIFIER_MIN_CONFIDENCE
+
+    static int getVenueCount();
+    static int getAuthCount();
+    static const char* getVenueLabel(int venue);
+    static const char* getAuthLabel(int auth);
+    static int getUnknownVenue();   // Index of "Unknown"
+    static size_t getWeightBytes();
+    static uint32_t getModelHash();     // Changes with retraining, for cache keys
+
+    // Buckets present in `text` (CLASSIFIER_FEATURES bits), their count
+    // as the return value; lets the host bench compare with the trainer
+    static int extract(const char* text, size_t len, uint32_t* bits);
+
+    // Whether extract() agrees with the trainer's on its check text
+    static bool checkFeatures();
+
+private:
+    static void score(const uint32_t* bits, const int8_t* weights, float scale,
+                      const float* bias, int classes, int* best, float* confidence);
+};
+
+#endif // PORTAL_CLASSIFIER_H
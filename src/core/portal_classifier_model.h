@@ -0,0 +1,339 @@
+// Generated by tools/train_classifier.py - do not edit.
+// 1536 training pages (seed 7), validation venue 99.2%, auth 100.0%; test_portal.py 4/5
+#ifndef PORTAL_CLASSIFIER_MODEL_H
+#define PORTAL_CLASSIFIER_MODEL_H
+
+#include <stdint.h>
+
+#define CLASSIFIER_FEATURES 512
+#define CLASSIFIER_MAX_WORD 24
+#define CLASSIFIER_VENUES 8
+#define CLASSIFIER_AUTHS 6
+#define CLASSIFIER_MODEL_HASH 0xa55befb2u   // Of the tables below, for cache keys
+
+// Buckets the trainer extracts from this text (bench-classifier checks
+// that PortalClassifier agrees)
+#define CLASSIFIER_CHECK_TEXT "<title>Grand Hotel</title><style>.room{color:red}</style><script>var email=1;</script><input name=\"room_number\" type=\"text\">"
+#define CLASSIFIER_CHECK_COUNT 9
+#define CLASSIFIER_CHECK_SUM 1937
+
+static const char* const classifierVenueLabels[] = {
+    "Hotel/Resort", "Airport", "Healthcare Facility", "Cafe/Restaurant", "Conference Center", "Educational Institution", "Library", "Unknown",
+};
+static const float classifierVenueScale = 0.0195752597f;
+static const float classifierVenueBias[] = {
+    0.204477f, -0.0398434f, -0.0349448f, -0.282836f, -0.147711f, -0.114637f, 0.145397f, 0.270098f,
+};
+static const int8_t classifierVenueWeights[CLASSIFIER_FEATURES * 8] = {
+    0, 0, 0, -1, 0, 0, -3, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    -6, 61, -3, -7, -1, -27, -7, -9, 0, 0, 0, 0, -3, 0, 0, 4, 0, -1, -3, 0, -16, 17, 0, 3,
+    0, 0, 10, -10, 0, 0, 5, -4, -1, -4, 6, 8, -2, -16, 10, -2, -5, -19, -11, -10, 97, -16, -13, -23,
+    -19, -9, -18, -15, 108, -10, -11, -26, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0, 11, 7, -2, 1, -1, -10, 17, -24, -7, 0, -7, 45, -6, -13, -8, -4,
+    0, 0, 0, 0, 0, 0, 0, 0, 66, -10, -9, 3, -18, -3, -2, -26, -22, -6, -18, -12, -5, -2, 105, -40,
+    -14, -8, -3, 48, -10, -2, -1, -10, -6, -11, -4, -18, -2, -22, -42, 105, -10, 1, 73, -7, -3, -12, -23, -19,
+    -16, -3, -3, 49, -1, -9, -3, -15, -23, -18, 35, -12, -14, 79, -21, -27, -17, -13, -8, -8, -14, -5, 68, -2,
+    0, 0, 0, 0, 0, 0, -1, 2, 0, -1, -4, -2, 0, 1, 3, 2, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 2, 0, 0, -2, -2, -1, -1, -1, 1, 0, 1, 3, 7, -1, 0, -2, 5, -2, 10, -17,
+    -2, 0, 8, 1, 0, -7, -1, 0, 0, -1, 0, 0, 0, 0, 1, 1, 94, -22, -18, 50, -17, -20, -25, -43,
+    3, -3, 1, 0, 0, 1, -5, 3, 0, 0, 0, 0, 0, 0, 0, 0, -22, -12, -19, -10, -7, 104, -9, -26,
+    1, -2, 1, -2, -4, -3, 1, 8, 0, -1, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+    63, -6, -21, 6, -9, -20, -13, -2, 3, 1, 1, 0, -3, -8, -2, 9, -2, -2, 0, -1, -1, 0, 4, 2,
+    0, 0, 2, 0, 0, 0, -1, 0, -16, -13, -8, -8, -14, -5, 67, -2, 1, 1, -1, 0, -1, 1, -1, -1,
+    11, -9, 0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 11, -10, 0, 0, -7, 0, 0, 0, 0, 0, 8, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, -8, -5, 5, 1, -2, 7, -5, 7, 0, 10, -10, 0, 0, 0, 0, 0,
+    -8, -10, -7, -16, 83, -17, -19, -5, 2, 4, -1, -11, 3, 0, 0, 3, 3, -3, 1, 0, 0, 1, -5, 3,
+    -23, -8, -2, 77, -15, -14, -3, -11, -20, -2, 5, 7, 10, 2, -13, 11, 5, 4, 6, -3, -5, -4, -11, 7,
+    0, 0, 0, 6, 0, 0, -6, 0, 0, -8, -7, -13, -14, 83, -26, -16, -11, 47, -9, -4, -2, -3, -10, -8,
+    0, 0, 0, 0, 0, 0, 0, 0, 72, -19, -2, -12, -2, -2, -22, -14, 18, -2, 0, 5, 2, -6, -7, -10,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -9, 0, 0, -1, 0, 10, -5, -2, 6, 2, 7, 0, -7, 0,
+    -30, -3, 38, -14, -18, 70, -29, -14, 0, 0, 0, 0, 0, 0, 0, 0, -8, -3, 8, -4, 5, -1, 4, -2,
+    0, -3, -3, 0, 0, -3, -1, 11, 0, 0, -1, 0, 1, 0, 0, 0, 0, -1, 0, 0, 0, 0, 1, 1,
+    1, -1, -1, 1, 0, -2, -2, 4, -2, 1, 0, 3, -2, 0, -4, 4, -10, 7, -3, -2, -3, 0, 0, 11,
+    0, 0, 0, 0, 0, 0, 0, 0, -5, -3, 5, 0, 5, -1, 16, -17, -7, -6, 7, 10, 2, 8, 3, -18,
+    -20, -7, -4, -11, -12, 89, -18, -17, 0, 2, 1, -2, 6, -2, 2, -6, 0, 0, -2, 0, 0, 3, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 5, 0, 0, -5, 0, 0, 0, 32, 0, -1, -3, -4, 0, 0, -24,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -2, 2, 1, 0, 0, 0, 0, 10, 0, -11,
+    0, 3, 3, -5, -11, -4, 2, 12, 16, 4, -3, -1, -3, -8, 6, -11, 1, -2, -4, 3, 6, 0, -5, 2,
+    -2, -3, 0, 2, -3, -8, 0, 15, 5, 0, -1, -3, -1, 0, 0, 0, 0, -8, 9, 0, 18, -9, -10, 0,
+    0, 0, 0, 0, -1, 8, 0, -7, 6, -6, -10, -5, 2, 9, -4, 7, 45, -6, -8, 9, -17, -18, -11, 5,
+    -13, -11, 2, -1, -23, -30, -28, 104, 17, -7, 18, -5, 4, -7, -5, -16, -10, -1, -1, 14, 0, 0, -1, -1,
+    0, -1, 0, 0, 0, 0, 0, 2, 0, 1, -1, 1, 0, 0, -2, 2, 74, -9, -8, 1, -18, -8, -9, -24,
+    0, 0, 0, 0, 0, 0, 0, 0, -6, -5, 0, 28, -10, 9, -13, -4, -1, -1, 0, 0, 0, 0, 2, 2,
+    -7, -8, -10, 4, 3, 7, 30, -20, 0, 0, 0, 0, 0, 0, 0, 0, -10, 0, 0, 0, 0, 0, 10, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 8, -6, 8, -3, 2, -8, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, -1, 1, -2, 0, -1, 3, 0, 0, 0, 8, 0, 0, 0, -8, 0, -1, 0, 0, 0, 0, 1, 1,
+    3, 6, -4, -1, 5, -1, 8, -16, 4, -1, -8, 3, -2, 0, 4, -1, 0, 2, 0, 0, -10, 0, -9, 17,
+    -11, 0, -7, 46, -6, -10, -8, -4, -22, -4, 10, 10, 3, 3, -6, 5, -5, 5, 5, 6, 1, -8, 1, -4,
+    -6, -3, -12, -12, 73, -9, -7, -23, 0, 0, 0, 0, 0, 0, 0, 0, -13, -3, -5, 30, -3, -2, -1, -3,
+    0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 16, -16, 0, -1, 0, 0, 0, 0, 1, 1,
+    11, -9, 0, 0, 0, 0, 0, -1, 1, 0, -4, 0, 1, 1, 1, 0, 11, -4, -9, -6, -3, 21, 0, -9,
+    -3, -1, -2, -1, 0, 10, 1, -4, 0, 0, 0, 0, 0, 0, 0, 0, 6, -8, 11, -1, 3, -2, 2, -11,
+    -10, -5, 57, -5, 30, -28, -17, -22, 0, 6, 0, -6, -3, -4, 9, -2, -3, 7, -1, -11, 4, 2, 11, -9,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 5, 9, 8, -3, -5, -5, -11, 3,
+    -4, -5, 2, -1, -2, -5, 2, 13, -2, 0, 0, 4, 0, 0, 0, -1, -10, 5, 15, -1, -6, -2, 4, -4,
+    6, -1, -2, -2, -1, -4, 6, -1, 0, 0, 0, 0, -1, 0, 0, 1, 5, -9, -8, -4, 16, -8, 13, -4,
+    0, 0, 0, 0, 0, 0, 0, 0, 1, -1, -5, -3, -9, 34, -5, -13, 0, 0, 0, 0, 0, -7, 3, 4,
+    0, 0, -9, 0, 0, 9, 0, 0, -1, -1, 1, 2, -1, -1, 0, 0, 0, 0, 0, 9, 0, 0, -9, 0,
+    5, -3, -5, -11, 38, 3, -13, -15, 0, -10, 2, 0, 0, 0, -10, 19, 47, -11, -10, -25, -16, -20, 57, -22,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 8, -8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    -2, -1, -2, 0, -3, 1, -1, 8, 0, 0, 16, 0, 0, -7, 0, -9, -4, -1, -1, 0, -2, -1, 16, -6,
+    -3, -4, -6, -7, 28, -10, -1, 3, 3, -3, 1, 0, 0, -3, 3, -1, -23, 1, -10, 66, -6, -18, -11, 1,
+    3, -3, 1, 0, 0, 1, -5, 3, 0, 0, 0, 0, 0, 0, 0, 0, 6, 6, 0, 0, -10, 16, -1, -17,
+    5, 59, -9, -11, 0, -2, -13, -29, -8, -5, 5, 8, -3, 6, 1, -4, 0, -1, 0, 0, 0, 0, 1, 1,
+    0, -10, 0, 0, 0, 10, 0, 0, 18, -3, 5, 2, -5, -3, -8, -5, 1, 2, -4, 1, -2, -4, 5, 1,
+    6, 4, -1, 3, -10, -5, -1, 6, 0, 0, 0, 1, 0, 0, 0, -1, -1, 0, -9, 0, 0, 0, 0, 10,
+    5, -6, -6, -1, 48, -15, -19, -6, 9, 1, -10, -1, 6, -10, -6, 11, -15, 101, -12, -9, -16, -19, -10, -19,
+    1, 12, 0, -2, -5, 0, -6, -1, 8, -6, 5, 7, -15, -4, -3, 9, -9, 1, 0, 10, -1, 0, 0, 0,
+    0, -1, -1, 0, 0, 0, 0, 3, 29, 2, -12, -17, -10, -16, -11, 36, -25, -7, -8, -27, -10, -17, 104, -10,
+    0, 0, 1, 0, 5, 0, 0, -6, 31, -4, -2, -9, -10, 5, -1, -11, -5, -4, -6, -5, 12, -3, -3, 13,
+    -8, -1, 0, 0, 0, 10, -1, 1, 12, -10, 0, -15, 15, 0, -22, 19, -2, 2, -1, 3, -3, 0, 5, -5,
+    -36, -12, -8, 127, -19, -25, -6, -19, 0, 1, -1, 3, -1, 0, -3, 1, -5, -13, -11, -12, -7, 79, -22, -10,
+    -5, 2, 0, -2, 8, -3, 0, -1, 0, 14, 0, 0, -13, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, -1, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, -1, -6, 13, -7, 9, -5, -6, 2,
+    0, 10, 0, 0, 0, 0, -10, 0, -1, 1, 0, 2, 0, 0, 1, -4, -1, -4, -15, -10, 16, 5, 4, 5,
+    -16, -14, -18, -19, -13, 78, -27, 28, 10, 0, 0, -9, 0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    14, 4, 1, 1, 11, -3, -18, -11, 2, 0, -3, 6, -2, -6, -7, 10, -16, -8, 24, 7, -2, -24, 11, 9,
+    0, 0, 0, 0, 0, 0, 0, 0, -16, -6, 1, 35, -4, -2, -3, -5, -5, -7, -6, -18, -12, 82, -22, -12,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, -14, -13, -13, -11, 74, -14, -11,
+    0, 0, 0, 0, 0, 0, 0, 0, 10, 20, 2, -11, -8, -4, 4, -14, 0, 0, 0, -10, 0, 0, -2, 12,
+    -6, 0, -2, 0, -1, -1, 0, 10, 0, 0, 0, 0, 0, 0, 0, 0, 4, 6, -6, -16, 8, 6, -2, -1,
+    -8, 16, -8, 6, -14, -2, -13, 24, -10, 1, 95, -10, -16, -21, -19, -21, 100, -10, -5, -4, -21, -13, -23, -24,
+    9, -1, 0, -7, -2, 0, 10, -8, -5, -19, -11, -10, 94, -15, -13, -22, -4, 0, 3, 1, 13, -1, -7, -5,
+    -2, -1, 0, 0, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 11, 0, 0, -10, 0,
+    -13, 7, 0, 11, -7, -6, -6, 13, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    3, -3, 1, 0, 0, 1, -5, 3, -1, 10, -1, -6, -1, 9, 3, -13, 7, -2, -2, -7, -2, 13, -6, -1,
+    3, 8, -17, 1, 5, -3, -1, 4, -2, -2, 1, -2, -3, 5, 0, 4, -3, 0, 0, 4, 0, 0, 0, 0,
+    3, 2, -1, 2, 1, -2, -4, 0, 6, 0, -1, 9, -8, -9, 1, 1, -8, 59, -6, -4, -14, -16, -4, -7,
+    0, 0, 10, 0, -10, 0, 0, 0, -26, -8, -8, -17, -12, 43, 44, -16, 12, 5, -2, 14, 0, 1, -16, -14,
+    0, -1, 0, 0, 0, 0, 1, 1, -2, -2, 1, 2, 4, 0, 2, -5, -17, -2, -10, 71, -6, -20, -10, -8,
+    -32, -5, 30, -1, -13, 52, -30, -1, -22, 13, 21, -3, -5, -14, 36, -26, 3, -3, -4, -2, 1, 3, -4, 6,
+    -4, -3, -4, 1, -2, -3, -4, 19, 0, 0, -9, 0, 0, 3, 0, 8, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, -2, -7, 1, 4, 2, 3, -3, 2, 0, 0, 2, 0, 0, 0, -2, 0,
+    0, -1, 0, 0, 0, 0, 1, 1, 0, 0, -7, 0, 17, 0, -10, 0, 0, 0, 0, 0, 0, -10, 0, 10,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, -1,
+    0, 3, 6, 2, -2, -6, 7, -11, -18, -1, -7, 5, 1, 4, 2, 14, 75, -12, -12, -13, -6, -15, -9, -8,
+    -39, -19, -27, -6, 82, -17, -28, 54, 0, -1, 0, 0, 0, 0, 1, 1, -2, 0, -8, 0, 0, 12, 0, -1,
+    0, 0, 0, -1, 0, 0, 2, -1, -2, 8, 0, 0, 0, 0, 0, -5, 1, 2, 0, 1, -5, 0, 5, -4,
+    -13, -13, -8, -8, -16, -5, 65, -2, 0, 0, 0, 0, 0, 0, 0, 0, 15, 0, -3, 0, -10, 0, -2, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, -6, 94, -5, -14, -33, -13, -6, -18, 4, -3, 0, 0, 0, 0, -1, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 3, 1, -7, -2, 8, -1, -2, -1, -5, -6, -12, -11, -7, -27, -18, 87,
+    0, 0, 0, 0, 0, 0, 0, 0, -4, 3, -4, -2, 10, 4, -5, -2, -9, 3, 0, 1, 8, -2, 0, -1,
+    -25, -7, 22, 10, -9, -11, -20, 40, 0, -8, 0, 0, 0, 0, 0, 9, -4, 10, 0, -6, 0, 0, 1, -1,
+    0, 0, 0, 0, 0, 0, 0, 0, -5, -3, -3, 44, -1, -10, -3, -19, 9, -2, -1, 0, 0, -7, -1, 1,
+    4, 3, 4, -8, -10, 14, -9, 4, 30, -15, 61, -10, -1, -6, -23, -36, 0, 0, 0, 0, 0, 0, 2, -2,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 5, -5, 0, 0, 0, 0, -1, 0, 1, 0, 0, 0, 0, 0, 6, 0, 0, 0, -3, 0, -2,
+    -15, -15, -12, 82, -7, 3, -15, -20, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    -6, -9, 10, 6, 0, 0, 0, 0, -7, 0, 0, 9, -1, 0, 0, 0, 0, -5, -19, -6, -14, 0, 8, 36,
+    -17, -4, -4, 11, -2, -9, 16, 8, 0, -1, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, -1, -4, -2, 3, -2, 1, 4, -4, 3, -5, -11, -4, -13, -1, 35, -3, 1, 5, -1, -1, 4, 2, -7,
+    2, -4, 3, -5, -2, 0, 0, 6, 0, 0, 0, 0, 0, 0, 0, 0, -1, 9, -8, -2, -6, 6, -7, 6,
+    0, 0, 0, -4, 0, 0, 0, 4, -3, 0, -2, 1, 0, 0, 5, 0, -11, 0, -7, 46, -6, -10, -8, -4,
+    0, 0, 0, 0, 0, 0, 0, 0, 3, -4, 3, -6, -3, 2, -5, 10, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 34, -10, 0, -1, -5, -7, -12, 0, 0, 0, 0, 0, 0, 0, 0, -10, 0, -8, 0, 0, 19, 0, -1,
+    -11, -2, -2, -1, -2, 0, 19, -1, -18, -21, -11, -28, -18, -26, 48, 74, -1, 0, 5, 2, -7, -2, 9, -6,
+    2, 0, -1, 0, 0, 0, 4, -4, -32, -6, -4, 36, -19, -30, 88, -32, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, -1, 0, 0, 0, 0, 1, 1, 0, -1, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, -1, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, -1, -1, -1, 0, 0, -1, 22, -18,
+    -36, -9, 4, 89, -5, -7, -2, -35, -18, -2, -23, -9, -3, 87, -16, -17, -9, -6, -16, -6, 76, -20, -4, -14,
+    -16, -9, -20, -5, 27, 44, -15, -7, 0, 0, 0, 0, 0, 0, 0, 0, -12, 1, -13, -13, -16, -34, -14, 100,
+    -5, -8, -10, -2, 65, -7, -8, -24, -1, -4, 1, -3, 0, -5, -2, 15, 0, -1, 0, 0, 0, 0, 1, 1,
+    0, 0, 0, 0, 0, 0, 0, 0, -25, -8, -30, -31, -11, -25, 55, 75, -23, -7, -7, 64, -1, -9, -9, -9,
+    0, -1, 0, 0, 0, 0, 1, 1, 0, 0, -1, 0, 0, 2, -1, 0, -22, -8, 75, -12, -3, -1, -18, -11,
+    0, -5, -5, -4, -2, -4, 30, -9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    -2, -2, -8, 86, -18, -23, -16, -16, 3, -6, 24, 1, 2, -5, -8, -11, -9, -1, -9, 9, 0, 6, -8, 12,
+    0, 0, 0, 0, 0, -9, 0, 10, -7, 68, -1, -7, -17, -5, -8, -22, 0, 0, 0, 0, 0, 0, 0, 0,
+    -11, -7, 114, -6, -18, -25, -15, -32, 0, 0, 0, 0, 0, 0, 0, 0, -24, 47, -17, -12, -9, -32, -34, 83,
+    0, 0, 0, 0, 0, 0, 0, 0, 47, -6, -4, -6, -4, -6, -4, -17, -4, 0, -9, 10, 4, 0, 0, -1,
+    0, 0, 11, -10, 0, 11, 0, -10, 0, 2, 0, 0, 0, -3, 3, -2, -1, -3, 3, 0, 3, 1, 0, -1,
+    0, 0, 0, 0, 0, 0, 0, 0, -1, 1, 0, 0, 0, 0, 0, 0, -15, -9, 60, -8, -13, -38, 52, -29,
+    -2, 1, 0, 3, -2, 0, -4, 4, 0, -1, 0, 0, 0, 0, 1, 1, 4, 0, 0, 0, -2, 0, -1, 0,
+    -19, -10, -15, -11, -4, -18, -15, 91, 0, -1, 0, 0, 0, 0, 1, 1, -8, 0, 0, 0, -1, 10, 0, -2,
+    -1, 1, -4, -3, -5, 1, 2, 9, 0, 0, 0, 0, 0, 0, 0, 0, 1, -6, -1, 2, 1, -1, -5, 9,
+    3, 0, -2, 0, 0, 0, 0, 0, 0, 0, 10, 0, 0, 0, 0, -9, 117, -9, -14, -18, -4, -5, -30, -38,
+    0, -12, -1, -19, -8, -13, 33, 20, 0, 0, 0, 0, 0, 0, 0, 0, -23, -9, 59, -13, 54, -12, -25, -32,
+    0, 0, 0, 0, 0, 0, 1, 0, -4, 1, 5, 1, 1, -6, -10, 14, 0, -6, -1, 0, 0, 17, -10, -1,
+    0, -3, 19, -2, 0, -6, -10, 2, -2, 43, -7, -3, -4, -10, -13, -3, -5, 23, -4, -8, 13, -2, -3, -15,
+    0, 0, 0, 0, 0, 0, 0, 0, -13, -2, -2, -4, 5, 6, -6, 15, -2, 4, 0, 1, 2, 0, -2, -2,
+    -13, 7, 0, 3, 1, -6, -5, 13, 0, -1, 6, -3, 5, -1, 3, -8, -12, 2, 7, 7, 6, -20, 10, 0,
+    -4, -9, 98, -27, -12, -20, -15, -12, 1, -1, 2, -2, -1, 1, 3, -4, 0, 0, 0, 0, 0, -10, 0, 10,
+    0, -1, 0, 0, 0, 0, 1, 1, 0, -2, -1, 0, 6, 0, -3, 0, -1, 0, -1, 4, -2, -1, -1, 2,
+    -7, 68, -1, -7, -17, -5, -8, -22, 0, 0, -7, 0, 0, 0, 7, 0, -1, 0, 0, 0, -8, 0, 0, 9,
+    76, -7, -18, -19, -4, -3, -13, -13, -9, -5, 4, -1, 11, 3, -7, 5, -10, 0, -1, -1, 0, 14, 0, -2,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, -1, -6, -7, 5, 11, -3, 13, -11,
+    0, 0, 0, -1, 0, 1, 0, 0, 0, 0, 9, -2, -9, -1, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, -8, 8, 0, -1, 0, -1, 2, 0, 0, -2, 3, -14, -14, -21, -7, 80, -4, 13, -34,
+    -2, -1, -1, 0, -3, 4, 10, -5, -1, 3, 9, 0, -5, -3, -2, -1, 4, -1, 2, 3, -18, -8, 13, 6,
+    0, 0, -2, 0, 3, 0, -1, 0, -10, 20, 5, 1, 1, -14, 7, -9, 3, 1, -3, -4, 2, 7, -6, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, -24, 37, -19, -11, 81, -11, -20, -34, 0, 1, -1, 0, 0, 0, 0, 0,
+    0, -1, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, -3, -4, 9, 5, 2, 3, -12, 2,
+    0, 0, 0, 0, 0, 0, 0, 0, -4, -3, 1, 2, -2, 0, 2, 4, 1, 1, 0, 2, 0, 0, 1, -5,
+    -18, -12, 107, -8, 4, -31, -15, -27, 2, 3, -5, 3, 20, 9, -4, -29, 0, 0, 1, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6, -6, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    4, -10, 8, 12, -2, -9, -7, 5, -1, 0, 0, 0, -2, 0, 0, 4, 5, 4, 8, -3, -9, -1, -11, 5,
+    0, 0, -10, 0, 10, 17, 0, -17, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    7, 0, 3, -21, -4, 16, 6, -7, 0, 0, 0, 9, 0, 0, 0, -8, 8, 0, 6, -8, 5, -10, -14, 13,
+    0, -1, 0, 0, 0, 0, 1, 1, 0, -1, 0, 0, 0, 0, 1, 1, 1, 20, -7, -1, 16, -11, -8, -10,
+    9, -2, -5, 5, 4, 1, -4, -7, -1, 0, 3, 0, 0, -1, -1, -1, 2, 3, -2, 0, 2, 2, -2, -7,
+    -17, -2, 1, -3, 10, 3, -6, 13, 0, -1, -10, 10, 0, 0, 0, 0, -3, -6, -1, 1, 1, 4, -1, 5,
+    75, 4, -10, -32, -11, -8, -1, -16, -2, 0, 0, 2, -1, 1, 2, -2, -23, -15, -12, 81, -4, -8, -17, -2,
+    -9, -9, -6, -10, -11, 2, -14, 57, -2, -8, -17, 7, 15, 8, 5, -10, 0, -1, 0, 0, 0, 0, 1, 1,
+    0, 0, 4, -1, -14, -3, 13, 2, 0, 4, 0, -3, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, -4,
+    12, 0, 0, -10, 0, 0, 0, 0, -9, -2, -1, -1, -4, 0, -2, 19, -2, -2, -4, 83, -14, -9, -31, -22,
+    1, -4, 103, -15, -16, -47, -1, -21, 84, -1, -4, -15, -17, -10, -13, -24, 1, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, -1, 0, 0, 0, 3, -1, 0, 0, 0, 0, 0, 0, 0, 0, 11, 62, -9, -10, -14, -2, -8, -32,
+    0, 0, 0, 0, 0, 0, 0, 0, 9, -4, -1, -1, -2, 3, -10, 5, 11, -11, 0, 0, -7, 0, 0, 7,
+    -22, -6, -17, -12, -5, -2, 104, -40, -3, 0, 11, 0, 0, -4, 0, -4, 12, -14, -4, 5, 2, -4, -18, 21,
+    0, -1, 0, 0, 0, 0, 1, 1, 3, -1, 0, -1, -1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, -1, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 5, 0, 0, -4, -2, 0, -9, -8, 6, -2, 5, 10,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, -1, 0, 0, 0, 0, 1, 1, 0, -1, 0, 0, 0, 12, 0, -10,
+    8, -1, -1, -1, -1, 2, 3, -10, 23, -4, 4, 1, -5, -4, -11, -5, -20, 59, -16, -11, -13, -10, 29, -18,
+    -3, 30, 1, -5, -7, -5, -1, -10, 0, 0, 0, 0, 9, -1, 0, -8, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 1, -3, -3, 0, -2, 2, 2, 4, -5, 6, 0, 9, 0, 0, -9, 0,
+    13, 0, -5, -2, -2, 0, 0, -3, -3, 0, 0, -4, 1, 1, 0, 5, 1, -10, -8, 0, -1, 1, 4, 13,
+    0, 0, 0, 0, 0, 0, 0, 0, 9, 2, 6, -1, -2, -12, 0, -1, 7, 0, 0, -4, -2, -1, 1, 0,
+    -3, 43, -14, -20, -20, -8, -9, 32, -12, 0, 2, 7, 2, 9, 7, -14, 0, -2, 2, -1, -2, 2, 4, -4,
+    0, 0, 0, 0, 0, 10, -10, 0, 0, -1, 0, 0, 0, 0, 1, 1,
+};
+
+static const char* const classifierAuthLabels[] = {
+    "Room + surname", "Email", "Access code", "Phone (SMS)", "Click-through", "Username + password",
+};
+static const float classifierAuthScale = 0.0206045981f;
+static const float classifierAuthBias[] = {
+    -0.186734f, -0.158149f, -0.0219692f, -0.155478f, 0.681963f, -0.159633f,
+};
+static const int8_t classifierAuthWeights[CLASSIFIER_FEATURES * 6] = {
+    0, 2, -1, 0, 0, -1, 0, 0, 1, 0, 0, 0, 1, 0, -1, 0, 0, 0, 3, -7, 8, -3, 4, -5,
+    0, 0, 0, 0, 0, 0, 0, -1, 2, 0, 0, 0, 0, -2, 1, 4, -4, 0, -2, -8, -28, -4, -7, 50,
+    1, -4, 0, 2, 8, -6, -2, 8, -11, 4, 7, -6, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    -2, -3, 8, -2, 0, -1, 17, -2, 0, -1, -10, -3, 0, 3, -10, 1, 5, 0, 0, 0, 0, 0, 0, 0,
+    3, -7, -4, 7, -2, 4, -5, -2, -2, 5, 0, 4, -4, -6, -4, -2, -7, 22, 7, -7, 4, -15, 8, 3,
+    3, 2, -8, 2, -1, 2, -1, 12, -11, 0, 2, -2, -3, 2, -4, -1, 5, 1, 0, 2, -4, -2, 4, 0,
+    -1, 0, 0, 1, 0, 0, 51, -10, -11, -7, -13, -11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    -2, -2, 1, -2, 6, -2, -3, 18, 0, -1, -20, 6, 0, 0, 9, 0, -8, 0, -1, 0, 0, 0, 2, 0,
+    -3, 0, 2, -2, 0, 3, 0, 1, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -2, 1, 0, -2, 4,
+    -2, 5, -2, -1, 3, -3, -1, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, -5, 18, 12, -4, -10, -11,
+    -1, 0, 21, 0, -8, -12, -1, -2, -3, -2, 9, -2, 0, 0, -10, 0, 0, 10, 0, 2, -4, -2, 4, 0,
+    -1, 0, -1, 0, 4, -1, 0, 0, 0, 0, 0, 0, 0, 2, -1, 0, -1, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, -3, -6, -5, 30, -13, -2, 0, 0, -9, 0, 0, 9, 0, -7, 5, -10, 8, 3,
+    -7, -19, -21, -9, 83, -27, 0, 1, -1, 0, 0, 0, 0, -3, 2, -3, 3, 1, -2, -29, 48, -9, -8, 0,
+    2, 1, 3, 1, -1, -6, -1, 4, -2, 1, -1, 0, -2, 1, -2, 0, 0, 3, -3, -8, -3, 28, -6, -8,
+    0, 0, 0, 0, 0, 0, -1, -2, 4, -3, 1, 1, 0, -8, -4, 23, -12, 2, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 3, -2, 3, -5, 1, 1, 1, -4, -1, 3, 0, 0, 0, 0, 0, 0, 0,
+    0, -1, -1, -1, 6, -2, 0, 0, 0, 0, 0, 0, 0, -1, 1, 0, 0, 0, -1, 0, 0, 0, 2, 0,
+    -1, 0, 1, 0, 0, 1, -1, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, -1, 1, 0, 0, 0, -1, -2, 11, -2, -3, -3, 2, -4, -6, -3, 9, 2, -1, 0, -1, -1, 4, -1,
+    0, 0, 0, 0, 0, 0, -9, -1, 1, 0, 0, 9, 0, 0, 0, 0, 0, 0, 0, 9, -9, 0, 1, -1,
+    0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, -10, 10, 0, 0, 0, 21, -2, -7, -3, -4, -5,
+    0, 10, 0, 0, -1, -9, 0, 1, -2, 0, 0, 0, 0, 2, -1, 0, -1, 0, 0, -10, 11, 0, -1, 0,
+    0, 0, 0, -9, 9, 0, 0, 0, 0, 0, 0, 0, 8, -7, -15, 15, -14, 13, -8, -14, -17, -9, 63, -14,
+    -1, -3, 1, 1, 0, 2, 13, -2, -2, -1, -3, -4, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0,
+    -2, -1, -1, -1, 7, -1, 0, 9, -10, -5, 4, 1, 0, 0, 0, 0, 0, 0, 1, 0, 3, 0, 1, -5,
+    0, -1, -1, -2, 3, 1, -4, -2, -7, -4, -7, 24, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+    0, 0, 0, 0, 0, 0, -1, -3, -2, -1, -4, 10, 0, 1, 0, 0, 0, -1, 0, 0, -1, 0, 1, 0,
+    0, 0, 0, 1, 0, 0, -1, 0, 0, 0, 2, 0, -1, 0, 3, 1, -4, 1, 0, 0, 1, 1, -1, -1,
+    0, 0, 1, 0, 0, 0, 0, -2, -5, 1, 5, 0, 1, -7, 0, 5, -4, 5, -8, -3, -4, 24, -7, -3,
+    -4, -9, 21, 2, 1, -11, 0, 0, 0, 0, 0, 0, 35, -7, -9, -6, -8, -5, 0, 0, -6, 0, 14, -7,
+    0, 0, 0, 0, 0, 0, -1, 0, 0, 0, 2, 0, 0, 0, -9, 0, 0, 10, 0, 0, -1, 0, 1, 1,
+    -1, 0, -3, 0, 1, 3, -1, 1, -2, 0, -1, 2, 0, 0, 0, 0, 0, 0, -1, -11, -4, 25, -2, -8,
+    8, -7, 3, -3, -3, 3, -8, -26, 90, -10, -18, -28, 12, -1, -1, -1, -8, -1, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 2, 1, 3, 1, 0, -6, -4, 13, -8, -2, 2, -2, 0, 0, 0, 0, 1, 0,
+    -2, 5, -7, -3, 2, 5, 42, -14, 6, -7, -15, -12, 0, 0, 0, 0, 0, 0, -8, -9, 62, -2, -22, -20,
+    0, 0, 0, 0, 0, 0, 0, -2, 2, 0, -1, 3, 0, 1, -1, 3, -2, 0, 0, -10, 10, 0, 0, 0,
+    -2, 0, -1, -1, 0, 3, 0, 0, 0, 0, 0, 0, -5, -7, 5, -8, -15, 31, 0, 0, 0, 0, 0, 0,
+    2, 0, 2, -1, -6, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0,
+    -2, -1, 7, 3, -3, -5, 0, 0, 0, 0, 10, -9, -2, -1, -3, -3, -6, 14, -1, -6, -1, 17, -3, -6,
+    27, -9, -10, 4, -12, 1, 4, -2, 1, 1, 0, -3, 0, 1, -1, 0, 1, 0, 0, 0, 0, 0, 0, 0,
+    13, -2, -5, -1, -3, -2, -3, 5, -3, 1, 1, 0, 7, -5, -3, -3, 7, -3, -1, 0, 0, 0, 2, 0,
+    0, 0, 0, 0, 0, 0, -1, 0, 2, 2, -5, 1, 4, 7, -9, -4, -7, 8, 2, 5, -3, 2, -14, 8,
+    0, 0, 1, 0, -1, 0, 0, 0, 0, 0, 0, 0, -4, -21, 45, -3, -16, -1, -7, 47, -15, -10, -5, -9,
+    0, -1, 8, -4, 1, -5, -1, 0, -1, 0, 1, 1, -11, -51, 127, -10, -28, -28, 0, 0, 1, 0, 0, 0,
+    0, 0, 0, 1, 0, 0, -1, -2, -9, 20, -2, -5, 0, 6, -3, -1, 0, -1, 0, -2, 5, 0, -1, -1,
+    -4, -1, -7, -5, -7, 25, 41, -9, -10, -2, -9, -11, 0, 0, 0, 0, 2, -1, -6, 36, -12, -2, -5, -11,
+    4, -2, -1, -1, -1, 1, -3, 7, 3, 5, -3, -11, -2, -2, -2, -2, 8, -1, -2, -8, 10, 0, 4, -4,
+    -1, -3, 0, -1, 5, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1, 0, 0, 0, 2, 0,
+    -1, 0, 0, -1, 4, -2, -1, 0, 0, -1, 4, -2, 0, 0, 0, 0, 1, 0, -1, 1, -1, 0, 2, 0,
+    22, -8, -3, -1, -4, -5, -2, 0, -10, -2, 4, 11, -10, 0, 10, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    -8, 40, -24, -8, -15, 15, -4, 2, 2, 3, -4, 2, 18, -2, -5, -2, -5, -4, 0, 0, 0, 0, 0, 0,
+    -3, 0, -1, -1, 3, 3, -1, -5, 7, 1, 3, -4, 0, 0, 2, 0, 0, -1, 0, 0, 0, 0, 1, 0,
+    2, -17, 15, -5, 7, -1, 0, 0, 0, 0, 0, 0, -4, -17, -20, 14, -17, 45, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, -1, -2, -2, -8, 5, 0, 2, -2, -2, 2, 1,
+    2, -1, 0, 2, -4, 1, 4, 0, 1, -4, 0, 0, 0, 0, 0, 1, -1, 0, 1, -4, 0, 2, 7, -6,
+    -4, -9, 3, -1, -10, 21, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0,
+    -8, -2, -1, 19, -5, -2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, -1, 0, 0, 0,
+    -5, 30, -10, -4, -8, -4, 5, -1, -1, -1, -1, -1, -1, 27, -5, -8, -8, -3, -2, -3, 6, -1, -1, 0,
+    0, 0, 0, 0, 0, 0, -9, 49, 12, -9, -22, -19, -9, -29, 73, -2, -20, -13, 1, -15, 6, -1, 5, 4,
+    0, 0, 0, 0, 1, 0, 1, 0, -5, -3, 5, 1, -6, 13, -17, -4, -8, 22, -1, 0, 0, 0, 2, 0,
+    -2, -2, 7, 2, -2, -4, -2, -3, 1, 1, -1, 4, -3, 17, 6, -3, -8, -8, 4, -3, 2, -2, -7, 6,
+    49, -11, -11, -7, -10, -10, -4, -6, 0, -3, 18, -5, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0,
+    -1, 0, 0, 0, 0, 1, -5, -9, -7, 43, -12, -9, 0, 0, 0, 0, 0, 0, -1, 0, 0, 0, 2, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, -3, 2, 2, 2, -4, 13, -1, -4, -1, -4, -2, 0, -6, -1, -1, 9, 0,
+    4, 8, -7, -7, 6, -2, -1, 0, 0, 0, 2, 0, -1, 1, -1, 0, 0, 1, 0, 0, 0, 10, -10, 0,
+    0, 0, 0, 0, 0, 0, 16, 21, 11, -9, -21, -19, 0, 8, -3, -2, -2, -1, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1, 1, 1, -2, -2, 3, 0, 1, 0, -1, 0, 0,
+    0, 0, 0, 0, 0, 0, -1, 2, -2, 1, 0, -1, 0, -1, -8, -2, -1, 12, 0, 0, 0, 0, 0, 0,
+    -3, -4, 2, -5, -10, 20, -1, -3, 0, -1, 5, -1, 1, 19, -8, -5, -6, -2, 5, 0, 0, -2, 0, -2,
+    0, 2, -2, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1, 12, -11, 0, 2, -2, 0, -2, 1, 0, 0, 0,
+    -8, -8, -6, -7, -15, 43, 3, -6, 9, -1, -6, 1, 0, 0, -10, 0, -1, 11, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1, -1, 0, 0, 2, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 1, -5, 4, 5, 1, -6, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 6, 0, -5, 0, 1, 0, 0, 0, 0, 0, -3, 36, -19, -6, -10, 2, 1, -19, 21, -1, -4, 2,
+    -1, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, -1, 1, -1, 0, -1, 2, -5, -23, 60, -5, -13, -14,
+    -1, -3, 11, -2, 0, -4, 0, -1, -1, -1, 3, 0, 0, 0, 0, 0, 1, 0, 18, -1, -9, -2, -4, -3,
+    0, 1, 9, -9, 0, -1, 0, 0, 0, 0, -2, 2, 0, -2, -5, 1, 5, 0, 0, 0, 0, 0, 0, 0,
+    -1, -2, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0, -1, 1, 1, 1, -3, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1, 0, 0, -1, 2, 1, -3, -3, -4, 1, 4, 1, 0,
+    0, 0, 0, 0, 0, 0, -3, -7, 14, 8, -5, -7, -1, -1, -1, 0, -2, 5, -1, 0, 0, 0, 2, 0,
+    -1, 0, 0, 0, 2, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, -1, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, -1, 0, 0,
+    0, 7, 7, -1, -5, -8, 0, 3, -5, 0, 3, -1, -1, -2, 0, -5, 2, 6, -3, 24, -12, -6, -3, -1,
+    0, 0, 0, 1, 0, 0, -1, -10, 25, -7, -3, -4, 0, -9, 16, -5, 0, -3, -4, 15, -7, -3, 4, -6,
+    -1, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, -4, -1, 1, 2, 0, 2, 7, 6, 5, -1, -9, -7,
+    -1, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 9, -8, -3, -3, 1, 4, -1, 1, 0, -1, 0, 2,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -3, 0, 40, -1, -11, -24, 0, 0, -3, 1, 2, -1,
+    4, 0, -4, -1, -12, 12, 0, 0, 0, 0, 0, 0, 2, -3, -4, -1, 6, 0, 0, 0, 0, 0, 0, 0,
+    1, -1, -9, -1, 6, 5, 0, 0, 1, 0, 0, 0, 0, -8, -7, 0, 5, 10, 0, 0, 0, 0, 0, 0,
+    1, 2, -3, -1, 2, -1, -1, -1, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 0, -1, 0,
+    -6, -10, -9, 56, -17, -14, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -3, 0, 6, 0, 5, -9,
+    -1, 0, 0, 1, 1, 0, -1, 0, 0, 0, 2, 0, 0, -10, 10, 0, 0, 0, 1, 0, -2, 1, 3, -3,
+    -1, 0, 0, 0, 2, 0, 0, 0, -4, 0, 6, 0, 0, 0, 0, -1, 4, -3, 0, 0, 0, 0, 0, 0,
+    -4, -8, -10, 46, -15, -9, 0, -3, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6, -2, -5, 0, 0, 0,
+    1, -3, 4, -4, 1, 1, 0, 0, 0, 0, 0, 0, 0, -1, 6, 1, -2, -4, 0, 0, 0, 0, 0, 0,
+    -3, 5, 10, 1, -7, -7, 0, -1, 0, 0, 1, 0, -3, 15, -9, 14, -8, -8, 3, 6, -3, -5, 0, -2,
+    -3, -6, -5, -2, -1, 17, 0, 0, 0, 0, 0, 0, -3, -6, -3, -3, -1, 15, 2, 3, 1, -1, -7, 2,
+    -8, -2, -1, 18, -5, -2, -7, -9, -8, 52, -16, -12, 0, 0, 2, -1, -5, 5, -8, 15, -17, 0, 3, 7,
+    1, 1, 2, -1, -5, 3, 0, 0, 0, 0, 0, 0, -1, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, -1, 0, 1, 0, 3, -3, -4, -1, 5, 0, 1, 8, -9, 0, 1, -1, 0, -10, 11, 0, 0, 0,
+    -8, 0, 4, -1, 6, -1, -7, -14, 13, -10, -12, 30, 0, 0, -9, 10, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 2, 0, -1, -8, -3, 33, 7, -16, -13, -2, 0, 7, -2, 0, -2, 0, -1, 0, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -2, -3, -3, -3, 12, -2, 1, -8, -3, 18, 3, -11,
+    -1, -2, -3, -3, -1, 11, 0, 3, -1, -1, 5, -7, 4, -4, 4, 2, -17, 13, 0, 1, 1, 0, 0, -1,
+    -2, -10, -7, -2, -4, 25, -4, 11, -9, 19, -8, -9, 0, 0, 0, 0, 0, 0, 0, 3, 6, -2, 0, -5,
+    0, 0, 0, 0, 0, 0, -1, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, -3, -6, -5, 36, -11, -10,
+    0, 0, 0, 0, 0, 0, -1, 0, -6, 9, 1, -2, 0, 2, -1, -1, 0, 0, -3, -2, 0, -2, 3, 4,
+    -8, -21, -16, -13, 79, -22, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, -1, -8, -21, -4, -5, 40, 0, 0, 0, 1, 0, 0, 2, 1, 3, 1, 1, -7,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 17, -3, -2, -2, -8, -3,
+    0, 10, 0, 0, -10, 0, -2, 0, -2, -1, -1, 7, -1, 0, 0, 0, 2, 0, -1, 0, 0, 0, 2, 0,
+    2, -5, 3, -2, -1, 2, -2, 3, -2, 4, 0, -3, 10, 1, -10, 0, 0, 0, -10, 59, 3, -9, -23, -20,
+    14, -2, -5, -1, -5, -2, 0, 0, 0, 0, 0, 0, -4, -8, -10, 47, -15, -10, 2, 3, 0, 2, -9, 1,
+    4, 5, -1, 1, -15, 6, 0, 2, -2, 6, 0, -6, -3, -5, -8, -5, -3, 24, 13, -5, -2, -1, -3, -2,
+    -1, 0, 0, 0, 2, 0, -1, -1, -6, 32, -11, -12, 0, 0, 0, 0, 0, 0, -1, -5, -3, -9, -1, 20,
+    0, 0, 0, 0, 0, 0, -1, -3, 0, 9, -3, 0, -4, -4, 5, 16, -5, -7, -2, 4, 3, -1, 3, -7,
+    -4, 10, 5, -4, -6, -1, 0, -4, -4, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    -3, 5, -3, 0, 2, 0, 0, 0, 1, 0, -1, 0, 0, -1, -2, 0, 0, 3, 0, 0, -4, 0, 4, 0,
+    -5, -1, -2, 5, 0, 4, 0, 0, 0, 0, 0, 0, -11, -13, -15, -6, -12, 56, -1, 0, 0, 0, 2, 0,
+    2, 5, 5, 3, -21, 5, 0, 0, 0, 0, 0, 0, -1, 0, 0, 0, 2, 0, 0, 0, 0, 0, 1, 0,
+    4, -1, -1, 0, -1, -1, 0, 0, 0, 0, 0, 0, -1, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0,
+    0, -2, 4, 0, -1, -1, -1, 0, 2, 2, -4, 1, 1, -3, 1, -4, 7, -2, -5, -7, -5, 31, -9, -5,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1, 0, 0, 1, 0, 0, -1, 0, -1, 2, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -11, -25, 12, -12, -28, 65, 0, 0, -1, 1, 3, -2,
+    0, 0, 0, 0, 0, 1, -2, 3, -6, 0, 1, 3, 2, -7, -5, -3, 22, -9, -3, 2, 7, -3, -2, 0,
+    0, 0, 3, 0, -1, -2, 3, 1, 3, -1, -12, 6, 0, 0, 10, 0, -9, 0, -1, 0, 0, 0, 2, 0,
+};
+
+#endif // PORTAL_CLASSIFIER_MODEL_H
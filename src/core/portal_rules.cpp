@@ -0,0 +1,368 @@
+#include "portal_rules.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+// Built-in rules, used when no rule file is on flash
+static const char defaultRules[] =
+    "# kind | label | min score | keyword[=weight], ...\n"
+    "\n"
+    "# The best-scoring venue wins; ties go to the one listed first\n"
+    "venue  | Hotel/Resort            | 1 | hotel=3, resort=3, suites=2, inn, room\n"
+    "venue  | Airport                 | 1 | airport=3, airline=3, terminal=2, flight=2\n"
+    "venue  | Healthcare Facility     | 1 | hospital=3, clinic=3, medical=2, patient=2\n"
+    "venue  | Cafe/Restaurant         | 1 | cafe=3, coffee=3, restaurant=3\n"
+    "venue  | Conference Center       | 1 | conference=3, convention=3, event\n"
+    "venue  | Educational Institution | 1 | university=3, college=3, school=2\n"
+    "venue  | Library                 | 1 | library=3\n"
+    "\n"
+    "field  | Room Number   | 1 | room\n"
+    "field  | Last Name     | 2 | last, name\n"
+    "field  | First Name    | 2 | first, name\n"
+    "field  | Email Address | 1 | email\n"
+    "field  | Phone Number  | 1 | phone, mobile\n"
+    "field  | Access Code   | 1 | code, access\n"
+    "\n"
+    "issue  | Form submits over HTTP (unencrypted)     | 1 | http://, https://=-9\n"
+    "issue  | Password field may not be masked         | 1 | password, type=\"password\"=-9\n"
+    "issue  | Session persistence may leak credentials | 1 | remember, stay logged\n"
+    "\n"
+    "advice | Try room number enumeration (101-999)   | 1 | @Hotel/Resort\n"
+    "advice | Common surnames likely to yield results | 1 | @Hotel/Resort\n";
+
+static uint32_t fnv1a(const char* data, size_t len) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (uint8_t)data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void trim(const char*& begin, const char*& end) {
+    while (begin < end && isspace((unsigned char)*begin)) begin++;
+    while (end > begin && isspace((unsigned char)end[-1])) end--;
+}
+
+// Whole of [begin, end) is an optionally signed integer
+static bool parseInt(const char* begin, const char* end, int* value) {
+    const char* p = begin;
+    if (p < end && (*p == '-' || *p == '+')) p++;
+    if (p == end) return false;
+    int v = 0;
+    for (; p < end; p++) {
+        if (!isdigit((unsigned char)*p) || v > 9999) return false;
+        v = v * 10 + (*p - '0');
+    }
+    *value = *begin == '-' ? -v : v;
+    return true;
+}
+
+PortalRules::PortalRules() {
+    clear();
+}
+
+void PortalRules::clear() {
+    ruleCount = 0;
+    termCount = 0;
+    keywordCount = 0;
+    memset(classOf, 0, sizeof(classOf));
+    classCount = 1;
+    next.assign(1, 0);
+    output.assign(1, -1);
+    outLink.assign(1, 0);
+    stateCount = 1;
+    hash = 0;
+    error[0] = '\0';
+}
+
+const char* PortalRules::getDefaultText() {
+    return defaultRules;
+}
+
+bool PortalRules::loadDefaults() {
+    return load(defaultRules, sizeof(defaultRules) - 1);
+}
+
+bool PortalRules::load(const char* text, size_t len) {
+    clear();
+
+    const char* end = text + len;
+    int lineNo = 0;
+    for (const char* line = text; line < end; ) {
+        const char* eol = (const char*)memchr(line, '\n', end - line);
+        if (!eol) eol = end;
+        lineNo++;
+
+        const char* reason = parseLine(line, eol);
+        if (reason) {
+            clear();
+            snprintf(error, sizeof(error), "line %d: %s", lineNo, reason);
+            return false;
+        }
+        line = eol + 1;
+    }
+
+    const char* reason = compile();
+    if (reason) {
+        clear();
+        snprintf(error, sizeof(error), "%s", reason);
+        return false;
+    }
+
+    hash = fnv1a(text, len);
+    if (hash == 0) hash = 1;
+    return true;
+}
+
+const char* PortalRules::parseLine(const char* line, const char* end) {
+    trim(line, end);
+    if (line == end || *line == '#') return nullptr;
+
+    // kind | label | min | terms
+    const char* fields[5];
+    int count = 0;
+    fields[count++] = line;
+    for (const char* p = line; p < end && count < 5; p++) {
+        if (*p == '|') fields[count++] = p + 1;
+    }
+    if (count != 4) return "expected kind | label | min score | terms";
+    const char* fieldEnd[4] = {fields[1] - 1, fields[2] - 1, fields[3] - 1, end};
+
+    if (ruleCount >= RULES_MAX_RULES) return "too many rules";
+    Rule& rule = rules[ruleCount];
+
+    const char* b = fields[0];
+    const char* e = fieldEnd[0];
+    trim(b, e);
+    static const char* const kinds[] = {"venue", "field", "issue", "advice"};
+    int kind = -1;
+    for (int i = 0; i < 4; i++) {
+        if ((size_t)(e - b) == strlen(kinds[i]) && strncmp(b, kinds[i], e - b) == 0) kind = i;
+    }
+    if (kind < 0) return "kind must be venue, field, issue or advice";
+    rule.kind = (RuleKind)kind;
+
+    b = fields[1];
+    e = fieldEnd[1];
+    trim(b, e);
+    if (b == e || e - b >= RULES_MAX_LABEL) return "label empty or too long";
+    memcpy(rule.label, b, e - b);
+    rule.label[e - b] = '\0';
+
+    b = fields[2];
+    e = fieldEnd[2];
+    trim(b, e);
+    int minScore;
+    if (!parseInt(b, e, &minScore) || minScore < 1) return "min score must be a positive integer";
+    rule.minScore = minScore;
+
+    rule.termStart = termCount;
+    rule.termCount = 0;
+    const char* term = fields[3];
+    while (term <= end) {
+        const char* comma = (const char*)memchr(term, ',', end - term);
+        if (!comma) comma = end;
+        const char* reason = addTerm(rule, term, comma);
+        if (reason) return reason;
+        term = comma + 1;
+    }
+
+    ruleCount++;
+    return nullptr;
+}
+
+const char* PortalRules::addTerm(Rule& rule, const char* begin, const char* end) {
+    trim(begin, end);
+    if (begin == end) return "empty term";
+    if (termCount >= RULES_MAX_TERMS) return "too many terms";
+    Term& term = terms[termCount];
+
+    // "=weight" suffix, unless what follows the last '=' isn't a number
+    // (type="password" is a keyword)
+    term.weight = 1;
+    const char* eq = end;
+    while (eq > begin && eq[-1] != '=') eq--;
+    int weight;
+    if (eq > begin && parseInt(eq, end, &weight)) {
+        term.weight = weight;
+        end = eq - 1;
+        trim(begin, end);
+        if (begin == end) return "empty term";
+    }
+
+    if (*begin == '@') {
+        begin++;
+        term.keyword = -1;
+        term.venue = -1;
+        for (int i = 0; i < ruleCount; i++) {
+            if (rules[i].kind == RULE_VENUE && strlen(rules[i].label) == (size_t)(end - begin) &&
+                strncmp(rules[i].label, begin, end - begin) == 0) {
+                term.venue = i;
+            }
+        }
+        if (term.venue < 0) return "@ names no venue defined above";
+    } else {
+        int keyword = addKeyword(begin, end - begin);
+        if (keyword < 0) return "keyword too long or too many keywords";
+        term.keyword = keyword;
+        term.venue = -1;
+    }
+
+    termCount++;
+    rule.termCount++;
+    return nullptr;
+}
+
+// Index of the (lowercased) keyword, added if new
+int PortalRules::addKeyword(const char* text, size_t len) {
+    if (len >= RULES_MAX_KEYWORD) return -1;
+    char lower[RULES_MAX_KEYWORD];
+    for (size_t i = 0; i < len; i++) lower[i] = tolower((unsigned char)text[i]);
+    lower[len] = '\0';
+
+    for (int i = 0; i < keywordCount; i++) {
+        if (strcmp(keywords[i], lower) == 0) return i;
+    }
+    if (keywordCount >= RULES_MAX_KEYWORDS) return -1;
+    memcpy(keywords[keywordCount], lower, len + 1);
+    return keywordCount++;
+}
+
+// Build the automaton: a trie of all keywords, then failure links
+// (breadth first) folded into a complete transition table
+const char* PortalRules::compile() {
+    // Bytes no keyword uses share class 0; letters match either case
+    classCount = 1;
+    for (int k = 0; k < keywordCount; k++) {
+        for (const char* p = keywords[k]; *p; p++) {
+            uint8_t c = (uint8_t)*p;
+            if (classOf[c] == 0) {
+                classOf[c] = classCount++;
+                if (c != toupper(c)) classOf[(uint8_t)toupper(c)] = classOf[c];
+            }
+        }
+    }
+
+    size_t bytes = 0;
+    for (int k = 0; k < keywordCount; k++) bytes += strlen(keywords[k]);
+    if (bytes + 1 > RULES_MAX_STATES) return "keywords too long in total";
+
+    const int C = classCount;
+    next.assign((bytes + 1) * C, 0);
+    output.assign(bytes + 1, -1);
+    outLink.assign(bytes + 1, 0);
+    stateCount = 1;
+
+    for (int k = 0; k < keywordCount; k++) {
+        int s = 0;
+        for (const char* p = keywords[k]; *p; p++) {
+            uint16_t& child = next[s * C + classOf[(uint8_t)*p]];
+            if (child == 0) child = stateCount++;
+            s = child;
+        }
+        output[s] = k;
+    }
+
+    std::vector<uint16_t> fail(stateCount, 0);
+    std::vector<uint16_t> queue;
+    queue.reserve(stateCount);
+    queue.push_back(0);
+    for (size_t head = 0; head < queue.size(); head++) {
+        int r = queue[head];
+        for (int c = 0; c < C; c++) {
+            uint16_t& u = next[r * C + c];
+            uint16_t viaFail = r == 0 ? 0 : next[fail[r] * C + c];
+            if (u == 0) {
+                u = viaFail;            // No child: follow the failure link
+                continue;
+            }
+            fail[u] = viaFail;
+            outLink[u] = output[fail[u]] >= 0 ? fail[u] : outLink[fail[u]];
+            queue.push_back(u);
+        }
+    }
+
+    next.resize(stateCount * C);
+    output.resize(stateCount);
+    outLink.resize(stateCount);
+    return nullptr;
+}
+
+void PortalRules::evaluate(const char* text, size_t len, RuleMatch& out) const {
+    // One pass: mark every keyword present
+    uint32_t seen[(RULES_MAX_KEYWORDS + 31) / 32] = {0};
+    const uint16_t* table = next.data();
+    const int16_t* outputs = output.data();
+    const uint16_t* links = outLink.data();
+    const int C = classCount;
+    unsigned s = 0;
+    for (size_t i = 0; i < len; i++) {
+        s = table[s * C + classOf[(uint8_t)text[i]]];
+        for (unsigned o = outputs[s] >= 0 ? s : links[s]; o; o = links[o]) {
+            int k = outputs[o];
+            seen[k >> 5] |= 1u << (k & 31);
+        }
+    }
+
+    // Keyword scores, then the venue, then terms that depend on it
+    out.fired = 0;
+    out.venue = -1;
+    for (int r = 0; r < ruleCount; r++) {
+        const Rule& rule = rules[r];
+        int score = 0;
+        for (int t = rule.termStart; t < rule.termStart + rule.termCount; t++) {
+            int k = terms[t].keyword;
+            if (k >= 0 && (seen[k >> 5] >> (k & 31)) & 1) score += terms[t].weight;
+        }
+        out.scores[r] = score;
+        if (rule.kind == RULE_VENUE && score >= rule.minScore &&
+            (out.venue < 0 || score > out.scores[out.venue])) {
+            out.venue = r;
+        }
+    }
+
+    for (int r = 0; r < ruleCount; r++) {
+        const Rule& rule = rules[r];
+        for (int t = rule.termStart; t < rule.termStart + rule.termCount; t++) {
+            if (terms[t].keyword < 0 && terms[t].venue == out.venue) {
+                out.scores[r] += terms[t].weight;
+            }
+        }
+        if (out.scores[r] >= rule.minScore) out.fired |= 1ull << r;
+    }
+}
+
+int PortalRules::getRuleCount() const {
+    return ruleCount;
+}
+
+RuleKind PortalRules::getKind(int rule) const {
+    return rules[rule].kind;
+}
+
+const char* PortalRules::getLabel(int rule) const {
+    return rules[rule].label;
+}
+
+int PortalRules::getKeywordCount() const {
+    return keywordCount;
+}
+
+int PortalRules::getStateCount() const {
+    return stateCount;
+}
+
+size_t PortalRules::getTableBytes() const {
+    return sizeof(classOf) + next.size() * sizeof(uint16_t) + output.size() * sizeof(int16_t) +
+           outLink.size() * sizeof(uint16_t);
+}
+
+uint32_t PortalRules::getHash() const {
+    return hash;
+}
+
+const char* PortalRules::getError() const {
+    return error;
+}
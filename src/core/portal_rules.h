@@ -0,0 +1,110 @@
+#ifndef PORTAL_RULES_H
+#define PORTAL_RULES_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+// Rule set limits
+#define RULES_MAX_RULES    64
+#define RULES_MAX_TERMS    256
+#define RULES_MAX_KEYWORDS 192
+#define RULES_MAX_LABEL    64       // Including the terminator
+#define RULES_MAX_KEYWORD  32
+#define RULES_MAX_STATES   4096     // Matcher states (about one per keyword byte)
+
+// What a rule reports when it fires
+enum RuleKind : uint8_t {
+    RULE_VENUE,                     // Venue type; only the best-scoring one is used
+    RULE_FIELD,                     // Form field the portal asks for
+    RULE_ISSUE,                     // Security issue
+    RULE_ADVICE                     // Recommendation
+};
+
+// Scores of every rule for one page
+struct RuleMatch {
+    int16_t scores[RULES_MAX_RULES];
+    uint64_t fired;                 // Bit per rule that reached its minimum score
+    int venue;                      // Best-scoring venue rule that fired, -1 if none
+
+    bool hasFired(int rule) const { return (fired >> rule) & 1; }
+};
+
+// Keyword rules for pattern-based portal analysis, in a text format so a
+// rule set can be replaced from flash without rebuilding. One rule per line:
+//
+//     kind | label | min score | term, term, ...
+//
+// kind is venue, field, issue or advice. A term is a keyword (matched
+// case-insensitively anywhere in the page) with an optional integer
+// weight, "keyword=weight" (default 1; negative weights veto), or
+// "@<venue label>", which scores when that venue (defined above) is the
+// detected one. A rule fires when the weights of its keywords present in
+// the page add up to the minimum score. Lines starting with # are comments.
+//
+// All keywords are compiled into one Aho-Corasick automaton with a dense
+// transition table over the byte classes the keywords use, so evaluate()
+// reads the page once however many rules there are, and does not
+// allocate.
+class PortalRules {
+public:
+    PortalRules();
+
+    // Parse and compile a rule set. On error the set is left empty and
+    // getError() names the line.
+    bool load(const char* text, size_t len);
+    bool loadDefaults();
+    static const char* getDefaultText();
+
+    void evaluate(const char* text, size_t len, RuleMatch& out) const;
+
+    int getRuleCount() const;
+    RuleKind getKind(int rule) const;
+    const char* getLabel(int rule) const;
+    int getKeywordCount() const;
+    int getStateCount() const;
+    size_t getTableBytes() const;   // Matcher memory
+    uint32_t getHash() const;       // FNV-1a of the rule text, 0 when empty
+    const char* getError() const;
+
+private:
+    struct Rule {
+        RuleKind kind;
+        int16_t minScore;
+        uint16_t termStart;
+        uint16_t termCount;
+        char label[RULES_MAX_LABEL];
+    };
+
+    struct Term {
+        int16_t keyword;            // Keyword index, or -1 for a venue term
+        int16_t venue;              // Venue rule index for "@label" terms
+        int16_t weight;
+    };
+
+    Rule rules[RULES_MAX_RULES];
+    int ruleCount;
+    Term terms[RULES_MAX_TERMS];
+    int termCount;
+    char keywords[RULES_MAX_KEYWORDS][RULES_MAX_KEYWORD];
+    int keywordCount;
+
+    // Matcher: byte -> class, then next[state * classCount + class]
+    uint8_t classOf[256];
+    int classCount;
+    std::vector<uint16_t> next;
+    std::vector<int16_t> output;    // Keyword ending at each state, -1 if none
+    std::vector<uint16_t> outLink;  // Nearest suffix state with an output, 0 if none
+    int stateCount;
+
+    uint32_t hash;
+    char error[96];
+
+    void clear();
+    const char* parseLine(const char* line, const char* end);
+    const char* addTerm(Rule& rule, const char* begin, const char* end);
+    int addKeyword(const char* text, size_t len);
+    const char* compile();
+};
+
+#endif // PORTAL_RULES_H
@@ -8,6 +8,7 @@ PowerMode Power::currentMode = POWER_BATTERY;
 unsigned long Power::lastActivity = 0;
 bool Power::sleepPrevented = false;
 float Power::batteryVoltage = 0.0;
+Power::SleepCallback Power::sleepCb = nullptr;
 
 void Power::init(PowerMode mode) {
     currentMode = mode;
@@ -139,6 +140,11 @@ void Power::deepSleep(unsigned long durationMs) {
         esp_sleep_enable_timer_wakeup(durationMs * 1000);
     }
 
+    // Deep sleep resets the chip; give subsystems a chance to persist state
+    if (sleepCb) {
+        sleepCb();
+    }
+
     #if DEBUG_SERIAL
     Serial.println("[POWER] Entering deep sleep...");
     Serial.flush();
@@ -156,3 +162,7 @@ void Power::allowSleep() {
     sleepPrevented = false;
     lastActivity = millis();
 }
+
+void Power::setSleepCallback(SleepCallback cb) {
+    sleepCb = cb;
+}
@@ -28,11 +28,16 @@ public:
     static void preventSleep();
     static void allowSleep();
 
+    // Called right before deep sleep (e.g. to flush pending state)
+    typedef void (*SleepCallback)();
+    static void setSleepCallback(SleepCallback cb);
+
 private:
     static PowerMode currentMode;
     static unsigned long lastActivity;
     static bool sleepPrevented;
     static float batteryVoltage;
+    static SleepCallback sleepCb;
 };
 
 #endif // POWER_H
@@ -2,6 +2,7 @@
 #include "config.h"
 #include "core/scanner.h"
 #include "core/power.h"
+#include "llm/engine.h"
 #include <SPI.h>
 
 // Static member initialization
@@ -22,6 +23,12 @@ static bool contentNeedsUpdate = true;  // For dynamic content like network list
 static int prevNetworkCount = -1;       // Track network count changes
 static int prevSelectedIndex = -1;      // Track selection changes
 
+// Tail of the model output shown on the LLM screen
+#define LLM_SCREEN_TEXT 512
+static StreamCursor llmCursor = {0, 0};
+static char llmText[LLM_SCREEN_TEXT + 1];
+static size_t llmTextLen = 0;
+
 // Forward declarations for static helper functions
 static void drawMenuButton(int x, int y, int w, int h, const char* label, bool sel, uint16_t color, int iconType);
 static void drawNetworkListItem(int x, int y, int w, int h, NetworkInfo& net, bool sel);
@@ -615,6 +622,7 @@ void UI::drawEnumScreen() {
 void UI::drawLLMScreen() {
     int w = tft.width();
     int h = tft.height();
+    bool fullRedraw = needsFullRedraw;
 
     if (needsFullRedraw) {
         tft.fillScreen(colors.background);
@@ -651,11 +659,98 @@ void UI::drawLLMScreen() {
     tft.print("LLM: Disabled");
     #endif
 
+    #if LLM_ENABLED
+    drawLLMStream(10, cardY + 108, w - 20, h - 18 - (cardY + 108) - 4, fullRedraw);
+    #endif
+
     tft.fillRect(0, h - 18, w, 18, colors.background);
     tft.drawFastHLine(0, h - 18, w, colors.secondary);
     tft.setTextColor(colors.textDim, colors.background);
     tft.setCursor(4, h - 12);
-    tft.print("[<] Back");
+    tft.print(LLMEngine::getStream().getState() == STREAM_RUNNING ? "[<] Back  [OK] Stop" : "[<] Back");
+}
+
+// Model output as it is generated: new text is taken from the engine's
+// token stream each frame, and the panel is redrawn only when it changed
+void UI::drawLLMStream(int x, int y, int w, int h, bool fullRedraw) {
+    static uint32_t shownId = 0;
+    static uint8_t shownState = STREAM_IDLE;
+    static int shownTokens = -1;
+
+    const TokenStream& stream = LLMEngine::getStream();
+    char fresh[LLM_SCREEN_TEXT + 1];
+    size_t n = stream.read(llmCursor, fresh, sizeof(fresh));
+    if (llmCursor.id != shownId) llmTextLen = 0;
+
+    // Keep the tail: drop the oldest text when the buffer is full
+    if (llmTextLen + n > LLM_SCREEN_TEXT) {
+        size_t drop = llmTextLen + n - LLM_SCREEN_TEXT;
+        if (drop > llmTextLen) drop = llmTextLen;
+        memmove(llmText, llmText + drop, llmTextLen - drop);
+        llmTextLen -= drop;
+    }
+    memcpy(llmText + llmTextLen, fresh, n);
+    llmTextLen += n;
+    llmText[llmTextLen] = '\0';
+
+    TokenStreamState state = stream.getState();
+    bool changed = n > 0 || llmCursor.id != shownId || state != shownState ||
+                   stream.getTokens() != shownTokens;
+    if (!changed && !fullRedraw) return;
+    shownId = llmCursor.id;
+    shownState = state;
+    shownTokens = stream.getTokens();
+    if (state == STREAM_IDLE) return;
+
+    tft.fillRect(x, y, w, h, colors.background);
+    tft.drawRoundRect(x, y, w, h, 8, colors.secondary);
+
+    // Status line: progress while running, first-text latency when done
+    tft.setTextColor(colors.accent, colors.background);
+    tft.setCursor(x + 8, y + 6);
+    if (state == STREAM_RUNNING) {
+        tft.printf("Generating... %d tok", stream.getTokens());
+    } else {
+        tft.printf("%s: %d tok, first text %u ms", TokenStream::getStateName(state),
+                   stream.getTokens(), (unsigned)stream.getFirstVisibleMs());
+    }
+
+    // Wrap at the panel width (6x8 font) and show the last lines that fit
+    int cols = (w - 16) / 6;
+    int rows = (h - 22) / 10;
+    if (cols <= 0 || rows <= 0) return;
+    if (rows > 32) rows = 32;
+
+    size_t lineStart[32];               // Ring of the latest line starts
+    int lineCount = 1;
+    lineStart[0] = 0;
+    int col = 0;
+    for (size_t i = 0; i < llmTextLen; i++) {
+        if (llmText[i] == '\n') {
+            lineStart[lineCount++ % 32] = i + 1;
+            col = 0;
+        } else if (++col > cols) {
+            lineStart[lineCount++ % 32] = i;
+            col = 1;
+        }
+    }
+    size_t start = lineStart[(lineCount > rows ? lineCount - rows : 0) % 32];
+
+    tft.setTextColor(colors.text, colors.background);
+    int row = 0;
+    col = 0;
+    for (size_t i = start; i < llmTextLen && row < rows; i++) {
+        char c = llmText[i];
+        if (c == '\n' || col >= cols) {
+            row++;
+            col = 0;
+            if (c == '\n') continue;
+            if (row >= rows) break;
+        }
+        if (c == '\r' || c == '\t') c = ' ';
+        tft.drawChar(x + 8 + col * 6, y + 20 + row * 10, c, colors.text, colors.background, 1);
+        col++;
+    }
 }
 
 // ============================================================
@@ -789,11 +884,27 @@ void UI::navigate(NavAction action) {
                     selectedIndex++;
                     needsFullRedraw = true;
                 }
+            } else if (action == NAV_SELECT) {
+                // Analyze with the model and watch the output arrive
+                auto& portals = Scanner::getPortals();
+                if (selectedIndex < (int)portals.size() &&
+                    LLMEngine::startAnalysis(portals[selectedIndex]->portalHtml)) {
+                    portals[selectedIndex]->analyzed = true;
+                    showScreen(SCREEN_LLM);
+                    return;
+                }
             }
             break;
 
-        case SCREEN_ENUM:
         case SCREEN_LLM:
+            if (action == NAV_BACK || action == NAV_LEFT) {
+                showScreen(SCREEN_MAIN);
+            } else if (action == NAV_SELECT) {
+                LLMEngine::cancel();
+            }
+            break;
+
+        case SCREEN_ENUM:
         case SCREEN_SETTINGS:
             if (action == NAV_BACK || action == NAV_LEFT) {
                 showScreen(SCREEN_MAIN);
@@ -117,6 +117,7 @@ private:
     static void drawPortalsScreen();
     static void drawEnumScreen();
     static void drawLLMScreen();
+    static void drawLLMStream(int x, int y, int w, int h, bool fullRedraw);
     static void drawNetworkDetailScreen();
     static void drawSettingsScreen();
 
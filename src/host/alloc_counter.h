@@ -0,0 +1,15 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <stdint.h>
+
+// Heap allocation counters for host tools. On glibc, malloc and friends
+// (and therefore operator new) are interposed and counted.
+class AllocCounter {
+public:
+    static bool supported();
+    static uint64_t count();   // Allocation calls since start
+    static uint64_t bytes();   // Bytes requested since start
+};
+
+#endif // ALLOC_COUNTER_H
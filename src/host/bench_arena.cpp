@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "commands.h"
+#include "alloc_counter.h"
+#include "portal_corpus.h"
+#include "synthetic_model.h"
+#include "config.h"
+#include "llm/arena_plan.h"
+#include "llm/generator.h"
+#include "llm/platform.h"
+
+static void phaseString(uint8_t phases, char* out) {
+    const char letters[] = "EAFO";
+    for (int i = 0; i < 4; i++) out[i] = phases & (1 << i) ? letters[i] : '.';
+    out[4] = '\0';
+}
+
+// No two buffers live in a common phase may overlap
+static bool planValid(const ArenaPlan& plan) {
+    for (int i = 0; i < plan.getCount(); i++) {
+        const ArenaBuffer& a = plan.getBuffer(i);
+        if (a.offset + a.bytes > plan.getSize() || a.offset % LLM_ALIGN != 0) return false;
+        for (int j = i + 1; j < plan.getCount(); j++) {
+            const ArenaBuffer& b = plan.getBuffer(j);
+            if ((a.phases & b.phases) && a.offset < b.offset + b.bytes &&
+                b.offset < a.offset + a.bytes) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// bench-arena [preset] [gen-tokens]
+int benchArena(int argc, char** argv) {
+    const char* presetName = argc > 1 ? argv[1] : "15m";
+    int genTokens = argc > 2 ? atoi(argv[2]) : 64;
+
+    const SyntheticPreset* preset = findSyntheticPreset(presetName);
+    if (!preset || genTokens <= 0 || genTokens > LLM_MAX_TOKENS) {
+        printf("Usage: bench-arena [preset] [gen-tokens <= %d]\nPresets:\n", LLM_MAX_TOKENS);
+        listSyntheticPresets();
+        return 1;
+    }
+
+    TransformerConfig config = preset->config;
+    std::vector<uint8_t> checkpoint = buildSyntheticCheckpoint(config, 42);
+    std::vector<CorpusPrompt> prompts = buildCorpusPrompts();
+    std::vector<std::string> corpus;
+    for (const auto& p : prompts) corpus.push_back(p.text);
+    std::vector<uint8_t> vocab = buildSyntheticTokenizer(config.vocabSize, corpus);
+
+    // LLMEngine's layout: one arena planned at load. The reference run
+    // gets the same buffers with no two sharing memory.
+    ArenaPlan plans[2];
+    Transformer models[2];
+    Tokenizer tokenizers[2];
+    Sampler samplers[2];
+    char* responses[2] = {nullptr, nullptr};
+    uint8_t* arenas[2] = {nullptr, nullptr};
+    for (int k = 0; k < 2; k++) {
+        ArenaPlan& plan = plans[k];
+        bool planned =
+            models[k].load(checkpoint.data(), checkpoint.size(), LLM_CONTEXT_SIZE, &plan) &&
+            tokenizers[k].load(vocab.data(), vocab.size(), config.vocabSize, &plan) &&
+            samplers[k].configure(config.vocabSize, LLM_TEMPERATURE, LLM_TOP_P, 1234, &plan) &&
+            plan.add("response", (void**)&responses[k], LLM_RESPONSE_BYTES, ARENA_ALWAYS);
+        size_t size = planned ? plan.plan(k == 0) : 0;
+        arenas[k] = planned ? (uint8_t*)llmAlloc(size) : nullptr;
+        if (!arenas[k]) {
+            printf("Arena setup failed: %s\n",
+                   models[k].getError() ? models[k].getError() : "out of memory");
+            if (arenas[0]) llmFree(arenas[0]);
+            return 1;
+        }
+        memset(arenas[k], 0, size);
+        plan.bind(arenas[k]);
+    }
+    const ArenaPlan& plan = plans[0];
+    size_t arenaSize = plan.getSize();
+
+    printf("Synthetic '%s' model, context %d (E encode, A attention, F feed-forward, "
+           "O output)\n\n", preset->name, models[0].getConfig().seqLen);
+    printf("  %-12s %10s %10s  %s\n", "buffer", "bytes", "offset", "live");
+    for (int i = 0; i < plan.getCount(); i++) {
+        const ArenaBuffer& b = plan.getBuffer(i);
+        char phases[5];
+        phaseString(b.phases, phases);
+        printf("  %-12s %10zu %10zu  %s\n", b.name, b.bytes, b.offset, phases);
+    }
+    size_t kv = models[0].getKvCacheSize();
+    printf("\nArena %.1f KB for %d buffers: %.1f KB without reuse, %.1f KB live in the "
+           "busiest phase\n(KV cache %.1f KB of it; scratch %.1f KB vs %.1f KB)\n\n",
+           arenaSize / 1024.0, plan.getCount(), plan.getUnsharedSize() / 1024.0,
+           plan.getPeakLive() / 1024.0, kv / 1024.0, (arenaSize - kv) / 1024.0,
+           (plan.getUnsharedSize() - kv) / 1024.0);
+
+    // Same prompts and sampler seed both ways, so the random streams stay
+    // in step; only the arena runs are counted (prompts are built first)
+    std::vector<std::string> texts;
+    for (int i = 0; i < portalSampleCount; i++) {
+        texts.push_back(buildAnalysisPrompt(portalSamples[i].html));
+    }
+
+    bool same = true;
+    uint64_t allocs = 0;
+    double ms[2] = {0, 0};
+    int tokens = 0;
+    for (size_t i = 0; i < texts.size(); i++) {
+        GenerateStats stats[2];
+        for (int k = 1; k >= 0; k--) {
+            uint64_t before = AllocCounter::count();
+            Generator::run(models[k], tokenizers[k], samplers[k], texts[i].c_str(), genTokens,
+                           responses[k], LLM_RESPONSE_BYTES, &stats[k]);
+            if (k == 0) allocs += AllocCounter::count() - before;
+            ms[k] += stats[k].totalUs / 1000.0;
+        }
+        same = same && strcmp(responses[0], responses[1]) == 0 &&
+               stats[0].generatedTokens == stats[1].generatedTokens;
+        tokens += stats[0].promptTokens + stats[0].generatedTokens;
+    }
+    printf("%zu prompts, %d positions: %.1f ms without reuse, %.1f ms from the planned arena\n",
+           texts.size(), tokens, ms[1], ms[0]);
+
+    bool valid = planValid(plan);
+    bool smaller = arenaSize < plan.getUnsharedSize();
+    printf("\nChecks: plan has no live overlaps %s, arena smaller than the buffers %s, "
+           "same text as without reuse %s", valid ? "ok" : "FAILED", smaller ? "ok" : "FAILED",
+           same ? "ok" : "FAILED");
+    if (AllocCounter::supported()) {
+        printf(", no allocations while generating %s", allocs == 0 ? "ok" : "FAILED");
+    }
+    printf("\n");
+
+    for (int k = 0; k < 2; k++) {
+        models[k].unload();
+        tokenizers[k].unload();
+        samplers[k].release();
+        llmFree(arenas[k]);
+    }
+    return valid && smaller && same && (allocs == 0 || !AllocCounter::supported()) ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <set>
+#include <string>
+#include <vector>
+#include "commands.h"
+#include "alloc_counter.h"
+#include "portal_corpus.h"
+#include "synthetic_model.h"
+#include "core/analysis_cache.h"
+#include "llm/generator.h"
+#include "llm/platform.h"
+
+// As in llm/engine.h (which needs Arduino)
+#define ANALYZER_MODEL ANALYZER_ID(2, 1)
+
+// The persisted tier in memory: what the SPIFFS file holds on the device
+struct MemoryStore {
+    std::vector<AnalysisRecord> slots;
+    int writes;
+};
+
+static bool readSlot(void* ctx, uint32_t slot, AnalysisRecord& out) {
+    out = ((MemoryStore*)ctx)->slots[slot];
+    return true;
+}
+
+static bool writeSlot(void* ctx, uint32_t slot, const AnalysisRecord& record) {
+    MemoryStore* store = (MemoryStore*)ctx;
+    store->slots[slot] = record;
+    store->writes++;
+    return true;
+}
+
+// More pages than RAM entries: the least recently used one goes first
+static bool checkEviction() {
+    AnalysisCache cache;
+    char out[16];
+    for (int i = 0; i < ANALYSIS_CACHE_MAX_ENTRIES; i++) {
+        cache.insert(i, ANALYZER_MODEL, "x", 1);
+    }
+    cache.lookup(0, ANALYZER_MODEL, out, sizeof(out));         // 0 is now the most recent
+    cache.insert(100, ANALYZER_MODEL, "y", 1);                 // Evicts 1
+    cache.insert(101, ANALYZER_MODEL, "z", 1);                 // Evicts 2
+
+    return cache.getEvictions() == 2 && cache.getCount() == ANALYSIS_CACHE_MAX_ENTRIES &&
+           cache.lookup(0, ANALYZER_MODEL, out, sizeof(out)) == 1 &&
+           cache.lookup(1, ANALYZER_MODEL, out, sizeof(out)) < 0 &&
+           cache.lookup(2, ANALYZER_MODEL, out, sizeof(out)) < 0 &&
+           cache.lookup(101, ANALYZER_MODEL, out, sizeof(out)) == 1;
+}
+
+// bench-cache [preset] [gen-tokens] [slots]
+int benchCache(int argc, char** argv) {
+    const char* presetName = argc > 1 ? argv[1] : "15m";
+    int genTokens = argc > 2 ? atoi(argv[2]) : 64;
+    int slots = argc > 3 ? atoi(argv[3]) : 32;
+
+    const SyntheticPreset* preset = findSyntheticPreset(presetName);
+    if (!preset || genTokens <= 0 || slots <= 0) {
+        printf("Usage: bench-cache [preset] [gen-tokens] [slots]\nPresets:\n");
+        listSyntheticPresets();
+        return 1;
+    }
+
+    TransformerConfig config = preset->config;
+    std::vector<uint8_t> checkpoint = buildSyntheticCheckpoint(config, 42);
+    std::vector<CorpusPrompt> prompts = buildCorpusPrompts();
+    std::vector<std::string> corpus;
+    for (const auto& p : prompts) corpus.push_back(p.text);
+    std::vector<uint8_t> vocab = buildSyntheticTokenizer(config.vocabSize, corpus);
+
+    Transformer model;
+    Tokenizer tokenizer;
+    Sampler sampler;
+    if (!model.load(checkpoint.data(), checkpoint.size()) ||
+        !tokenizer.load(vocab.data(), vocab.size(), config.vocabSize)) {
+        printf("Load failed: %s\n", model.getError());
+        return 1;
+    }
+    sampler.configure(config.vocabSize, 0.0f, 0.9f, 1234);
+
+    MemoryStore memory;
+    memory.slots.assign(slots, AnalysisRecord());
+    memset(memory.slots.data(), 0, slots * sizeof(AnalysisRecord));
+    memory.writes = 0;
+    AnalysisStore store = {&memory, (uint32_t)slots, readSlot, writeSlot};
+
+    AnalysisCache cache;
+    cache.setStore(&store);
+
+    printf("Synthetic '%s' model (random weights), %d generated tokens, %d store slots\n\n",
+           preset->name, genTokens, slots);
+    printf("%-11s %8s %12s %10s %10s %9s\n", "page", "chars", "analysis ms", "hash us",
+           "hit us", "speedup");
+
+    // First request: miss, digest + generation, result inserted. Repeat
+    // requests: hash the page and copy the result out.
+    const int iterations = 2000;
+    std::vector<char> out(genTokens * TOKENIZER_MAX_PIECE + 1);
+    char cached[ANALYSIS_CACHE_VALUE + 1];
+    std::vector<std::string> results;
+    std::set<uint32_t> usedSlots;
+    bool sameText = true;
+    uint64_t allocs = 0;
+    double analysisTotal = 0;
+    double hitTotal = 0;
+
+    for (int i = 0; i < portalSampleCount; i++) {
+        const char* html = portalSamples[i].html;
+        size_t len = strlen(html);
+
+        uint64_t start = llmMicros();
+        uint64_t hash = AnalysisCache::hashPage(html, len);
+        int missed = cache.lookup(hash, ANALYZER_MODEL, cached, sizeof(cached));
+        std::string prompt = buildAnalysisPrompt(html);
+        Generator::run(model, tokenizer, sampler, prompt.c_str(), genTokens, out.data(), out.size());
+        cache.insert(hash, ANALYZER_MODEL, out.data(), strlen(out.data()));
+        double analysisUs = (double)(llmMicros() - start);
+        results.push_back(out.data());
+        usedSlots.insert((uint32_t)(hash % slots));
+        sameText = sameText && missed < 0;
+
+        uint64_t before = AllocCounter::count();
+        start = llmMicros();
+        for (int j = 0; j < iterations; j++) {
+            hash = AnalysisCache::hashPage(html, len);
+        }
+        double hashUs = (double)(llmMicros() - start) / iterations;
+
+        start = llmMicros();
+        int n = 0;
+        for (int j = 0; j < iterations; j++) {
+            hash = AnalysisCache::hashPage(html, len);
+            n = cache.lookup(hash, ANALYZER_MODEL, cached, sizeof(cached));
+        }
+        double hitUs = (double)(llmMicros() - start) / iterations;
+        allocs += AllocCounter::count() - before;
+        sameText = sameText && n >= 0 && results.back() == cached;
+
+        analysisTotal += analysisUs;
+        hitTotal += hitUs;
+        printf("%-11s %8zu %12.1f %10.2f %10.2f %8.0fx\n", portalSamples[i].name, len,
+               analysisUs / 1000.0, hashUs, hitUs, analysisUs / hitUs);
+    }
+    printf("%-11s %8s %12.1f %10s %10.2f %8.0fx\n", "total", "", analysisTotal / 1000.0, "",
+           hitTotal, analysisTotal / hitTotal);
+    printf("\nCounters: %u hits, %u misses, %u evictions, %d entries, %d store writes\n",
+           cache.getHits(), cache.getMisses(), cache.getEvictions(), cache.getCount(),
+           memory.writes);
+
+    // After a restart: RAM is empty, results come back from the store
+    AnalysisCache restarted;
+    restarted.setStore(&store);
+    int restored = 0;
+    for (int i = 0; i < portalSampleCount; i++) {
+        const char* html = portalSamples[i].html;
+        uint64_t hash = AnalysisCache::hashPage(html, strlen(html));
+        if (restarted.lookup(hash, ANALYZER_MODEL, cached, sizeof(cached)) >= 0 &&
+            results[i] == cached) {
+            restored++;
+        }
+    }
+    // Pages sharing a slot keep only the last one written
+    bool persisted = restored == (int)usedSlots.size() &&
+                     restarted.getStoreHits() == (uint32_t)restored;
+    printf("After restart: %d of %d pages read back from the store (%zu distinct slots)\n",
+           restored, portalSampleCount, usedSlots.size());
+
+    // A damaged record or a newer analyzer version is a miss, never stale text
+    const char* html = portalSamples[0].html;
+    uint64_t hash = AnalysisCache::hashPage(html, strlen(html));
+    AnalysisCache fresh;
+    fresh.setStore(&store);
+    bool versioned = fresh.lookup(hash, ANALYZER_ID(2, 2), cached, sizeof(cached)) < 0;
+    memory.slots[hash % slots].value[0] ^= 0x20;
+    bool corruptRejected = fresh.lookup(hash, ANALYZER_MODEL, cached, sizeof(cached)) < 0;
+
+    bool evicts = checkEviction();
+
+    printf("\nChecks: cached text matches %s, LRU eviction %s, restored from store %s, "
+           "version bump misses %s, corrupt record rejected %s",
+           sameText ? "ok" : "FAILED", evicts ? "ok" : "FAILED", persisted ? "ok" : "FAILED",
+           versioned ? "ok" : "FAILED", corruptRejected ? "ok" : "FAILED");
+    if (AllocCounter::supported()) {
+        printf(", no allocations per hit %s", allocs == 0 ? "ok" : "FAILED");
+    }
+    printf("\n");
+    return sameText && evicts && persisted && versioned && corruptRejected &&
+           (allocs == 0 || !AllocCounter::supported()) ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "commands.h"
+#include "alloc_counter.h"
+#include "portal_corpus.h"
+#include "synthetic_model.h"
+#include "config.h"
+#include "core/portal_classifier.h"
+#include "core/portal_rules.h"
+#include "llm/generator.h"
+#include "llm/platform.h"
+
+// What each corpus page is (none of them is in the trainer's data)
+struct Expected {
+    const char* name;
+    const char* venue;
+    const char* auth;
+};
+
+static const Expected expected[] = {
+    {"hotel", "Hotel/Resort", "Room + surname"},
+    {"airport", "Airport", "Email"},
+    {"cafe", "Cafe/Restaurant", "Access code"},
+    {"conference", "Conference Center", "Access code"},
+    {"hospital", "Healthcare Facility", "Room + surname"},
+    {"resort", "Hotel/Resort", "Room + surname"},
+};
+
+static const Expected* expectedFor(const char* name) {
+    for (const auto& e : expected) {
+        if (strcmp(e.name, name) == 0) return &e;
+    }
+    return nullptr;
+}
+
+// bench-classifier [iterations] [preset] [gen-tokens]
+int benchClassifier(int argc, char** argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 2000;
+    const char* presetName = argc > 2 ? argv[2] : "15m";
+    int genTokens = argc > 3 ? atoi(argv[3]) : 64;
+
+    const SyntheticPreset* preset = findSyntheticPreset(presetName);
+    if (iterations <= 0 || !preset || genTokens <= 0) {
+        printf("Usage: bench-classifier [iterations] [preset] [gen-tokens]\nPresets:\n");
+        listSyntheticPresets();
+        return 1;
+    }
+
+    printf("Classifier: %d+%d classes, %zu weight bytes, threshold %.0f%%\n\n",
+           PortalClassifier::getVenueCount(), PortalClassifier::getAuthCount(),
+           PortalClassifier::getWeightBytes(), CLASSIFIER_MIN_CONFIDENCE * 100);
+
+    PortalRules rules;
+    rules.loadDefaults();
+
+    printf("%-11s %-20s %5s %-15s %5s %5s %9s %9s\n", "page", "venue", "conf", "login", "conf",
+           "ok", "class us", "rules us");
+    int correct = 0;
+    int confident = 0;
+    int confidentWrong = 0;
+    double classifyTotal = 0;
+    double rulesTotal = 0;
+    uint64_t allocs = 0;
+    std::vector<bool> skipped;
+    for (int i = 0; i < portalSampleCount; i++) {
+        const char* html = portalSamples[i].html;
+        size_t len = strlen(html);
+
+        ClassifierResult result;
+        uint64_t before = AllocCounter::count();
+        uint64_t start = llmMicros();
+        for (int n = 0; n < iterations; n++) PortalClassifier::classify(html, len, result);
+        double classifyUs = (double)(llmMicros() - start) / iterations;
+        allocs += AllocCounter::count() - before;
+
+        RuleMatch match;
+        start = llmMicros();
+        for (int n = 0; n < iterations; n++) rules.evaluate(html, len, match);
+        double rulesUs = (double)(llmMicros() - start) / iterations;
+
+        const char* venue = PortalClassifier::getVenueLabel(result.venue);
+        const char* auth = PortalClassifier::getAuthLabel(result.auth);
+        const Expected* want = expectedFor(portalSamples[i].name);
+        bool right = want && strcmp(venue, want->venue) == 0 && strcmp(auth, want->auth) == 0;
+        bool sure = PortalClassifier::isConfident(result);
+        correct += right;
+        confident += sure;
+        confidentWrong += sure && !right;
+        skipped.push_back(sure);
+        classifyTotal += classifyUs;
+        rulesTotal += rulesUs;
+
+        printf("%-11s %-20s %4.0f%% %-15s %4.0f%% %5s %9.1f %9.1f%s\n", portalSamples[i].name,
+               venue, result.venueConfidence * 100, auth, result.authConfidence * 100,
+               right ? "yes" : "NO", classifyUs, rulesUs, sure ? "  (model skipped)" : "");
+    }
+    printf("\nAccuracy %d/%d; %d confident (%d of them wrong), %.1f us per page vs %.1f us "
+           "for the rules\n", correct, portalSampleCount, confident, confidentWrong,
+           classifyTotal / portalSampleCount, rulesTotal / portalSampleCount);
+
+    // What the fast path saves: the model's pass over each page it skips
+    TransformerConfig config = preset->config;
+    std::vector<uint8_t> checkpoint = buildSyntheticCheckpoint(config, 42);
+    std::vector<CorpusPrompt> prompts = buildCorpusPrompts();
+    std::vector<std::string> corpus;
+    for (const auto& p : prompts) corpus.push_back(p.text);
+    std::vector<uint8_t> vocab = buildSyntheticTokenizer(config.vocabSize, corpus);
+    Transformer model;
+    Tokenizer tokenizer;
+    Sampler sampler;
+    if (!model.load(checkpoint.data(), checkpoint.size()) ||
+        !tokenizer.load(vocab.data(), vocab.size(), config.vocabSize)) {
+        printf("Load failed: %s\n", model.getError());
+        return 1;
+    }
+    sampler.configure(config.vocabSize, 0.0f, 0.9f, 1234);
+
+    std::vector<char> out(genTokens * TOKENIZER_MAX_PIECE + 1);
+    double modelMs = 0;
+    double savedMs = 0;
+    for (int i = 0; i < portalSampleCount; i++) {
+        std::string prompt = buildAnalysisPrompt(portalSamples[i].html);
+        GenerateStats stats;
+        Generator::run(model, tokenizer, sampler, prompt.c_str(), genTokens, out.data(),
+                       out.size(), &stats);
+        modelMs += stats.totalUs / 1000.0;
+        if (skipped[i]) savedMs += stats.totalUs / 1000.0;
+    }
+    printf("Synthetic '%s' model, %d tokens per answer: %.1f ms for all pages, %.1f ms of it "
+           "skipped by the fast path\n", preset->name, genTokens, modelMs, savedMs);
+
+    bool parity = PortalClassifier::checkFeatures();
+    bool trusted = confidentWrong == 0;
+    printf("\nChecks: features match the trainer %s, confident answers correct %s",
+           parity ? "ok" : "FAILED", trusted ? "ok" : "FAILED");
+    if (AllocCounter::supported()) {
+        printf(", no allocations %s", allocs == 0 ? "ok" : "FAILED");
+    }
+    printf("\n");
+    return parity && trusted && (allocs == 0 || !AllocCounter::supported()) ? 0 : 1;
+}
@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "commands.h"
+#include "alloc_counter.h"
+#include "portal_corpus.h"
+#include "synthetic_model.h"
+#include "llm/generator.h"
+#include "llm/html_digest.h"
+#include "llm/platform.h"
+#include "llm/prompts.h"
+
+// What buildAnalysisPrompt used before the digest: the first 2000
+// characters of HTML
+#define RAW_HTML_MAX 2000
+
+static std::string rawPrompt(const std::string& html) {
+    std::string page = html;
+    if (page.size() > RAW_HTML_MAX) page = page.substr(0, RAW_HTML_MAX) + "...[truncated]";
+    return std::string(PROMPT_ANALYSIS_PREFIX) + page + PROMPT_ANALYSIS_SUFFIX;
+}
+
+// Values of `attr` on every tag named `tag` (plain scan, enough for the corpus)
+static std::vector<std::string> attrValues(const std::string& html, const char* tag,
+                                           const char* attr) {
+    std::vector<std::string> out;
+    std::string open = std::string("<") + tag;
+    std::string key = std::string(attr) + "=\"";
+    for (size_t pos = html.find(open); pos != std::string::npos; pos = html.find(open, pos + 1)) {
+        size_t close = html.find('>', pos);
+        size_t at = html.find(key, pos);
+        if (at == std::string::npos || at > close) continue;
+        at += key.size();
+        out.push_back(html.substr(at, html.find('"', at) - at));
+    }
+    return out;
+}
+
+// Text of the <title> element, entities left as written
+static std::string titleOf(const std::string& html) {
+    size_t start = html.find("<title>");
+    size_t end = html.find("</title>");
+    if (start == std::string::npos || end == std::string::npos) return "";
+    start += 7;
+    return html.substr(start, end - start);
+}
+
+// bench-digest [budget] [preset] [context]
+int benchDigest(int argc, char** argv) {
+    int budget = argc > 1 ? atoi(argv[1]) : PROMPT_DIGEST_MAX;
+    const char* presetName = argc > 2 ? argv[2] : "15m";
+    int context = argc > 3 ? atoi(argv[3]) : 1024;
+
+    const SyntheticPreset* preset = findSyntheticPreset(presetName);
+    if (!preset || budget <= 0 || context <= 0) {
+        printf("Usage: bench-digest [budget] [preset] [context]\nPresets:\n");
+        listSyntheticPresets();
+        return 1;
+    }
+
+    // Digest every page; check what the analysis needs survives
+    HtmlDigest digest;
+    std::vector<char> page(budget + 1);
+    std::vector<std::string> raws;
+    std::vector<std::string> digests;
+    bool complete = true;
+    uint64_t allocs = 0;
+    double digestUs = 0;
+    const int iterations = 50;
+
+    printf("Page digests (budget %d chars):\n", budget);
+    for (int i = 0; i < portalSampleCount; i++) {
+        std::string html = portalSamples[i].html;
+        DigestStats stats;
+
+        uint64_t before = AllocCounter::count();
+        uint64_t start = llmMicros();
+        for (int j = 0; j < iterations; j++) {
+            digest.build(html.c_str(), html.size(), page.data(), page.size(), &stats);
+        }
+        double us = (double)(llmMicros() - start) / iterations;
+        allocs += AllocCounter::count() - before;
+        digestUs += us;
+
+        std::string text = page.data();
+        std::vector<std::string> missing;
+        std::string title = titleOf(html);
+        size_t amp = title.find("&amp;");
+        if (amp != std::string::npos) title.replace(amp, 5, "&");
+        if (!title.empty() && text.find(title) == std::string::npos) missing.push_back("title");
+        std::string raw = rawPrompt(html);
+        int named = 0;
+        int rawKept = 0;
+        for (const char* tag : {"input", "select", "textarea"}) {
+            for (const auto& name : attrValues(html, tag, "name")) {
+                named++;
+                if (text.find(" " + name) == std::string::npos) missing.push_back(name);
+                if (raw.find("\"" + name + "\"") != std::string::npos) rawKept++;
+            }
+        }
+        complete = complete && missing.empty();
+
+        printf("  %-11s %5zu -> %4zu chars, %d forms, %2d fields, %5.1f us, raw prompt keeps %d/%d names%s",
+               portalSamples[i].name, stats.inputBytes, stats.outputBytes, stats.forms, stats.fields,
+               us, rawKept, named, stats.truncated ? ", truncated" : "");
+        for (const auto& m : missing) printf(", MISSING %s", m.c_str());
+        printf("\n");
+
+        raws.push_back(raw);
+        digests.push_back(std::string(PROMPT_ANALYSIS_PREFIX) + text + PROMPT_ANALYSIS_SUFFIX);
+    }
+
+    printf("\nDigest of the '%s' page:\n%s\n\n", portalSamples[portalSampleCount - 1].name,
+           page.data());
+
+    // Prefill cost of each prompt form on a synthetic model whose
+    // vocabulary was learned from both
+    TransformerConfig config = preset->config;
+    config.seqLen = context;
+    std::vector<uint8_t> checkpoint = buildSyntheticCheckpoint(config, 42);
+    std::vector<std::string> corpus = raws;
+    corpus.insert(corpus.end(), digests.begin(), digests.end());
+    std::vector<uint8_t> vocab = buildSyntheticTokenizer(config.vocabSize, corpus);
+
+    Transformer model;
+    Tokenizer tokenizer;
+    Sampler sampler;
+    if (!model.load(checkpoint.data(), checkpoint.size()) ||
+        !tokenizer.load(vocab.data(), vocab.size(), config.vocabSize)) {
+        printf("Load failed: %s\n", model.getError());
+        return 1;
+    }
+    sampler.configure(config.vocabSize, 0.0f, 0.9f, 1234);
+
+    printf("Synthetic '%s' model (random weights), context %d, BPE vocabulary from both prompt forms\n\n",
+           preset->name, context);
+    printf("%-11s %10s %10s %10s %10s %11s %11s %8s\n", "page", "raw chars", "dig chars",
+           "raw tok", "dig tok", "raw TTFT ms", "dig TTFT ms", "speedup");
+
+    double rawTotal = 0;
+    double digestTotal = 0;
+    int rawTokens = 0;
+    int digestTokens = 0;
+    for (int i = 0; i < portalSampleCount; i++) {
+        char out[64];
+        GenerateStats raw;
+        GenerateStats dig;
+        Generator::run(model, tokenizer, sampler, raws[i].c_str(), 1, out, sizeof(out), &raw);
+        Generator::run(model, tokenizer, sampler, digests[i].c_str(), 1, out, sizeof(out), &dig);
+
+        rawTotal += raw.firstTokenUs;
+        digestTotal += dig.firstTokenUs;
+        rawTokens += raw.promptTokens;
+        digestTokens += dig.promptTokens;
+        printf("%-11s %10zu %10zu %10d %10d %11.1f %11.1f %7.2fx\n", portalSamples[i].name,
+               raws[i].size(), digests[i].size(), raw.promptTokens, dig.promptTokens,
+               raw.firstTokenUs / 1000.0, dig.firstTokenUs / 1000.0,
+               (double)raw.firstTokenUs / dig.firstTokenUs);
+    }
+    printf("%-11s %10s %10s %10d %10d %11.1f %11.1f %7.2fx\n", "total", "", "", rawTokens,
+           digestTokens, rawTotal / 1000.0, digestTotal / 1000.0, rawTotal / digestTotal);
+    printf("\nDigest build: %.1f us per page on average\n", digestUs / portalSampleCount);
+
+    printf("\nChecks: title and every field name kept %s", complete ? "ok" : "FAILED");
+    if (AllocCounter::supported()) {
+        printf(", no allocations per digest %s", allocs == 0 ? "ok" : "FAILED");
+    }
+    printf("\n");
+    return complete && (allocs == 0 || !AllocCounter::supported()) ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "commands.h"
+#include "alloc_counter.h"
+#include "core/candidates.h"
+#include "core/form_template.h"
+
+// Typical hotel login form: hidden token, room, surname, first name, terms
+struct BenchField {
+    const char* name;
+    int kind;  // 0 = static value, 1 = room, 2 = name
+    const char* value;
+};
+
+static const BenchField benchFields[] = {
+    {"csrf_token", 0, "f3a9c2d1e8b7"},
+    {"room_number", 1, nullptr},
+    {"last_name", 2, nullptr},
+    {"first_name", 0, "Guest"},
+    {"accept_terms", 0, "on"},
+    {"lang", 0, ""}
+};
+
+static const char* const benchNames[] = {
+    "Smith", "Johnson", "O'Brien", "Garcia", "van der Berg"
+};
+
+// Per-attempt String-style concatenation, as buildPostData used to do
+static std::string concatBody(const char* room, const char* name) {
+    std::string data = "";
+    for (const auto& f : benchFields) {
+        if (data.length() > 0) data += "&";
+        data += std::string(f.name) + "=";
+        if (f.kind == 1) data += room;
+        else if (f.kind == 2) data += name;
+        else data += f.value;
+    }
+    return data;
+}
+
+int benchForm(int argc, char** argv) {
+    long iterations = argc > 1 ? atol(argv[1]) : 200000;
+
+    CandidateSpec spec;
+    CandidateGen::parse("%F%2R:1-40:1-60", spec);
+    uint32_t rooms = CandidateGen::count(spec);
+    const uint32_t names = sizeof(benchNames) / sizeof(benchNames[0]);
+
+    FormTemplate form;
+    for (const auto& f : benchFields) {
+        if (f.kind == 1) form.addSlot(f.name, SLOT_ROOM);
+        else if (f.kind == 2) form.addSlot(f.name, SLOT_NAME);
+        else form.addStatic(f.name, f.value);
+    }
+
+    // Compiled template
+    size_t checksum = 0;
+    uint64_t allocsBefore = AllocCounter::count();
+    auto t0 = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++) {
+        char room[CANDIDATE_MAX_LEN];
+        CandidateGen::at(spec, i % rooms, room, sizeof(room));
+
+        size_t len;
+        const char* body = form.fill(room, benchNames[i % names], &len);
+        checksum += len + (body ? body[len - 1] : 0);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    uint64_t templateAllocs = AllocCounter::count() - allocsBefore;
+
+    // Concatenation baseline
+    allocsBefore = AllocCounter::count();
+    auto t2 = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++) {
+        char room[CANDIDATE_MAX_LEN];
+        CandidateGen::at(spec, i % rooms, room, sizeof(room));
+
+        std::string body = concatBody(room, benchNames[i % names]);
+        checksum += body.length();
+    }
+    auto t3 = std::chrono::steady_clock::now();
+    uint64_t concatAllocs = AllocCounter::count() - allocsBefore;
+
+    double templateNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+    double concatNs = std::chrono::duration<double, std::nano>(t3 - t2).count() / iterations;
+
+    size_t sampleLen;
+    printf("Sample body: %s\n", form.fill("1207", "O'Brien", &sampleLen));
+    printf("Iterations:  %ld (checksum %zu)\n\n", iterations, checksum);
+    printf("%-14s %12s %16s\n", "builder", "ns/attempt", "allocs/attempt");
+    printf("%-14s %12.1f %16.3f\n", "template", templateNs, (double)templateAllocs / iterations);
+    printf("%-14s %12.1f %16.3f\n", "concatenation", concatNs, (double)concatAllocs / iterations);
+
+    if (!AllocCounter::supported()) {
+        printf("\n(allocation counting unavailable on this platform)\n");
+    }
+
+    return templateAllocs == 0 ? 0 : 1;
+}
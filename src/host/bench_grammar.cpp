@@ -0,0 +1,289 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "commands.h"
+#include "alloc_counter.h"
+#include "portal_corpus.h"
+#include "synthetic_model.h"
+#include "llm/generator.h"
+#include "llm/job_queue.h"
+#include "llm/json_grammar.h"
+#include "llm/platform.h"
+
+// Answers of the analysis schema, for the synthetic vocabulary (a real one
+// has pieces for JSON punctuation too) and the parse checks
+static const char* const sampleAnswers[] = {
+    "{\"venueName\":\"Grand Plaza Hotel\",\"venueType\":\"Hotel/Resort\",\"estimatedRooms\":240,"
+    "\"formFields\":[\"Room Number\",\"Last Name\"],\"securityIssues\":[\"Form submits over HTTP\"],"
+    "\"recommendations\":[\"Try room numbers 101-999\"]}",
+    "{\"venueName\":\"SkyPort Lounge\",\"venueType\":\"Airport\",\"estimatedRooms\":0,"
+    "\"formFields\":[\"Email Address\"],\"securityIssues\":[],\"recommendations\":[]}",
+    "{\"venueName\":\"\",\"venueType\":\"Unknown\",\"estimatedRooms\":0,\"formFields\":[],"
+    "\"securityIssues\":[],\"recommendations\":[]}",
+};
+
+struct Values {
+    int count;
+    std::string name;
+    std::string type;
+    std::string rooms;
+    std::vector<std::string> fields;
+};
+
+static void collect(void* ctx, int member, int, const char* text, size_t len) {
+    Values& v = *(Values*)ctx;
+    v.count++;
+    std::string value(text, len);
+    if (member == 0) v.name = value;
+    if (member == 1) v.type = value;
+    if (member == 2) v.rooms = value;
+    if (member == 3) v.fields.push_back(value);
+}
+
+// Id of the one-character token for c (a plain piece or a byte token)
+static int charToken(const Tokenizer& tokenizer, char c) {
+    int id = tokenizer.lookup(&c, 1);
+    if (id >= 0) return id;
+    char name[8];
+    snprintf(name, sizeof(name), "<0x%02X>", (uint8_t)c);
+    return tokenizer.lookup(name, strlen(name));
+}
+
+// LLMEngine's job kinds: an analysis job carries the page, and the worker
+// builds the prompt and constrains the answer; a prompt job runs free
+enum { KIND_ANALYSIS, KIND_PROMPT };
+
+struct AnalysisWorker {
+    InferenceQueue* queue;
+    Transformer* model;
+    Tokenizer* tokenizer;
+    Sampler* sampler;
+    JsonGrammar* grammar;
+
+    // LLMEngine::runJob() and generate()
+    void run() {
+        InferenceJob job;
+        std::vector<char> out;
+        std::string tail(GRAMMAR_TEXT_MAX + 4 * GRAMMAR_MAX_OPS, '\0');
+        while (queue->next(job)) {
+            bool analysis = job.kind == KIND_ANALYSIS;
+            std::string prompt = analysis ? buildAnalysisPrompt(job.input.c_str()) : job.input;
+            JsonGrammar* constraint = analysis ? grammar : nullptr;
+            out.assign(job.maxTokens * TOKENIZER_MAX_PIECE + tail.size() + 1, '\0');
+            size_t len = Generator::run(*model, *tokenizer, *sampler, prompt.c_str(), job.maxTokens,
+                                        out.data(), out.size(), nullptr, nullptr, constraint);
+            if (constraint && !constraint->isComplete()) {
+                size_t n = constraint->finish(&tail[0], tail.size());
+                memcpy(out.data() + len, tail.data(), n + 1);
+                len += n;
+            }
+            queue->complete(job.id, out.data(), len, false);
+        }
+    }
+};
+
+// Average mask() time over the states the automaton passes through
+// while reading `text`, one character per step
+static double maskUs(JsonGrammar& grammar, const Tokenizer& tokenizer, const std::string& text,
+                     int vocabSize, int* allowedMin) {
+    std::vector<float> logits(vocabSize);
+    uint64_t total = 0;
+    int steps = 0;
+    *allowedMin = vocabSize;
+    grammar.reset();
+    for (char c : text) {
+        for (int i = 0; i < vocabSize; i++) logits[i] = (float)(i % 97);
+        uint64_t start = llmMicros();
+        grammar.mask(logits.data());
+        total += llmMicros() - start;
+        steps++;
+
+        int allowed = 0;
+        for (int i = 0; i < vocabSize; i++) allowed += !isinf(logits[i]);
+        if (allowed < *allowedMin) *allowedMin = allowed;
+        if (!grammar.advance(charToken(tokenizer, c))) return -1;
+    }
+    return steps > 0 ? (double)total / steps : 0;
+}
+
+// bench-grammar [preset] [gen-tokens]
+int benchGrammar(int argc, char** argv) {
+    const char* presetName = argc > 1 ? argv[1] : "15m";
+    int genTokens = argc > 2 ? atoi(argv[2]) : 256;
+
+    const SyntheticPreset* preset = findSyntheticPreset(presetName);
+    if (!preset || genTokens <= 0) {
+        printf("Usage: bench-grammar [preset] [gen-tokens]\nPresets:\n");
+        listSyntheticPresets();
+        return 1;
+    }
+
+    TransformerConfig config = preset->config;
+    std::vector<uint8_t> checkpoint = buildSyntheticCheckpoint(config, 42);
+    std::vector<CorpusPrompt> prompts = buildCorpusPrompts();
+    std::vector<std::string> corpus;
+    for (const auto& p : prompts) corpus.push_back(p.text);
+    for (const char* answer : sampleAnswers) corpus.push_back(answer);
+    std::vector<uint8_t> vocab = buildSyntheticTokenizer(config.vocabSize, corpus);
+
+    Transformer model;
+    Tokenizer tokenizer;
+    Sampler sampler;
+    if (!model.load(checkpoint.data(), checkpoint.size()) ||
+        !tokenizer.load(vocab.data(), vocab.size(), config.vocabSize)) {
+        printf("Load failed: %s\n", model.getError());
+        return 1;
+    }
+    sampler.configure(config.vocabSize, 0.7f, 0.9f, 1234);
+
+    PortalRules rules;
+    rules.loadDefaults();
+    JsonGrammar grammar;
+    buildAnalysisGrammar(grammar, rules);
+    if (!grammar.bind(tokenizer)) {
+        printf("Grammar bind failed\n");
+        return 1;
+    }
+
+    printf("Synthetic '%s' model (random weights), vocab %d, up to %d tokens per answer\n",
+           preset->name, config.vocabSize, genTokens);
+    printf("Schema: %d members, %zu table bytes\n\n", grammar.getMemberCount(),
+           grammar.getTableSize());
+    printf("%-11s %12s %12s %8s %12s %12s %8s\n", "page", "free tokens", "free ms",
+           "parses", "JSON tokens", "JSON ms", "parses");
+
+    std::vector<char> out(genTokens * TOKENIZER_MAX_PIECE + GRAMMAR_TEXT_MAX + 1);
+    std::string tail(GRAMMAR_TEXT_MAX + 4 * GRAMMAR_MAX_OPS, '\0');
+    bool allParse = true;
+    int freeParsed = 0;
+    int freeTokens = 0;
+    int jsonTokens = 0;
+    double freeMs = 0;
+    double jsonMs = 0;
+    uint64_t allocs = 0;
+    double decodeUsPerToken = 0;
+    std::string lastAnswer;
+
+    for (int i = 0; i < portalSampleCount; i++) {
+        std::string prompt = buildAnalysisPrompt(portalSamples[i].html);
+
+        GenerateStats free;
+        Generator::run(model, tokenizer, sampler, prompt.c_str(), genTokens, out.data(),
+                       out.size(), &free);
+        bool freeParses = grammar.parse(out.data(), strlen(out.data()), nullptr, nullptr);
+        freeParsed += freeParses;
+        if (free.decodeTokensPerSec() > 0) decodeUsPerToken = 1e6 / free.decodeTokensPerSec();
+
+        // What LLMEngine::generate() does: constrained run, closed if cut off
+        GenerateStats json;
+        uint64_t before = AllocCounter::count();
+        size_t len = Generator::run(model, tokenizer, sampler, prompt.c_str(), genTokens,
+                                    out.data(), out.size(), &json, nullptr, &grammar);
+        if (!grammar.isComplete()) {
+            size_t n = grammar.finish(&tail[0], tail.size());
+            memcpy(out.data() + len, tail.data(), n + 1);
+            len += n;
+        }
+        allocs += AllocCounter::count() - before;
+
+        Values values = {};
+        bool parses = grammar.parse(out.data(), len, collect, &values);
+        allParse = allParse && parses;
+        lastAnswer.assign(out.data(), len);
+
+        freeTokens += free.generatedTokens;
+        jsonTokens += json.generatedTokens;
+        freeMs += free.totalUs / 1000.0;
+        jsonMs += json.totalUs / 1000.0;
+        printf("%-11s %12d %12.1f %8s %12d %12.1f %8s\n", portalSamples[i].name,
+               free.generatedTokens, free.totalUs / 1000.0, freeParses ? "yes" : "no",
+               json.generatedTokens, json.totalUs / 1000.0, parses ? "yes" : "NO");
+    }
+    printf("%-11s %12d %12.1f %8d %12d %12.1f %8s\n", "total", freeTokens, freeMs, freeParsed,
+           jsonTokens, jsonMs, allParse ? "all" : "NOT ALL");
+    printf("Free text runs until EOS or the limit; a constrained answer ends when its object "
+           "closes (at most the schema's bounds)\n");
+    printf("\nLast constrained answer (random weights, so the values are noise):\n%s\n",
+           lastAnswer.c_str());
+
+    // Per-step cost of masking, against a forward pass
+    int allowedMin = 0;
+    double stepUs = maskUs(grammar, tokenizer, sampleAnswers[0], config.vocabSize, &allowedMin);
+    printf("\nMask: %.1f us per step over %d tokens (a decode step is %.0f us), "
+           "at least %d token(s) allowed at every step\n",
+           stepUs, config.vocabSize, decodeUsPerToken, allowedMin);
+
+    // The blocking entry point (LLMEngine::analyzePortalHTML): the page is
+    // queued as an analysis job and waited for, so its answer is
+    // constrained like a streamed one and fills the structured fields
+    InferenceQueue queue;
+    AnalysisWorker worker = {&queue, &model, &tokenizer, &sampler, &grammar};
+    std::thread thread(&AnalysisWorker::run, &worker);
+    bool blockingParses = true;
+    for (int i = 0; i < portalSampleCount && i < 2; i++) {
+        const char* html = portalSamples[i].html;
+        uint32_t id = queue.submit(i + 1, KIND_ANALYSIS, JOB_INTERACTIVE, html, strlen(html),
+                                   genTokens, true);
+        std::string answer;
+        Values values = {};
+        blockingParses = blockingParses && id && queue.wait(id, answer, 600000) &&
+                         grammar.parse(answer.data(), answer.size(), collect, &values) &&
+                         values.count > 0;
+    }
+    queue.close();
+    thread.join();
+    printf("\nBlocking analysis (queued page, waited for): answers %s\n",
+           blockingParses ? "parse" : "DO NOT PARSE");
+
+    // Cut off early, the answer is closed and still parses
+    GenerateStats cut;
+    size_t len = Generator::run(model, tokenizer, sampler, prompts[0].text.c_str(), 12,
+                                out.data(), out.size(), &cut, nullptr, &grammar);
+    bool wasOpen = !grammar.isComplete();
+    size_t n = grammar.finish(&tail[0], tail.size());
+    std::string closed = std::string(out.data(), len) + tail.substr(0, n);
+    bool truncated = wasOpen && grammar.isComplete() &&
+                     grammar.parse(closed.data(), closed.size(), nullptr, nullptr);
+    printf("Cut off after %d tokens and closed: %s\n", cut.generatedTokens, closed.c_str());
+
+    // Hand-written answers parse with their values; near misses don't
+    Values values = {};
+    bool reads = grammar.parse(sampleAnswers[0], strlen(sampleAnswers[0]), collect, &values) &&
+                 values.name == "Grand Plaza Hotel" && values.type == "Hotel/Resort" &&
+                 values.rooms == "240" && values.fields.size() == 2 &&
+                 values.fields[1] == "Last Name";
+    for (const char* answer : sampleAnswers) {
+        reads = reads && grammar.parse(answer, strlen(answer), nullptr, nullptr);
+    }
+    static const char* const invalid[] = {
+        "{\"venueName\":\"Cafe\",\"venueType\":\"Casino\",\"estimatedRooms\":0,\"formFields\":[],"
+        "\"securityIssues\":[],\"recommendations\":[]}",                          // Not a venue label
+        "{\"venueName\":\"Cafe\",\"venueType\":\"Unknown\",\"estimatedRooms\":007,\"formFields\":[],"
+        "\"securityIssues\":[],\"recommendations\":[]}",                          // Leading zeros
+        "{\"venueName\":\"Cafe\", \"venueType\":\"Unknown\",\"estimatedRooms\":0,\"formFields\":[],"
+        "\"securityIssues\":[],\"recommendations\":[]}",                          // Whitespace
+        "{\"venueName\":\"Cafe\",\"venueType\":\"Unknown\",\"estimatedRooms\":0,\"formFields\":[],"
+        "\"securityIssues\":[],\"recommendations\":[]",                           // Not closed
+        "{\"venueName\":\"A very long venue name that goes on and on and on\",\"venueType\":"
+        "\"Unknown\",\"estimatedRooms\":0,\"formFields\":[],\"securityIssues\":[],"
+        "\"recommendations\":[]}",                                                // Too long
+        "Venue: Grand Plaza Hotel (Hotel/Resort)",                                // Free text
+    };
+    bool rejects = true;
+    for (const char* text : invalid) rejects = rejects && !grammar.parse(text, strlen(text), nullptr, nullptr);
+
+    printf("\nChecks: constrained answers parse %s, blocking analyses parse %s, "
+           "cut-off answers close %s, values read %s, malformed answers rejected %s",
+           allParse ? "ok" : "FAILED", blockingParses ? "ok" : "FAILED",
+           truncated ? "ok" : "FAILED", reads ? "ok" : "FAILED", rejects ? "ok" : "FAILED");
+    if (AllocCounter::supported()) {
+        printf(", no allocations while constrained %s", allocs == 0 ? "ok" : "FAILED");
+    }
+    printf("\n");
+    return allParse && blockingParses && truncated && reads && rejects && stepUs >= 0 && allowedMin > 0 &&
+           (allocs == 0 || !AllocCounter::supported()) ? 0 : 1;
+}
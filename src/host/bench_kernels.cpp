@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "commands.h"
+#include "llm/kernels.h"
+#include "llm/platform.h"
+
+struct MatvecShape {
+    const char* name;
+    int n;
+    int d;
+    int groupSize;
+};
+
+// Matmuls of the 15M stories model and of TinyLlama
+static const MatvecShape benchShapes[] = {
+    {"15m wq", 288, 288, 32},
+    {"15m w1", 288, 768, 32},
+    {"15m w2", 768, 288, 32},
+    {"15m classifier", 288, 32000, 32},
+    {"tinyllama wq", 2048, 2048, 64},
+    {"tinyllama w1", 2048, 5632, 64},
+    {"tinyllama w2", 5632, 2048, 64},
+};
+
+// Bit-exactness shapes, including group sizes that leave AVX2/PIE tails
+static const MatvecShape checkShapes[] = {
+    {"", 64, 7, 32}, {"", 96, 33, 32}, {"", 48, 5, 16}, {"", 40, 3, 8},
+    {"", 288, 64, 32}, {"", 256, 17, 64}, {"", 24, 9, 24}, {"", 2048, 8, 128},
+};
+
+static uint32_t rngState = 12345;
+
+static uint32_t nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+// Matvec inputs with the full int8 range (-128 included) for weights
+struct MatvecData {
+    std::vector<int8_t> wq;
+    std::vector<uint8_t> w4;
+    std::vector<float> ws;
+    int8_t* xq;
+    float* xs;
+    float* out;
+
+    MatvecData(const MatvecShape& s) : wq((size_t)s.n * s.d), w4((size_t)s.n * s.d / 2),
+                                       ws((size_t)s.n * s.d / s.groupSize) {
+        // Activations in aligned buffers, as in the model arena
+        xq = (int8_t*)llmAlloc(s.n);
+        xs = (float*)llmAlloc(s.n / s.groupSize * sizeof(float));
+        out = (float*)llmAlloc(s.d * sizeof(float));
+
+        std::vector<float> x(s.n);
+        for (auto& v : x) v = ((int)(nextRandom() % 2001) - 1000) / 250.0f;
+        Kernels::quantizeQ8(xq, xs, x.data(), s.n, s.groupSize);
+
+        for (auto& w : wq) w = (int8_t)(nextRandom() & 0xFF);
+        for (auto& w : ws) w = (nextRandom() % 1000 + 1) / 100000.0f;
+
+        if (s.groupSize % KERNEL_Q4_BLOCK == 0) {
+            std::vector<int8_t> nibbles(wq.size());
+            for (auto& v : nibbles) v = (int8_t)(nextRandom() % 16) - 8;
+            Kernels::packQ4(w4.data(), nibbles.data(), nibbles.size());
+        }
+    }
+
+    ~MatvecData() {
+        llmFree(xq);
+        llmFree(xs);
+        llmFree(out);
+    }
+};
+
+static bool checkKernel(const MatvecKernels& k) {
+    const MatvecKernels& ref = Kernels::scalar();
+    bool ok = true;
+
+    for (int n = 0; n <= 80 && ok; n++) {
+        std::vector<int8_t> a(n), b(n);
+        for (int i = 0; i < n; i++) {
+            a[i] = (int8_t)(nextRandom() & 0xFF);
+            b[i] = (int8_t)(nextRandom() & 0xFF);
+        }
+        ok = k.dotQ8(a.data(), b.data(), n) == ref.dotQ8(a.data(), b.data(), n);
+    }
+
+    for (const auto& shape : checkShapes) {
+        MatvecData data(shape);
+        std::vector<float> expected(shape.d);
+
+        ref.matvecQ8(expected.data(), data.xq, data.xs, data.wq.data(), data.ws.data(),
+                     shape.n, shape.d, shape.groupSize);
+        k.matvecQ8(data.out, data.xq, data.xs, data.wq.data(), data.ws.data(),
+                   shape.n, shape.d, shape.groupSize);
+        ok = ok && memcmp(expected.data(), data.out, shape.d * sizeof(float)) == 0;
+
+        if (shape.groupSize % KERNEL_Q4_BLOCK != 0) continue;
+        ref.matvecQ4(expected.data(), data.xq, data.xs, data.w4.data(), data.ws.data(),
+                     shape.n, shape.d, shape.groupSize);
+        k.matvecQ4(data.out, data.xq, data.xs, data.w4.data(), data.ws.data(),
+                   shape.n, shape.d, shape.groupSize);
+        ok = ok && memcmp(expected.data(), data.out, shape.d * sizeof(float)) == 0;
+    }
+    return ok;
+}
+
+// Average microseconds per call over `iterations` calls
+template <typename Fn>
+static double timeCalls(int iterations, Fn fn) {
+    fn();  // Warm caches
+    uint64_t start = llmMicros();
+    for (int i = 0; i < iterations; i++) fn();
+    return (double)(llmMicros() - start) / iterations;
+}
+
+// bench-kernels [iterations]
+int benchKernels(int argc, char** argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 20;
+    if (iterations <= 0) iterations = 20;
+
+    printf("Kernels:");
+    for (int i = 0; i < Kernels::count(); i++) printf(" %s", Kernels::get(i).name);
+    printf(" (active: %s)\n\n", Kernels::active().name);
+
+    bool allExact = true;
+    for (int i = 1; i < Kernels::count(); i++) {
+        bool exact = checkKernel(Kernels::get(i));
+        printf("Bit-exact vs scalar: %-8s %s\n", Kernels::get(i).name, exact ? "ok" : "FAILED");
+        allExact = allExact && exact;
+    }
+    if (Kernels::count() > 1) printf("\n");
+
+    printf("%-16s %-8s %6s %10s %10s %11s %8s\n",
+           "shape", "kernel", "type", "us/call", "GOP/s", "weight GB/s", "speedup");
+    for (const auto& shape : benchShapes) {
+        MatvecData data(shape);
+        double ops = 2.0 * shape.n * shape.d;
+
+        for (int q4 = 0; q4 < 2; q4++) {
+            double scalarUs = 0;
+            for (int i = 0; i < Kernels::count(); i++) {
+                const MatvecKernels& k = Kernels::get(i);
+                double us = q4 ? timeCalls(iterations, [&]() {
+                    k.matvecQ4(data.out, data.xq, data.xs, data.w4.data(), data.ws.data(),
+                               shape.n, shape.d, shape.groupSize);
+                }) : timeCalls(iterations, [&]() {
+                    k.matvecQ8(data.out, data.xq, data.xs, data.wq.data(), data.ws.data(),
+                               shape.n, shape.d, shape.groupSize);
+                });
+                if (i == 0) scalarUs = us;
+
+                double weightBytes = q4 ? data.w4.size() : data.wq.size();
+                weightBytes += data.ws.size() * sizeof(float);
+                printf("%-16s %-8s %6s %10.1f %10.2f %11.2f %7.1fx\n",
+                       shape.name, k.name, q4 ? "q4" : "q8", us, ops / us / 1000.0,
+                       weightBytes / us / 1000.0, scalarUs / us);
+            }
+        }
+    }
+
+    printf("\nChecks: %s\n", allExact ? "all kernels bit-exact" : "MISMATCH");
+    return allExact ? 0 : 1;
+}
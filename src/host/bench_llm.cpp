@@ -0,0 +1,125 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "commands.h"
+#include "synthetic_model.h"
+#include "llm/generator.h"
+
+static bool readFile(const char* path, std::vector<uint8_t>& out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    out.resize(size > 0 ? size : 0);
+    bool ok = size > 0 && fread(out.data(), 1, size, f) == (size_t)size;
+    fclose(f);
+    return ok;
+}
+
+static void printConfig(const TransformerConfig& c, size_t weightBytes, const Transformer& model) {
+    printf("Model: dim %d, hidden %d, %d layers, %d/%d heads, vocab %d, ctx %d, group %d\n",
+           c.dim, c.hiddenDim, c.nLayers, c.nHeads, c.nKvHeads, c.vocabSize, c.seqLen, c.groupSize);
+    printf("Weights %.1f MB, activation arena %.1f KB (KV cache %.1f KB)\n\n",
+           weightBytes / 1048576.0, model.getArenaSize() / 1024.0, model.getKvCacheSize() / 1024.0);
+}
+
+// bench-llm [preset|model.bin] [prompt-tokens] [gen-tokens] [tokenizer.bin "prompt"]
+int benchLlm(int argc, char** argv) {
+    const char* source = argc > 1 ? argv[1] : "15m";
+    int promptTokens = argc > 2 ? atoi(argv[2]) : 64;
+    int genTokens = argc > 3 ? atoi(argv[3]) : 64;
+    const char* tokenizerPath = argc > 4 ? argv[4] : nullptr;
+    const char* promptText = argc > 5 ? argv[5] : "Once upon a time";
+
+    if (promptTokens <= 0 || genTokens <= 0) {
+        printf("Usage: bench-llm [preset|model.bin] [prompt-tokens] [gen-tokens] "
+               "[tokenizer.bin \"prompt\"]\nPresets:\n");
+        listSyntheticPresets();
+        return 1;
+    }
+
+    std::vector<uint8_t> checkpoint;
+    const SyntheticPreset* preset = findSyntheticPreset(source);
+    if (preset) {
+        printf("Synthetic '%s' checkpoint (random weights)\n", preset->name);
+        checkpoint = buildSyntheticCheckpoint(preset->config, 42);
+    } else if (!readFile(source, checkpoint)) {
+        printf("Cannot read %s (or unknown preset). Presets:\n", source);
+        listSyntheticPresets();
+        return 1;
+    }
+
+    Transformer model;
+    if (!model.load(checkpoint.data(), checkpoint.size())) {
+        printf("Load failed: %s\n", model.getError());
+        return 1;
+    }
+    const TransformerConfig& c = model.getConfig();
+    printConfig(c, checkpoint.size(), model);
+
+    if (promptTokens + genTokens > c.seqLen) {
+        promptTokens = c.seqLen / 2;
+        genTokens = c.seqLen - promptTokens;
+    }
+
+    Sampler sampler;
+    sampler.configure(c.vocabSize, 0.0f, 0.9f, 1234);  // Greedy: repeatable
+
+    // Token-level run: TTFT is prefill of the prompt plus the first sample
+    std::vector<int> prompt(promptTokens);
+    uint32_t rng = 7;
+    for (int i = 0; i < promptTokens; i++) {
+        rng = rng * 1103515245u + 12345u;
+        prompt[i] = 3 + (rng >> 8) % (c.vocabSize - 3);
+    }
+    prompt[0] = TOKEN_BOS;
+
+    std::vector<int> first(genTokens);
+    std::vector<int> second(genTokens);
+    GenerateStats stats;
+    int n = Generator::runTokens(model, sampler, prompt.data(), promptTokens, genTokens,
+                                 first.data(), &stats);
+
+    printf("Greedy generation\n");
+    printf("  %-26s %10d\n", "prompt tokens", stats.promptTokens);
+    printf("  %-26s %10d\n", "generated tokens", n);
+    printf("  %-26s %10.1f ms\n", "time to first token", stats.firstTokenUs / 1000.0);
+    printf("  %-26s %10.1f tok/s\n", "prefill", stats.prefillTokensPerSec());
+    printf("  %-26s %10.1f tok/s\n", "decode", stats.decodeTokensPerSec());
+    printf("  %-26s %10.1f ms\n", "total", stats.totalUs / 1000.0);
+
+    // Greedy decoding of the same prompt must repeat exactly
+    int again = Generator::runTokens(model, sampler, prompt.data(), promptTokens, genTokens,
+                                     second.data(), nullptr);
+    bool repeatable = again == n && memcmp(first.data(), second.data(), n * sizeof(int)) == 0;
+
+    float* logits = model.forward(prompt[0], 0);
+    bool finite = logits != nullptr;
+    for (int i = 0; finite && i < c.vocabSize; i++) finite = isfinite(logits[i]);
+
+    printf("\nChecks: greedy repeatable %s, logits finite %s\n",
+           repeatable ? "ok" : "FAILED", finite ? "ok" : "FAILED");
+
+    // Text round trip with a real tokenizer
+    if (tokenizerPath) {
+        std::vector<uint8_t> vocab;
+        Tokenizer tokenizer;
+        if (!readFile(tokenizerPath, vocab) || !tokenizer.load(vocab.data(), vocab.size(), c.vocabSize)) {
+            printf("Cannot load tokenizer %s\n", tokenizerPath);
+            return 1;
+        }
+        sampler.configure(c.vocabSize, 0.7f, 0.9f, 1234);
+
+        char text[4096];
+        Generator::run(model, tokenizer, sampler, promptText, genTokens, text, sizeof(text), &stats);
+        printf("\n%s%s\n", promptText, text);
+        printf("(%d prompt tokens, %d generated, TTFT %.1f ms, %.1f tok/s)\n",
+               stats.promptTokens, stats.generatedTokens, stats.firstTokenUs / 1000.0,
+               stats.decodeTokensPerSec());
+    }
+
+    return repeatable && finite ? 0 : 1;
+}
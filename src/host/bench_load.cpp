@@ -0,0 +1,201 @@
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+#include "commands.h"
+#include "synthetic_model.h"
+#include "llm/model_file.h"
+#include "llm/model_map.h"
+#include "llm/platform.h"
+#include "llm/tokenizer.h"
+
+static bool writeFile(const char* path, const std::vector<uint8_t>& data) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+    return fclose(f) == 0 && ok;
+}
+
+// Copying load: the whole file into one heap buffer, as LLMEngine does
+// for models on SPIFFS
+static uint8_t* readCopy(const char* path, size_t* size) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return nullptr;
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t* data = len > 0 ? (uint8_t*)llmAlloc(len) : nullptr;
+    if (data && fread(data, 1, len, f) != (size_t)len) {
+        llmFree(data);
+        data = nullptr;
+    }
+    fclose(f);
+    *size = data ? len : 0;
+    return data;
+}
+
+static bool sameLogits(Transformer& a, Transformer& b, int tokens) {
+    int vocab = a.getConfig().vocabSize;
+    for (int pos = 0; pos < tokens; pos++) {
+        int token = (pos * 7919 + 1) % vocab;
+        float* la = a.forward(token, pos);
+        float* lb = b.forward(token, pos);
+        if (!la || !lb || memcmp(la, lb, vocab * sizeof(float)) != 0) return false;
+    }
+    return true;
+}
+
+// The same file in the version 1 layout: 16-byte entries right after the
+// header, no info block; tensors stay where they are
+static std::vector<uint8_t> downgradeToV1(const uint8_t* data, size_t size) {
+    std::vector<uint8_t> out(data, data + size);
+    ModelFileHeader h;
+    memcpy(&h, data, sizeof(h));
+    std::vector<ModelTensorEntryV1> table;
+    ModelTensorEntry e;
+    for (uint32_t i = 0; ModelFile::getEntry(data, size, i, e); i++) {
+        if (e.kind == TENSOR_VOCAB) continue;
+        table.push_back({e.kind, e.layer, e.type, 0, e.offset, e.bytes});
+    }
+    h.version = 1;
+    h.tensorCount = table.size();
+    h.tableOffset = sizeof(h);
+    memset(&out[sizeof(h)], 0, sizeof(ModelFileInfo) + h.tensorCount * sizeof(ModelTensorEntry));
+    memcpy(&out[0], &h, sizeof(h));
+    memcpy(&out[sizeof(h)], table.data(), table.size() * sizeof(ModelTensorEntryV1));
+    return out;
+}
+
+static void printRow(const char* name, double loadMs, size_t resident, size_t arena) {
+    printf("  %-10s %12.2f ms %12.1f MB %12.1f MB\n", name, loadMs,
+           resident / 1048576.0, (resident + arena) / 1048576.0);
+}
+
+// bench-load [preset|model.cplm] [tokens]
+int benchLoad(int argc, char** argv) {
+    const char* source = argc > 1 ? argv[1] : "15m";
+    int tokens = argc > 2 ? atoi(argv[2]) : 8;
+
+    std::vector<uint8_t> checkpoint;
+    char path[256];
+    const SyntheticPreset* preset = findSyntheticPreset(source);
+    if (preset) {
+        snprintf(path, sizeof(path), "/tmp/bench-load-%s.cplm", preset->name);
+        std::vector<uint8_t> vocab = buildSyntheticTokenizer(preset->config.vocabSize,
+                                                             {"guest wifi captive portal"});
+        if (!writeFile(path, buildSyntheticModelFile(preset->config, 42, &vocab))) {
+            printf("Cannot write %s\n", path);
+            return 1;
+        }
+        checkpoint = buildSyntheticCheckpoint(preset->config, 42);
+        printf("Synthetic '%s' model written to %s\n", preset->name, path);
+    } else {
+        snprintf(path, sizeof(path), "%s", source);
+    }
+
+    // Copy into RAM
+    uint64_t start = llmMicros();
+    size_t copySize = 0;
+    uint8_t* copy = readCopy(path, &copySize);
+    Transformer copied;
+    bool copyOk = copy && copied.load(copy, copySize);
+    uint64_t copyUs = llmMicros() - start;
+
+    // Map in place
+    start = llmMicros();
+    ModelMap map;
+    Transformer mapped;
+    bool mapOk = map.mapFile(path) && mapped.load(map.data(), map.size());
+    uint64_t mapUs = llmMicros() - start;
+
+    if (!copyOk || !mapOk) {
+        printf("Load failed: %s\n", !copy ? "cannot read file" : !copyOk ? copied.getError() :
+               !map.isMapped() ? map.getError() : mapped.getError());
+        if (copy) llmFree(copy);
+        return 1;
+    }
+
+    const TransformerConfig& c = mapped.getConfig();
+    printf("Model: dim %d, %d layers, vocab %d, %.1f MB file, %.1f KB arena\n\n",
+           c.dim, c.nLayers, c.vocabSize, map.size() / 1048576.0, mapped.getArenaSize() / 1024.0);
+
+    size_t residentAtLoad = map.residentBytes();
+    bool same = sameLogits(copied, mapped, tokens);
+    size_t residentAfter = map.residentBytes();
+
+    printf("  %-10s %15s %15s %15s\n", "", "load", "weights in RAM", "total RAM");
+    printRow("copy", copyUs / 1000.0, copySize, copied.getArenaSize());
+    printRow("mmap", mapUs / 1000.0, residentAtLoad, mapped.getArenaSize());
+    printf("\nAfter %d tokens %.1f MB of the mapping is resident (clean file pages the\n"
+           "kernel can drop; on the device, flash is read through the cache and uses no RAM).\n",
+           tokens, residentAfter / 1048576.0);
+
+    // The packed file must hold exactly the checkpoint's weights
+    bool sameAsCheckpoint = true;
+    if (preset) {
+        Transformer reference;
+        sameAsCheckpoint = reference.load(checkpoint.data(), checkpoint.size()) &&
+                           sameLogits(reference, mapped, tokens);
+    }
+
+    // Boot-time validation: header and table checksums, then every tensor
+    ModelFileCheck quick;
+    ModelFileCheck full;
+    bool quickOk = ModelFile::verify(map.data(), map.size(), MODEL_VERIFY_HEADER, quick);
+    bool fullOk = ModelFile::verify(map.data(), map.size(), MODEL_VERIFY_FULL, full);
+    printf("\nVerify (version %u, %u tensors): header + table %.1f us, every tensor %.1f ms "
+           "(%.0f MB/s)%s\n", quick.version, quick.tensorCount, (double)quick.timeUs,
+           full.timeUs / 1000.0, full.timeUs ? full.bytesChecked / (double)full.timeUs : 0.0,
+           quick.checksummed ? "" : " - version 1, no checksums");
+    if (!fullOk) printf("  %s (tensor %d)\n", full.error, full.badTensor);
+
+    // Damage is caught: one flipped bit in a tensor, in the header
+    bool detects = true;
+    if (quick.checksummed) {
+        ModelTensorEntry last;
+        ModelFile::getEntry(copy, copySize, quick.tensorCount - 1, last);
+        ModelFileCheck check;
+        copy[last.offset + last.bytes / 2] ^= 0x10;
+        detects = ModelFile::verify(copy, copySize, MODEL_VERIFY_HEADER, check) &&
+                  !ModelFile::verify(copy, copySize, MODEL_VERIFY_FULL, check) &&
+                  check.badTensor == (int)quick.tensorCount - 1;
+        copy[last.offset + last.bytes / 2] ^= 0x10;
+        copy[offsetof(ModelFileHeader, seqLen)] ^= 0x01;
+        detects = detects && !ModelFile::verify(copy, copySize, MODEL_VERIFY_HEADER, check);
+        copy[offsetof(ModelFileHeader, seqLen)] ^= 0x01;
+    }
+
+    // The vocab travels in the file; version 1 files still load
+    bool vocabOk = true;
+    bool v1Ok = true;
+    if (preset) {
+        size_t vocabBytes = 0;
+        const uint8_t* vocab = ModelFile::findTensor(map.data(), map.size(), TENSOR_VOCAB, &vocabBytes);
+        Tokenizer tokenizer;
+        vocabOk = vocab && tokenizer.load(vocab, vocabBytes, c.vocabSize);
+        printf("Embedded vocab: %zu bytes, %s\n", vocabBytes, vocabOk ? "loads" : "FAILED");
+
+        std::vector<uint8_t> v1 = downgradeToV1(map.data(), map.size());
+        Transformer old;
+        ModelFileCheck check;
+        v1Ok = ModelFile::verify(v1.data(), v1.size(), MODEL_VERIFY_FULL, check) &&
+               !check.checksummed && old.load(v1.data(), v1.size()) && sameLogits(old, mapped, tokens);
+    }
+
+    printf("\nChecks: copy == mmap logits %s", same ? "ok" : "FAILED");
+    if (preset) printf(", packed == llama2.c checkpoint %s", sameAsCheckpoint ? "ok" : "FAILED");
+    printf(", checksums verify %s, corruption detected %s", quickOk && fullOk ? "ok" : "FAILED",
+           detects ? "ok" : "FAILED");
+    if (preset) {
+        printf(", embedded vocab %s, version 1 loads %s", vocabOk ? "ok" : "FAILED",
+               v1Ok ? "ok" : "FAILED");
+    }
+    printf("\n");
+
+    copied.unload();
+    llmFree(copy);
+    if (preset) unlink(path);
+    return same && sameAsCheckpoint && quickOk && fullOk && detects && vocabOk && v1Ok ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "commands.h"
+#include "portal_corpus.h"
+#include "synthetic_model.h"
+#include "llm/generator.h"
+#include "llm/platform.h"
+#include "llm/prompts.h"
+
+// bench-prefix [preset] [context] [gen-tokens]
+int benchPrefix(int argc, char** argv) {
+    const char* presetName = argc > 1 ? argv[1] : "15m";
+    int context = argc > 2 ? atoi(argv[2]) : 512;
+    int genTokens = argc > 3 ? atoi(argv[3]) : 8;
+
+    const SyntheticPreset* preset = findSyntheticPreset(presetName);
+    if (!preset || context <= 0 || genTokens <= 0) {
+        printf("Usage: bench-prefix [preset] [context] [gen-tokens]\nPresets:\n");
+        listSyntheticPresets();
+        return 1;
+    }
+
+    // RoPE has no learned positions, so the synthetic model takes any context
+    TransformerConfig config = preset->config;
+    config.seqLen = context;
+    std::vector<uint8_t> checkpoint = buildSyntheticCheckpoint(config, 42);
+
+    std::vector<CorpusPrompt> scenarios = buildCorpusPrompts();
+    std::vector<std::string> corpus;
+    for (const auto& s : scenarios) corpus.push_back(s.text);
+    std::vector<uint8_t> vocab = buildSyntheticTokenizer(config.vocabSize, corpus);
+
+    Transformer model;
+    Tokenizer tokenizer;
+    Sampler sampler;
+    if (!model.load(checkpoint.data(), checkpoint.size()) ||
+        !tokenizer.load(vocab.data(), vocab.size(), config.vocabSize)) {
+        printf("Load failed: %s\n", model.getError());
+        return 1;
+    }
+    sampler.configure(config.vocabSize, 0.0f, 0.9f, 1234);  // Greedy: comparable outputs
+
+    printf("Synthetic '%s' model (random weights), context %d, BPE vocabulary from the prompts\n\n",
+           preset->name, context);
+
+    // Build the cache the way LLMEngine does at load
+    PrefixCache prefixes;
+    const char* const preambles[] = {
+        PROMPT_ANALYSIS_PREFIX, PROMPT_ENUM_PREFIX, PROMPT_INTERPRET_PREFIX,
+    };
+    uint64_t start = llmMicros();
+    for (const char* text : preambles) prefixes.add(model, tokenizer, text);
+    double buildMs = (llmMicros() - start) / 1000.0;
+    printf("Prefix cache: %d prefixes, %.1f KB, built in %.1f ms\n\n",
+           prefixes.getCount(), prefixes.getBytes() / 1024.0, buildMs);
+
+    printf("%-20s %7s %7s %12s %12s %8s\n", "prompt", "tokens", "cached",
+           "TTFT off ms", "TTFT on ms", "speedup");
+
+    bool identical = true;
+    double offTotal = 0;
+    double onTotal = 0;
+    for (const auto& s : scenarios) {
+        char plain[1024];
+        char cached[1024];
+        GenerateStats off;
+        GenerateStats on;
+        Generator::run(model, tokenizer, sampler, s.text.c_str(), genTokens,
+                       plain, sizeof(plain), &off);
+        Generator::run(model, tokenizer, sampler, s.text.c_str(), genTokens,
+                       cached, sizeof(cached), &on, &prefixes);
+
+        // Restored positions must give exactly what computing them gives
+        identical = identical && strcmp(plain, cached) == 0;
+        offTotal += off.firstTokenUs;
+        onTotal += on.firstTokenUs;
+
+        printf("%-20s %7d %7d %12.1f %12.1f %7.2fx\n", s.name.c_str(), off.promptTokens,
+               on.cachedTokens, off.firstTokenUs / 1000.0, on.firstTokenUs / 1000.0,
+               (double)off.firstTokenUs / on.firstTokenUs);
+    }
+    printf("%-20s %7s %7s %12.1f %12.1f %7.2fx\n", "total", "", "", offTotal / 1000.0,
+           onTotal / 1000.0, offTotal / onTotal);
+
+    // Cost of the restore alone (the copy that replaces the prefix's forward passes)
+    std::vector<int> tokens(strlen(PROMPT_ANALYSIS_PREFIX) + 8);
+    int n = tokenizer.encode(PROMPT_ANALYSIS_PREFIX "<html>", true, false,
+                             tokens.data(), tokens.size());
+    const int iterations = 200;
+    int restored = 0;
+    start = llmMicros();
+    for (int i = 0; i < iterations; i++) restored = prefixes.restore(model, tokens.data(), n);
+    double restoreUs = (double)(llmMicros() - start) / iterations;
+    printf("\nRestore of %d analysis prefix positions: %.1f us (%.1f KB copied)\n",
+           restored, restoreUs, model.getKvSnapshotSize(restored) / 1024.0);
+    printf("Hits %u, misses %u, positions reused %u\n",
+           prefixes.getHits(), prefixes.getMisses(), prefixes.getReusedTokens());
+
+    printf("\nChecks: output identical with and without the cache %s\n",
+           identical ? "ok" : "FAILED");
+    return identical ? 0 : 1;
+}
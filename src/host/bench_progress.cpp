@@ -0,0 +1,96 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "commands.h"
+#include "alloc_counter.h"
+#include "core/enum_progress.h"
+
+// Every field of a publish is derived from one counter, so a reader can
+// tell whether a snapshot mixes two publishes
+static void fillSnapshot(EnumProgressSnapshot& snap, uint32_t i) {
+    snap.next = i;
+    snap.current = (int32_t)i;
+    snap.total = (int32_t)i + 1000;
+    snap.successes = (int32_t)(i / 7);
+
+    char room[16];
+    snprintf(room, sizeof(room), "%u", i);
+    EnumProgress::formatStatus(snap.status, sizeof(snap.status), room, "Smith");
+}
+
+static bool isConsistent(const EnumProgressSnapshot& snap) {
+    EnumProgressSnapshot expected;
+    memset(&expected, 0, sizeof(expected));
+    fillSnapshot(expected, snap.next);
+    return snap.current == expected.current &&
+           snap.total == expected.total &&
+           snap.successes == expected.successes &&
+           strcmp(snap.status, expected.status) == 0;
+}
+
+int benchProgress(int argc, char** argv) {
+    long publishes = argc > 1 ? atol(argv[1]) : 2000000;
+    int readers = argc > 2 ? atoi(argv[2]) : 3;
+    if (publishes <= 0 || readers <= 0) {
+        printf("Usage: bench-progress [publishes] [readers]\n");
+        return 1;
+    }
+
+    EnumProgress progress;
+    EnumProgressSnapshot initial;
+    memset(&initial, 0, sizeof(initial));
+    fillSnapshot(initial, 0);
+    progress.publish(initial);
+
+    std::atomic<bool> done(false);
+    std::atomic<long> reads(0);
+    std::atomic<long> torn(0);
+
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; r++) {
+        threads.emplace_back([&]() {
+            long localReads = 0;
+            long localTorn = 0;
+            EnumProgressSnapshot snap;
+            while (!done.load(std::memory_order_relaxed)) {
+                progress.read(snap);
+                if (!isConsistent(snap)) localTorn++;
+                localReads++;
+            }
+            reads.fetch_add(localReads);
+            torn.fetch_add(localTorn);
+        });
+    }
+
+    // Writer: same work per attempt as the job task
+    EnumProgressSnapshot live;
+    memset(&live, 0, sizeof(live));
+    uint64_t allocsBefore = AllocCounter::count();
+    auto t0 = std::chrono::steady_clock::now();
+    for (long i = 1; i <= publishes; i++) {
+        fillSnapshot(live, (uint32_t)i);
+        progress.publish(live);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    uint64_t writerAllocs = AllocCounter::count() - allocsBefore;
+
+    done.store(true);
+    for (auto& t : threads) t.join();
+
+    double secs = std::chrono::duration<double>(t1 - t0).count();
+    printf("Publishes:     %ld (%.1f ns each incl. formatting)\n", publishes, secs * 1e9 / publishes);
+    printf("Reads:         %ld across %d readers (%.1f M/s)\n", reads.load(), readers,
+           reads.load() / secs / 1e6);
+    printf("Torn reads:    %ld\n", torn.load());
+    printf("Writer allocs: %llu\n", (unsigned long long)writerAllocs);
+
+    if (!AllocCounter::supported()) {
+        printf("\n(allocation counting unavailable on this platform)\n");
+    }
+
+    return torn.load() == 0 && writerAllocs == 0 ? 0 : 1;
+}
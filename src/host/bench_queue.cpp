@@ -0,0 +1,240 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "commands.h"
+#include "portal_corpus.h"
+#include "synthetic_model.h"
+#include "llm/generator.h"
+#include "llm/job_queue.h"
+#include "llm/platform.h"
+#include "llm/token_stream.h"
+
+struct Sink {
+    TokenStream* stream;
+    std::string* out;
+};
+
+static bool publish(void* ctx, const char* text, size_t len) {
+    Sink* sink = (Sink*)ctx;
+    sink->stream->write(text, len);
+    sink->out->append(text, len);
+    return true;
+}
+
+// What LLMEngine's worker task does: one job at a time, in queue order,
+// streamed under the job's id
+struct QueueWorker {
+    InferenceQueue* queue;
+    Transformer* model;
+    Tokenizer* tokenizer;
+    Sampler* sampler;
+    TokenStream stream;
+    std::mutex lock;
+    std::vector<uint32_t> started;
+    std::vector<uint64_t> waitedUs;
+    std::atomic<int> active;
+    std::atomic<int> maxActive;
+    std::atomic<int> generations;
+
+    void run() {
+        InferenceJob job;
+        std::string out;
+        out.reserve(4096);
+        while (queue->next(job)) {
+            int now = ++active;
+            if (now > maxActive) maxActive = now;
+            generations++;
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                started.push_back(job.id);
+                waitedUs.push_back(job.waitedUs);
+            }
+
+            out.clear();
+            stream.begin(job.id);
+            if (queue->isCancelRequested(job.id)) stream.cancel(job.id);
+            Sink sink = {&stream, &out};
+            Generator::stream(*model, *tokenizer, *sampler, job.input.c_str(), job.maxTokens,
+                              publish, &sink, nullptr, nullptr, stream.getCancelFlag());
+            stream.finish();
+
+            active--;
+            queue->complete(job.id, out.data(), out.size(), stream.getState() == STREAM_CANCELLED);
+        }
+    }
+
+    // LLMEngine::cancel()
+    bool cancel(uint32_t id) {
+        InferenceState state = queue->cancel(id);
+        if (state == INFER_RUNNING) stream.cancel(id);
+        return state == INFER_RUNNING || state == INFER_CANCELLED;
+    }
+
+    uint64_t waitOf(uint32_t id) {
+        std::lock_guard<std::mutex> guard(lock);
+        for (size_t i = 0; i < started.size(); i++) {
+            if (started[i] == id) return waitedUs[i];
+        }
+        return 0;
+    }
+};
+
+static bool waitFor(const std::function<bool()>& done, int timeoutMs = 30000) {
+    for (int ms = 0; ms < timeoutMs; ms++) {
+        if (done()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+static uint64_t keyOf(const std::string& text) {
+    return std::hash<std::string>()(text);
+}
+
+// bench-queue [preset] [gen-tokens]
+int benchQueue(int argc, char** argv) {
+    const char* presetName = argc > 1 ? argv[1] : "15m";
+    int genTokens = argc > 2 ? atoi(argv[2]) : 32;
+
+    const SyntheticPreset* preset = findSyntheticPreset(presetName);
+    if (!preset || genTokens <= 0) {
+        printf("Usage: bench-queue [preset] [gen-tokens]\nPresets:\n");
+        listSyntheticPresets();
+        return 1;
+    }
+
+    TransformerConfig config = preset->config;
+    std::vector<uint8_t> checkpoint = buildSyntheticCheckpoint(config, 42);
+    std::vector<CorpusPrompt> prompts = buildCorpusPrompts();
+    std::vector<std::string> corpus;
+    for (const auto& p : prompts) corpus.push_back(p.text);
+    std::vector<uint8_t> vocab = buildSyntheticTokenizer(config.vocabSize, corpus);
+
+    Transformer model;
+    Tokenizer tokenizer;
+    Sampler sampler;
+    if (!model.load(checkpoint.data(), checkpoint.size()) ||
+        !tokenizer.load(vocab.data(), vocab.size(), config.vocabSize)) {
+        printf("Load failed: %s\n", model.getError());
+        return 1;
+    }
+    sampler.configure(config.vocabSize, 0.0f, 0.9f, 1234);     // Greedy: repeatable text
+
+    InferenceQueue queue;
+    QueueWorker worker;
+    worker.queue = &queue;
+    worker.model = &model;
+    worker.tokenizer = &tokenizer;
+    worker.sampler = &sampler;
+    worker.active = 0;
+    worker.maxActive = 0;
+    worker.generations = 0;
+    std::thread thread(&QueueWorker::run, &worker);
+
+    auto running = [&](uint32_t id) { return [&queue, id]() { return queue.getStats().running == id; }; };
+    auto idle = [&]() { QueueStats s = queue.getStats(); return s.running == 0 && s.queued == 0; };
+    auto submit = [&](int prompt, JobPriority priority, bool wait = false, SubmitError* error = nullptr) {
+        const std::string& text = prompts[prompt].text;
+        return queue.submit(keyOf(text), 0, priority, text.data(), text.size(), genTokens, wait, error);
+    };
+
+    printf("Synthetic '%s' model (random weights), %d tokens per job, queue depth %d\n\n",
+           preset->name, genTokens, INFERENCE_QUEUE_DEPTH);
+
+    // Priority: an interactive request arriving behind two background
+    // ones runs as soon as the current job ends
+    uint32_t b0 = submit(0, JOB_BACKGROUND);
+    waitFor(running(b0));
+    uint32_t b1 = submit(1, JOB_BACKGROUND);
+    uint32_t b2 = submit(2, JOB_BACKGROUND);
+    uint32_t in = submit(3, JOB_INTERACTIVE);
+    waitFor(idle);
+
+    std::vector<uint32_t> expected = {b0, in, b1, b2};
+    bool ordered = worker.started == expected;
+    printf("Start order: ");
+    for (uint32_t id : worker.started) {
+        printf("%s ", id == in ? "interactive" : id == b0 ? "bg0" : id == b1 ? "bg1" : "bg2");
+    }
+    printf("\n  interactive waited %.1f ms in the queue, last background %.1f ms\n",
+           worker.waitOf(in) / 1000.0, worker.waitOf(b2) / 1000.0);
+
+    // Coalescing: the same prompt three times while it's queued is one job
+    int before = worker.generations;
+    uint32_t blocker = submit(4, JOB_NORMAL);
+    waitFor(running(blocker));
+    uint32_t c1 = submit(5, JOB_NORMAL, true);
+    uint32_t c2 = submit(5, JOB_NORMAL, true);
+    uint32_t c3 = submit(5, JOB_INTERACTIVE);
+    std::string out1;
+    std::string out2;
+    bool waited = queue.wait(c1, out1, 30000) && queue.wait(c2, out2, 30000);
+    waitFor(idle);
+    bool coalesced = c1 == c2 && c2 == c3 && worker.generations - before == 2 && out1 == out2;
+    printf("Coalescing: 3 submits of one prompt -> %d generation(s), ids %u/%u/%u\n",
+           worker.generations - before - 1, c1, c2, c3);
+
+    // The waited output is what a direct run produces
+    std::vector<char> direct(genTokens * TOKENIZER_MAX_PIECE + 1);
+    Generator::run(model, tokenizer, sampler, prompts[5].text.c_str(), genTokens, direct.data(),
+                   direct.size());
+    bool sameText = waited && out1 == direct.data();
+
+    // Cancellation: a queued job never runs, a running one stops early
+    before = worker.generations;
+    uint32_t run = submit(0, JOB_NORMAL, true);
+    waitFor(running(run));
+    uint32_t queued = submit(1, JOB_NORMAL);
+    bool droppedQueued = worker.cancel(queued) && queue.getState(queued) == INFER_FREE;
+    waitFor([&]() { return worker.stream.getTokens() >= 2; });
+    uint64_t cancelAt = llmMicros();
+    bool cancelledRun = worker.cancel(run);
+    std::string ignored;
+    bool waitFailed = !queue.wait(run, ignored, 30000);
+    uint64_t stopUs = llmMicros() - cancelAt;
+    waitFor(idle);
+    bool cancelOk = droppedQueued && cancelledRun && waitFailed &&
+                    worker.generations - before == 1 && worker.stream.getTokens() < genTokens;
+    printf("Cancellation: queued job dropped, running job stopped after %d of %d tokens, %.1f ms after cancel\n",
+           worker.stream.getTokens(), genTokens, stopUs / 1000.0);
+
+    // Bounded: a full queue turns away background work; interactive work
+    // displaces the newest background job
+    uint32_t hold = submit(0, JOB_NORMAL);
+    waitFor(running(hold));
+    for (int i = 1; i < INFERENCE_QUEUE_DEPTH; i++) submit(i, JOB_BACKGROUND);
+    SubmitError fullError;
+    SubmitError displaceError;
+    uint32_t rejected = submit(INFERENCE_QUEUE_DEPTH, JOB_BACKGROUND, false, &fullError);
+    uint32_t urgent = submit(INFERENCE_QUEUE_DEPTH + 1, JOB_INTERACTIVE, false, &displaceError);
+    QueueStats full = queue.getStats();
+    for (uint32_t id = hold; id <= urgent; id++) worker.cancel(id);    // Drain quickly
+    waitFor(idle);
+    bool bounded = rejected == 0 && fullError == SUBMIT_FULL && urgent != 0 &&
+                   displaceError == SUBMIT_OK && full.displaced == 1 &&
+                   full.queued == INFERENCE_QUEUE_DEPTH - 1;
+
+    queue.close();
+    thread.join();
+
+    QueueStats stats = queue.getStats();
+    printf("\nQueue: %u submitted, %u coalesced, %u rejected, %u displaced, %u cancelled, %u completed\n",
+           stats.submitted, stats.coalesced, stats.rejected, stats.displaced, stats.cancelled,
+           stats.completed);
+    printf("Queue latency: last %u ms, average %u ms, max %u ms\n",
+           stats.lastWaitMs, stats.avgWaitMs, stats.maxWaitMs);
+
+    bool single = worker.maxActive == 1;
+    printf("\nChecks: priority order %s, coalescing %s, waited output matches %s, cancellation %s, "
+           "bounded queue %s, one generation at a time %s\n",
+           ordered ? "ok" : "FAILED", coalesced ? "ok" : "FAILED", sameText ? "ok" : "FAILED",
+           cancelOk ? "ok" : "FAILED", bounded ? "ok" : "FAILED", single ? "ok" : "FAILED");
+    return ordered && coalesced && sameText && cancelOk && bounded && single ? 0 : 1;
+}
@@ -0,0 +1,260 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <string>
+#include <vector>
+#include "commands.h"
+#include "alloc_counter.h"
+#include "portal_corpus.h"
+#include "core/portal_rules.h"
+#include "llm/platform.h"
+
+// Labels one analysis produced, by kind
+struct Labels {
+    std::string venue;
+    std::vector<std::string> fields;
+    std::vector<std::string> issues;
+    std::vector<std::string> advice;
+
+    bool operator==(const Labels& o) const {
+        return venue == o.venue && fields == o.fields && issues == o.issues && advice == o.advice;
+    }
+};
+
+// The keyword part of patternBasedAnalysis before the rule engine: a
+// lowered copy of the page and one search per keyword
+static void referenceAnalysis(const std::string& html, Labels& out) {
+    std::string lower = html;
+    for (auto& c : lower) c = tolower((unsigned char)c);
+    auto has = [&](const char* k) { return lower.find(k) != std::string::npos; };
+
+    if (has("hotel") || has("resort") || has("inn") || has("suites")) {
+        out.venue = "Hotel/Resort";
+    } else if (has("airport") || has("terminal") || has("airline")) {
+        out.venue = "Airport";
+    } else if (has("hospital") || has("medical") || has("clinic")) {
+        out.venue = "Healthcare Facility";
+    } else if (has("cafe") || has("coffee") || has("restaurant")) {
+        out.venue = "Cafe/Restaurant";
+    } else if (has("conference") || has("convention") || has("event")) {
+        out.venue = "Conference Center";
+    } else if (has("university") || has("college") || has("school")) {
+        out.venue = "Educational Institution";
+    } else if (has("library")) {
+        out.venue = "Library";
+    } else {
+        out.venue = "";
+    }
+
+    if (has("room")) out.fields.push_back("Room Number");
+    if (has("last") && has("name")) out.fields.push_back("Last Name");
+    if (has("first") && has("name")) out.fields.push_back("First Name");
+    if (has("email")) out.fields.push_back("Email Address");
+    if (has("phone") || has("mobile")) out.fields.push_back("Phone Number");
+    if (has("code") || has("access")) out.fields.push_back("Access Code");
+
+    if (has("http://") && !has("https://")) out.issues.push_back("Form submits over HTTP (unencrypted)");
+    if (has("password") && !has("type=\"password\"")) out.issues.push_back("Password field may not be masked");
+    if (has("remember") || has("stay logged")) out.issues.push_back("Session persistence may leak credentials");
+
+    if (out.venue == "Hotel/Resort") {
+        out.advice.push_back("Try room number enumeration (101-999)");
+        out.advice.push_back("Common surnames likely to yield results");
+    }
+}
+
+static void ruleAnalysis(const PortalRules& rules, const RuleMatch& match, Labels& out) {
+    out.venue = match.venue >= 0 ? rules.getLabel(match.venue) : "";
+    for (int r = 0; r < rules.getRuleCount(); r++) {
+        if (!match.hasFired(r)) continue;
+        switch (rules.getKind(r)) {
+            case RULE_FIELD: out.fields.push_back(rules.getLabel(r)); break;
+            case RULE_ISSUE: out.issues.push_back(rules.getLabel(r)); break;
+            case RULE_ADVICE: out.advice.push_back(rules.getLabel(r)); break;
+            default: break;
+        }
+    }
+}
+
+// The default rules plus `extra` issue rules of four made-up keywords each
+static std::string scaledRules(int extra, uint32_t seed) {
+    std::string text = PortalRules::getDefaultText();
+    for (int r = 0; r < extra; r++) {
+        text += "issue | synthetic " + std::to_string(r) + " | 2 | ";
+        for (int k = 0; k < 4; k++) {
+            if (k > 0) text += ", ";
+            int len = 4 + seed % 6;
+            for (int i = 0; i < len; i++) {
+                seed = seed * 1103515245u + 12345u;
+                text += (char)('a' + (seed >> 16) % 26);
+            }
+        }
+        text += "\n";
+    }
+    return text;
+}
+
+// Keyword-per-search cost of the same rule set: what adding rules to the
+// if/else chains costs
+static double naiveUs(const std::vector<std::string>& keywords, const std::string& html,
+                      int iterations) {
+    static volatile size_t found;
+    uint64_t start = llmMicros();
+    for (int i = 0; i < iterations; i++) {
+        std::string lower = html;
+        for (auto& c : lower) c = tolower((unsigned char)c);
+        for (const auto& k : keywords) found += lower.find(k) != std::string::npos;
+    }
+    return (double)(llmMicros() - start) / iterations;
+}
+
+static std::vector<std::string> keywordsOf(const std::string& text) {
+    std::vector<std::string> out;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t eol = text.find('\n', pos);
+        if (eol == std::string::npos) eol = text.size();
+        std::string line = text.substr(pos, eol - pos);
+        pos = eol + 1;
+        size_t bar = line.rfind('|');
+        if (line.empty() || line[0] == '#' || bar == std::string::npos) continue;
+        std::string terms = line.substr(bar + 1) + ",";
+        size_t start = 0;
+        for (size_t comma = terms.find(','); comma != std::string::npos;
+             start = comma + 1, comma = terms.find(',', start)) {
+            std::string term = terms.substr(start, comma - start);
+            term.erase(0, term.find_first_not_of(' '));
+            size_t eq = term.rfind('=');
+            if (eq != std::string::npos && eq + 1 < term.size() &&
+                (isdigit((unsigned char)term[eq + 1]) || term[eq + 1] == '-')) {
+                term.erase(eq);
+            }
+            if (!term.empty() && term[0] != '@') out.push_back(term);
+        }
+    }
+    return out;
+}
+
+// bench-rules [iterations] [rules-file]
+int benchRules(int argc, char** argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 2000;
+    const char* path = argc > 2 ? argv[2] : nullptr;
+    if (iterations <= 0) {
+        printf("Usage: bench-rules [iterations] [rules-file]\n");
+        return 1;
+    }
+
+    PortalRules rules;
+    if (path) {
+        FILE* f = fopen(path, "rb");
+        std::string text;
+        char buf[4096];
+        size_t n;
+        while (f && (n = fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, n);
+        if (f) fclose(f);
+        if (!f || !rules.load(text.data(), text.size())) {
+            printf("%s: %s\n", path, f ? rules.getError() : "cannot open");
+            return 1;
+        }
+    } else {
+        rules.loadDefaults();
+    }
+
+    printf("%s: %d rules, %d keywords, %d matcher states, %zu table bytes\n\n",
+           path ? path : "Built-in rules", rules.getRuleCount(), rules.getKeywordCount(),
+           rules.getStateCount(), rules.getTableBytes());
+    printf("%-11s %6s  %-24s %6s %6s %10s %10s %8s\n", "page", "chars", "venue", "fields",
+           "issues", "chains us", "rules us", "agrees");
+
+    bool agree = true;
+    uint64_t allocs = 0;
+    size_t totalBytes = 0;
+    double chainTotal = 0;
+    double ruleTotal = 0;
+    for (int i = 0; i < portalSampleCount; i++) {
+        std::string html = portalSamples[i].html;
+
+        uint64_t start = llmMicros();
+        Labels reference;
+        for (int j = 0; j < iterations; j++) {
+            reference = Labels();
+            referenceAnalysis(html, reference);
+        }
+        double chainUs = (double)(llmMicros() - start) / iterations;
+
+        RuleMatch match;
+        uint64_t before = AllocCounter::count();
+        start = llmMicros();
+        for (int j = 0; j < iterations; j++) {
+            rules.evaluate(html.c_str(), html.size(), match);
+        }
+        double ruleUs = (double)(llmMicros() - start) / iterations;
+        allocs += AllocCounter::count() - before;
+
+        Labels result;
+        ruleAnalysis(rules, match, result);
+        bool same = result == reference;
+        agree = agree && same;
+
+        totalBytes += html.size();
+        chainTotal += chainUs;
+        ruleTotal += ruleUs;
+        printf("%-11s %6zu  %-24s %6zu %6zu %10.2f %10.2f %8s\n", portalSamples[i].name,
+               html.size(), result.venue.empty() ? "-" : result.venue.c_str(),
+               result.fields.size(), result.issues.size(), chainUs, ruleUs,
+               path ? "n/a" : same ? "yes" : "NO");
+        if (!same && !path) {
+            printf("%-11s %6s  %-24s %6zu %6zu   (if/else chains)\n", "", "",
+                   reference.venue.empty() ? "-" : reference.venue.c_str(),
+                   reference.fields.size(), reference.issues.size());
+        }
+    }
+    printf("%-11s %6zu  %-24s %6s %6s %10.2f %10.2f\n", "total", totalBytes, "", "", "",
+           chainTotal, ruleTotal);
+    printf("\nRule evaluation: %.1f MB/s (%.2fx the if/else chains)\n",
+           totalBytes / ruleTotal, chainTotal / ruleTotal);
+
+    // More rules: one search per keyword grows with the rule count, the
+    // automaton's single pass does not
+    std::string page = portalSamples[portalSampleCount - 1].html;
+    printf("\nScaling on the '%s' page (%zu chars):\n", portalSamples[portalSampleCount - 1].name,
+           page.size());
+    printf("%8s %9s %8s %12s %10s %12s\n", "rules", "keywords", "states", "table bytes",
+           "rules us", "searches us");
+    bool scaled = true;
+    for (int extra : {0, 8, 16, 32}) {
+        std::string text = scaledRules(extra, 7);
+        PortalRules big;
+        scaled = scaled && big.load(text.data(), text.size());
+
+        RuleMatch match;
+        uint64_t before = AllocCounter::count();
+        uint64_t start = llmMicros();
+        for (int j = 0; j < iterations; j++) big.evaluate(page.c_str(), page.size(), match);
+        double us = (double)(llmMicros() - start) / iterations;
+        allocs += AllocCounter::count() - before;
+
+        printf("%8d %9d %8d %12zu %10.2f %12.2f\n", big.getRuleCount(), big.getKeywordCount(),
+               big.getStateCount(), big.getTableBytes(), us,
+               naiveUs(keywordsOf(text), page, iterations / 10 + 1));
+    }
+
+    // Bad rule files are rejected with the line at fault
+    PortalRules bad;
+    const char* unknownVenue = "venue | Hotel | 1 | hotel\nadvice | Try | 1 | @Airport\n";
+    const char* badKind = "# comment\n\nvenu | Hotel | 1 | hotel\n";
+    bool rejects = !bad.load(unknownVenue, strlen(unknownVenue)) &&
+                   strncmp(bad.getError(), "line 2:", 7) == 0 && bad.getRuleCount() == 0 &&
+                   !bad.load(badKind, strlen(badKind)) && strncmp(bad.getError(), "line 3:", 7) == 0;
+
+    printf("\nChecks: %s, larger rule sets load %s, bad rule files rejected %s",
+           path ? "agreement with the old chains skipped (custom rules)"
+                : agree ? "matches the old if/else chains ok" : "matches the old if/else chains FAILED",
+           scaled ? "ok" : "FAILED", rejects ? "ok" : "FAILED");
+    if (AllocCounter::supported()) {
+        printf(", no allocations per evaluation %s", allocs == 0 ? "ok" : "FAILED");
+    }
+    printf("\n");
+    return (agree || path) && scaled && rejects && (allocs == 0 || !AllocCounter::supported()) ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "commands.h"
+#include "alloc_counter.h"
+#include "portal_corpus.h"
+#include "synthetic_model.h"
+#include "llm/generator.h"
+#include "llm/platform.h"
+#include "llm/token_stream.h"
+
+// What LLMEngine does with each token: publish it for readers
+static bool publish(void* ctx, const char* text, size_t len) {
+    ((TokenStream*)ctx)->write(text, len);
+    return true;
+}
+
+// A UI-like consumer on its own thread: polls the stream every `pollMs`,
+// rebuilds the text and notes when non-blank text first showed up.
+// Optionally cancels after seeing `cancelAfter` tokens.
+struct Reader {
+    const TokenStream* stream;
+    int pollMs;
+    int cancelAfter;
+    std::atomic<bool> stop;
+    std::string text;
+    uint64_t start;
+    uint64_t firstVisibleUs;
+    uint64_t cancelUs;
+    int tokensAtCancel;
+
+    void run() {
+        StreamCursor cursor = {stream->getId(), stream->getWritten()};
+        char buf[TOKEN_STREAM_BYTES + 1];
+        while (true) {
+            bool last = stop.load();
+            size_t n = stream->read(cursor, buf, sizeof(buf));
+            text.append(buf, n);
+            if (firstVisibleUs == 0 && text.find_first_not_of(" \n\t\r") != std::string::npos) {
+                firstVisibleUs = llmMicros() - start;
+            }
+            if (cancelAfter > 0 && cancelUs == 0 && stream->getTokens() >= cancelAfter) {
+                tokensAtCancel = stream->getTokens();
+                cancelUs = llmMicros();
+                ((TokenStream*)stream)->cancel();
+            }
+            if (last) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(pollMs));
+        }
+    }
+};
+
+// A reader that falls behind loses the oldest text, never gets corrupt text
+static bool checkLapping() {
+    TokenStream stream;
+    std::string written;
+    stream.begin();
+    StreamCursor cursor = {stream.getId(), 0};
+    for (int i = 0; i < 1500; i++) {
+        char piece[8];
+        int n = snprintf(piece, sizeof(piece), "%d ", i);
+        stream.write(piece, n);
+        written.append(piece, n);
+    }
+    stream.finish();
+
+    char buf[TOKEN_STREAM_BYTES + 1];
+    size_t n = stream.read(cursor, buf, sizeof(buf));
+    std::string tail = written.substr(written.size() - TOKEN_STREAM_BYTES);
+    return n == TOKEN_STREAM_BYTES && tail == buf && cursor.offset == written.size() &&
+           stream.read(cursor, buf, sizeof(buf)) == 0;
+}
+
+// bench-stream [preset] [gen-tokens] [poll-ms]
+int benchStream(int argc, char** argv) {
+    const char* presetName = argc > 1 ? argv[1] : "15m";
+    int genTokens = argc > 2 ? atoi(argv[2]) : 64;
+    int pollMs = argc > 3 ? atoi(argv[3]) : 50;
+
+    const SyntheticPreset* preset = findSyntheticPreset(presetName);
+    if (!preset || genTokens <= 0 || pollMs <= 0) {
+        printf("Usage: bench-stream [preset] [gen-tokens] [poll-ms]\nPresets:\n");
+        listSyntheticPresets();
+        return 1;
+    }
+
+    TransformerConfig config = preset->config;
+    std::vector<uint8_t> checkpoint = buildSyntheticCheckpoint(config, 42);
+    std::vector<CorpusPrompt> prompts = buildCorpusPrompts();
+    std::vector<std::string> corpus;
+    for (const auto& p : prompts) corpus.push_back(p.text);
+    std::vector<uint8_t> vocab = buildSyntheticTokenizer(config.vocabSize, corpus);
+
+    Transformer model;
+    Tokenizer tokenizer;
+    Sampler sampler;
+    if (!model.load(checkpoint.data(), checkpoint.size()) ||
+        !tokenizer.load(vocab.data(), vocab.size(), config.vocabSize)) {
+        printf("Load failed: %s\n", model.getError());
+        return 1;
+    }
+    sampler.configure(config.vocabSize, 0.0f, 0.9f, 1234);  // Greedy: repeatable text
+    const char* prompt = prompts[0].text.c_str();
+
+    printf("Synthetic '%s' model (random weights), '%s' prompt, %d tokens, reader polls every %d ms\n\n",
+           preset->name, prompts[0].name.c_str(), genTokens, pollMs);
+
+    // Blocking: nothing is visible until the whole response is back
+    std::vector<char> out(genTokens * TOKENIZER_MAX_PIECE + 1);
+    GenerateStats blocking;
+    Generator::run(model, tokenizer, sampler, prompt, genTokens, out.data(), out.size(), &blocking);
+
+    // Streaming: a reader thread shows text while generation runs
+    TokenStream stream;
+    Reader reader;
+    reader.stream = &stream;
+    reader.pollMs = pollMs;
+    reader.cancelAfter = 0;
+    reader.stop = false;
+    reader.firstVisibleUs = 0;
+    reader.cancelUs = 0;
+    reader.text.reserve(out.size());    // The reader must not allocate while counted
+
+    stream.begin();
+    reader.start = llmMicros();
+    std::thread consumer(&Reader::run, &reader);
+
+    GenerateStats streamed;
+    uint64_t allocsBefore = AllocCounter::count();
+    Generator::stream(model, tokenizer, sampler, prompt, genTokens, publish, &stream, &streamed,
+                      nullptr, stream.getCancelFlag());
+    uint64_t allocs = AllocCounter::count() - allocsBefore;
+    stream.finish();
+    reader.stop = true;
+    consumer.join();
+
+    bool sameText = reader.text == out.data();
+    printf("%-34s %10s\n", "", "ms");
+    printf("%-34s %10.1f\n", "blocking: text visible after", blocking.totalUs / 1000.0);
+    printf("%-34s %10.1f\n", "streaming: first token (TTFT)", streamed.firstTokenUs / 1000.0);
+    printf("%-34s %10.1f\n", "streaming: first visible text", streamed.firstVisibleUs / 1000.0);
+    printf("%-34s %10.1f\n", "reader: first visible text seen", reader.firstVisibleUs / 1000.0);
+    printf("%-34s %10.1f\n", "streaming: complete", streamed.totalUs / 1000.0);
+    printf("\n%d tokens, %zu bytes; reader text %s the blocking output\n",
+           streamed.generatedTokens, reader.text.size(), sameText ? "matches" : "DIFFERS from");
+
+    // Cancellation mid-generation: generation stops after the pass in flight
+    int cancelAfter = genTokens / 4 > 0 ? genTokens / 4 : 1;
+    stream.begin();
+    reader.cancelAfter = cancelAfter;
+    reader.stop = false;
+    reader.text.clear();
+    reader.firstVisibleUs = 0;
+    reader.cancelUs = 0;
+    reader.start = llmMicros();
+    std::thread canceller(&Reader::run, &reader);
+
+    GenerateStats cancelled;
+    Generator::stream(model, tokenizer, sampler, prompt, genTokens, publish, &stream, &cancelled,
+                      nullptr, stream.getCancelFlag());
+    uint64_t stoppedAt = llmMicros();
+    stream.finish();
+    reader.stop = true;
+    canceller.join();
+
+    int overrun = cancelled.generatedTokens - reader.tokensAtCancel;
+    bool cancelOk = reader.cancelUs > 0 && stream.getState() == STREAM_CANCELLED && overrun <= 1;
+    printf("\nCancel after %d tokens seen: stopped at %d tokens, %.1f ms after cancel()\n",
+           reader.tokensAtCancel, cancelled.generatedTokens,
+           reader.cancelUs ? (stoppedAt - reader.cancelUs) / 1000.0 : 0.0);
+
+    // Cancelled before the prompt is through: no token at all
+    std::atomic<bool> early(true);
+    GenerateStats none;
+    Generator::stream(model, tokenizer, sampler, prompt, genTokens, publish, &stream, &none,
+                      nullptr, &early);
+    cancelOk = cancelOk && none.generatedTokens == 0;
+
+    bool lapping = checkLapping();
+
+    printf("\nChecks: streamed text matches %s, cancellation %s, lapped reader %s",
+           sameText ? "ok" : "FAILED", cancelOk ? "ok" : "FAILED", lapping ? "ok" : "FAILED");
+    if (AllocCounter::supported()) {
+        printf(", no allocations while streaming %s", allocs == 0 ? "ok" : "FAILED");
+    }
+    printf("\n");
+    return sameText && cancelOk && lapping && (allocs == 0 || !AllocCounter::supported()) ? 0 : 1;
+}
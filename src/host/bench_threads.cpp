@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "commands.h"
+#include "alloc_counter.h"
+#include "synthetic_model.h"
+#include "llm/kernels.h"
+#include "llm/platform.h"
+#include "llm/worker_pool.h"
+
+struct ScalingShape {
+    const char* name;
+    int n;
+    int d;
+    int groupSize;
+};
+
+static const ScalingShape shapes[] = {
+    {"15m wq", 288, 288, 32},
+    {"15m w1", 288, 768, 32},
+    {"15m classifier", 288, 32000, 32},
+    {"tinyllama w1", 2048, 5632, 64},
+};
+
+static double timeMatvec(WorkerPool& pool, const ScalingShape& s, const std::vector<int8_t>& wq,
+                         const std::vector<float>& ws, const int8_t* xq, const float* xs,
+                         float* out, int iterations) {
+    const MatvecKernels& k = Kernels::active();
+    pool.matvecQ8(k, out, xq, xs, wq.data(), ws.data(), s.n, s.d, s.groupSize);
+    uint64_t start = llmMicros();
+    for (int i = 0; i < iterations; i++) {
+        pool.matvecQ8(k, out, xq, xs, wq.data(), ws.data(), s.n, s.d, s.groupSize);
+    }
+    return (double)(llmMicros() - start) / iterations;
+}
+
+// bench-threads [preset] [tokens] [max-threads]
+int benchThreads(int argc, char** argv) {
+    const char* presetName = argc > 1 ? argv[1] : "15m";
+    int tokens = argc > 2 ? atoi(argv[2]) : 64;
+    int maxThreads = argc > 3 ? atoi(argv[3]) : WORKER_POOL_MAX_THREADS;
+    if (maxThreads < 1 || maxThreads > WORKER_POOL_MAX_THREADS) maxThreads = WORKER_POOL_MAX_THREADS;
+
+    const SyntheticPreset* preset = findSyntheticPreset(presetName);
+    if (!preset || tokens <= 0) {
+        printf("Usage: bench-threads [preset] [tokens] [max-threads]\nPresets:\n");
+        listSyntheticPresets();
+        return 1;
+    }
+
+    printf("Kernels: %s, threads 1-%d (rows split per matvec, caller + workers), %u CPUs\n\n",
+           Kernels::active().name, maxThreads, std::thread::hardware_concurrency());
+
+    // Matvec scaling: small matrices show the dispatch and barrier cost
+    printf("%-16s", "matvec us/call");
+    for (int t = 1; t <= maxThreads; t++) printf(" %7dT", t);
+    printf("\n");
+
+    for (const auto& s : shapes) {
+        std::vector<int8_t> wq((size_t)s.n * s.d);
+        std::vector<float> ws(wq.size() / s.groupSize, 0.001f);
+        for (size_t i = 0; i < wq.size(); i++) wq[i] = (int8_t)(i * 2654435761u >> 24);
+        int8_t* xq = (int8_t*)llmAlloc(s.n);
+        float* xs = (float*)llmAlloc(s.n / s.groupSize * sizeof(float));
+        float* out = (float*)llmAlloc(s.d * sizeof(float));
+        for (int i = 0; i < s.n; i++) xq[i] = (int8_t)(i * 37);
+        for (int i = 0; i < s.n / s.groupSize; i++) xs[i] = 0.01f;
+
+        int iterations = (int)(2e8 / ((double)s.n * s.d)) + 1;
+        printf("%-16s", s.name);
+        for (int t = 1; t <= maxThreads; t++) {
+            WorkerPool pool;
+            pool.start(t);
+            printf(" %8.1f", timeMatvec(pool, s, wq, ws, xq, xs, out, iterations));
+        }
+        printf("\n");
+
+        llmFree(xq);
+        llmFree(xs);
+        llmFree(out);
+    }
+
+    // Whole-model decode scaling
+    std::vector<uint8_t> checkpoint = buildSyntheticCheckpoint(preset->config, 42);
+    Transformer model;
+    if (!model.load(checkpoint.data(), checkpoint.size())) {
+        printf("Load failed: %s\n", model.getError());
+        return 1;
+    }
+    const TransformerConfig& c = model.getConfig();
+    if (tokens > c.seqLen) tokens = c.seqLen;
+
+    std::vector<float> reference(c.vocabSize);
+    bool identical = true;
+    bool noAllocs = true;
+    double singleRate = 0;
+
+    printf("\n'%s' decode, %d tokens\n", preset->name, tokens);
+    printf("  %-8s %10s %9s %11s %7s\n", "threads", "tok/s", "speedup", "efficiency", "allocs");
+    for (int t = 1; t <= maxThreads; t++) {
+        WorkerPool pool;
+        pool.start(t);
+        model.setPool(&pool);
+
+        uint64_t allocsBefore = AllocCounter::count();
+        uint64_t start = llmMicros();
+        float* logits = nullptr;
+        for (int pos = 0; pos < tokens; pos++) {
+            logits = model.forward((pos * 7919 + 1) % c.vocabSize, pos);
+        }
+        uint64_t us = llmMicros() - start;
+        uint64_t allocs = AllocCounter::count() - allocsBefore;
+
+        // Row splits must not change a single bit of the output
+        if (t == 1) memcpy(reference.data(), logits, c.vocabSize * sizeof(float));
+        identical = identical && memcmp(reference.data(), logits, c.vocabSize * sizeof(float)) == 0;
+        noAllocs = noAllocs && allocs == 0;
+
+        double rate = tokens * 1e6 / us;
+        if (t == 1) singleRate = rate;
+        printf("  %-8d %10.1f %8.2fx %10.0f%% %7llu\n", t, rate, rate / singleRate,
+               100.0 * rate / singleRate / t, (unsigned long long)allocs);
+        model.setPool(nullptr);
+    }
+
+    printf("\nChecks: logits identical across thread counts %s", identical ? "ok" : "FAILED");
+    if (AllocCounter::supported()) {
+        printf(", no allocations per token %s", noAllocs ? "ok" : "FAILED");
+    }
+    printf("\n");
+    return identical && (noAllocs || !AllocCounter::supported()) ? 0 : 1;
+}
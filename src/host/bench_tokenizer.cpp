@@ -0,0 +1,212 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "commands.h"
+#include "alloc_counter.h"
+#include "portal_corpus.h"
+#include "synthetic_model.h"
+#include "llm/platform.h"
+#include "llm/tokenizer.h"
+
+// The original encoder: merge the best-scoring adjacent pair, found by a
+// full scan with a concatenate-and-look-up per pair, until none is left.
+// O(n^2) lookups; kept as the definition encode() must match, including
+// its cut at TOKENIZER_MAX_SYMBOLS symbols past BOS and the dummy space.
+static int referenceEncode(const Tokenizer& tok, const char* text, bool bos, bool eos,
+                           std::vector<int>& tokens) {
+    const size_t capacity = TOKENIZER_MAX_SYMBOLS + 2;
+    tokens.clear();
+    if (bos) tokens.push_back(TOKEN_BOS);
+
+    if (text[0] != '\0') {
+        int space = tok.lookup(" ", 1);
+        if (space >= 0) tokens.push_back(space);
+    }
+
+    for (const char* c = text; *c && tokens.size() < capacity; ) {
+        size_t len = 1;
+        while (len < 4 && (c[len] & 0xC0) == 0x80) len++;
+
+        int id = tok.lookup(c, len);
+        if (id >= 0) {
+            tokens.push_back(id);
+        } else {
+            for (size_t i = 0; i < len && tokens.size() < capacity; i++) {
+                tokens.push_back((uint8_t)c[i] + 3);
+            }
+        }
+        c += len;
+    }
+
+    std::string buf;
+    while (true) {
+        float bestScore = TOKENIZER_NO_MERGE;
+        int bestId = -1;
+        int bestIndex = -1;
+
+        for (size_t i = 0; i + 1 < tokens.size(); i++) {
+            size_t aLen, bLen;
+            const char* a = tok.getPiece(tokens[i], &aLen);
+            const char* b = tok.getPiece(tokens[i + 1], &bLen);
+            buf.assign(a, aLen);
+            buf.append(b, bLen);
+
+            int id = tok.lookup(buf.data(), buf.size());
+            if (id >= 0 && tok.getScore(id) > bestScore) {
+                bestScore = tok.getScore(id);
+                bestId = id;
+                bestIndex = i;
+            }
+        }
+
+        if (bestIndex < 0) break;
+        tokens[bestIndex] = bestId;
+        tokens.erase(tokens.begin() + bestIndex + 1);
+    }
+
+    if (eos) tokens.push_back(TOKEN_EOS);
+    return tokens.size();
+}
+
+static bool readFile(const char* path, std::vector<uint8_t>& out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    out.resize(size > 0 ? size : 0);
+    bool ok = size > 0 && fread(out.data(), 1, size, f) == (size_t)size;
+    fclose(f);
+    return ok;
+}
+
+// Edge cases plus seeded random text: ASCII, multi-byte UTF-8 and invalid
+// bytes that take the byte fallback
+static std::vector<std::string> buildCheckInputs(const std::vector<CorpusPrompt>& prompts) {
+    std::vector<std::string> out = {
+        "", " ", "a", "  leading and trailing  ", "\n\n\t", "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "Caf\xc3\xa9 na\xc3\xafve \xe2\x80\x94 \xe6\x97\xa5\xe6\x9c\xac \xf0\x9f\x93\xb6",
+        "\xff\xfe broken \xc3 utf-8 \x80",
+    };
+    for (const auto& p : prompts) out.push_back(p.text);
+    for (int i = 0; i < portalSampleCount; i++) out.push_back(portalSamples[i].html);
+
+    static const char* const fragments[] = {
+        "room", "_number", " ", "<input", "name=\"", "\">", "\n", "Hotel", "WiFi", "e",
+        "th", "\xc3\xa9", "\xe2\x82\xac", "\x80", "12", "::", "login", "Guest",
+    };
+    uint32_t rng = 99;
+    for (int i = 0; i < 200; i++) {
+        std::string s;
+        rng = rng * 1103515245u + 12345u;
+        int parts = (rng >> 16) % 40;
+        for (int j = 0; j < parts; j++) {
+            rng = rng * 1103515245u + 12345u;
+            s += fragments[(rng >> 16) % (sizeof(fragments) / sizeof(fragments[0]))];
+        }
+        out.push_back(s);
+    }
+    return out;
+}
+
+static bool runChecks(const Tokenizer& tok, const std::vector<std::string>& inputs,
+                      int* matched) {
+    std::vector<int> expected;
+    std::vector<int> actual(TOKENIZER_MAX_SYMBOLS + 3);
+    *matched = 0;
+    for (const auto& text : inputs) {
+        for (int flags = 0; flags < 4; flags++) {
+            bool bos = flags & 1;
+            bool eos = flags & 2;
+            int n = referenceEncode(tok, text.c_str(), bos, eos, expected);
+            int m = tok.encode(text.c_str(), bos, eos, actual.data(), actual.size());
+            if (n != m || memcmp(expected.data(), actual.data(), n * sizeof(int)) != 0) {
+                printf("  MISMATCH on \"%.40s\"%s (bos %d, eos %d): %d vs %d tokens\n",
+                       text.c_str(), text.size() > 40 ? "..." : "", bos, eos, n, m);
+                return false;
+            }
+        }
+        (*matched)++;
+    }
+    return true;
+}
+
+// bench-tokenizer [iterations] [tokenizer.bin vocab-size]
+int benchTokenizer(int argc, char** argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 20;
+    const char* path = argc > 2 ? argv[2] : nullptr;
+    int vocabSize = argc > 3 ? atoi(argv[3]) : 32000;
+    if (iterations <= 0 || vocabSize <= 0) {
+        printf("Usage: bench-tokenizer [iterations] [tokenizer.bin vocab-size]\n");
+        return 1;
+    }
+
+    std::vector<CorpusPrompt> prompts = buildCorpusPrompts();
+    std::vector<uint8_t> vocab;
+    if (path) {
+        if (!readFile(path, vocab)) {
+            printf("Cannot read %s\n", path);
+            return 1;
+        }
+        printf("Tokenizer %s, vocab %d\n", path, vocabSize);
+    } else {
+        std::vector<std::string> corpus;
+        for (const auto& p : prompts) corpus.push_back(p.text);
+        vocab = buildSyntheticTokenizer(vocabSize, corpus);
+        printf("Synthetic BPE vocabulary (%d pieces) learned from the engine prompts\n", vocabSize);
+    }
+
+    Tokenizer tok;
+    uint64_t start = llmMicros();
+    if (!tok.load(vocab.data(), vocab.size(), vocabSize)) {
+        printf("Cannot load tokenizer\n");
+        return 1;
+    }
+    printf("Load with index build: %.1f ms, index + scratch %.1f KB\n\n",
+           (llmMicros() - start) / 1000.0, tok.getIndexSize() / 1024.0);
+
+    std::vector<std::string> inputs = buildCheckInputs(prompts);
+    int matched = 0;
+    bool exact = runChecks(tok, inputs, &matched);
+    printf("Exact match vs reference: %d/%zu inputs (x4 BOS/EOS combinations)\n\n",
+           matched, inputs.size());
+
+    printf("%-20s %6s %7s %14s %14s %8s\n", "prompt", "chars", "tokens",
+           "reference tok/s", "fast tok/s", "speedup");
+
+    std::vector<int> tokens(TOKENIZER_MAX_SYMBOLS + 3);
+    std::vector<int> reference;
+    uint64_t allocs = 0;
+    double refTotal = 0;
+    double fastTotal = 0;
+    for (const auto& p : prompts) {
+        const char* text = p.text.c_str();
+        int n = 0;
+
+        start = llmMicros();
+        for (int i = 0; i < iterations; i++) n = referenceEncode(tok, text, true, false, reference);
+        double refUs = (double)(llmMicros() - start) / iterations;
+
+        uint64_t before = AllocCounter::count();
+        start = llmMicros();
+        for (int i = 0; i < iterations; i++) tok.encode(text, true, false, tokens.data(), tokens.size());
+        double fastUs = (double)(llmMicros() - start) / iterations;
+        allocs += AllocCounter::count() - before;
+
+        refTotal += refUs;
+        fastTotal += fastUs;
+        printf("%-20s %6zu %7d %14.0f %14.0f %7.1fx\n", p.name.c_str(), p.text.size(), n,
+               n * 1e6 / refUs, n * 1e6 / fastUs, refUs / fastUs);
+    }
+    printf("%-20s %6s %7s %11.1f us %11.1f us %7.1fx\n", "total per pass", "", "",
+           refTotal, fastTotal, refTotal / fastTotal);
+
+    printf("\nChecks: exact match %s", exact ? "ok" : "FAILED");
+    if (AllocCounter::supported()) {
+        printf(", no allocations per encode %s", allocs == 0 ? "ok" : "FAILED");
+    }
+    printf("\n");
+    return exact && (allocs == 0 || !AllocCounter::supported()) ? 0 : 1;
+}
@@ -0,0 +1,25 @@
+#ifndef HOST_COMMANDS_H
+#define HOST_COMMANDS_H
+
+// Host tool entry points (one per subcommand, see main.cpp)
+int benchForm(int argc, char** argv);
+int simPacer(int argc, char** argv);
+int simEnum(int argc, char** argv);
+int benchProgress(int argc, char** argv);
+int simOrder(int argc, char** argv);
+int benchLlm(int argc, char** argv);
+int benchLoad(int argc, char** argv);
+int benchKernels(int argc, char** argv);
+int benchThreads(int argc, char** argv);
+int benchPrefix(int argc, char** argv);
+int benchTokenizer(int argc, char** argv);
+int benchDigest(int argc, char** argv);
+int benchStream(int argc, char** argv);
+int benchCache(int argc, char** argv);
+int benchRules(int argc, char** argv);
+int benchQueue(int argc, char** argv);
+int benchGrammar(int argc, char** argv);
+int benchClassifier(int argc, char** argv);
+int benchArena(int argc, char** argv);
+
+#endif // HOST_COMMANDS_H
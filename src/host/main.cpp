@@ -0,0 +1,60 @@
+// Host-side tools for Captured Portal: benchmarks and simulators that run
+// the portable parts of the firmware on Linux.
+//
+//   pio run -e native
+//   .pio/build/native/program <command> [options]
+
+#include <stdio.h>
+#include <string.h>
+#include "commands.h"
+
+struct HostCommand {
+    const char* name;
+    const char* help;
+    int (*run)(int argc, char** argv);
+};
+
+static const HostCommand commands[] = {
+    {"bench-form", "Form template fill throughput and allocations per attempt", benchForm},
+    {"sim-pacer", "Adaptive pacing against simulated portals (virtual clock)", simPacer},
+    {"sim-enum", "Enumeration runs against scripted portals (virtual clock)", simEnum},
+    {"bench-progress", "Seqlock progress publish/read cost and torn-read check", benchProgress},
+    {"sim-order", "Attempts to first hit: set order vs. prior-ranked candidates", simOrder},
+    {"bench-llm", "Quantized transformer TTFT and tokens/sec (synthetic or real checkpoint)", benchLlm},
+    {"bench-load", "Model load time and resident memory: copy vs. memory map", benchLoad},
+    {"bench-kernels", "Int8/int4 matvec kernels: bit-exact checks and throughput", benchKernels},
+    {"bench-threads", "Row-split matvec and decode scaling over 1-8 threads", benchThreads},
+    {"bench-prefix", "Time to first token with and without prompt-prefix KV reuse", benchPrefix},
+    {"bench-tokenizer", "BPE encode tokens/sec and exact match vs. the reference merge loop", benchTokenizer},
+    {"bench-digest", "Analysis prompt size and TTFT: page digest vs. truncated raw HTML", benchDigest},
+    {"bench-stream", "Time to first visible text when streaming, cancellation latency", benchStream},
+    {"bench-cache", "Repeat analysis latency from the page-hash cache vs. recomputing", benchCache},
+    {"bench-rules", "Single-pass rule engine vs. the keyword if/else chains, scaling with rule count", benchRules},
+    {"bench-queue", "Inference job queue: priority order, coalescing, cancellation, queue latency", benchQueue},
+    {"bench-grammar", "JSON-constrained analysis decoding: tokens, mask cost, parse checks", benchGrammar},
+    {"bench-classifier", "Trained portal classifier: accuracy, confidence, us per page vs the model", benchClassifier},
+    {"bench-arena", "Inference arena plan: buffer reuse, peak size, no allocations while generating", benchArena},
+};
+
+static void usage(const char* prog) {
+    printf("Usage: %s <command> [options]\n\nCommands:\n", prog);
+    for (const auto& cmd : commands) {
+        printf("  %-16s %s\n", cmd.name, cmd.help);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    for (const auto& cmd : commands) {
+        if (strcmp(argv[1], cmd.name) == 0) {
+            return cmd.run(argc - 1, argv + 1);
+        }
+    }
+
+    usage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,312 @@
+#include "portal_corpus.h"
+#include <string.h>
+#include "llm/html_digest.h"
+#include "llm/prompts.h"
+
+// Portal pages served by tools/test_portal.py, so host measurements run on
+// the same HTML as the end-to-end test setup, plus a vendor-controller
+// page with the bulk real portals carry (inline CSS/JS, hidden tokens)
+const PortalSample portalSamples[] = {
+    {"hotel", R"HTML(<!DOCTYPE html>
+<html>
+<head>
+    <title>Grand Hotel - Guest WiFi Access</title>
+    <meta name="viewport" content="width=device-width, initial-scale=1">
+    <style>
+        body { font-family: Arial, sans-serif; background: #f5f5f5; margin: 0; padding: 20px; }
+        .container { max-width: 400px; margin: 0 auto; background: white; padding: 30px; border-radius: 8px; box-shadow: 0 2px 10px rgba(0,0,0,0.1); }
+        h1 { color: #8B4513; margin-bottom: 10px; }
+        h2 { color: #666; font-weight: normal; font-size: 16px; margin-bottom: 30px; }
+        label { display: block; margin-bottom: 5px; color: #333; font-weight: bold; }
+        input[type="text"], input[type="number"] { width: 100%; padding: 12px; margin-bottom: 20px; border: 1px solid #ddd; border-radius: 4px; box-sizing: border-box; }
+        button { width: 100%; padding: 14px; background: #8B4513; color: white; border: none; border-radius: 4px; font-size: 16px; cursor: pointer; }
+        button:hover { background: #A0522D; }
+        .logo { text-align: center; margin-bottom: 20px; }
+        .error { background: #ffebee; color: #c62828; padding: 10px; border-radius: 4px; margin-bottom: 20px; display: none; }
+        .footer { text-align: center; margin-top: 20px; color: #999; font-size: 12px; }
+    </style>
+</head>
+<body>
+    <div class="container">
+        <div class="logo">
+            <h1>Grand Hotel</h1>
+            <h2>Guest WiFi Access</h2>
+        </div>
+        <div class="error" id="error">Invalid room number or name. Please try again.</div>
+        <form method="POST" action="/login">
+            <label for="room">Room Number</label>
+            <input type="text" id="room" name="room_number" placeholder="e.g., 101" required>
+
+            <label for="name">Last Name</label>
+            <input type="text" id="name" name="last_name" placeholder="Guest last name" required>
+
+            <input type="checkbox" name="terms" required> I accept the terms of service
+
+            <button type="submit">Connect to WiFi</button>
+        </form>
+        <div class="footer">
+            Managed by HotelWiFi Systems<br>
+            &copy; 2024 Grand Hotel. All rights reserved.
+        </div>
+    </div>
+</body>
+</html>)HTML"},
+    {"airport", R"HTML(<!DOCTYPE html>
+<html>
+<head>
+    <title>Airport Free WiFi - Connect</title>
+    <meta name="viewport" content="width=device-width, initial-scale=1">
+    <style>
+        body { font-family: 'Segoe UI', sans-serif; background: linear-gradient(135deg, #1a5276, #2980b9); min-height: 100vh; margin: 0; display: flex; align-items: center; justify-content: center; }
+        .container { background: white; padding: 40px; border-radius: 12px; max-width: 380px; text-align: center; }
+        h1 { color: #1a5276; margin-bottom: 5px; }
+        p { color: #666; margin-bottom: 30px; }
+        input[type="email"] { width: 100%; padding: 14px; margin-bottom: 20px; border: 2px solid #ddd; border-radius: 8px; box-sizing: border-box; font-size: 16px; }
+        button { width: 100%; padding: 14px; background: #2980b9; color: white; border: none; border-radius: 8px; font-size: 16px; cursor: pointer; }
+        .terms { font-size: 12px; color: #999; margin-top: 20px; }
+    </style>
+</head>
+<body>
+    <div class="container">
+        <h1>Welcome!</h1>
+        <p>Connect to Airport Free WiFi</p>
+        <form method="POST" action="/login">
+            <input type="email" name="email" placeholder="Enter your email" required>
+            <button type="submit">Connect Now</button>
+        </form>
+        <p class="terms">By connecting, you agree to our terms of service and privacy policy. Free WiFi for 2 hours.</p>
+    </div>
+</body>
+</html>)HTML"},
+    {"cafe", R"HTML(<!DOCTYPE html>
+<html>
+<head>
+    <title>Coffee House - Free WiFi</title>
+    <meta name="viewport" content="width=device-width, initial-scale=1">
+    <style>
+        body { font-family: Georgia, serif; background: #3e2723; color: white; min-height: 100vh; margin: 0; display: flex; align-items: center; justify-content: center; }
+        .container { background: rgba(255,255,255,0.1); padding: 40px; border-radius: 20px; max-width: 350px; text-align: center; backdrop-filter: blur(10px); }
+        h1 { font-size: 28px; margin-bottom: 10px; }
+        p { opacity: 0.8; margin-bottom: 30px; }
+        input { width: 100%; padding: 14px; margin-bottom: 20px; border: none; border-radius: 25px; box-sizing: border-box; font-size: 16px; text-align: center; }
+        button { width: 100%; padding: 14px; background: #8d6e63; color: white; border: none; border-radius: 25px; font-size: 16px; cursor: pointer; }
+        .hint { font-size: 12px; opacity: 0.6; margin-top: 20px; }
+    </style>
+</head>
+<body>
+    <div class="container">
+        <h1>Coffee House</h1>
+        <p>Enter the access code from your receipt</p>
+        <form method="POST" action="/login">
+            <input type="text" name="access_code" placeholder="Access Code" required>
+            <button type="submit">Connect</button>
+        </form>
+        <p class="hint">Ask your barista for the daily code!</p>
+    </div>
+</body>
+</html>)HTML"},
+    {"conference", R"HTML(<!DOCTYPE html>
+<html>
+<head>
+    <title>TechConf 2024 - Attendee WiFi</title>
+    <meta name="viewport" content="width=device-width, initial-scale=1">
+    <style>
+        body { font-family: 'Helvetica Neue', sans-serif; background: #0d0d0d; color: white; min-height: 100vh; margin: 0; display: flex; align-items: center; justify-content: center; }
+        .container { background: linear-gradient(145deg, #1a1a2e, #16213e); padding: 40px; border-radius: 16px; max-width: 400px; border: 1px solid #0f3460; }
+        h1 { background: linear-gradient(90deg, #e94560, #0f3460); -webkit-background-clip: text; -webkit-text-fill-color: transparent; margin-bottom: 5px; }
+        p { color: #888; margin-bottom: 30px; }
+        label { display: block; margin-bottom: 5px; color: #e94560; font-size: 12px; text-transform: uppercase; }
+        input { width: 100%; padding: 14px; margin-bottom: 20px; background: rgba(255,255,255,0.05); border: 1px solid #0f3460; border-radius: 8px; color: white; box-sizing: border-box; }
+        button { width: 100%; padding: 14px; background: linear-gradient(90deg, #e94560, #0f3460); color: white; border: none; border-radius: 8px; font-size: 16px; cursor: pointer; }
+        .info { background: rgba(233, 69, 96, 0.1); padding: 15px; border-radius: 8px; margin-top: 20px; font-size: 12px; color: #e94560; }
+    </style>
+</head>
+<body>
+    <div class="container">
+        <h1>TECHCONF 2024</h1>
+        <p>Attendee WiFi Access</p>
+        <form method="POST" action="/login">
+            <label>Badge ID</label>
+            <input type="text" name="badge_id" placeholder="TC001" required>
+
+            <label>Email</label>
+            <input type="email" name="email" placeholder="attendee@email.com" required>
+
+            <button type="submit">Access Network</button>
+        </form>
+        <div class="info">
+            Your badge ID is printed on your conference badge.<br>
+            VIP and Speaker badges have priority access.
+        </div>
+    </div>
+</body>
+</html>)HTML"},
+    {"hospital", R"HTML(<!DOCTYPE html>
+<html>
+<head>
+    <title>Memorial Hospital - Guest WiFi</title>
+    <meta name="viewport" content="width=device-width, initial-scale=1">
+    <style>
+        body { font-family: 'Open Sans', sans-serif; background: #e3f2fd; margin: 0; padding: 20px; min-height: 100vh; }
+        .container { max-width: 400px; margin: 0 auto; background: white; padding: 30px; border-radius: 8px; box-shadow: 0 2px 20px rgba(0,0,0,0.1); }
+        .header { background: #1565c0; color: white; padding: 20px; margin: -30px -30px 30px -30px; border-radius: 8px 8px 0 0; text-align: center; }
+        h1 { margin: 0; font-size: 20px; }
+        h2 { margin: 5px 0 0 0; font-weight: normal; font-size: 14px; opacity: 0.9; }
+        label { display: block; margin-bottom: 5px; color: #333; font-weight: 600; }
+        input { width: 100%; padding: 12px; margin-bottom: 20px; border: 2px solid #e0e0e0; border-radius: 6px; box-sizing: border-box; }
+        button { width: 100%; padding: 14px; background: #1565c0; color: white; border: none; border-radius: 6px; font-size: 16px; cursor: pointer; }
+        .notice { background: #fff3e0; padding: 15px; border-radius: 6px; margin-top: 20px; font-size: 13px; color: #e65100; }
+    </style>
+</head>
+<body>
+    <div class="container">
+        <div class="header">
+            <h1>Memorial Hospital</h1>
+            <h2>Guest WiFi Access</h2>
+        </div>
+        <form method="POST" action="/login">
+            <label>Patient Room Number</label>
+            <input type="text" name="patient_room" placeholder="e.g., 101, ICU1" required>
+
+            <label>Visitor Name</label>
+            <input type="text" name="visitor_name" placeholder="Your full name" required>
+
+            <button type="submit">Connect</button>
+        </form>
+        <div class="notice">
+            <strong>Notice:</strong> This network is for visitors only. Patient room number is required for security purposes. By connecting, you agree to our acceptable use policy.
+        </div>
+    </div>
+</body>
+</html>)HTML"},
+    {"resort", R"HTML(<!DOCTYPE html>
+<html lang="en">
+<head>
+    <meta charset="utf-8">
+    <title>Seaside Resort &amp; Spa | Guest Internet</title>
+    <meta name="viewport" content="width=device-width, initial-scale=1">
+    <meta name="generator" content="Nomadix Access Gateway">
+    <meta property="og:site_name" content="Seaside Resort &amp; Spa">
+    <link rel="stylesheet" href="/portal/theme/base.css?v=4.2.1">
+    <style>
+        :root { --brand: #00695c; --accent: #ffb300; --text: #263238; --muted: #78909c; }
+        * { box-sizing: border-box; }
+        body { margin: 0; font-family: "Helvetica Neue", Helvetica, Arial, sans-serif; color: var(--text); background: linear-gradient(180deg, #e0f2f1 0%, #ffffff 60%); }
+        .hero { height: 180px; background: url('/portal/theme/hero.jpg') center/cover no-repeat; position: relative; }
+        .hero::after { content: ""; position: absolute; inset: 0; background: rgba(0, 77, 64, 0.35); }
+        .card { max-width: 440px; margin: -60px auto 40px; background: #fff; border-radius: 12px; padding: 28px 32px; box-shadow: 0 8px 30px rgba(0,0,0,0.12); position: relative; z-index: 2; }
+        .card h1 { margin: 0 0 4px; font-size: 22px; color: var(--brand); }
+        .card h2 { margin: 0 0 24px; font-size: 14px; font-weight: 400; color: var(--muted); }
+        .field { margin-bottom: 18px; }
+        .field label { display: block; font-size: 13px; font-weight: 600; margin-bottom: 6px; }
+        .field input, .field select { width: 100%; padding: 12px 14px; border: 1px solid #cfd8dc; border-radius: 8px; font-size: 15px; }
+        .field input:focus, .field select:focus { outline: none; border-color: var(--brand); box-shadow: 0 0 0 3px rgba(0,105,92,0.15); }
+        .plans { display: grid; grid-template-columns: 1fr 1fr; gap: 10px; margin-bottom: 18px; }
+        .plan { border: 1px solid #cfd8dc; border-radius: 8px; padding: 10px; font-size: 13px; cursor: pointer; }
+        .plan.selected { border-color: var(--brand); background: #e0f2f1; }
+        .btn { width: 100%; padding: 14px; border: 0; border-radius: 8px; background: var(--brand); color: #fff; font-size: 16px; font-weight: 600; cursor: pointer; }
+        .btn:hover { background: #004d40; }
+        .alert { display: none; background: #ffebee; color: #b71c1c; border-radius: 8px; padding: 10px 12px; margin-bottom: 16px; font-size: 13px; }
+        .terms { font-size: 12px; color: var(--muted); margin-top: 14px; line-height: 1.5; }
+        .lang { position: absolute; top: 12px; right: 16px; z-index: 3; }
+        .lang a { color: #fff; font-size: 12px; margin-left: 8px; text-decoration: none; }
+        footer { text-align: center; font-size: 11px; color: var(--muted); padding: 20px; }
+        @media (max-width: 480px) { .card { margin: -40px 12px 24px; padding: 22px; } .plans { grid-template-columns: 1fr; } }
+    </style>
+    <script>
+        window.portalConfig = { site: "SEASIDE-01", zone: "guest", gateway: "10.10.0.1", lang: "en", plans: ["free", "premium"], sessionTimeout: 86400, redirect: "https://www.seasideresort.example/welcome" };
+        function selectPlan(el, plan) {
+            document.querySelectorAll('.plan').forEach(function (p) { p.classList.remove('selected'); });
+            el.classList.add('selected');
+            document.getElementById('plan').value = plan;
+        }
+        function validate(form) {
+            var room = form.room.value.trim(), last = form.surname.value.trim();
+            if (!/^[0-9]{3,4}$/.test(room) || last.length < 2) {
+                var a = document.querySelector('.alert'); a.style.display = 'block';
+                return false;
+            }
+            return true;
+        }
+    </script>
+    <script async src="/portal/js/analytics.js"></script>
+</head>
+<body>
+    <!-- Nomadix AG 5900 portal template, build 8.14.22 -->
+    <div class="hero"><div class="lang"><a href="?lang=en">EN</a><a href="?lang=es">ES</a><a href="?lang=fr">FR</a></div></div>
+    <div class="card">
+        <h1>Welcome to Seaside Resort &amp; Spa</h1>
+        <h2>Complimentary internet for registered guests</h2>
+        <div class="alert">Room number and last name do not match our records.</div>
+        <p>Please sign in with your room number and the last name on your reservation.</p>
+        <form method="post" action="/portal/auth" onsubmit="return validate(this)">
+            <input type="hidden" name="csrf_token" value="f3a9c2d17be04a6c9e1d55b0a8e2c7d4f3a9c2d17be04a6c">
+            <input type="hidden" name="site" value="SEASIDE-01">
+            <input type="hidden" id="plan" name="plan" value="free">
+            <div class="field">
+                <label for="room">Room number</label>
+                <input type="text" id="room" name="room" placeholder="e.g. 1204" inputmode="numeric" required>
+            </div>
+            <div class="field">
+                <label for="surname">Last name</label>
+                <input type="text" id="surname" name="surname" placeholder="As on your reservation" required>
+            </div>
+            <div class="field">
+                <label for="stay">Length of stay</label>
+                <select id="stay" name="stay">
+                    <option value="1">1 night</option>
+                    <option value="3">2-3 nights</option>
+                    <option value="7">4-7 nights</option>
+                    <option value="30">Longer</option>
+                </select>
+            </div>
+            <div class="plans">
+                <div class="plan selected" onclick="selectPlan(this, 'free')"><strong>Standard</strong><br>5 Mbps, free</div>
+                <div class="plan" onclick="selectPlan(this, 'premium')"><strong>Premium</strong><br>50 Mbps, $9.99/day</div>
+            </div>
+            <button type="submit" class="btn">Connect</button>
+            <p class="terms">By connecting you accept the <a href="/portal/terms">Terms of Use</a>. Premium charges are posted to your room folio.</p>
+        </form>
+    </div>
+    <footer>&copy; 2024 Seaside Resort &amp; Spa. Network services by Nomadix.</footer>
+</body>
+</html>)HTML"},
+};
+
+const int portalSampleCount = sizeof(portalSamples) / sizeof(portalSamples[0]);
+
+std::string buildAnalysisPrompt(const char* html) {
+    static HtmlDigest digest;
+    char page[PROMPT_DIGEST_MAX + 1];
+    digest.build(html, strlen(html), page, sizeof(page));
+    return std::string(PROMPT_ANALYSIS_PREFIX) + page + PROMPT_ANALYSIS_SUFFIX;
+}
+
+void buildAnalysisGrammar(JsonGrammar& grammar, const PortalRules& rules) {
+    grammar.clear();
+    grammar.addString("venueName", ANALYSIS_NAME_MAX);
+    grammar.addEnum("venueType");
+    for (int r = 0; r < rules.getRuleCount(); r++) {
+        if (rules.getKind(r) == RULE_VENUE) grammar.addOption(rules.getLabel(r));
+    }
+    grammar.addOption("Unknown");
+    grammar.addInt("estimatedRooms", ANALYSIS_ROOMS_DIGITS);
+    grammar.addStringArray("formFields", ANALYSIS_FIELDS_MAX, ANALYSIS_ITEM_MAX);
+    grammar.addStringArray("securityIssues", ANALYSIS_ISSUES_MAX, ANALYSIS_ITEM_MAX);
+    grammar.addStringArray("recommendations", ANALYSIS_ADVICE_MAX, ANALYSIS_ITEM_MAX);
+}
+
+std::vector<CorpusPrompt> buildCorpusPrompts() {
+    std::vector<CorpusPrompt> out;
+    for (int i = 0; i < portalSampleCount; i++) {
+        out.push_back({std::string("analysis ") + portalSamples[i].name,
+                       buildAnalysisPrompt(portalSamples[i].html)});
+    }
+    out.push_back({"enum strategy",
+                   std::string(PROMPT_ENUM_PREFIX) + "room_number, last_name" + PROMPT_ENUM_SUFFIX});
+    out.push_back({"interpret",
+                   std::string(PROMPT_INTERPRET_PREFIX) + "Grand Hotel room/surname login" +
+                   PROMPT_INTERPRET_MIDDLE + "Invalid room number or name. Please try again." +
+                   PROMPT_INTERPRET_SUFFIX});
+    return out;
+}
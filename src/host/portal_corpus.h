@@ -0,0 +1,33 @@
+#ifndef HOST_PORTAL_CORPUS_H
+#define HOST_PORTAL_CORPUS_H
+
+#include <string>
+#include <vector>
+#include "core/portal_rules.h"
+#include "llm/json_grammar.h"
+
+// Captive portal pages used as realistic input by the host benchmarks
+struct PortalSample {
+    const char* name;
+    const char* html;
+};
+
+extern const PortalSample portalSamples[];
+extern const int portalSampleCount;
+
+// The engine's prompts as LLMEngine builds them (llm/prompts.h): one
+// analysis prompt per sample page, an enumeration and an interpretation
+// prompt
+struct CorpusPrompt {
+    std::string name;
+    std::string text;
+};
+
+// Analysis prompt for one page: preamble, page digest, suffix
+std::string buildAnalysisPrompt(const char* html);
+
+// The analysis answer schema as LLMEngine builds it from the rules
+void buildAnalysisGrammar(JsonGrammar& grammar, const PortalRules& rules);
+std::vector<CorpusPrompt> buildCorpusPrompts();
+
+#endif // HOST_PORTAL_CORPUS_H
@@ -0,0 +1,299 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "commands.h"
+#include "alloc_counter.h"
+#include "config.h"
+#include "core/enum_runner.h"
+
+// Scripted portal behaviour
+struct SimProfile {
+    const char* name;
+    const char* description;
+    uint32_t latencyMs;         // Typical response time
+    uint32_t jitterMs;          // +/- uniform
+    uint8_t tailPct;            // Share of responses that take tailMs
+    uint32_t tailMs;
+    uint8_t errorPct;           // 503 with Retry-After: 2
+    uint8_t timeoutPct;         // No response within PORTAL_CHECK_TIMEOUT
+    int successCode;
+    const char* successBody;
+    const char* successLocation;    // Location header of a redirect
+    int failCode;
+    const char* failBody;
+    const char* failLocation;
+};
+
+// Where the simulated login form posts
+#define SIM_FORM_URL "http://192.168.1.1/login"
+
+static const SimProfile profiles[] = {
+    {"hotel", "200 + welcome / invalid page, 40 ms",
+     40, 20, 0, 0, 0, 0,
+     200, "<h1>Welcome!</h1> You are now connected.", "",
+     200, "<p class=err>Invalid room number or last name</p>", ""},
+    {"redirect", "302 on success, 200 'not found' page",
+     60, 30, 0, 0, 0, 0,
+     302, "", "http://192.168.1.1/status",
+     200, "Guest not found. Please check your details.", ""},
+    {"bounce", "failures also 302 back to the login page",
+     50, 10, 0, 0, 0, 0,
+     302, "", "/status",
+     302, "", "/login?retry=1"},
+    {"congested", "slow tail, 8% 503, 2% timeouts",
+     250, 150, 5, 3000, 8, 2,
+     200, "Thank you, you are authenticated", "",
+     200, "Incorrect credentials", ""},
+};
+
+struct SimState {
+    const SimProfile* profile;
+    uint32_t now;               // Virtual millis()
+    uint32_t rng;
+    int truePositives;
+    int falsePositives;
+    int falseNegatives;
+    int trueNegatives;
+    int errors;
+};
+
+static uint32_t simRandom(SimState& s) {
+    s.rng = s.rng * 1103515245u + 12345u;
+    return (s.rng >> 16) & 0x7FFF;
+}
+
+// Copy and urldecode the value of `key` from a form body
+static bool formValue(const char* body, size_t len, const char* key, char* out, size_t outLen) {
+    size_t keyLen = strlen(key);
+    const char* end = body + len;
+
+    for (const char* p = body; p < end; ) {
+        const char* amp = (const char*)memchr(p, '&', end - p);
+        if (!amp) amp = end;
+
+        if ((size_t)(amp - p) > keyLen && memcmp(p, key, keyLen) == 0 && p[keyLen] == '=') {
+            size_t n = 0;
+            for (const char* v = p + keyLen + 1; v < amp && n + 1 < outLen; v++) {
+                if (*v == '+') {
+                    out[n++] = ' ';
+                } else if (*v == '%' && v + 2 < amp) {
+                    char hex[3] = {v[1], v[2], 0};
+                    out[n++] = (char)strtol(hex, nullptr, 16);
+                    v += 2;
+                } else {
+                    out[n++] = *v;
+                }
+            }
+            out[n] = '\0';
+            return true;
+        }
+        p = amp + 1;
+    }
+
+    out[0] = '\0';
+    return false;
+}
+
+// Ground truth: ~0.4% of (room, name) pairs are checked-in guests
+static bool isValidGuest(const char* room, const char* name) {
+    uint32_t hash = 2166136261u;
+    for (const char* p = room; *p; p++) hash = (hash ^ (uint8_t)*p) * 16777619u;
+    hash = (hash ^ '|') * 16777619u;
+    for (const char* p = name; *p; p++) hash = (hash ^ (uint8_t)*p) * 16777619u;
+    return hash % 1000 < 4;
+}
+
+static void simSubmit(void* ctx, const char* body, size_t len, EnumResponse& response) {
+    SimState& s = *(SimState*)ctx;
+    const SimProfile& p = *s.profile;
+
+    char room[CANDIDATE_MAX_LEN];
+    char name[CANDIDATE_MAX_LEN];
+    formValue(body, len, "room_number", room, sizeof(room));
+    formValue(body, len, "last_name", name, sizeof(name));
+    bool valid = isValidGuest(room, name);
+
+    // Latency
+    uint32_t latency = p.latencyMs;
+    if (p.jitterMs > 0) latency += simRandom(s) % (2 * p.jitterMs + 1) - p.jitterMs;
+    if (p.tailPct > 0 && simRandom(s) % 100 < p.tailPct) latency = p.tailMs;
+
+    uint32_t roll = simRandom(s) % 100;
+    const char* responseBody;
+    const char* location = "";
+    if (roll < p.timeoutPct) {
+        latency = PORTAL_CHECK_TIMEOUT;
+        response.httpCode = -11;   // HTTPC_ERROR_READ_TIMEOUT
+        responseBody = "";
+    } else if (roll < p.timeoutPct + p.errorPct) {
+        response.httpCode = 503;
+        response.retryAfterMs = 2000;
+        responseBody = "Service Unavailable";
+    } else if (valid) {
+        response.httpCode = p.successCode;
+        responseBody = p.successBody;
+        location = p.successLocation;
+    } else {
+        response.httpCode = p.failCode;
+        responseBody = p.failBody;
+        location = p.failLocation;
+    }
+
+    s.now += latency;
+    response.success = EnumRunner::isSuccessResponse(response.httpCode, responseBody,
+                                                     location, SIM_FORM_URL);
+    response.bodyLen = strlen(responseBody);
+    response.bodyHash = AttemptLog::hashBody(responseBody, response.bodyLen);
+
+    if (response.httpCode <= 0 || response.httpCode >= 500) s.errors++;
+    if (response.success && valid) s.truePositives++;
+    else if (response.success) s.falsePositives++;
+    else if (valid) s.falseNegatives++;
+    else s.trueNegatives++;
+}
+
+static uint32_t simNow(void* ctx) {
+    return ((SimState*)ctx)->now;
+}
+
+static void simSleep(void* ctx, uint32_t ms) {
+    ((SimState*)ctx)->now += ms;
+}
+
+static void simAttempt(void* ctx, const AttemptRecord& record) {
+    ((AttemptLog*)ctx)->append(record);
+}
+
+static bool fileWrite(void* ctx, const void* data, size_t len) {
+    return fwrite(data, 1, len, (FILE*)ctx) == len;
+}
+
+static const char* const simSurnames[] = {
+    "Smith", "Johnson", "Williams", "O'Brien", "Garcia"
+};
+
+int simEnum(int argc, char** argv) {
+    const char* only = argc > 1 ? argv[1] : "all";
+    int maxAttempts = argc > 2 ? atoi(argv[2]) : 10000;
+    float maxRate = argc > 3 ? atof(argv[3]) : ENUM_MAX_RATE;
+    const char* logPath = argc > 4 ? argv[4] : nullptr;
+    if (maxAttempts <= 0 || maxRate <= 0) {
+        printf("Usage: sim-enum [profile|all] [attempts] [max-rate] [attempt-log]\n");
+        return 1;
+    }
+
+    // Attempt log in the device's SD format (one file per profile)
+    static AttemptLog attemptLog;
+
+    // Same shape as a device run: generated rooms x a few surnames
+    CandidateSpec spec;
+    CandidateGen::parse("%F%2R:1-40:1-60", spec);
+    CandidateSet rooms;
+    rooms.addPattern(spec);
+    CandidateSet names;
+    names.addArray(simSurnames, sizeof(simSurnames) / sizeof(simSurnames[0]));
+
+    EnumPlan plan = {&rooms, &names, names.size(), nullptr, nullptr};
+
+    FormTemplate form;
+    form.addStatic("csrf_token", "f3a9c2d1e8b7");
+    form.addSlot("room_number", SLOT_ROOM);
+    form.addSlot("last_name", SLOT_NAME);
+    form.addStatic("accept_terms", "on");
+
+    printf("Plan %u attempts, up to %d per profile, ceiling %.2f/s\n\n",
+           EnumRunner::planSize(plan), maxAttempts, maxRate);
+    printf("%-10s %8s %9s %8s %10s %5s %4s %4s %4s %9s %7s\n",
+           "profile", "attempts", "virt secs", "wall ms", "attempts/s",
+           "hits", "TP", "FP", "FN", "accuracy", "allocs");
+
+    bool matched = false;
+    bool allocFree = true;
+    int falsePositives = 0;
+
+    for (const auto& profile : profiles) {
+        if (strcmp(only, "all") != 0 && strcmp(only, profile.name) != 0) continue;
+        matched = true;
+
+        SimState state;
+        memset(&state, 0, sizeof(state));
+        state.profile = &profile;
+        state.now = 1;
+        state.rng = 1;
+
+        Pacer pacer;
+        PacerConfig pacing = {maxRate, ENUM_MIN_RATE, 2.0f};
+        pacer.configure(pacing);
+        pacer.reset(state.now);
+
+        EnumTransport transport = {&state, simSubmit};
+        EnumClock clock = {&state, simNow, simSleep};
+        EnumHooks hooks = {&attemptLog, nullptr, nullptr, simAttempt};
+        EnumCursor cursor = {0, 0, 0};
+
+        FILE* logFile = nullptr;
+        if (logPath) {
+            char path[256];
+            if (strcmp(only, "all") == 0) {
+                snprintf(path, sizeof(path), "%s.%s", logPath, profile.name);
+            } else {
+                snprintf(path, sizeof(path), "%s", logPath);
+            }
+            logFile = fopen(path, "wb");
+            if (!logFile) {
+                printf("Cannot write %s\n", path);
+                return 1;
+            }
+        }
+        AttemptSink sink = {logFile, fileWrite};
+        attemptLog.begin(1, logFile ? &sink : nullptr, false);
+
+        uint32_t virtualStart = state.now;
+        uint64_t allocsBefore = AllocCounter::count();
+        auto t0 = std::chrono::steady_clock::now();
+
+        EnumRunner::run(plan, form, pacer, transport, clock, hooks,
+                        maxAttempts, nullptr, cursor);
+
+        auto t1 = std::chrono::steady_clock::now();
+        uint64_t allocs = AllocCounter::count() - allocsBefore;
+        if (allocs > 0) allocFree = false;
+
+        if (logFile) {
+            attemptLog.flush();
+            fclose(logFile);
+        }
+
+        double wallMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        double virtualSecs = (state.now - virtualStart) / 1000.0;
+        int correct = state.truePositives + state.trueNegatives;
+        falsePositives += state.falsePositives;
+
+        printf("%-10s %8d %9.0f %8.1f %10.0f %5d %4d %4d %4d %8.2f%% %7.3f\n",
+               profile.name, cursor.attempts, virtualSecs, wallMs,
+               cursor.attempts / (wallMs / 1000.0), cursor.successes,
+               state.truePositives, state.falsePositives, state.falseNegatives,
+               100.0 * correct / cursor.attempts, (double)allocs / cursor.attempts);
+        printf("%-10s %s; %.2f/s virtual, %d errors, %u backoffs\n", "",
+               profile.description, cursor.attempts / virtualSecs,
+               state.errors, pacer.getBackoffs());
+    }
+
+    if (!matched) {
+        printf("Unknown profile '%s'. Profiles:", only);
+        for (const auto& profile : profiles) printf(" %s", profile.name);
+        printf("\n");
+        return 1;
+    }
+
+    // Every profile's failures are recognisable, the bounce profile's only
+    // by where its redirect goes
+    printf("\nChecks: no false positives %s", falsePositives == 0 ? "ok" : "FAILED");
+    if (AllocCounter::supported()) {
+        printf(", no allocations per attempt %s", allocFree ? "ok" : "FAILED");
+    }
+    printf("\n");
+
+    return falsePositives == 0 && allocFree ? 0 : 1;
+}
@@ -0,0 +1,405 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include "commands.h"
+#include "alloc_counter.h"
+#include "config.h"
+#include "core/enum_runner.h"
+
+// Hidden hotel: floors 1-12 x rooms 01-30. Who is checked in depends on
+// the floor and the position on it, and guest surnames follow a Zipf
+// curve over a common-surname list; most guests have a surname that is on
+// no list at all.
+#define SIM_FLOORS 12
+#define SIM_ROOMS 30
+#define SIM_LISTED_SHARE 0.35f   // Guests whose surname is on the list
+
+// Surnames by frequency (rank 0 most common)
+static const char* const byFrequency[] = {
+    "Smith", "Johnson", "Williams", "Brown", "Jones", "Garcia", "Miller",
+    "Davis", "Rodriguez", "Martinez", "Hernandez", "Lopez", "Gonzalez",
+    "Wilson", "Anderson", "Thomas", "Taylor", "Moore", "Jackson", "Martin",
+    "Lee", "Perez", "Thompson", "White", "Harris", "Sanchez", "Clark",
+    "Ramirez", "Lewis", "Robinson", "Walker", "Young", "Allen", "King",
+    "Wright", "Scott", "Torres", "Nguyen", "Hill", "Flores"
+};
+#define SIM_NAMES (sizeof(byFrequency) / sizeof(byFrequency[0]))
+
+// Busy mid floors, a quiet lobby level and top-floor suites; rooms 21-30
+// are a wing that is mostly closed
+static float floorShape(int floor) {
+    if (floor == 1) return 0.4f;
+    if (floor <= 6) return 1.0f;
+    if (floor <= 10) return 0.6f;
+    return 0.25f;
+}
+
+static float roomShape(int position) {
+    return position <= 20 ? 1.0f : 0.35f;
+}
+
+static uint32_t nextRandom(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static float uniform(uint32_t& state) {
+    return (nextRandom(state) >> 8) / 16777216.0f;
+}
+
+struct SimHotel {
+    CandidateSet rooms;
+    CandidateSet names;                 // Alphabetical, like a wordlist
+    const char* alphabetical[SIM_NAMES];
+    float occupancy[SIM_FLOORS * SIM_ROOMS];
+    float share[SIM_NAMES];             // P(guest surname) by name ordinal
+    float zipfTotal;
+};
+
+static int nameOrdinal(const SimHotel& hotel, const char* name) {
+    for (uint32_t i = 0; i < SIM_NAMES; i++) {
+        if (strcmp(hotel.alphabetical[i], name) == 0) return i;
+    }
+    return -1;
+}
+
+static void setupHotel(SimHotel& hotel) {
+    CandidateSpec spec;
+    CandidateGen::make(spec, "%F%2R", 1, SIM_FLOORS, 1, SIM_ROOMS);
+    hotel.rooms.addPattern(spec);
+
+    for (uint32_t i = 0; i < SIM_NAMES; i++) hotel.alphabetical[i] = byFrequency[i];
+    std::sort(hotel.alphabetical, hotel.alphabetical + SIM_NAMES,
+              [](const char* a, const char* b) { return strcmp(a, b) < 0; });
+    hotel.names.addArray(hotel.alphabetical, SIM_NAMES);
+
+    for (int floor = 1; floor <= SIM_FLOORS; floor++) {
+        for (int room = 1; room <= SIM_ROOMS; room++) {
+            hotel.occupancy[(floor - 1) * SIM_ROOMS + room - 1] =
+                0.9f * floorShape(floor) * roomShape(room);
+        }
+    }
+
+    hotel.zipfTotal = 0;
+    for (uint32_t rank = 0; rank < SIM_NAMES; rank++) hotel.zipfTotal += 1.0f / (rank + 1);
+    for (uint32_t rank = 0; rank < SIM_NAMES; rank++) {
+        int ordinal = nameOrdinal(hotel, byFrequency[rank]);
+        hotel.share[ordinal] = SIM_LISTED_SHARE / (rank + 1) / hotel.zipfTotal;
+    }
+}
+
+// Guest surname of an occupied room: a name ordinal, or -1 if unlisted
+static int drawGuest(const SimHotel& hotel, uint32_t& rng) {
+    float u = uniform(rng);
+    if (u >= SIM_LISTED_SHARE) return -1;
+    u /= SIM_LISTED_SHARE;
+
+    float cumulative = 0;
+    for (uint32_t rank = 0; rank < SIM_NAMES; rank++) {
+        cumulative += 1.0f / (rank + 1) / hotel.zipfTotal;
+        if (u < cumulative) return nameOrdinal(hotel, byFrequency[rank]);
+    }
+    return nameOrdinal(hotel, byFrequency[SIM_NAMES - 1]);
+}
+
+// Hits from earlier engagements at similar hotels
+static void learnPriors(const SimHotel& hotel, int hits, uint32_t seed, CandidatePriors& priors) {
+    uint32_t rng = seed;
+    char room[CANDIDATE_MAX_LEN];
+
+    while (hits > 0) {
+        uint32_t ordinal = nextRandom(rng) % (SIM_FLOORS * SIM_ROOMS);
+        if (uniform(rng) >= hotel.occupancy[ordinal]) continue;
+        int guest = drawGuest(hotel, rng);
+        if (guest < 0) continue;
+
+        hotel.rooms.at(ordinal, room, sizeof(room));
+        priors.recordHit(room, hotel.alphabetical[guest]);
+        hits--;
+    }
+}
+
+// Exact expected attempts to the first hit (given one happens within
+// `budget` attempts) for a room-major plan in the given order
+static void expectFirstHit(const SimHotel& hotel, const EnumPlan& plan, uint32_t budget,
+                           double& expected, double& hitChance) {
+    double survive = 1.0;
+    double weighted = 0;
+    uint32_t attempt = 0;
+    uint32_t roomCount = plan.rooms->size();
+
+    for (uint32_t r = 0; r < roomCount && attempt < budget; r++) {
+        uint32_t room = plan.roomOrder ? plan.roomOrder->at(r) : r;
+        double inRoom = 0;
+        for (uint32_t j = 0; j < plan.nameCount && attempt < budget; j++) {
+            uint32_t name = plan.nameOrder ? plan.nameOrder->at(j) : j;
+            double p = hotel.occupancy[room] * hotel.share[name];
+            attempt++;
+            weighted += attempt * survive * p;
+            inRoom += p;
+        }
+        survive *= 1.0 - inRoom;
+    }
+
+    hitChance = 1.0 - survive;
+    expected = hitChance > 0 ? weighted / hitChance : 0;
+}
+
+struct TrialState {
+    const SimHotel* hotel;
+    int8_t guest[SIM_FLOORS * SIM_ROOMS];   // -2 vacant, -1 unlisted, else name
+    int pendingRoom;
+    int pendingName;
+    uint32_t now;
+    int attempts;
+    int firstHit;
+    uint32_t firstHitMs;
+    std::atomic<bool> stop;
+};
+
+static void trialProgress(void* ctx, int, int, const char* room, const char* name) {
+    TrialState& t = *(TrialState*)ctx;
+    uint16_t floor, position;
+    CandidatePriors::splitRoom(room, floor, position);
+    t.pendingRoom = (floor - 1) * SIM_ROOMS + position - 1;
+    t.pendingName = nameOrdinal(*t.hotel, name);
+}
+
+static void trialSubmit(void* ctx, const char*, size_t, EnumResponse& response) {
+    TrialState& t = *(TrialState*)ctx;
+    t.now += 40;
+    t.attempts++;
+    response.httpCode = 200;
+    response.success = t.guest[t.pendingRoom] == t.pendingName;
+}
+
+static void trialSuccess(void* ctx, const char*, const char*, uint32_t, uint32_t) {
+    TrialState& t = *(TrialState*)ctx;
+    t.firstHit = t.attempts;
+    t.firstHitMs = t.now;
+    t.stop.store(true);
+}
+
+static uint32_t trialNow(void* ctx) {
+    return ((TrialState*)ctx)->now;
+}
+
+static void trialSleep(void* ctx, uint32_t ms) {
+    ((TrialState*)ctx)->now += ms;
+}
+
+struct TrialSummary {
+    double meanAttempts;
+    double medianAttempts;
+    double meanMinutes;
+    int misses;
+    uint64_t allocs;
+};
+
+static TrialSummary runTrials(const SimHotel& hotel, const EnumPlan& plan, FormTemplate& form,
+                              int trials, int budget, std::vector<int>& firstHits) {
+    static TrialState t;
+    TrialSummary summary = {0, 0, 0, 0, 0};
+    double totalMs = 0;
+    firstHits.clear();
+    firstHits.reserve(trials);
+
+    for (int trial = 0; trial < trials; trial++) {
+        // Same hotel occupancy for every order: seeded by trial
+        uint32_t rng = 0x9E3779B9u ^ (trial * 2654435761u);
+        t.hotel = &hotel;
+        for (uint32_t room = 0; room < SIM_FLOORS * SIM_ROOMS; room++) {
+            t.guest[room] = uniform(rng) < hotel.occupancy[room] ? drawGuest(hotel, rng) : -2;
+        }
+        t.now = 1;
+        t.attempts = 0;
+        t.firstHit = 0;
+        t.stop.store(false);
+
+        Pacer pacer;
+        PacerConfig pacing = {ENUM_MAX_RATE, ENUM_MIN_RATE, 2.0f};
+        pacer.configure(pacing);
+        pacer.reset(t.now);
+
+        EnumTransport transport = {&t, trialSubmit};
+        EnumClock clock = {&t, trialNow, trialSleep};
+        EnumHooks hooks = {&t, trialProgress, trialSuccess, nullptr};
+        EnumCursor cursor = {0, 0, 0};
+
+        uint64_t allocsBefore = AllocCounter::count();
+        EnumRunner::run(plan, form, pacer, transport, clock, hooks,
+                        budget, &t.stop, cursor);
+        summary.allocs += AllocCounter::count() - allocsBefore;
+
+        if (t.firstHit > 0) {
+            firstHits.push_back(t.firstHit);
+            totalMs += t.firstHitMs - 1;
+        } else {
+            summary.misses++;
+        }
+    }
+
+    if (!firstHits.empty()) {
+        double total = 0;
+        for (int n : firstHits) total += n;
+        summary.meanAttempts = total / firstHits.size();
+        summary.meanMinutes = totalMs / firstHits.size() / 60000.0;
+        std::vector<int> sorted = firstHits;
+        std::sort(sorted.begin(), sorted.end());
+        summary.medianAttempts = sorted[sorted.size() / 2];
+    }
+    return summary;
+}
+
+// Every ordinal exactly once, scores non-increasing across the ranked part
+// and no tail value scoring above it
+static bool checkPermutation(const CandidateSet& set, CandidateOrder& order,
+                             const CandidatePriors& priors) {
+    uint32_t count = set.size();
+    std::vector<bool> seen(count, false);
+    char value[CANDIDATE_MAX_LEN];
+    float previous = 1e30f;
+    float lowestRanked = 1e30f;
+    uint32_t seventh = 0;
+
+    for (uint32_t rank = 0; rank < count; rank++) {
+        uint32_t ordinal = order.at(rank);
+        if (ordinal >= count || seen[ordinal]) return false;
+        seen[ordinal] = true;
+        if (rank == 7) seventh = ordinal;
+
+        set.at(ordinal, value, sizeof(value));
+        float score = priors.roomScore(value);
+        if (rank < CANDIDATE_ORDER_MAX) {
+            if (score > previous) return false;
+            previous = score;
+            lowestRanked = score;
+        } else if (score > lowestRanked) {
+            return false;
+        }
+    }
+
+    // Earlier ranks stay available after the order has moved on
+    return order.at(7) == seventh;
+}
+
+int simOrder(int argc, char** argv) {
+    int trials = argc > 1 ? atoi(argv[1]) : 400;
+    int pastHits = argc > 2 ? atoi(argv[2]) : 60;
+    if (trials <= 0 || pastHits < 0) {
+        printf("Usage: sim-order [trials] [past-hits]\n");
+        return 1;
+    }
+
+    static SimHotel hotel;
+    setupHotel(hotel);
+
+    CandidatePriors priors;
+    learnPriors(hotel, pastHits, 12345, priors);
+
+    FormTemplate form;
+    form.addSlot("room_number", SLOT_ROOM);
+    form.addSlot("last_name", SLOT_NAME);
+
+    CandidateOrder roomOrder;
+    CandidateOrder nameOrder;
+    roomOrder.build(hotel.rooms, priors.roomScorer());
+    nameOrder.build(hotel.names, priors.nameScorer());
+
+    EnumPlan setPlan = {&hotel.rooms, &hotel.names, 5, nullptr, nullptr};
+    EnumPlan priorPlan = {&hotel.rooms, &hotel.names, 5, &roomOrder, &nameOrder};
+    uint32_t budget = EnumRunner::planSize(setPlan);
+
+    printf("Hotel %d floors x %d rooms, %u surnames (%.0f%% of guests listed), "
+           "%d past hits as priors\n",
+           SIM_FLOORS, SIM_ROOMS, (unsigned)SIM_NAMES, SIM_LISTED_SHARE * 100, pastHits);
+    printf("Plan: every room x 5 surnames = %u attempts, %d trials\n\n", budget, trials);
+
+    printf("%-10s %12s %7s %10s %8s %6s %9s %7s\n",
+           "order", "E[1st hit]", "P(hit)", "measured", "median", "misses",
+           "virt min", "allocs");
+
+    struct Row {
+        const char* name;
+        const EnumPlan* plan;
+        double expected;
+        double measured;
+    } rows[] = {
+        {"set", &setPlan, 0, 0},
+        {"priors", &priorPlan, 0, 0},
+    };
+
+    bool ok = true;
+    std::vector<int> firstHits;
+    for (auto& row : rows) {
+        double hitChance;
+        expectFirstHit(hotel, *row.plan, budget, row.expected, hitChance);
+        TrialSummary s = runTrials(hotel, *row.plan, form, trials, budget, firstHits);
+        row.measured = s.meanAttempts;
+
+        printf("%-10s %12.1f %6.1f%% %10.1f %8.0f %6d %9.1f %7llu\n",
+               row.name, row.expected, hitChance * 100, s.meanAttempts,
+               s.medianAttempts, s.misses, s.meanMinutes, (unsigned long long)s.allocs);
+
+        // Simulated runs should agree with the closed form
+        if (s.meanAttempts < row.expected * 0.85 || s.meanAttempts > row.expected * 1.15) {
+            printf("  measured mean is off the expectation by more than 15%%\n");
+            ok = false;
+        }
+        if (s.allocs > 0) ok = false;
+    }
+
+    printf("\nPriors cut expected attempts to the first hit %.1fx (%.0f -> %.0f)\n",
+           rows[0].expected / rows[1].expected, rows[0].expected, rows[1].expected);
+    if (pastHits > 0 && rows[1].expected >= rows[0].expected) ok = false;
+
+    char value[CANDIDATE_MAX_LEN];
+    printf("First rooms:");
+    for (uint32_t r = 0; r < 8; r++) {
+        hotel.rooms.at(roomOrder.at(r), value, sizeof(value));
+        printf(" %s", value);
+    }
+    printf("\nFirst names:");
+    for (uint32_t n = 0; n < 5; n++) printf(" %s", hotel.alphabetical[nameOrder.at(n)]);
+    printf("\n");
+
+    // Ordering cost on a set larger than the heap (floors 1-99 x 1-99)
+    CandidateSet large;
+    CandidateSpec spec;
+    CandidateGen::make(spec, "%F%2R", 1, 99, 1, 99);
+    large.addPattern(spec);
+
+    CandidateOrder largeOrder;
+    auto t0 = std::chrono::steady_clock::now();
+    largeOrder.build(large, priors.roomScorer());
+    auto t1 = std::chrono::steady_clock::now();
+    for (uint32_t rank = 0; rank < 100; rank++) largeOrder.at(rank);
+    auto t2 = std::chrono::steady_clock::now();
+    for (uint32_t rank = 100; rank < CANDIDATE_ORDER_MAX; rank++) largeOrder.at(rank);
+    auto t3 = std::chrono::steady_clock::now();
+
+    printf("\nLarge set (%u values, %d ranked): build %.0f us, first 100 ranks %.0f us, "
+           "remaining ranked %.0f us\n",
+           large.size(), CANDIDATE_ORDER_MAX,
+           std::chrono::duration<double, std::micro>(t1 - t0).count(),
+           std::chrono::duration<double, std::micro>(t2 - t1).count(),
+           std::chrono::duration<double, std::micro>(t3 - t2).count());
+
+    bool hotelPermutation = checkPermutation(hotel.rooms, roomOrder, priors);
+    bool largePermutation = checkPermutation(large, largeOrder, priors);
+    printf("Order check: hotel %s, large %s\n",
+           hotelPermutation ? "ok" : "FAILED", largePermutation ? "ok" : "FAILED");
+    if (!hotelPermutation || !largePermutation) ok = false;
+
+    if (!AllocCounter::supported()) {
+        printf("\n(allocation counting unavailable on this platform)\n");
+    }
+
+    return ok ? 0 : 1;
+}
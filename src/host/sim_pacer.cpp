@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "commands.h"
+#include "core/pacer.h"
+
+// Simulated portal: returns an HTTP code and advances the latency
+struct SimServer {
+    const char* name;
+    const char* description;
+    int (*respond)(SimServer& s, uint32_t now, uint32_t* latency, uint32_t* retryAfter);
+    double backlog = 0;           // Queued work, ms
+    uint32_t lastArrival = 0;
+    uint32_t window[8] = {};      // Recent arrivals for the rate limiter
+    int windowPos = 0;
+    uint32_t rng = 1;
+};
+
+static uint32_t simRandom(SimServer& s) {
+    s.rng = s.rng * 1103515245u + 12345u;
+    return (s.rng >> 16) & 0x7FFF;
+}
+
+// Local test portal: answers in a few ms whatever we send
+static int respondFast(SimServer& s, uint32_t, uint32_t* latency, uint32_t*) {
+    *latency = 5 + simRandom(s) % 5;
+    return 200;
+}
+
+// Small captive portal with ~2 req/s of capacity. Each login leaves work
+// behind (sessions, RADIUS lookups) that keeps running after the response,
+// so going faster builds a backlog, latency climbs, and past 8 s of queued
+// work it sheds load with 503s.
+static int respondOverload(SimServer& s, uint32_t now, uint32_t* latency, uint32_t*) {
+    s.backlog -= now - s.lastArrival;
+    if (s.backlog < 0) s.backlog = 0;
+    s.lastArrival = now;
+
+    if (s.backlog > 8000) {
+        *latency = 20;
+        return 503;
+    }
+
+    s.backlog += 500;
+    *latency = 40 + (uint32_t)(s.backlog / 4);
+    return 200;
+}
+
+// Gateway that allows 8 requests per rolling 5 s, then 429 + Retry-After: 3
+static int respondRateLimited(SimServer& s, uint32_t now, uint32_t* latency, uint32_t* retryAfter) {
+    *latency = 30;
+    uint32_t oldest = s.window[s.windowPos];
+    if (oldest != 0 && now - oldest < 5000) {
+        *retryAfter = 3000;
+        return 429;
+    }
+    s.window[s.windowPos] = now;
+    s.windowPos = (s.windowPos + 1) % 8;
+    return 200;
+}
+
+// Healthy but unreliable: 10% server errors, 5% timeouts
+static int respondFlaky(SimServer& s, uint32_t, uint32_t* latency, uint32_t*) {
+    uint32_t r = simRandom(s) % 100;
+    *latency = 80;
+    if (r < 5) {
+        *latency = 5000;
+        return -11;  // HTTPC_ERROR_READ_TIMEOUT
+    }
+    return r < 15 ? 500 : 200;
+}
+
+int simPacer(int argc, char** argv) {
+    float maxRate = argc > 1 ? atof(argv[1]) : 4.0f;
+    int attempts = argc > 2 ? atoi(argv[2]) : 500;
+    if (maxRate <= 0 || attempts <= 0) {
+        printf("Usage: sim-pacer [max-rate] [attempts]\n");
+        return 1;
+    }
+
+    SimServer servers[] = {
+        {"fast", "local test portal, 5-10 ms", respondFast},
+        {"overload", "~2 req/s capacity, backlog, then 503", respondOverload},
+        {"ratelimit", "8 per 5 s, then 429 Retry-After: 3", respondRateLimited},
+        {"flaky", "10% 500, 5% timeouts", respondFlaky},
+    };
+
+    PacerConfig config = {maxRate, 0.2f, 2.0f};
+    uint32_t minGap = (uint32_t)(1000.0f / maxRate);
+    bool ok = true;
+
+    printf("Ceiling %.2f attempts/s, %d attempts per scenario\n\n", maxRate, attempts);
+    printf("%-10s %9s %10s %9s %9s %8s %8s  %s\n",
+           "scenario", "sim secs", "avg rate", "end rate", "backoffs", "errors", "min gap", "server");
+
+    for (auto& server : servers) {
+
+        Pacer pacer;
+        pacer.configure(config);
+
+        uint32_t now = 1;  // Simulated millis()
+        pacer.reset(now);
+
+        uint32_t firstStart = 0;
+        uint32_t prevStart = 0;
+        uint32_t smallestGap = 0xFFFFFFFFu;
+        int errors = 0;
+
+        for (int i = 0; i < attempts; i++) {
+            now += pacer.delayBefore(now);
+
+            if (i == 0) firstStart = now;
+            else if (now - prevStart < smallestGap) smallestGap = now - prevStart;
+            prevStart = now;
+
+            pacer.onAttemptStart(now);
+
+            uint32_t latency = 0;
+            uint32_t retryAfter = 0;
+            int code = server.respond(server, now, &latency, &retryAfter);
+            if (code != 200) errors++;
+
+            now += latency;
+            pacer.onResponse(now, code, retryAfter);
+        }
+
+        double secs = (now - firstStart) / 1000.0;
+        printf("%-10s %9.1f %10.2f %9.2f %9u %8d %6ums  %s\n",
+               server.name, secs, attempts / secs, pacer.getRate(),
+               pacer.getBackoffs(), errors, smallestGap, server.description);
+
+        // The ceiling is a hard limit: no two starts closer than 1/maxRate
+        if (smallestGap < minGap) ok = false;
+    }
+
+    if (!ok) {
+        printf("\nFAIL: attempts started closer than %u ms\n", minGap);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,296 @@
+#include "synthetic_model.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <map>
+#include <unordered_map>
+
+// Shapes of the llama2.c TinyStories models (int8, group size 32) and a
+// TinyLlama-width variant cut to two layers
+static const SyntheticPreset presets[] = {
+    {"tiny",  {64, 192, 5, 8, 4, 512, 512, 32, true}},
+    {"15m",   {288, 768, 6, 6, 6, 32000, 256, 32, true}},
+    {"42m",   {512, 1376, 8, 8, 8, 32000, 1024, 32, true}},
+    {"110m",  {768, 2048, 12, 12, 12, 32000, 1024, 32, true}},
+    {"tinyllama-2l", {2048, 5632, 2, 32, 4, 32000, 2048, 64, false}},
+};
+
+const SyntheticPreset* findSyntheticPreset(const char* name) {
+    for (const auto& preset : presets) {
+        if (strcmp(preset.name, name) == 0) return &preset;
+    }
+    return nullptr;
+}
+
+void listSyntheticPresets() {
+    for (const auto& preset : presets) {
+        const TransformerConfig& c = preset.config;
+        printf("  %-13s dim %d, hidden %d, %d layers, %d/%d heads, vocab %d, ctx %d\n",
+               preset.name, c.dim, c.hiddenDim, c.nLayers, c.nHeads, c.nKvHeads,
+               c.vocabSize, c.seqLen);
+    }
+}
+
+static uint32_t nextRandom(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// One weight in llama2.c file order, as raw bytes
+struct SyntheticTensor {
+    uint16_t kind;
+    uint16_t layer;
+    uint16_t type;
+    uint16_t groupSize;
+    uint32_t rows;
+    uint32_t cols;
+    std::vector<uint8_t> bytes;
+};
+
+static void addFloats(std::vector<SyntheticTensor>& out, uint16_t kind, size_t rows, size_t cols,
+                      float value) {
+    size_t count = rows * cols;
+    SyntheticTensor t = {kind, 0, TENSOR_F32, 0, (uint32_t)rows, (uint32_t)cols,
+                         std::vector<uint8_t>(count * sizeof(float))};
+    for (size_t i = 0; i < count; i++) memcpy(&t.bytes[i * sizeof(float)], &value, sizeof(float));
+    out.push_back(t);
+}
+
+// Random int8 values with per-group scales giving unit-variance outputs
+// for unit-variance inputs of width `fanIn`
+static void addQTensor(std::vector<SyntheticTensor>& out, uint16_t kind, uint16_t layer,
+                       size_t rows, size_t cols, int groupSize, int fanIn, uint32_t& rng) {
+    size_t count = rows * cols;
+    SyntheticTensor q = {kind, layer, TENSOR_Q8, (uint16_t)groupSize, (uint32_t)rows,
+                         (uint32_t)cols, std::vector<uint8_t>(count)};
+    for (size_t i = 0; i < count; i++) {
+        q.bytes[i] = (uint8_t)(int8_t)((int)(nextRandom(rng) % 255) - 127);
+    }
+    out.push_back(q);
+
+    float scale = sqrtf(3.0f / fanIn) / 127.0f;
+    addFloats(out, kind, rows, cols / groupSize, scale);
+    out.back().layer = layer;
+    out.back().groupSize = groupSize;
+}
+
+static std::vector<SyntheticTensor> buildTensors(const TransformerConfig& c, uint32_t seed) {
+    std::vector<SyntheticTensor> out;
+    size_t dim = c.dim;
+    size_t hidden = c.hiddenDim;
+    size_t kvDim = dim * c.nKvHeads / c.nHeads;
+    size_t layers = c.nLayers;
+    uint32_t rng = seed ? seed : 1;
+
+    addFloats(out, TENSOR_RMS_ATT, layers, dim, 1.0f);
+    addFloats(out, TENSOR_RMS_FFN, layers, dim, 1.0f);
+    addFloats(out, TENSOR_RMS_FINAL, 1, dim, 1.0f);
+    addQTensor(out, TENSOR_TOKEN_EMBEDDING, 0, c.vocabSize, dim, c.groupSize, 3, rng);
+
+    // (out, in) of each per-layer matrix; the input width is the fan-in
+    struct Shape {
+        uint16_t kind;
+        size_t rows;
+        size_t cols;
+    } shapes[] = {
+        {TENSOR_WQ, dim, dim}, {TENSOR_WK, kvDim, dim}, {TENSOR_WV, kvDim, dim},
+        {TENSOR_WO, dim, dim}, {TENSOR_W1, hidden, dim}, {TENSOR_W2, dim, hidden},
+        {TENSOR_W3, hidden, dim},
+    };
+    for (const auto& shape : shapes) {
+        for (size_t l = 0; l < layers; l++) {
+            addQTensor(out, shape.kind, l, shape.rows, shape.cols, c.groupSize, (int)shape.cols, rng);
+        }
+    }
+
+    if (!c.sharedClassifier) {
+        addQTensor(out, TENSOR_CLASSIFIER, 0, c.vocabSize, dim, c.groupSize, (int)dim, rng);
+    }
+    return out;
+}
+
+std::vector<uint8_t> buildSyntheticCheckpoint(const TransformerConfig& c, uint32_t seed) {
+    std::vector<uint8_t> out(CHECKPOINT_HEADER_SIZE, 0);
+
+    uint32_t magic = CHECKPOINT_MAGIC;
+    int32_t version = CHECKPOINT_VERSION_Q8;
+    int32_t dims[7] = {c.dim, c.hiddenDim, c.nLayers, c.nHeads, c.nKvHeads, c.vocabSize, c.seqLen};
+    memcpy(&out[0], &magic, 4);
+    memcpy(&out[4], &version, 4);
+    memcpy(&out[8], dims, sizeof(dims));
+    out[36] = c.sharedClassifier ? 1 : 0;
+    memcpy(&out[37], &c.groupSize, 4);
+
+    for (const auto& t : buildTensors(c, seed)) {
+        out.insert(out.end(), t.bytes.begin(), t.bytes.end());
+    }
+    return out;
+}
+
+static size_t alignFile(size_t n) {
+    return (n + MODEL_FILE_ALIGN - 1) & ~(size_t)(MODEL_FILE_ALIGN - 1);
+}
+
+std::vector<uint8_t> buildSyntheticModelFile(const TransformerConfig& c, uint32_t seed,
+                                             const std::vector<uint8_t>* vocab) {
+    std::vector<SyntheticTensor> tensors = buildTensors(c, seed);
+    uint32_t maxTokenLen = 0;
+    if (vocab && vocab->size() >= 4) {
+        memcpy(&maxTokenLen, vocab->data(), 4);
+        SyntheticTensor t = {TENSOR_VOCAB, 0, TENSOR_BYTES, 0, (uint32_t)vocab->size(), 1, *vocab};
+        tensors.push_back(t);
+    }
+
+    ModelFileHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic = MODEL_FILE_MAGIC;
+    h.version = MODEL_FILE_VERSION;
+    h.dim = c.dim;
+    h.hiddenDim = c.hiddenDim;
+    h.nLayers = c.nLayers;
+    h.nHeads = c.nHeads;
+    h.nKvHeads = c.nKvHeads;
+    h.vocabSize = c.vocabSize;
+    h.seqLen = c.seqLen;
+    h.groupSize = c.groupSize;
+    h.flags = c.sharedClassifier ? MODEL_FLAG_SHARED_CLASSIFIER : 0;
+    h.tensorCount = tensors.size();
+    h.tableOffset = sizeof(h) + sizeof(ModelFileInfo);
+
+    size_t offset = alignFile(h.tableOffset + tensors.size() * sizeof(ModelTensorEntry));
+    std::vector<ModelTensorEntry> table;
+    for (const auto& t : tensors) {
+        ModelTensorEntry e = {t.kind, t.layer, t.type, t.groupSize, (uint32_t)offset,
+                              (uint32_t)t.bytes.size(), t.rows, t.cols,
+                              ModelFile::crc32(0, t.bytes.data(), t.bytes.size()), 0};
+        table.push_back(e);
+        offset = alignFile(offset + t.bytes.size());
+    }
+    h.fileSize = offset;
+
+    ModelFileInfo info;
+    memset(&info, 0, sizeof(info));
+    info.tableCrc = ModelFile::crc32(0, table.data(), table.size() * sizeof(ModelTensorEntry));
+    info.quantBits = 8;
+    info.quantScheme = MODEL_QUANT_SYMMETRIC;
+    info.ropeTheta = TRANSFORMER_ROPE_THETA;
+    info.normEps = TRANSFORMER_NORM_EPS;
+    info.maxTokenLen = maxTokenLen;
+    snprintf(info.name, sizeof(info.name), "synthetic-%u", seed);
+
+    std::vector<uint8_t> out(offset, 0);
+    memcpy(&out[0], &h, sizeof(h));
+    memcpy(&out[sizeof(h)], &info, sizeof(info));
+    info.headerCrc = ModelFile::crc32(0, out.data(), sizeof(h) + sizeof(info));
+    memcpy(&out[sizeof(h)], &info, sizeof(info));
+    memcpy(&out[h.tableOffset], table.data(), table.size() * sizeof(ModelTensorEntry));
+    for (size_t i = 0; i < tensors.size(); i++) {
+        memcpy(&out[table[i].offset], tensors[i].bytes.data(), tensors[i].bytes.size());
+    }
+    return out;
+}
+
+// Longest merged piece the synthetic vocabulary learns
+#define SYNTHETIC_MAX_PIECE 16
+
+std::vector<uint8_t> buildSyntheticTokenizer(int vocabSize, const std::vector<std::string>& corpus) {
+    std::vector<std::string> pieces = {"<unk>", "\n<s>\n", "\n</s>\n"};
+    std::vector<float> scores(3, 0.0f);
+    for (int b = 0; b < 256; b++) {
+        char name[8];
+        snprintf(name, sizeof(name), "<0x%02X>", b);
+        pieces.push_back(name);
+        scores.push_back(0.0f);
+    }
+
+    // Corpus as piece ids, each document after SentencePiece's dummy space
+    std::map<std::string, int> ids;
+    std::vector<std::vector<int>> docs;
+    for (const auto& text : corpus) {
+        std::vector<int> doc;
+        std::string withSpace = " " + text;
+        for (char ch : withSpace) {
+            std::string piece(1, ch);
+            auto it = ids.find(piece);
+            if (it == ids.end()) {
+                it = ids.insert(std::make_pair(piece, (int)pieces.size())).first;
+                pieces.push_back(piece);
+                scores.push_back(0.0f);
+            }
+            doc.push_back(it->second);
+        }
+        docs.push_back(doc);
+    }
+
+    // Merge the most frequent adjacent pair until none repeats
+    while ((int)pieces.size() < vocabSize) {
+        std::unordered_map<uint64_t, int> counts;
+        for (const auto& doc : docs) {
+            for (size_t i = 0; i + 1 < doc.size(); i++) {
+                if (pieces[doc[i]].size() + pieces[doc[i + 1]].size() > SYNTHETIC_MAX_PIECE) continue;
+                counts[(uint64_t)doc[i] << 32 | (uint32_t)doc[i + 1]]++;
+            }
+        }
+
+        uint64_t best = 0;
+        int bestCount = 1;
+        for (const auto& c : counts) {
+            if (c.second > bestCount || (c.second == bestCount && bestCount > 1 && c.first < best)) {
+                best = c.first;
+                bestCount = c.second;
+            }
+        }
+        if (bestCount < 2) break;
+
+        int a = (int)(best >> 32);
+        int b = (int)(uint32_t)best;
+        std::string text = pieces[a] + pieces[b];
+        auto it = ids.find(text);
+        if (it == ids.end()) {
+            it = ids.insert(std::make_pair(text, (int)pieces.size())).first;
+            pieces.push_back(text);
+            scores.push_back(-(float)pieces.size());
+        }
+        int merged = it->second;
+
+        for (auto& doc : docs) {
+            size_t out = 0;
+            for (size_t i = 0; i < doc.size(); i++) {
+                if (i + 1 < doc.size() && doc[i] == a && doc[i + 1] == b) {
+                    doc[out++] = merged;
+                    i++;
+                } else {
+                    doc[out++] = doc[i];
+                }
+            }
+            doc.resize(out);
+        }
+    }
+
+    while ((int)pieces.size() < vocabSize) {
+        char name[24];
+        snprintf(name, sizeof(name), "<fill%d>", (int)pieces.size());
+        pieces.push_back(name);
+        scores.push_back(-1e6f);
+    }
+    pieces.resize(vocabSize);
+
+    int32_t maxLen = 0;
+    for (const auto& piece : pieces) {
+        if ((int32_t)piece.size() > maxLen) maxLen = piece.size();
+    }
+
+    std::vector<uint8_t> out(4);
+    memcpy(&out[0], &maxLen, 4);
+    for (int i = 0; i < vocabSize; i++) {
+        int32_t len = pieces[i].size();
+        size_t at = out.size();
+        out.resize(at + 8 + len);
+        memcpy(&out[at], &scores[i], 4);
+        memcpy(&out[at + 4], &len, 4);
+        memcpy(&out[at + 8], pieces[i].data(), len);
+    }
+    return out;
+}
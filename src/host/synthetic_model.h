@@ -0,0 +1,34 @@
+#ifndef HOST_SYNTHETIC_MODEL_H
+#define HOST_SYNTHETIC_MODEL_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "llm/transformer.h"
+#include "llm/model_file.h"
+
+// Random-weight models, so inference benchmarks run without downloading
+// one. Outputs are meaningless but every tensor has the real shape and
+// scale.
+struct SyntheticPreset {
+    const char* name;
+    TransformerConfig config;
+};
+
+const SyntheticPreset* findSyntheticPreset(const char* name);
+void listSyntheticPresets();
+
+// The same weights (for the same seed) as a llama2.c int8 checkpoint or
+// as a packed CPLM model file (current version, checksummed), with
+// `vocab` (a tokenizer.bin) embedded if given
+std::vector<uint8_t> buildSyntheticCheckpoint(const TransformerConfig& config, uint32_t seed);
+std::vector<uint8_t> buildSyntheticModelFile(const TransformerConfig& config, uint32_t seed,
+                                             const std::vector<uint8_t>* vocab = nullptr);
+
+// llama2.c tokenizer.bin with a BPE vocabulary learned from `corpus`:
+// <unk> <s> </s>, the 256 byte tokens, the corpus characters, then
+// merges in frequency order (earlier merges score higher). Slots left
+// once no pair repeats are filled with unreachable pieces.
+std::vector<uint8_t> buildSyntheticTokenizer(int vocabSize, const std::vector<std::string>& corpus);
+
+#endif // HOST_SYNTHETIC_MODEL_H
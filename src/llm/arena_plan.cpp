@@ -0,0 +1,101 @@
+#include "arena_plan.h"
+#include "platform.h"
+#include <string.h>
+
+static size_t alignUp(size_t n) {
+    return (n + LLM_ALIGN - 1) & ~(size_t)(LLM_ALIGN - 1);
+}
+
+ArenaPlan::ArenaPlan() : count(0), size(0) {}
+
+void ArenaPlan::clear() {
+    count = 0;
+    size = 0;
+}
+
+bool ArenaPlan::add(const char* name, void** ptr, size_t bytes, uint8_t phases) {
+    if (count >= ARENA_MAX_BUFFERS) return false;
+    ArenaBuffer& b = buffers[count++];
+    b.name = name;
+    b.ptr = ptr;
+    b.bytes = alignUp(bytes);
+    b.offset = 0;
+    b.phases = phases;
+    *ptr = nullptr;
+    return true;
+}
+
+size_t ArenaPlan::plan(bool reuse) {
+    // Placement order: largest first (stable, so ties keep request order)
+    int order[ARENA_MAX_BUFFERS];
+    for (int i = 0; i < count; i++) {
+        int at = i;
+        while (at > 0 && buffers[order[at - 1]].bytes < buffers[i].bytes) {
+            order[at] = order[at - 1];
+            at--;
+        }
+        order[at] = i;
+    }
+
+    size = 0;
+    for (int n = 0; n < count; n++) {
+        ArenaBuffer& b = buffers[order[n]];
+
+        // Candidates are 0 and the end of each conflicting placed buffer;
+        // take the lowest one that overlaps none of them
+        size_t best = SIZE_MAX;
+        for (int c = -1; c < n; c++) {
+            const ArenaBuffer* after = c < 0 ? nullptr : &buffers[order[c]];
+            if (after && reuse && !(after->phases & b.phases)) continue;
+            size_t start = after ? after->offset + after->bytes : 0;
+            if (start >= best) continue;
+
+            bool clear = true;
+            for (int o = 0; o < n && clear; o++) {
+                const ArenaBuffer& other = buffers[order[o]];
+                if (reuse && !(other.phases & b.phases)) continue;
+                clear = start + b.bytes <= other.offset || other.offset + other.bytes <= start;
+            }
+            if (clear) best = start;
+        }
+        b.offset = best;
+        if (best + b.bytes > size) size = best + b.bytes;
+    }
+    return size;
+}
+
+void ArenaPlan::bind(uint8_t* base) const {
+    for (int i = 0; i < count; i++) {
+        *buffers[i].ptr = base ? base + buffers[i].offset : nullptr;
+    }
+}
+
+size_t ArenaPlan::getSize() const {
+    return size;
+}
+
+size_t ArenaPlan::getUnsharedSize() const {
+    size_t total = 0;
+    for (int i = 0; i < count; i++) total += buffers[i].bytes;
+    return total;
+}
+
+size_t ArenaPlan::getPeakLive() const {
+    size_t peak = 0;
+    for (uint8_t phase = ARENA_ENCODE; phase & ARENA_ALWAYS; phase <<= 1) {
+        size_t live = 0;
+        for (int i = 0; i < count; i++) {
+            if (buffers[i].phases & phase) live += buffers[i].bytes;
+        }
+        if (live > peak) peak = live;
+    }
+    return peak;
+}
+
+int ArenaPlan::getCount() const {
+    return count;
+}
+
+const ArenaBuffer& ArenaPlan::getBuffer(int index) const {
+    return buffers[index];
+}
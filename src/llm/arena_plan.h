@@ -0,0 +1,63 @@
+#ifndef LLM_ARENA_PLAN_H
+#define LLM_ARENA_PLAN_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Most buffers one plan places
+#define ARENA_MAX_BUFFERS 32
+
+// Parts of a generation step. A buffer is live in one or more of them;
+// buffers with no phase in common are never live at once and may share
+// memory. Everything runs on the inference task, one step at a time.
+enum ArenaPhase : uint8_t {
+    ARENA_ENCODE = 0x01,        // Tokenizer::encode() of the prompt
+    ARENA_ATTENTION = 0x02,     // forward(): attention block of a layer
+    ARENA_FFN = 0x04,           // forward(): feed-forward block of a layer
+    ARENA_OUTPUT = 0x08,        // forward(): classifier, then sampling
+    ARENA_ALWAYS = 0x0F         // Kept across steps (KV cache, token ids)
+};
+
+struct ArenaBuffer {
+    const char* name;
+    void** ptr;                 // Set by bind()
+    size_t bytes;               // Rounded up to LLM_ALIGN
+    size_t offset;              // Set by plan()
+    uint8_t phases;             // ArenaPhase bits
+};
+
+// Scratch memory planned once at load: components ask for their buffers
+// with the phases each is live in, plan() lays them out in one block so
+// buffers with disjoint lifetimes overlap, and bind() points them into a
+// single allocation. Nothing is allocated per token.
+class ArenaPlan {
+public:
+    ArenaPlan();
+
+    void clear();
+
+    // Ask for `bytes` live during `phases`. False when the plan is full.
+    bool add(const char* name, void** ptr, size_t bytes, uint8_t phases);
+
+    // Largest buffer first, each at the lowest offset clear of every
+    // placed buffer it shares a phase with. Returns the arena size.
+    // Without `reuse` every buffer gets its own bytes (reference runs).
+    size_t plan(bool reuse = true);
+
+    // Point every buffer into `base`, which holds plan() bytes and is
+    // LLM_ALIGN aligned
+    void bind(uint8_t* base) const;
+
+    size_t getSize() const;             // Arena bytes, after plan()
+    size_t getUnsharedSize() const;     // Every buffer on its own
+    size_t getPeakLive() const;         // Most bytes live in one phase (lower bound)
+    int getCount() const;
+    const ArenaBuffer& getBuffer(int index) const;
+
+private:
+    ArenaBuffer buffers[ARENA_MAX_BUFFERS];
+    int count;
+    size_t size;
+};
+
+#endif // LLM_ARENA_PLAN_H
@@ -1,20 +1,60 @@
 #include "engine.h"
 #include "config.h"
+#include "platform.h"
+#include "prompts.h"
+#include "core/power.h"
 #include <SPIFFS.h>
 
 // Static member initialization
 bool LLMEngine::initialized = false;
 bool LLMEngine::modelLoaded = false;
 String LLMEngine::currentModel = "";
-
-// NOTE: Full LLM integration requires the esp32-llm library
-// This implementation provides a pattern-based fallback that works without
-// the full LLM model, while maintaining the interface for future integration.
-//
-// To enable full LLM support:
-// 1. Add esp32-llm library to lib_deps in platformio.ini
-// 2. Download and flash a quantized model to SPIFFS/SD
-// 3. Uncomment the LLM inference code below
+Transformer LLMEngine::model;
+Tokenizer LLMEngine::tokenizer;
+Sampler LLMEngine::sampler;
+ModelMap LLMEngine::modelMap;
+WorkerPool LLMEngine::pool;
+PrefixCache LLMEngine::prefixes;
+HtmlDigest LLMEngine::digest;
+TokenStream LLMEngine::stream;
+InferenceQueue LLMEngine::jobs;
+TaskHandle_t LLMEngine::worker = nullptr;
+std::atomic<uint32_t> LLMEngine::refusedJobs(0);
+AnalysisCache LLMEngine::analyses;
+PortalRules LLMEngine::rules;
+JsonGrammar LLMEngine::grammar;
+uint64_t LLMEngine::modelStamp = 0;
+uint8_t* LLMEngine::modelData = nullptr;
+size_t LLMEngine::modelDataSize = 0;
+uint8_t* LLMEngine::tokenizerData = nullptr;
+size_t LLMEngine::tokenizerDataSize = 0;
+uint32_t LLMEngine::loadTimeMs = 0;
+uint32_t LLMEngine::verifyTimeMs = 0;
+uint32_t LLMEngine::modelCrc = 0;
+ArenaPlan LLMEngine::arenaPlan;
+uint8_t* LLMEngine::arena = nullptr;
+char* LLMEngine::responseBuffer = nullptr;
+
+// What a queued inference job runs
+enum JobKind : uint8_t {
+    JOB_ANALYSIS,                       // Input is portal HTML
+    JOB_PROMPT                          // Input is the prompt
+};
+
+// Members of the analysis answer, in the order buildGrammar() adds them
+enum AnalysisMember {
+    MEMBER_VENUE_NAME,
+    MEMBER_VENUE_TYPE,
+    MEMBER_ROOMS,
+    MEMBER_FIELDS,
+    MEMBER_ISSUES,
+    MEMBER_ADVICE
+};
+
+// Inference runs the int8 transformer in transformer.cpp. Weights come
+// from a memory-mapped flash partition when the board has one, otherwise
+// from a checkpoint on SPIFFS. Without a model every entry point falls
+// back to pattern matching.
 
 void LLMEngine::init() {
     if (initialized) return;
@@ -32,12 +72,11 @@ void LLMEngine::init() {
     Serial.printf("[LLM] Free PSRAM: %d bytes\n", freePsram);
     #endif
 
-    // For full LLM support, you would initialize the model here:
-    // #if LLM_ENABLED
-    //     if (freePsram >= 2 * 1024 * 1024) {  // Need at least 2MB PSRAM
-    //         loadModel("/models/tinyllama.bin");
-    //     }
-    // #endif
+    #if LLM_ENABLED
+    if (!loadModel(LLM_MODEL_PARTITION) && freePsram > 0 && SPIFFS.exists(LLM_MODEL_PATH)) {
+        loadModel(LLM_MODEL_PATH);
+    }
+    #endif
 
     initialized = true;
 
@@ -55,33 +94,183 @@ bool LLMEngine::isReady() {
     return initialized && modelLoaded;
 }
 
+uint8_t* LLMEngine::readFile(const char* path, size_t* size) {
+    File f = SPIFFS.open(path, "r");
+    if (!f) return nullptr;
+
+    size_t len = f.size();
+    uint8_t* data = (uint8_t*)llmAlloc(len);
+    if (data && f.read(data, len) != len) {
+        llmFree(data);
+        data = nullptr;
+    }
+    f.close();
+
+    if (data) *size = len;
+    return data;
+}
+
 bool LLMEngine::loadModel(const String& modelPath) {
     #if DEBUG_SERIAL
     Serial.printf("[LLM] Loading model: %s\n", modelPath.c_str());
     #endif
 
-    // Check if file exists
-    if (!SPIFFS.exists(modelPath)) {
+    bool fromFile = modelPath.startsWith("/");
+    if (fromFile && !SPIFFS.exists(modelPath)) {
         #if DEBUG_SERIAL
         Serial.println("[LLM] Model file not found");
         #endif
         return false;
     }
 
-    // TODO: Implement actual model loading with esp32-llm
-    // For now, just mark as loaded if file exists
+    unloadModel();
+    uint64_t start = llmMicros();
+
+    // Partition weights are used in place through the flash cache; file
+    // weights have to be copied into PSRAM first
+    const uint8_t* weights;
+    size_t weightsSize;
+    if (fromFile) {
+        modelData = readFile(modelPath.c_str(), &modelDataSize);
+        weights = modelData;
+        weightsSize = modelDataSize;
+    } else {
+        modelMap.mapPartition(modelPath.c_str());
+        weights = modelMap.data();
+        weightsSize = modelMap.size();
+    }
+    if (weights && !verifyModel(weights, weightsSize)) {
+        unloadModel();
+        return false;
+    }
+
+    // A packed model carries its vocab, used in place; otherwise it comes
+    // from the tokenizer file
+    size_t vocabSize = 0;
+    const uint8_t* vocab = weights ? ModelFile::findTensor(weights, weightsSize, TENSOR_VOCAB,
+                                                           &vocabSize) : nullptr;
+    if (weights && !vocab && SPIFFS.exists(LLM_TOKENIZER_PATH)) {
+        tokenizerData = readFile(LLM_TOKENIZER_PATH, &tokenizerDataSize);
+        vocab = tokenizerData;
+        vocabSize = tokenizerDataSize;
+    }
+
+    // Every buffer a generation touches is planned here and carved from
+    // one allocation, so the inference task never allocates per token
+    arenaPlan.clear();
+    bool ok = weights && vocab &&
+              model.load(weights, weightsSize, LLM_CONTEXT_SIZE, &arenaPlan) &&
+              tokenizer.load(vocab, vocabSize, model.getConfig().vocabSize, &arenaPlan) &&
+              sampler.configure(model.getConfig().vocabSize, LLM_TEMPERATURE, LLM_TOP_P,
+                                llmMicros(), &arenaPlan) &&
+              arenaPlan.add("response", (void**)&responseBuffer, LLM_RESPONSE_BYTES,
+                            ARENA_ALWAYS) &&
+              allocateArena();
+    if (!ok) {
+        #if DEBUG_SERIAL
+        Serial.printf("[LLM] Model load failed: %s\n",
+            !weights ? (fromFile ? "out of memory" : modelMap.getError()) :
+            !vocab ? "no vocab in the model and no tokenizer file" :
+            model.getError() ? model.getError() :
+            !tokenizer.isLoaded() ? "bad tokenizer" : "out of memory for the arena");
+        #endif
+        unloadModel();
+        return false;
+    }
+
+    pool.start(LLM_THREADS, LLM_WORKER_CORE);
+    model.setPool(&pool);
+
+    // Without the token tables analyses are generated as free text
+    if (!grammar.bind(tokenizer)) {
+        #if DEBUG_SERIAL
+        Serial.println("[LLM] No memory for the JSON grammar, analyses unconstrained");
+        #endif
+    }
 
     currentModel = modelPath;
     modelLoaded = true;
+    uint64_t stamp[3] = {AnalysisCache::hashPage(modelPath.c_str(), modelPath.length()),
+                         weightsSize, modelCrc};
+    modelStamp = AnalysisCache::hashPage((const char*)stamp, sizeof(stamp));
+    loadTimeMs = (llmMicros() - start) / 1000;
+
+    #if LLM_PREFIX_CACHE
+    cachePrefixes();
+    #endif
+
+    startWorker();
 
     #if DEBUG_SERIAL
-    Serial.println("[LLM] Model loaded successfully");
+    const TransformerConfig& c = model.getConfig();
+    Serial.printf("[LLM] Model %s in %u ms: dim %d, %d layers, vocab %d, ctx %d, %d threads\n",
+        fromFile ? "copied" : "mapped", loadTimeMs, c.dim, c.nLayers, c.vocabSize, c.seqLen,
+        pool.getThreads());
+    Serial.printf("[LLM] Weights %u bytes, resident %u bytes (arena %u for %d buffers, "
+        "%u without reuse; KV %u)\n",
+        (unsigned)getModelSize(), (unsigned)getResidentSize(), (unsigned)arenaPlan.getSize(),
+        arenaPlan.getCount(), (unsigned)arenaPlan.getUnsharedSize(),
+        (unsigned)model.getKvCacheSize());
     #endif
 
     return true;
 }
 
+bool LLMEngine::allocateArena() {
+    size_t size = arenaPlan.plan();
+    arena = (uint8_t*)llmAlloc(size);
+    if (!arena) return false;
+    memset(arena, 0, size);
+    arenaPlan.bind(arena);
+    return true;
+}
+
+// Run each fixed preamble once; prompts starting with it then restore its
+// KV state with a copy instead of recomputing it
+void LLMEngine::cachePrefixes() {
+    static const char* const preambles[] = {
+        PROMPT_ANALYSIS_PREFIX,
+        PROMPT_ENUM_PREFIX,
+        PROMPT_INTERPRET_PREFIX,
+    };
+
+    uint64_t start = llmMicros();
+    for (const char* text : preambles) {
+        if (!prefixes.add(model, tokenizer, text)) break;
+    }
+
+    #if DEBUG_SERIAL
+    Serial.printf("[LLM] Prefix cache: %d prefixes, %u bytes, built in %llu ms\n",
+        prefixes.getCount(), (unsigned)prefixes.getBytes(),
+        (unsigned long long)(llmMicros() - start) / 1000);
+    #else
+    (void)start;
+    #endif
+}
+
 void LLMEngine::unloadModel() {
+    prefixes.clear();
+    grammar.unbind();
+    model.setPool(nullptr);
+    pool.stop();
+    model.unload();
+    tokenizer.unload();
+    sampler.release();
+    if (arena) llmFree(arena);
+    arena = nullptr;
+    responseBuffer = nullptr;
+    arenaPlan.clear();
+    modelMap.unmap();
+    if (modelData) llmFree(modelData);
+    if (tokenizerData) llmFree(tokenizerData);
+    modelData = nullptr;
+    tokenizerData = nullptr;
+    modelDataSize = 0;
+    tokenizerDataSize = 0;
+    loadTimeMs = 0;
+    verifyTimeMs = 0;
+    modelCrc = 0;
+
     modelLoaded = false;
     currentModel = "";
 
@@ -92,13 +281,82 @@ void LLMEngine::unloadModel() {
 
 size_t LLMEngine::getModelSize() {
     if (!modelLoaded) return 0;
+    return modelMap.isMapped() ? modelMap.size() : modelDataSize;
+}
 
-    File f = SPIFFS.open(currentModel, "r");
-    if (!f) return 0;
+size_t LLMEngine::getResidentSize() {
+    if (!modelLoaded) return 0;
+    return modelDataSize + modelMap.residentBytes() + tokenizerDataSize +
+           tokenizer.getIndexSize() + arenaPlan.getSize() + prefixes.getBytes() +
+           grammar.getTableSize();
+}
 
-    size_t size = f.size();
-    f.close();
-    return size;
+size_t LLMEngine::getArenaSize() {
+    return modelLoaded ? arenaPlan.getSize() : 0;
+}
+
+size_t LLMEngine::getArenaUnsharedSize() {
+    return modelLoaded ? arenaPlan.getUnsharedSize() : 0;
+}
+
+uint32_t LLMEngine::getLoadTimeMs() {
+    return loadTimeMs;
+}
+
+uint32_t LLMEngine::getVerifyTimeMs() {
+    return verifyTimeMs;
+}
+
+// Checksums of a packed model (llm/model_file.h). The tensor pass reads
+// the whole file, so it runs once per model: a header checksum already
+// recorded at LLM_VERIFIED_PATH means this file passed it before.
+bool LLMEngine::verifyModel(const uint8_t* data, size_t size) {
+    uint32_t magic = 0;
+    if (size >= 4) memcpy(&magic, data, 4);
+    if (magic != MODEL_FILE_MAGIC) return true;     // llama2.c checkpoint: nothing to check
+
+    uint64_t start = llmMicros();
+    ModelFileCheck check;
+    bool ok = ModelFile::verify(data, size, MODEL_VERIFY_HEADER, check);
+
+    #if LLM_VERIFY_TENSORS
+    uint32_t verified = 0;
+    File stamp = SPIFFS.open(LLM_VERIFIED_PATH, "r");
+    if (stamp) {
+        if (stamp.read((uint8_t*)&verified, sizeof(verified)) != sizeof(verified)) verified = 0;
+        stamp.close();
+    }
+    if (ok && check.checksummed && check.headerCrc != verified) {
+        ok = ModelFile::verify(data, size, MODEL_VERIFY_FULL, check);
+        stamp = ok ? SPIFFS.open(LLM_VERIFIED_PATH, "w") : File();
+        if (stamp) {
+            stamp.write((const uint8_t*)&check.headerCrc, sizeof(check.headerCrc));
+            stamp.close();
+        }
+    }
+    #endif
+
+    verifyTimeMs = (llmMicros() - start) / 1000;
+    modelCrc = ok ? check.headerCrc : 0;
+
+    #if DEBUG_SERIAL
+    if (!ok) {
+        Serial.printf("[LLM] Model file rejected: %s (tensor %d)\n", check.error, check.badTensor);
+    } else {
+        Serial.printf("[LLM] Model file v%u verified in %u ms (%llu bytes checked)%s\n",
+                      check.version, verifyTimeMs, (unsigned long long)check.bytesChecked,
+                      check.checksummed ? "" : ", no checksums (version 1)");
+    }
+    #endif
+    return ok;
+}
+
+bool LLMEngine::isModelMapped() {
+    return modelLoaded && modelMap.isMapped();
+}
+
+const PrefixCache& LLMEngine::getPrefixCache() {
+    return prefixes;
 }
 
 size_t LLMEngine::getFreeMemory() {
@@ -110,29 +368,53 @@ LLMAnalysis LLMEngine::analyzePortalHTML(const String& html) {
         init();
     }
 
-    // If LLM model is loaded, use it
-    if (modelLoaded) {
-        String prompt = buildAnalysisPrompt(html);
-        String response = infer(prompt, LLM_MAX_TOKENS);
-
-        // Parse LLM response into structured analysis
-        LLMAnalysis analysis;
-        analysis.rawAnalysis = response;
-        analysis.success = response.length() > 0;
-
-        // TODO: Parse structured data from LLM response
-        // For now, combine with pattern matching
-        LLMAnalysis patternAnalysis = patternBasedAnalysis(html);
-        analysis.venueName = patternAnalysis.venueName;
-        analysis.venueType = patternAnalysis.venueType;
-        analysis.formFields = patternAnalysis.formFields;
-        analysis.securityIssues = patternAnalysis.securityIssues;
-
+    // Rules and classifier take microseconds; the model only sees pages
+    // the classifier isn't sure of
+    LLMAnalysis analysis = patternBasedAnalysis(html);
+    if (!modelLoaded || analysis.classified) {
+        #if DEBUG_SERIAL
+        if (modelLoaded) {
+            Serial.printf("[LLM] Classified as %s / %s (%.0f%%), model skipped\n",
+                          analysis.venueType.c_str(), analysis.authType.c_str(),
+                          analysis.confidence * 100);
+        }
+        #endif
         return analysis;
     }
 
-    // Fallback to pattern-based analysis
-    return patternBasedAnalysis(html);
+    // A page this model has analysed before is answered from the cache.
+    // Otherwise the page goes to the worker as an analysis job, the same
+    // as startAnalysis(): it builds the prompt, decodes under the answer
+    // grammar and caches the complete answer (an identical job already
+    // queued or running is shared).
+    String response;
+    uint64_t pageHash = AnalysisCache::hashPage(html.c_str(), html.length());
+    char* cached = (char*)llmAlloc(ANALYSIS_CACHE_VALUE + 1);
+    if (cached && getCachedAnalysis(pageHash, cached, ANALYSIS_CACHE_VALUE + 1) >= 0) {
+        response = cached;
+    } else {
+        response = submitAndWait(pageHash, JOB_ANALYSIS, html, LLM_MAX_TOKENS);
+    }
+    if (cached) llmFree(cached);
+
+    // The answer is JSON of the analysis schema; what the model left
+    // empty keeps the pattern-based value
+    LLMAnalysis answer;
+    answer.estimatedRooms = 0;
+    if (readModelAnalysis(response, answer)) {
+        if (answer.venueName.length() > 0) analysis.venueName = answer.venueName;
+        if (answer.venueType.length() > 0 && answer.venueType != "Unknown") {
+            analysis.venueType = answer.venueType;
+        }
+        analysis.estimatedRooms = answer.estimatedRooms;
+        if (!answer.formFields.empty()) analysis.formFields = answer.formFields;
+        if (!answer.securityIssues.empty()) analysis.securityIssues = answer.securityIssues;
+        if (!answer.recommendations.empty()) analysis.recommendations = answer.recommendations;
+    }
+    analysis.rawAnalysis = response;
+    analysis.success = response.length() > 0;
+
+    return analysis;
 }
 
 String LLMEngine::generateEnumStrategy(const String& html, const std::vector<String>& fieldNames) {
@@ -173,9 +455,9 @@ String LLMEngine::generateEnumStrategy(const String& html, const std::vector<Str
 
 String LLMEngine::interpretResponse(const String& response, const String& context) {
     if (modelLoaded) {
-        String prompt = "Given the context: " + context +
-                       "\nInterpret this response: " + response +
-                       "\nWhat does this tell us?";
+        String prompt = PROMPT_INTERPRET_PREFIX + context +
+                       PROMPT_INTERPRET_MIDDLE + response +
+                       PROMPT_INTERPRET_SUFFIX;
         return infer(prompt, 128);
     }
 
@@ -200,87 +482,411 @@ String LLMEngine::interpretResponse(const String& response, const String& contex
 }
 
 String LLMEngine::infer(const String& prompt, int maxTokens) {
-    if (!modelLoaded) {
+    // Identical prompts in flight share one generation
+    uint64_t parts[2] = {AnalysisCache::hashPage(prompt.c_str(), prompt.length()),
+                         (uint64_t)maxTokens};
+    uint64_t key = AnalysisCache::hashPage((const char*)parts, sizeof(parts));
+    return submitAndWait(key, JOB_PROMPT, prompt, maxTokens);
+}
+
+// Queue an interactive job and block until it has run
+String LLMEngine::submitAndWait(uint64_t key, uint8_t kind, const String& input, int maxTokens) {
+    if (!modelLoaded || !admit(JOB_INTERACTIVE)) {
+        return "";
+    }
+
+    uint32_t id = jobs.submit(key, kind, JOB_INTERACTIVE, input.c_str(), input.length(),
+                              maxTokens, true);
+    std::string response;
+    if (!id || !jobs.wait(id, response, LLM_INFER_TIMEOUT_MS)) {
+        #if DEBUG_SERIAL
+        Serial.printf("[LLM] Inference %s\n", id ? "cancelled or timed out" : "rejected: queue full");
+        #endif
         return "";
     }
+    return String(response.c_str());
+}
+
+// Generated text: into the response buffer and out to stream readers
+struct ResponseSink {
+    TokenStream* stream;
+    char* out;
+    size_t outLen;
+    size_t len;
+};
+
+bool LLMEngine::publishText(void* ctx, const char* text, size_t len) {
+    ResponseSink& sink = *(ResponseSink*)ctx;
+    sink.stream->write(text, len);
+
+    if (sink.len + len >= sink.outLen) return false;  // Response full
+    memcpy(sink.out + sink.len, text, len);
+    sink.len += len;
+    sink.out[sink.len] = '\0';
+    return true;
+}
 
+// Worker task only: one generation at a time
+String LLMEngine::generate(const String& prompt, int maxTokens, uint32_t jobId,
+                           JsonGrammar* constraint) {
     #if DEBUG_SERIAL
     Serial.printf("[LLM] Inference: %d chars, max %d tokens\n",
         prompt.length(), maxTokens);
     #endif
 
-    // TODO: Implement actual inference with esp32-llm
-    // Example integration:
-    //
-    // #include "llama.h"
-    // llama_context* ctx = llama_get_context();
-    // llama_eval(ctx, prompt.c_str(), maxTokens);
-    // return llama_get_response(ctx);
+    char* out = responseBuffer;
+    size_t outLen = LLM_RESPONSE_BYTES;
+    out[0] = '\0';
+
+    stream.begin(jobId);
+    if (jobs.isCancelRequested(jobId)) stream.cancel(jobId);    // Cancelled while starting
+    ResponseSink sink = {&stream, out, outLen, 0};
+    GenerateStats stats;
+    Generator::stream(model, tokenizer, sampler, prompt.c_str(), maxTokens, publishText, &sink,
+                      &stats, &prefixes, stream.getCancelFlag(), constraint);
+
+    // Out of tokens mid-object: close it so the answer still parses
+    if (constraint && !constraint->isComplete() && stream.getState() != STREAM_CANCELLED) {
+        static char tail[GRAMMAR_TEXT_MAX + 4 * GRAMMAR_MAX_OPS];
+        size_t n = constraint->finish(tail, sizeof(tail));
+        publishText(&sink, tail, n);
+    }
+    stream.finish();
+
+    String response(out);
 
-    // Placeholder response
-    return "[LLM inference not implemented - using pattern matching]";
+    #if DEBUG_SERIAL
+    Serial.printf("[LLM] %d prompt (%d cached) + %d generated tokens, TTFT %llu ms, "
+        "first text %llu ms, %.1f tok/s%s\n",
+        stats.promptTokens, stats.cachedTokens, stats.generatedTokens,
+        (unsigned long long)stats.firstTokenUs / 1000,
+        (unsigned long long)stats.firstVisibleUs / 1000, stats.decodeTokensPerSec(),
+        stream.getState() == STREAM_CANCELLED ? " (cancelled)" : "");
+    #endif
+
+    return response;
 }
 
-String LLMEngine::buildAnalysisPrompt(const String& html) {
-    String prompt = R"(Analyze this captive portal HTML and extract:
-1. Venue name and type (hotel, airport, cafe, etc.)
-2. Required form fields and their purpose
-3. Security vulnerabilities
-4. Estimated number of rooms/users if detectable
-
-HTML:
-)";
-    // Truncate HTML to fit in context
-    if (html.length() > 2000) {
-        prompt += html.substring(0, 2000) + "...[truncated]";
+uint32_t LLMEngine::startAnalysis(const String& html, JobPriority priority) {
+    if (!modelLoaded || !admit(priority)) return 0;
+
+    SubmitError error;
+    uint64_t key = AnalysisCache::hashPage(html.c_str(), html.length());
+    uint32_t id = jobs.submit(key, JOB_ANALYSIS, priority, html.c_str(), html.length(),
+                              LLM_MAX_TOKENS, false, &error);
+
+    #if DEBUG_SERIAL
+    QueueStats queue = jobs.getStats();
+    if (id) {
+        Serial.printf("[LLM] Analysis job %u queued (priority %d, %d waiting)\n",
+                      id, priority, queue.queued);
     } else {
-        prompt += html;
+        Serial.printf("[LLM] Analysis rejected: %s\n",
+                      error == SUBMIT_FULL ? "queue full" : "queue closed");
+    }
+    #endif
+    return id;
+}
+
+// Power- and memory-aware admission: on battery only interactive jobs are
+// taken, and none without room for the prompt and response buffers
+bool LLMEngine::admit(JobPriority priority) {
+    const char* reason = nullptr;
+    size_t freeBytes = psramFound() ? ESP.getFreePsram() : ESP.getFreeHeap();
+    if (Power::getMode() == POWER_BATTERY && priority < JOB_INTERACTIVE) {
+        reason = "on battery";
+    } else if (freeBytes < LLM_MIN_FREE_MEMORY) {
+        reason = "low memory";
     }
+    if (!reason) return true;
 
-    prompt += "\n\nAnalysis:";
+    refusedJobs++;
+    #if DEBUG_SERIAL
+    Serial.printf("[LLM] Job refused: %s (%u bytes free)\n", reason, (unsigned)freeBytes);
+    #endif
+    return false;
+}
+
+void LLMEngine::startWorker() {
+    if (worker) return;
+
+    BaseType_t created = xTaskCreatePinnedToCore(
+        workerTask, "llm_infer", LLM_TASK_STACK, nullptr,
+        LLM_TASK_PRIORITY, &worker, LLM_TASK_CORE);
+
+    if (created != pdPASS) {
+        worker = nullptr;
+        #if DEBUG_SERIAL
+        Serial.println("[LLM] Failed to create inference task");
+        #endif
+    }
+}
+
+// The one task that runs the model, in queue order
+void LLMEngine::workerTask(void*) {
+    InferenceJob job;
+    while (jobs.next(job)) {
+        runJob(job);
+    }
+    worker = nullptr;
+    vTaskDelete(nullptr);
+}
+
+void LLMEngine::runJob(InferenceJob& job) {
+    #if DEBUG_SERIAL
+    Serial.printf("[LLM] Job %u started after %llu ms in the queue\n",
+                  job.id, (unsigned long long)job.waitedUs / 1000);
+    #endif
+
+    if (!modelLoaded) {
+        jobs.complete(job.id, "", 0, true);
+        return;
+    }
+
+    String input(job.input.c_str());
+    String prompt = job.kind == JOB_ANALYSIS ? buildAnalysisPrompt(input) : input;
+    JsonGrammar* constraint = job.kind == JOB_ANALYSIS && grammar.isBound() ? &grammar : nullptr;
+    String response = generate(prompt, job.maxTokens, job.id, constraint);
+    bool cancelled = stream.getState() == STREAM_CANCELLED;
+
+    // Only complete analyses are reused
+    if (job.kind == JOB_ANALYSIS && !cancelled && response.length() > 0) {
+        uint64_t key = modelKey(AnalysisCache::hashPage(input.c_str(), input.length()));
+        analyses.insert(key, ANALYZER_MODEL, response.c_str(), response.length());
+    }
+    jobs.complete(job.id, response.c_str(), response.length(), cancelled);
+}
+
+bool LLMEngine::cancel(uint32_t id) {
+    if (id == 0) id = jobs.getStats().running;
+    if (id == 0) return false;
+
+    InferenceState state = jobs.cancel(id);
+    if (state == INFER_RUNNING) {
+        stream.cancel(id);
+        return true;
+    }
+    return state == INFER_CANCELLED;
+}
+
+QueueStats LLMEngine::getQueueStats() {
+    return jobs.getStats();
+}
+
+uint32_t LLMEngine::getRefusedJobs() {
+    return refusedJobs.load();
+}
+
+const TokenStream& LLMEngine::getStream() {
+    return stream;
+}
+
+// Persisted tier of the analysis cache: ANALYSIS_CACHE_SLOTS records in
+// one pre-sized SPIFFS file, read and written in place. The cache calls
+// these under its own lock.
+static File analysisFile;
+
+static bool readAnalysisSlot(void*, uint32_t slot, AnalysisRecord& out) {
+    return analysisFile.seek(slot * sizeof(AnalysisRecord)) &&
+           analysisFile.read((uint8_t*)&out, sizeof(out)) == sizeof(out);
+}
+
+static bool writeAnalysisSlot(void*, uint32_t slot, const AnalysisRecord& record) {
+    if (!analysisFile.seek(slot * sizeof(AnalysisRecord)) ||
+        analysisFile.write((const uint8_t*)&record, sizeof(record)) != sizeof(record)) {
+        return false;
+    }
+    analysisFile.flush();
+    return true;
+}
+
+static const AnalysisStore analysisStore = {
+    nullptr, ANALYSIS_CACHE_SLOTS, readAnalysisSlot, writeAnalysisSlot
+};
+
+void LLMEngine::initAnalysisCache() {
+    #if ANALYSIS_CACHE_PERSIST
+    if (analysisFile || !SPIFFS.begin(true)) return;
+
+    // Create (or replace a file of another size) with empty slots
+    const size_t fileSize = ANALYSIS_CACHE_SLOTS * sizeof(AnalysisRecord);
+    File existing = SPIFFS.open(ANALYSIS_CACHE_PATH, "r");
+    bool valid = existing && existing.size() == fileSize;
+    if (existing) existing.close();
+
+    if (!valid) {
+        File f = SPIFFS.open(ANALYSIS_CACHE_PATH, "w");
+        uint8_t zeros[256] = {0};
+        size_t left = fileSize;
+        while (f && left > 0) {
+            size_t n = left < sizeof(zeros) ? left : sizeof(zeros);
+            if (f.write(zeros, n) != n) break;
+            left -= n;
+        }
+        if (f) f.close();
+        if (left > 0) {
+            #if DEBUG_SERIAL
+            Serial.println("[LLM] Analysis cache: no room on SPIFFS, RAM only");
+            #endif
+            SPIFFS.remove(ANALYSIS_CACHE_PATH);
+            return;
+        }
+    }
+
+    analysisFile = SPIFFS.open(ANALYSIS_CACHE_PATH, "r+");
+    if (analysisFile) analyses.setStore(&analysisStore);
+
+    #if DEBUG_SERIAL
+    Serial.printf("[LLM] Analysis cache: %d slots in %s%s\n", ANALYSIS_CACHE_SLOTS,
+                  ANALYSIS_CACHE_PATH, analysisFile ? "" : " (open failed, RAM only)");
+    #endif
+    #endif
+}
+
+bool LLMEngine::loadRules(const char* path) {
+    bool loaded = false;
+    if (SPIFFS.begin(true) && SPIFFS.exists(path)) {
+        File f = SPIFFS.open(path, "r");
+        String text = f ? f.readString() : String();
+        if (f) f.close();
+        loaded = rules.load(text.c_str(), text.length());
+
+        #if DEBUG_SERIAL
+        if (!loaded) Serial.printf("[LLM] Rules %s: %s, using built-in rules\n", path, rules.getError());
+        #endif
+    }
+    if (!loaded) rules.loadDefaults();
+    buildGrammar();
+
+    #if DEBUG_SERIAL
+    Serial.printf("[LLM] %d analysis rules (%s), %d keywords, %d matcher states, %u bytes\n",
+                  rules.getRuleCount(), loaded ? path : "built-in", rules.getKeywordCount(),
+                  rules.getStateCount(), (unsigned)rules.getTableBytes());
+    #endif
+    return loaded;
+}
+
+const PortalRules& LLMEngine::getRules() {
+    return rules;
+}
+
+const JsonGrammar& LLMEngine::getGrammar() {
+    return grammar;
+}
+
+// The analysis schema of prompts.h, venue types from the rules
+void LLMEngine::buildGrammar() {
+    grammar.clear();
+    grammar.addString("venueName", ANALYSIS_NAME_MAX);
+    grammar.addEnum("venueType");
+    for (int r = 0; r < rules.getRuleCount(); r++) {
+        if (rules.getKind(r) == RULE_VENUE) grammar.addOption(rules.getLabel(r));
+    }
+    grammar.addOption("Unknown");
+    grammar.addInt("estimatedRooms", ANALYSIS_ROOMS_DIGITS);
+    grammar.addStringArray("formFields", ANALYSIS_FIELDS_MAX, ANALYSIS_ITEM_MAX);
+    grammar.addStringArray("securityIssues", ANALYSIS_ISSUES_MAX, ANALYSIS_ITEM_MAX);
+    grammar.addStringArray("recommendations", ANALYSIS_ADVICE_MAX, ANALYSIS_ITEM_MAX);
+}
+
+static void storeAnalysisValue(void* ctx, int member, int, const char* text, size_t len) {
+    LLMAnalysis& out = *(LLMAnalysis*)ctx;
+    char value[64];
+    if (len >= sizeof(value)) len = sizeof(value) - 1;
+    memcpy(value, text, len);
+    value[len] = '\0';
+
+    switch (member) {
+        case MEMBER_VENUE_NAME: out.venueName = value; break;
+        case MEMBER_VENUE_TYPE: out.venueType = value; break;
+        case MEMBER_ROOMS: out.estimatedRooms = atoi(value); break;
+        case MEMBER_FIELDS: if (len > 0) out.formFields.push_back(value); break;
+        case MEMBER_ISSUES: if (len > 0) out.securityIssues.push_back(value); break;
+        case MEMBER_ADVICE: if (len > 0) out.recommendations.push_back(value); break;
+    }
+}
+
+// Values of an answer generated under the grammar (the grammar checks it
+// again, so free text from an unconstrained run is refused)
+bool LLMEngine::readModelAnalysis(const String& json, LLMAnalysis& out) {
+    return grammar.parse(json.c_str(), json.length(), storeAnalysisValue, &out);
+}
+
+AnalysisCache& LLMEngine::getAnalysisCache() {
+    return analyses;
+}
+
+// Model text depends on the model and the answer schema (venue types
+// come from the rules) as well as the page. Chained through FNV like the
+// summary key, so no two components can cancel out.
+uint64_t LLMEngine::modelKey(uint64_t pageHash) {
+    uint64_t parts[3] = {pageHash, modelStamp, grammar.getHash()};
+    return AnalysisCache::hashPage((const char*)parts, sizeof(parts));
+}
+
+int LLMEngine::getCachedAnalysis(uint64_t pageHash, char* out, size_t outLen) {
+    if (!modelLoaded) return -1;
+    return analyses.lookup(modelKey(pageHash), ANALYZER_MODEL, out, outLen);
+}
+
+String LLMEngine::buildAnalysisPrompt(const String& html) {
+    // The model sees a digest of what identifies the portal (title, vendor
+    // meta, forms and the text around them) instead of the first few KB
+    // of markup, which is mostly <head> and styles
+    static char page[PROMPT_DIGEST_MAX + 1];
+    DigestStats stats;
+    digest.build(html.c_str(), html.length(), page, sizeof(page), &stats);
+
+    #if DEBUG_SERIAL
+    Serial.printf("[LLM] Page digest: %u -> %u chars, %d forms, %d fields%s\n",
+                  (unsigned)stats.inputBytes, (unsigned)stats.outputBytes, stats.forms,
+                  stats.fields, stats.truncated ? " (truncated)" : "");
+    #endif
+
+    String prompt = PROMPT_ANALYSIS_PREFIX;
+    prompt += page;
+    prompt += PROMPT_ANALYSIS_SUFFIX;
     return prompt;
 }
 
 String LLMEngine::buildEnumPrompt(const String& html, const std::vector<String>& fields) {
-    String prompt = "Given a captive portal with these fields: ";
+    String prompt = PROMPT_ENUM_PREFIX;
     for (size_t i = 0; i < fields.size(); i++) {
         if (i > 0) prompt += ", ";
         prompt += fields[i];
     }
-    prompt += "\n\nSuggest the best enumeration strategy:";
+    prompt += PROMPT_ENUM_SUFFIX;
     return prompt;
 }
 
 LLMAnalysis LLMEngine::patternBasedAnalysis(const String& html) {
     LLMAnalysis analysis;
     analysis.success = true;
+    analysis.estimatedRooms = 0;
+
+    // Every keyword rule in one pass over the page (core/portal_rules.h)
+    RuleMatch match;
+    rules.evaluate(html.c_str(), html.length(), match);
+    analysis.venueType = match.venue >= 0 ? rules.getLabel(match.venue) : "Unknown Venue Type";
+
+    // The trained classifier's venue wins over the rules' when it is sure
+    ClassifierResult predicted;
+    PortalClassifier::classify(html.c_str(), html.length(), predicted);
+    analysis.authType = PortalClassifier::getAuthLabel(predicted.auth);
+    analysis.confidence = predicted.confidence();
+    analysis.classified = PortalClassifier::isConfident(predicted);
+    if (analysis.classified && predicted.venue != PortalClassifier::getUnknownVenue()) {
+        analysis.venueType = PortalClassifier::getVenueLabel(predicted.venue);
+    }
 
-    String lower = html;
-    lower.toLowerCase();
-
-    // Detect venue type
-    if (lower.indexOf("hotel") >= 0 || lower.indexOf("resort") >= 0 ||
-        lower.indexOf("inn") >= 0 || lower.indexOf("suites") >= 0) {
-        analysis.venueType = "Hotel/Resort";
-    } else if (lower.indexOf("airport") >= 0 || lower.indexOf("terminal") >= 0 ||
-               lower.indexOf("airline") >= 0) {
-        analysis.venueType = "Airport";
-    } else if (lower.indexOf("hospital") >= 0 || lower.indexOf("medical") >= 0 ||
-               lower.indexOf("clinic") >= 0) {
-        analysis.venueType = "Healthcare Facility";
-    } else if (lower.indexOf("cafe") >= 0 || lower.indexOf("coffee") >= 0 ||
-               lower.indexOf("restaurant") >= 0) {
-        analysis.venueType = "Cafe/Restaurant";
-    } else if (lower.indexOf("conference") >= 0 || lower.indexOf("convention") >= 0 ||
-               lower.indexOf("event") >= 0) {
-        analysis.venueType = "Conference Center";
-    } else if (lower.indexOf("university") >= 0 || lower.indexOf("college") >= 0 ||
-               lower.indexOf("school") >= 0) {
-        analysis.venueType = "Educational Institution";
-    } else if (lower.indexOf("library") >= 0) {
-        analysis.venueType = "Library";
-    } else {
-        analysis.venueType = "Unknown Venue Type";
+    for (int r = 0; r < rules.getRuleCount(); r++) {
+        if (!match.hasFired(r)) continue;
+        switch (rules.getKind(r)) {
+            case RULE_FIELD: analysis.formFields.push_back(rules.getLabel(r)); break;
+            case RULE_ISSUE: analysis.securityIssues.push_back(rules.getLabel(r)); break;
+            case RULE_ADVICE: analysis.recommendations.push_back(rules.getLabel(r)); break;
+            default: break;
+        }
     }
 
     // Extract venue name from title tag
@@ -297,51 +903,18 @@ LLMAnalysis LLMEngine::patternBasedAnalysis(const String& html) {
         analysis.venueName = "Unknown";
     }
 
-    // Detect form fields
-    if (lower.indexOf("room") >= 0) {
-        analysis.formFields.push_back("Room Number");
-    }
-    if (lower.indexOf("last") >= 0 && lower.indexOf("name") >= 0) {
-        analysis.formFields.push_back("Last Name");
-    }
-    if (lower.indexOf("first") >= 0 && lower.indexOf("name") >= 0) {
-        analysis.formFields.push_back("First Name");
-    }
-    if (lower.indexOf("email") >= 0) {
-        analysis.formFields.push_back("Email Address");
-    }
-    if (lower.indexOf("phone") >= 0 || lower.indexOf("mobile") >= 0) {
-        analysis.formFields.push_back("Phone Number");
-    }
-    if (lower.indexOf("code") >= 0 || lower.indexOf("access") >= 0) {
-        analysis.formFields.push_back("Access Code");
-    }
-
-    // Detect security issues
-    if (lower.indexOf("http://") >= 0 && lower.indexOf("https://") < 0) {
-        analysis.securityIssues.push_back("Form submits over HTTP (unencrypted)");
-    }
-    if (lower.indexOf("password") >= 0 && lower.indexOf("type=\"password\"") < 0) {
-        analysis.securityIssues.push_back("Password field may not be masked");
-    }
+    // Rules that depend on the field count rather than on keywords
     if (analysis.formFields.size() == 1) {
         analysis.securityIssues.push_back("Single-factor authentication (weak)");
     }
-    if (lower.indexOf("remember") >= 0 || lower.indexOf("stay logged") >= 0) {
-        analysis.securityIssues.push_back("Session persistence may leak credentials");
-    }
-
-    // Generate recommendations
-    if (analysis.venueType == "Hotel/Resort") {
-        analysis.recommendations.push_back("Try room number enumeration (101-999)");
-        analysis.recommendations.push_back("Common surnames likely to yield results");
-    }
     if (analysis.formFields.size() <= 2) {
         analysis.recommendations.push_back("Low complexity - automated enumeration recommended");
     }
 
     // Build raw analysis text
     analysis.rawAnalysis = "Venue: " + analysis.venueName + " (" + analysis.venueType + ")\n";
+    analysis.rawAnalysis += "Login: " + analysis.authType + " (" +
+                            String((int)(analysis.confidence * 100)) + "% sure)\n";
     analysis.rawAnalysis += "Fields: ";
     for (size_t i = 0; i < analysis.formFields.size(); i++) {
         if (i > 0) analysis.rawAnalysis += ", ";
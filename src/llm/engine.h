@@ -3,6 +3,25 @@
 
 #include <Arduino.h>
 #include <vector>
+#include <atomic>
+#include "core/analysis_cache.h"
+#include "core/portal_classifier.h"
+#include "core/portal_rules.h"
+#include "arena_plan.h"
+#include "generator.h"
+#include "html_digest.h"
+#include "job_queue.h"
+#include "json_grammar.h"
+#include "model_file.h"
+#include "model_map.h"
+#include "prefix_cache.h"
+#include "token_stream.h"
+#include "worker_pool.h"
+
+// Analyses kept in the analysis cache. Bump a version whenever the code
+// behind it (prompts, page digest, pattern rules) changes its output.
+#define ANALYZER_PATTERN ANALYZER_ID(1, 3)  // /api/llm pattern summary (JSON)
+#define ANALYZER_MODEL   ANALYZER_ID(2, 2)  // Model JSON for the analysis prompt
 
 // LLM Analysis result
 struct LLMAnalysis {
@@ -13,6 +32,9 @@ struct LLMAnalysis {
     std::vector<String> formFields;
     std::vector<String> securityIssues;
     std::vector<String> recommendations;
+    String authType;                    // Login the portal asks for (classifier)
+    float confidence;                   // Classifier's, the lower of its two answers
+    bool classified;                    // Confident enough to skip the model
     String rawAnalysis;
     bool success;
 };
@@ -23,18 +45,64 @@ public:
     static bool isAvailable();
     static bool isReady();
 
-    // Analysis functions
+    // Analysis functions. Pages the portal classifier is confident about
+    // are answered without the model (CLASSIFIER_MIN_CONFIDENCE).
     static LLMAnalysis analyzePortalHTML(const String& html);
     static String generateEnumStrategy(const String& html, const std::vector<String>& fieldNames);
     static String interpretResponse(const String& response, const String& context);
 
-    // Direct inference
+    // All generation runs on one worker task, fed by a bounded priority
+    // queue (llm/job_queue.h). Jobs are admitted only with enough free
+    // memory, and on battery only interactive ones.
+
+    // Direct inference: queued as an interactive job, blocks until it has
+    // run (LLM_INFER_TIMEOUT_MS at most). Tokens are also published to
+    // getStream(). "" if refused, rejected, cancelled or timed out.
     static String infer(const String& prompt, int maxTokens = 256);
 
-    // Model management
+    // Queue the analysis prompt for `html`; its text arrives through
+    // getStream() under the returned job id once it runs. The same page
+    // already queued or running returns that job's id. 0 if no model is
+    // loaded or the job was refused or rejected.
+    static uint32_t startAnalysis(const String& html, JobPriority priority = JOB_INTERACTIVE);
+
+    // Drop job `id` if queued, or stop it after the current forward pass
+    // if running (0: the running job)
+    static bool cancel(uint32_t id = 0);
+    static const TokenStream& getStream();
+    static QueueStats getQueueStats();
+    static uint32_t getRefusedJobs();   // Turned away by admission
+
+    // Analysis results by page hash, shared with the web handlers. Opens
+    // the persisted tier (ANALYSIS_CACHE_PERSIST) on first call from setup().
+    static AnalysisCache& getAnalysisCache();
+
+    // Keyword rules behind the pattern-based analysis: the rule file at
+    // `path` on SPIFFS if it exists and parses, the built-in set otherwise.
+    // Call from setup() before the web server takes requests.
+    // The analysis schema (llm/prompts.h) is rebuilt from the rules' venue
+    // labels.
+    static bool loadRules(const char* path);
+    static const PortalRules& getRules();
+    static const JsonGrammar& getGrammar();
+    static void initAnalysisCache();
+
+    // The loaded model's finished analysis of the page with this hash,
+    // from the cache. Length, or -1 if there is none.
+    static int getCachedAnalysis(uint64_t pageHash, char* out, size_t outLen);
+
+    // Model management. modelPath is a SPIFFS file ("/models/...") or the
+    // label of a flash partition holding a packed model.
     static bool loadModel(const String& modelPath);
     static void unloadModel();
     static size_t getModelSize();
+    static size_t getResidentSize();    // RAM held by the model (copied weights, arena, vocab)
+    static size_t getArenaSize();       // Inference scratch, one block planned at load
+    static size_t getArenaUnsharedSize();   // The same buffers without lifetime reuse
+    static uint32_t getLoadTimeMs();
+    static uint32_t getVerifyTimeMs();  // Model file checksums, part of the load time
+    static bool isModelMapped();
+    static const PrefixCache& getPrefixCache();
     static size_t getFreeMemory();
 
 private:
@@ -42,6 +110,48 @@ private:
     static bool modelLoaded;
     static String currentModel;
 
+    static Transformer model;
+    static Tokenizer tokenizer;
+    static Sampler sampler;
+    static ModelMap modelMap;
+    static WorkerPool pool;
+    static PrefixCache prefixes;
+    static HtmlDigest digest;
+    static TokenStream stream;
+    static InferenceQueue jobs;
+    static TaskHandle_t worker;
+    static std::atomic<uint32_t> refusedJobs;
+    static AnalysisCache analyses;
+    static PortalRules rules;
+    static JsonGrammar grammar;         // Shape of analysis answers
+    static uint64_t modelStamp;         // Identifies the loaded model in cache keys
+    static uint8_t* modelData;          // Copied checkpoint (no partition) in PSRAM
+    static size_t modelDataSize;
+    static uint8_t* tokenizerData;
+    static size_t tokenizerDataSize;
+    static uint32_t loadTimeMs;
+    static uint32_t verifyTimeMs;
+    static uint32_t modelCrc;           // Header checksum of a packed model, 0 otherwise
+    static ArenaPlan arenaPlan;         // Activations, KV cache, encode/sampling scratch
+    static uint8_t* arena;
+    static char* responseBuffer;        // LLM_RESPONSE_BYTES, in the arena
+
+    static uint8_t* readFile(const char* path, size_t* size);
+    static bool verifyModel(const uint8_t* data, size_t size);
+    static bool allocateArena();
+    static void cachePrefixes();
+    static String generate(const String& prompt, int maxTokens, uint32_t jobId,
+                           JsonGrammar* constraint = nullptr);
+    static bool publishText(void* ctx, const char* text, size_t len);
+    static String submitAndWait(uint64_t key, uint8_t kind, const String& input, int maxTokens);
+    static bool admit(JobPriority priority);
+    static void startWorker();
+    static void workerTask(void* param);
+    static void runJob(InferenceJob& job);
+    static uint64_t modelKey(uint64_t pageHash);
+    static void buildGrammar();
+    static bool readModelAnalysis(const String& json, LLMAnalysis& out);
+
     // Prompt templates
     static String buildAnalysisPrompt(const String& html);
     static String buildEnumPrompt(const String& html, const std::vector<String>& fields);
@@ -0,0 +1,159 @@
+#include "generator.h"
+#include "platform.h"
+#include <string.h>
+
+float GenerateStats::prefillTokensPerSec() const {
+    int computed = promptTokens - cachedTokens;
+    return firstTokenUs > 0 ? computed * 1e6f / firstTokenUs : 0;
+}
+
+float GenerateStats::decodeTokensPerSec() const {
+    uint64_t decodeUs = totalUs - firstTokenUs;
+    return generatedTokens > 1 && decodeUs > 0 ? (generatedTokens - 1) * 1e6f / decodeUs : 0;
+}
+
+int Generator::loop(Transformer& model, Sampler& sampler,
+                    const int* prompt, int promptTokens, int maxTokens,
+                    TokenFn onToken, void* ctx, GenerateStats* stats, PrefixCache* prefixes,
+                    const std::atomic<bool>* cancel, JsonGrammar* grammar) {
+    int seqLen = model.getConfig().seqLen;
+    if (promptTokens > seqLen - 1) promptTokens = seqLen - 1;  // Keep room to answer
+
+    int steps = promptTokens + maxTokens;
+    if (steps > seqLen) steps = seqLen;
+
+    uint64_t start = llmMicros();
+    uint64_t firstToken = 0;
+    int generated = 0;
+
+    // Restored positions are part of the time to first token
+    int cached = prefixes ? prefixes->restore(model, prompt, promptTokens) : 0;
+
+    int token = prompt[cached];
+    for (int pos = cached; pos < steps; pos++) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) break;
+        float* logits = model.forward(token, pos);
+        if (!logits) break;
+
+        // Teacher-force the prompt, then sample
+        if (pos + 1 < promptTokens) {
+            token = prompt[pos + 1];
+            continue;
+        }
+
+        if (grammar && !grammar->mask(logits)) break;
+        int next = sampler.sample(logits);
+        if (generated == 0) firstToken = llmMicros() - start;
+        if (next == TOKEN_BOS || next == TOKEN_EOS) break;
+        if (grammar) grammar->advance(next);
+
+        generated++;
+        bool more = onToken(ctx, token, next);
+        token = next;
+        if (!more || generated >= maxTokens || (grammar && grammar->isComplete())) break;
+    }
+
+    if (stats) {
+        stats->promptTokens = promptTokens;
+        stats->cachedTokens = cached;
+        stats->generatedTokens = generated;
+        stats->firstTokenUs = firstToken;
+        stats->firstVisibleUs = 0;
+        stats->totalUs = llmMicros() - start;
+    }
+    return generated;
+}
+
+struct TextSink {
+    const Tokenizer* tokenizer;
+    Generator::TextFn onText;
+    void* ctx;
+    uint64_t start;
+    uint64_t firstVisible;
+};
+
+static bool decodeText(void* ctx, int prev, int token) {
+    TextSink& sink = *(TextSink*)ctx;
+    char piece[TOKENIZER_MAX_PIECE + 1];
+    size_t n = sink.tokenizer->decode(prev, token, piece, sizeof(piece));
+
+    if (sink.firstVisible == 0) {
+        for (size_t i = 0; i < n; i++) {
+            if (piece[i] != ' ' && piece[i] != '\n' && piece[i] != '\t' && piece[i] != '\r') {
+                sink.firstVisible = llmMicros() - sink.start;
+                break;
+            }
+        }
+    }
+    return sink.onText(sink.ctx, piece, n);
+}
+
+int Generator::stream(Transformer& model, const Tokenizer& tokenizer, Sampler& sampler,
+                      const char* prompt, int maxTokens, TextFn onText, void* ctx,
+                      GenerateStats* stats, PrefixCache* prefixes,
+                      const std::atomic<bool>* cancel, JsonGrammar* grammar) {
+    if (stats) memset(stats, 0, sizeof(*stats));
+    if (!model.isLoaded() || !tokenizer.isLoaded()) return 0;
+    if (grammar) grammar->reset();
+    uint64_t start = llmMicros();
+
+    // The loop keeps at most seqLen - 1 prompt tokens anyway
+    int* tokens = model.getTokenBuffer();
+    int n = tokenizer.encode(prompt, true, false, tokens, model.getConfig().seqLen);
+    if (n == 0) return 0;
+
+    TextSink sink = {&tokenizer, onText, ctx, start, 0};
+    int generated = loop(model, sampler, tokens, n, maxTokens, decodeText, &sink, stats,
+                         prefixes, cancel, grammar);
+    if (stats) stats->firstVisibleUs = sink.firstVisible;
+    return generated;
+}
+
+struct BufferSink {
+    char* out;
+    size_t outLen;
+    size_t len;
+};
+
+static bool appendText(void* ctx, const char* text, size_t n) {
+    BufferSink& sink = *(BufferSink*)ctx;
+    if (sink.len + n >= sink.outLen) return false;  // Output full
+    memcpy(sink.out + sink.len, text, n);
+    sink.len += n;
+    sink.out[sink.len] = '\0';
+    return true;
+}
+
+size_t Generator::run(Transformer& model, const Tokenizer& tokenizer, Sampler& sampler,
+                      const char* prompt, int maxTokens, char* out, size_t outLen,
+                      GenerateStats* stats, PrefixCache* prefixes, JsonGrammar* grammar) {
+    if (outLen == 0) return 0;
+    out[0] = '\0';
+
+    BufferSink sink = {out, outLen, 0};
+    stream(model, tokenizer, sampler, prompt, maxTokens, appendText, &sink, stats, prefixes,
+           nullptr, grammar);
+    return sink.len;
+}
+
+struct TokenSink {
+    int* generated;
+    int count;
+};
+
+static bool appendToken(void* ctx, int, int token) {
+    TokenSink& sink = *(TokenSink*)ctx;
+    if (sink.generated) sink.generated[sink.count] = token;
+    sink.count++;
+    return true;
+}
+
+int Generator::runTokens(Transformer& model, Sampler& sampler,
+                         const int* prompt, int promptTokens, int maxTokens,
+                         int* generated, GenerateStats* stats, PrefixCache* prefixes) {
+    if (!model.isLoaded() || promptTokens <= 0) return 0;
+
+    TokenSink sink = {generated, 0};
+    return loop(model, sampler, prompt, promptTokens, maxTokens, appendToken, &sink, stats,
+                prefixes, nullptr, nullptr);
+}
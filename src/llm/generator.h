@@ -0,0 +1,70 @@
+#ifndef LLM_GENERATOR_H
+#define LLM_GENERATOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include "transformer.h"
+#include "tokenizer.h"
+#include "sampler.h"
+#include "prefix_cache.h"
+#include "json_grammar.h"
+
+// Timing of one generation (microseconds)
+struct GenerateStats {
+    int promptTokens;
+    int cachedTokens;           // Prompt positions restored from a PrefixCache
+    int generatedTokens;
+    uint64_t firstTokenUs;      // Start to first generated token (TTFT)
+    uint64_t firstVisibleUs;    // stream() call to first non-blank text, encoding included
+    uint64_t totalUs;
+
+    float prefillTokensPerSec() const;      // Computed (not restored) prompt tokens
+    float decodeTokensPerSec() const;
+};
+
+// Prompt -> text loop shared by LLMEngine and the host benchmarks
+class Generator {
+public:
+    // Encode the prompt (BOS first), feed it through the model and sample
+    // up to maxTokens more until BOS/EOS or the context is full. Generated
+    // text goes to out (NUL-terminated, cut at outLen); returns its length.
+    // With `prefixes`, a cached prompt prefix is restored instead of run.
+    // With `grammar` (bound to the tokenizer), only tokens it allows are
+    // sampled and generation ends once the object is complete; text cut
+    // off by maxTokens is not closed (see JsonGrammar::finish()).
+    static size_t run(Transformer& model, const Tokenizer& tokenizer, Sampler& sampler,
+                      const char* prompt, int maxTokens, char* out, size_t outLen,
+                      GenerateStats* stats = nullptr, PrefixCache* prefixes = nullptr,
+                      JsonGrammar* grammar = nullptr);
+
+    // Called with the text of each generated token as soon as it is
+    // sampled; returning false stops generation
+    typedef bool (*TextFn)(void* ctx, const char* text, size_t len);
+
+    // run() without the output buffer: each token's text goes to onText.
+    // Generation also stops once *cancel is set (checked before every
+    // forward pass, prompt included). Returns the tokens generated.
+    static int stream(Transformer& model, const Tokenizer& tokenizer, Sampler& sampler,
+                      const char* prompt, int maxTokens, TextFn onText, void* ctx,
+                      GenerateStats* stats = nullptr, PrefixCache* prefixes = nullptr,
+                      const std::atomic<bool>* cancel = nullptr, JsonGrammar* grammar = nullptr);
+
+    // Same loop on token ids (no tokenizer), for benchmarks. Returns the
+    // number of tokens generated.
+    static int runTokens(Transformer& model, Sampler& sampler,
+                         const int* prompt, int promptTokens, int maxTokens,
+                         int* generated, GenerateStats* stats = nullptr,
+                         PrefixCache* prefixes = nullptr);
+
+private:
+    // Called for each generated token; false stops generation
+    typedef bool (*TokenFn)(void* ctx, int prev, int token);
+
+    static int loop(Transformer& model, Sampler& sampler,
+                    const int* prompt, int promptTokens, int maxTokens,
+                    TokenFn onToken, void* ctx, GenerateStats* stats, PrefixCache* prefixes,
+                    const std::atomic<bool>* cancel, JsonGrammar* grammar);
+};
+
+#endif // LLM_GENERATOR_H
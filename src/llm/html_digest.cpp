@@ -0,0 +1,492 @@
+#include "html_digest.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+// Meta names worth keeping: they often name the portal vendor or venue
+static const char* const metaNames[] = {
+    "generator", "application-name", "author", "description", "og:site_name", "og:title",
+};
+
+// Elements whose content is never visible text
+static const char* const rawTextTags[] = {"script", "style", "noscript", "template", "svg"};
+
+// Tags that start a new line of visible text
+static const char* const blockTags[] = {
+    "p", "div", "br", "li", "tr", "td", "th", "label", "form", "section", "header",
+    "footer", "table", "ul", "ol", "h4", "h5", "h6", "input", "fieldset", "legend",
+};
+
+static bool startsWithNoCase(const char* p, const char* end, const char* word) {
+    for (; *word; p++, word++) {
+        if (p >= end || tolower((unsigned char)*p) != *word) return false;
+    }
+    return true;
+}
+
+// Tag name at p (after '<' or '</') equals `name`
+static bool tagIs(const char* p, const char* end, const char* name) {
+    if (!startsWithNoCase(p, end, name)) return false;
+    const char* after = p + strlen(name);
+    return after >= end || *after == '>' || *after == '/' || isspace((unsigned char)*after);
+}
+
+// Position after the '>' closing the tag at p (quotes may contain '>')
+static const char* findTagEnd(const char* p, const char* end) {
+    char quote = 0;
+    for (; p < end; p++) {
+        if (quote) {
+            if (*p == quote) quote = 0;
+        } else if (*p == '"' || *p == '\'') {
+            quote = *p;
+        } else if (*p == '>') {
+            return p + 1;
+        }
+    }
+    return end;
+}
+
+// Position of the "</name" closing a raw-text element
+static const char* findClose(const char* p, const char* end, const char* name) {
+    for (; p + 1 < end; p++) {
+        if (p[0] == '<' && p[1] == '/' && tagIs(p + 2, end, name)) return p;
+    }
+    return end;
+}
+
+// Value of attribute `name` in the tag [tag, tagEnd), not decoded
+static bool findAttr(const char* tag, const char* tagEnd, const char* name,
+                     const char** value, size_t* valueLen) {
+    const char* p = tag + 1;
+    while (p < tagEnd && !isspace((unsigned char)*p) && *p != '>' && *p != '/') p++;
+
+    size_t nameLen = strlen(name);
+    while (p < tagEnd) {
+        while (p < tagEnd && (isspace((unsigned char)*p) || *p == '/')) p++;
+        if (p >= tagEnd || *p == '>') break;
+
+        const char* attr = p;
+        while (p < tagEnd && !isspace((unsigned char)*p) && *p != '=' && *p != '>' && *p != '/') p++;
+        size_t attrLen = p - attr;
+        while (p < tagEnd && isspace((unsigned char)*p)) p++;
+
+        const char* v = p;
+        size_t vLen = 0;
+        if (p < tagEnd && *p == '=') {
+            p++;
+            while (p < tagEnd && isspace((unsigned char)*p)) p++;
+            if (p < tagEnd && (*p == '"' || *p == '\'')) {
+                char quote = *p++;
+                v = p;
+                while (p < tagEnd && *p != quote) p++;
+                vLen = p - v;
+                if (p < tagEnd) p++;
+            } else {
+                v = p;
+                while (p < tagEnd && !isspace((unsigned char)*p) && *p != '>') p++;
+                vLen = p - v;
+            }
+        }
+
+        if (attrLen == nameLen && startsWithNoCase(attr, attr + attrLen, name)) {
+            *value = v;
+            *valueLen = vLen;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool hasAttr(const char* tag, const char* tagEnd, const char* name) {
+    const char* v;
+    size_t len;
+    return findAttr(tag, tagEnd, name, &v, &len);
+}
+
+static bool attrEquals(const char* tag, const char* tagEnd, const char* name, const char* expected) {
+    const char* v;
+    size_t len;
+    return findAttr(tag, tagEnd, name, &v, &len) && len == strlen(expected) &&
+           startsWithNoCase(v, v + len, expected);
+}
+
+// The few entities portal pages actually use; others pass through
+static size_t decodeEntity(const char* p, const char* end, const char** text) {
+    static const struct {
+        const char* entity;
+        const char* text;
+    } entities[] = {
+        {"&amp;", "&"}, {"&nbsp;", " "}, {"&quot;", "\""}, {"&#39;", "'"}, {"&#x27;", "'"},
+        {"&lt;", "<"}, {"&gt;", ">"}, {"&copy;", "(c)"}, {"&reg;", "(R)"},
+    };
+    for (const auto& e : entities) {
+        size_t len = strlen(e.entity);
+        if ((size_t)(end - p) >= len && memcmp(p, e.entity, len) == 0) {
+            *text = e.text;
+            return len;
+        }
+    }
+    return 0;
+}
+
+HtmlDigest::HtmlDigest() {
+    reset();
+}
+
+void HtmlDigest::reset() {
+    title = {titleBuf, sizeof(titleBuf), 0, false};
+    headings = {headingsBuf, sizeof(headingsBuf), 0, false};
+    meta = {metaBuf, sizeof(metaBuf), 0, false};
+    forms = {formsBuf, sizeof(formsBuf), 0, false};
+    nearText = {nearBuf, sizeof(nearBuf), 0, false};
+    text = {textBuf, sizeof(textBuf), 0, false};
+    pendingCount = 0;
+    afterForm = 0;
+}
+
+void HtmlDigest::append(Section& s, const char* data, size_t len) {
+    if (s.len + len > s.cap) {
+        len = s.cap - s.len;
+        s.full = true;
+    }
+    memcpy(s.buf + s.len, data, len);
+    s.len += len;
+}
+
+// " label=value" (or " value" without a label), quoted if asked
+void HtmlDigest::appendAttr(Section& s, const char* tag, const char* tagEnd, const char* name,
+                            const char* label, bool quoted) {
+    const char* v;
+    size_t len;
+    if (!findAttr(tag, tagEnd, name, &v, &len) || len == 0) return;
+    if (len > 48) len = 48;  // Long values (tokens, data URLs) carry no meaning here
+
+    append(s, " ", 1);
+    if (label) {
+        append(s, label, strlen(label));
+        append(s, "=", 1);
+    }
+    if (quoted) append(s, "\"", 1);
+    appendDecoded(s, v, v + len);
+    if (quoted) append(s, "\"", 1);
+}
+
+// Visible text with whitespace collapsed and common entities decoded,
+// after `separator` if the section already has text
+void HtmlDigest::appendText(Section& s, const char* p, const char* end, const char* separator) {
+    while (p < end && isspace((unsigned char)*p)) p++;
+    while (end > p && isspace((unsigned char)end[-1])) end--;
+    if (p >= end) return;
+
+    if (s.len > 0) append(s, separator, strlen(separator));
+    appendDecoded(s, p, end);
+}
+
+void HtmlDigest::appendDecoded(Section& s, const char* p, const char* end) {
+    bool space = false;
+    while (p < end && !s.full) {
+        if (isspace((unsigned char)*p)) {
+            space = true;
+            p++;
+            continue;
+        }
+        if (space) append(s, " ", 1);
+        space = false;
+
+        const char* decoded;
+        size_t used = *p == '&' ? decodeEntity(p, end, &decoded) : 0;
+        if (used) {
+            append(s, decoded, strlen(decoded));
+            p += used;
+        } else {
+            append(s, p++, 1);
+        }
+    }
+}
+
+// Move the oldest `count` pending runs into a section
+void HtmlDigest::flushPending(int count, Section& to) {
+    for (int i = 0; i < count; i++) {
+        appendText(to, pending[i].p, pending[i].end, pending[i].blockBreak ? " | " : " ");
+    }
+    memmove(pending, pending + count, (pendingCount - count) * sizeof(Span));
+    pendingCount -= count;
+}
+
+// Text outside forms: right after a form it is form context, otherwise
+// it is held back in case a form follows
+void HtmlDigest::addOutsideText(const char* p, const char* end, bool blockBreak) {
+    if (afterForm > 0) {
+        size_t start = nearText.len;
+        appendText(nearText, p, end, blockBreak ? " | " : " ");
+        afterForm -= (int)(nearText.len - start);
+        return;
+    }
+
+    if (pendingCount == DIGEST_PENDING_SPANS) flushPending(1, text);
+    Span span = {p, end, blockBreak};
+    pending[pendingCount++] = span;
+}
+
+size_t HtmlDigest::build(const char* html, size_t len, char* out, size_t outLen,
+                         DigestStats* stats) {
+    reset();
+    int formCount = 0;
+    int fieldCount = 0;
+
+    bool inHead = false;
+    bool inTitle = false;
+    bool inHeading = false;
+    bool inForm = false;
+    bool inButton = false;
+    bool buttonLabeled = false;
+    bool skipContent = false;           // <select> options, <textarea> text
+    int options = 0;
+    bool blockBreak = false;
+
+    const char* p = html;
+    const char* end = html + len;
+    while (p < end) {
+        const char* lt = (const char*)memchr(p, '<', end - p);
+        const char* textEnd = lt ? lt : end;
+
+        if (textEnd > p && inTitle) {
+            appendText(title, p, textEnd, " ");
+        } else if (textEnd > p && !inHead && !skipContent) {
+            if (inHeading) {
+                appendText(headings, p, textEnd, "; ");
+            } else if (inButton) {
+                // Button captions label the button line, not the form text
+                const char* q = p;
+                while (q < textEnd && isspace((unsigned char)*q)) q++;
+                if (q < textEnd) {
+                    append(forms, buttonLabeled ? " " : " \"", buttonLabeled ? 1 : 2);
+                    Section caption = {formsBuf + forms.len, forms.cap - forms.len, 0, false};
+                    appendText(caption, q, textEnd, " ");
+                    forms.len += caption.len;
+                    forms.full = forms.full || caption.full;
+                    buttonLabeled = true;
+                }
+            } else if (inForm) {
+                appendText(nearText, p, textEnd, blockBreak ? " | " : " ");
+                blockBreak = false;
+            } else {
+                const char* q = p;
+                while (q < textEnd && isspace((unsigned char)*q)) q++;
+                if (q < textEnd) {
+                    addOutsideText(p, textEnd, blockBreak);
+                    blockBreak = false;
+                }
+            }
+        }
+        if (!lt) break;
+        p = lt;
+
+        // Comments, doctype, processing instructions
+        if (p + 3 < end && p[1] == '!' && p[2] == '-' && p[3] == '-') {
+            const char* close = p + 4;
+            while (close + 2 < end && !(close[0] == '-' && close[1] == '-' && close[2] == '>')) close++;
+            p = close + 2 < end ? close + 3 : end;
+            continue;
+        }
+        const char* tagEnd = findTagEnd(p, end);
+        if (p + 1 < end && (p[1] == '!' || p[1] == '?')) {
+            p = tagEnd;
+            continue;
+        }
+
+        bool closing = p + 1 < end && p[1] == '/';
+        const char* name = p + (closing ? 2 : 1);
+
+        for (const char* raw : rawTextTags) {
+            if (!closing && tagIs(name, end, raw)) {
+                tagEnd = findClose(tagEnd, end, raw);
+                tagEnd = findTagEnd(tagEnd, end);
+                break;
+            }
+        }
+
+        for (const char* block : blockTags) {
+            if (tagIs(name, end, block)) blockBreak = true;
+        }
+
+        if (tagIs(name, end, "head")) {
+            inHead = !closing;
+        } else if (tagIs(name, end, "body")) {
+            inHead = false;
+        } else if (tagIs(name, end, "title")) {
+            inTitle = !closing;
+        } else if (name[0] == 'h' || name[0] == 'H') {
+            if (name + 1 < end && name[1] >= '1' && name[1] <= '3' && tagIs(name + 2, end, "")) {
+                inHeading = !closing;
+            }
+        }
+
+        if (!closing && inHead && tagIs(name, end, "meta")) {
+            for (const char* metaName : metaNames) {
+                if (attrEquals(p, tagEnd, "name", metaName) ||
+                    attrEquals(p, tagEnd, "property", metaName)) {
+                    if (meta.len > 0) append(meta, "; ", 2);
+                    append(meta, metaName, strlen(metaName));
+                    appendAttr(meta, p, tagEnd, "content", nullptr, false);
+                }
+            }
+        }
+
+        if (tagIs(name, end, "form")) {
+            if (!closing) {
+                inForm = true;
+                formCount++;
+                // The latest text before the form (instructions, errors)
+                // belongs with it; older held-back text is page text
+                int keep = 0;
+                size_t chars = 0;
+                while (keep < pendingCount) {
+                    const Span& span = pending[pendingCount - 1 - keep];
+                    chars += span.end - span.p;
+                    if (keep > 0 && chars > DIGEST_NEAR_CONTEXT) break;
+                    keep++;
+                }
+                flushPending(pendingCount - keep, text);
+                flushPending(keep, nearText);
+                afterForm = 0;
+
+                append(forms, "Form", 4);
+                const char* method;
+                size_t methodLen;
+                if (findAttr(p, tagEnd, "method", &method, &methodLen) && methodLen > 0) {
+                    append(forms, " ", 1);
+                    for (size_t i = 0; i < methodLen && i < 8; i++) {
+                        char c = toupper((unsigned char)method[i]);
+                        append(forms, &c, 1);
+                    }
+                } else {
+                    append(forms, " GET", 4);
+                }
+                appendAttr(forms, p, tagEnd, "action", nullptr, false);
+                append(forms, "\n", 1);
+            } else if (inForm) {
+                inForm = false;
+                afterForm = DIGEST_NEAR_CONTEXT;
+            }
+        } else if (!closing && tagIs(name, end, "input")) {
+            fieldCount++;
+            const char* type;
+            size_t typeLen;
+            append(forms, "- ", 2);
+            if (findAttr(p, tagEnd, "type", &type, &typeLen) && typeLen > 0) append(forms, type, typeLen);
+            else append(forms, "text", 4);
+
+            appendAttr(forms, p, tagEnd, "name", nullptr, false);
+            if (!hasAttr(p, tagEnd, "name")) appendAttr(forms, p, tagEnd, "id", "id", false);
+            appendAttr(forms, p, tagEnd, "placeholder", "placeholder", true);
+            if (attrEquals(p, tagEnd, "type", "submit") || attrEquals(p, tagEnd, "type", "button")) {
+                appendAttr(forms, p, tagEnd, "value", nullptr, true);
+            }
+            if (hasAttr(p, tagEnd, "required")) append(forms, " required", 9);
+            append(forms, "\n", 1);
+        } else if (tagIs(name, end, "select") || tagIs(name, end, "textarea")) {
+            bool select = tagIs(name, end, "select");
+            if (!closing) {
+                fieldCount++;
+                append(forms, select ? "- select" : "- textarea", select ? 8 : 10);
+                appendAttr(forms, p, tagEnd, "name", nullptr, false);
+                if (hasAttr(p, tagEnd, "required")) append(forms, " required", 9);
+                skipContent = true;
+                options = 0;
+            } else if (skipContent) {
+                if (select) {
+                    char count[24];
+                    int n = snprintf(count, sizeof(count), " options=%d", options);
+                    append(forms, count, n);
+                }
+                append(forms, "\n", 1);
+                skipContent = false;
+            }
+        } else if (!closing && skipContent && tagIs(name, end, "option")) {
+            options++;
+        } else if (tagIs(name, end, "button")) {
+            if (!closing) {
+                fieldCount++;
+                inButton = true;
+                buttonLabeled = false;
+                append(forms, "- button", 8);
+                const char* type;
+                size_t typeLen;
+                if (findAttr(p, tagEnd, "type", &type, &typeLen) && typeLen > 0) {
+                    append(forms, " ", 1);
+                    append(forms, type, typeLen);
+                }
+                appendAttr(forms, p, tagEnd, "name", nullptr, false);
+            } else if (inButton) {
+                if (buttonLabeled) append(forms, "\"", 1);
+                append(forms, "\n", 1);
+                inButton = false;
+            }
+        }
+
+        p = tagEnd;
+    }
+
+    // Text never followed by a form is general page text
+    flushPending(pendingCount, text);
+
+    // Assemble in priority order within the budget
+    struct Part {
+        const char* label;
+        const Section* section;
+    } parts[] = {
+        {"Title: ", &title},
+        {"Headings: ", &headings},
+        {"Meta: ", &meta},
+        {"", &forms},
+        {"Form text: ", &nearText},
+        {"Text: ", &text},
+    };
+
+    size_t n = 0;
+    bool truncated = false;
+    if (outLen > 0) {
+        size_t room = outLen - 1;
+        for (const auto& part : parts) {
+            const Section& s = *part.section;
+            if (s.len == 0) continue;
+
+            size_t labelLen = strlen(part.label);
+            bool newline = s.buf[s.len - 1] != '\n';
+            size_t need = labelLen + s.len + (newline ? 1 : 0);
+            if (n + need <= room) {
+                memcpy(out + n, part.label, labelLen);
+                memcpy(out + n + labelLen, s.buf, s.len);
+                n += labelLen + s.len;
+                if (newline) out[n++] = '\n';
+                continue;
+            }
+
+            // Cut this section at a word (or line) boundary and stop
+            truncated = true;
+            if (n + labelLen + 8 < room) {
+                size_t keep = room - n - labelLen - 3;
+                while (keep > 0 && s.buf[keep] != ' ' && s.buf[keep] != '\n') keep--;
+                if (keep > 0) {
+                    memcpy(out + n, part.label, labelLen);
+                    memcpy(out + n + labelLen, s.buf, keep);
+                    n += labelLen + keep;
+                    memcpy(out + n, "...", 3);
+                    n += 3;
+                }
+            }
+            break;
+        }
+        out[n] = '\0';
+    }
+
+    if (stats) {
+        stats->inputBytes = len;
+        stats->outputBytes = n;
+        stats->forms = formCount;
+        stats->fields = fieldCount;
+        stats->truncated = truncated;
+    }
+    return n;
+}
@@ -0,0 +1,93 @@
+#ifndef LLM_HTML_DIGEST_H
+#define LLM_HTML_DIGEST_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Section capacities (characters collected before the budget is applied)
+#define DIGEST_TITLE_MAX 128
+#define DIGEST_HEADINGS_MAX 256
+#define DIGEST_META_MAX 256
+#define DIGEST_FORMS_MAX 1024
+#define DIGEST_NEAR_MAX 512
+#define DIGEST_TEXT_MAX 512
+
+// Visible text kept just before and just after each form
+#define DIGEST_NEAR_CONTEXT 160
+
+// Text runs held back in case a form follows them
+#define DIGEST_PENDING_SPANS 8
+
+// What a digest kept and dropped
+struct DigestStats {
+    size_t inputBytes;
+    size_t outputBytes;
+    int forms;
+    int fields;
+    bool truncated;                     // Budget cut a section
+};
+
+// Compact, budgeted summary of a portal page for the analysis prompt.
+// The HTML is walked once; what identifies a portal goes into sections:
+//
+//   Title:      <title>
+//   Headings:   <h1>-<h3>
+//   Meta:       vendor tags (generator, application-name, author,
+//               description, og:site_name)
+//   Form ...:   action and method, then one line per input / select /
+//               textarea / button (type, name, placeholder, required)
+//   Form text:  visible text in and right around forms (labels, errors,
+//               instructions)
+//   Text:       other visible text
+//
+// <head> styles, scripts, comments and markup are dropped. Sections are
+// written in that priority order until `outLen` is used up, so a tight
+// budget loses body text first and the form last. Works in the
+// instance's fixed section buffers: no heap allocation.
+class HtmlDigest {
+public:
+    HtmlDigest();
+
+    // Returns the digest length (NUL-terminated in out)
+    size_t build(const char* html, size_t len, char* out, size_t outLen,
+                 DigestStats* stats = nullptr);
+
+private:
+    struct Section {
+        char* buf;
+        size_t cap;
+        size_t len;
+        bool full;
+    };
+
+    // A run of text in the input, not yet assigned to a section
+    struct Span {
+        const char* p;
+        const char* end;
+        bool blockBreak;
+    };
+
+    char titleBuf[DIGEST_TITLE_MAX];
+    char headingsBuf[DIGEST_HEADINGS_MAX];
+    char metaBuf[DIGEST_META_MAX];
+    char formsBuf[DIGEST_FORMS_MAX];
+    char nearBuf[DIGEST_NEAR_MAX];
+    char textBuf[DIGEST_TEXT_MAX];
+
+    Section title, headings, meta, forms, nearText, text;
+    Span pending[DIGEST_PENDING_SPANS]; // Latest text outside forms
+    int pendingCount;
+    int afterForm;                      // Near-text characters still owed after a form
+
+    void reset();
+    void addOutsideText(const char* p, const char* end, bool blockBreak);
+    void flushPending(int count, Section& to);
+
+    static void append(Section& s, const char* data, size_t len);
+    static void appendAttr(Section& s, const char* tag, const char* tagEnd, const char* name,
+                           const char* label, bool quoted);
+    static void appendText(Section& s, const char* p, const char* end, const char* separator);
+    static void appendDecoded(Section& s, const char* p, const char* end);
+};
+
+#endif // LLM_HTML_DIGEST_H
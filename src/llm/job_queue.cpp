@@ -0,0 +1,223 @@
+#include "job_queue.h"
+#include "platform.h"
+#include <chrono>
+#include <string.h>
+
+InferenceQueue::InferenceQueue()
+    : nextId(0), nextSeq(0), closed(false), totalWaitUs(0), started(0) {
+    memset(&stats, 0, sizeof(stats));
+    for (auto& e : entries) {
+        e.state = INFER_FREE;
+        e.id = 0;
+        e.waiters = 0;
+        e.cancelRequested = false;
+    }
+}
+
+InferenceQueue::Entry* InferenceQueue::find(uint32_t id) {
+    for (auto& e : entries) {
+        if (e.state != INFER_FREE && e.id == id) return &e;
+    }
+    return nullptr;
+}
+
+const InferenceQueue::Entry* InferenceQueue::find(uint32_t id) const {
+    for (const auto& e : entries) {
+        if (e.state != INFER_FREE && e.id == id) return &e;
+    }
+    return nullptr;
+}
+
+// Free a finished entry once nobody is left to collect it
+void InferenceQueue::release(Entry& e) {
+    if (e.waiters > 0) return;
+    e.state = INFER_FREE;
+    e.text.clear();
+    e.text.shrink_to_fit();
+}
+
+uint32_t InferenceQueue::submit(uint64_t key, uint8_t kind, JobPriority priority,
+                                const char* input, size_t len, int maxTokens, bool willWait,
+                                SubmitError* error) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (error) *error = SUBMIT_OK;
+    if (closed) {
+        if (error) *error = SUBMIT_CLOSED;
+        return 0;
+    }
+
+    // Same prompt already queued or running: share it
+    for (auto& e : entries) {
+        if ((e.state == INFER_QUEUED || e.state == INFER_RUNNING) && !e.cancelRequested &&
+            e.key == key && e.kind == kind) {
+            if (priority > e.priority) e.priority = priority;
+            if (willWait) e.waiters++;
+            stats.coalesced++;
+            return e.id;
+        }
+    }
+
+    Entry* slot = nullptr;
+    for (auto& e : entries) {
+        if (e.state == INFER_FREE) {
+            slot = &e;
+            break;
+        }
+    }
+
+    // Full: displace the newest queued job of the lowest priority below
+    // ours, unless someone waits for it
+    if (!slot) {
+        for (auto& e : entries) {
+            if (e.state == INFER_QUEUED && e.priority < priority && e.waiters == 0 &&
+                (!slot || e.priority < slot->priority ||
+                 (e.priority == slot->priority && e.seq > slot->seq))) {
+                slot = &e;
+            }
+        }
+        if (!slot) {
+            stats.rejected++;
+            if (error) *error = SUBMIT_FULL;
+            return 0;
+        }
+        stats.displaced++;
+        stats.cancelled++;
+    }
+
+    if (++nextId == 0) nextId = 1;
+    slot->state = INFER_QUEUED;
+    slot->id = nextId;
+    slot->key = key;
+    slot->kind = kind;
+    slot->priority = priority;
+    slot->maxTokens = maxTokens;
+    slot->waiters = willWait ? 1 : 0;
+    slot->cancelRequested = false;
+    slot->seq = nextSeq++;
+    slot->submittedUs = llmMicros();
+    slot->text.assign(input, len);
+    stats.submitted++;
+
+    workAvailable.notify_one();
+    return slot->id;
+}
+
+bool InferenceQueue::next(InferenceJob& job) {
+    std::unique_lock<std::mutex> guard(lock);
+    Entry* best = nullptr;
+    workAvailable.wait(guard, [&]() {
+        best = nullptr;
+        for (auto& e : entries) {
+            if (e.state == INFER_QUEUED &&
+                (!best || e.priority > best->priority ||
+                 (e.priority == best->priority && e.seq < best->seq))) {
+                best = &e;
+            }
+        }
+        return closed || best != nullptr;
+    });
+    if (closed) return false;
+
+    best->state = INFER_RUNNING;
+    job.id = best->id;
+    job.kind = best->kind;
+    job.priority = best->priority;
+    job.maxTokens = best->maxTokens;
+    job.input.swap(best->text);
+    best->text.clear();
+    job.waitedUs = llmMicros() - best->submittedUs;
+
+    uint32_t waitMs = (uint32_t)(job.waitedUs / 1000);
+    totalWaitUs += job.waitedUs;
+    started++;
+    stats.lastWaitMs = waitMs;
+    if (waitMs > stats.maxWaitMs) stats.maxWaitMs = waitMs;
+    stats.avgWaitMs = (uint32_t)(totalWaitUs / started / 1000);
+    return true;
+}
+
+void InferenceQueue::complete(uint32_t id, const char* output, size_t len, bool cancelled) {
+    std::lock_guard<std::mutex> guard(lock);
+    Entry* e = find(id);
+    if (!e) return;
+
+    if (cancelled || e->cancelRequested) {
+        e->state = INFER_CANCELLED;
+        stats.cancelled++;
+    } else {
+        e->state = INFER_DONE;
+        stats.completed++;
+        if (e->waiters > 0) e->text.assign(output, len);
+    }
+    release(*e);
+    jobEnded.notify_all();
+}
+
+bool InferenceQueue::wait(uint32_t id, std::string& output, uint32_t timeoutMs) {
+    std::unique_lock<std::mutex> guard(lock);
+    Entry* e = find(id);
+    if (!e || e->waiters == 0) return false;
+
+    jobEnded.wait_for(guard, std::chrono::milliseconds(timeoutMs), [&]() {
+        return closed || e->id != id || e->state == INFER_DONE || e->state == INFER_CANCELLED ||
+               e->state == INFER_FREE;
+    });
+    if (e->id != id || e->state == INFER_FREE) return false;
+
+    bool done = e->state == INFER_DONE;
+    if (done) output = e->text;
+    e->waiters--;
+    if (e->state == INFER_DONE || e->state == INFER_CANCELLED) release(*e);
+    return done;
+}
+
+InferenceState InferenceQueue::cancel(uint32_t id) {
+    std::lock_guard<std::mutex> guard(lock);
+    Entry* e = find(id);
+    if (!e) return INFER_FREE;
+
+    if (e->state == INFER_QUEUED) {
+        e->state = INFER_CANCELLED;
+        e->text.clear();
+        stats.cancelled++;
+        release(*e);
+        jobEnded.notify_all();
+        return INFER_CANCELLED;
+    }
+    if (e->state == INFER_RUNNING) {
+        e->cancelRequested = true;      // complete() counts it
+        return INFER_RUNNING;
+    }
+    return e->state;
+}
+
+InferenceState InferenceQueue::getState(uint32_t id) const {
+    std::lock_guard<std::mutex> guard(lock);
+    const Entry* e = find(id);
+    return e ? e->state : INFER_FREE;
+}
+
+bool InferenceQueue::isCancelRequested(uint32_t id) const {
+    std::lock_guard<std::mutex> guard(lock);
+    const Entry* e = find(id);
+    return e && e->cancelRequested;
+}
+
+QueueStats InferenceQueue::getStats() const {
+    std::lock_guard<std::mutex> guard(lock);
+    QueueStats s = stats;
+    s.queued = 0;
+    s.running = 0;
+    for (const auto& e : entries) {
+        if (e.state == INFER_QUEUED) s.queued++;
+        if (e.state == INFER_RUNNING) s.running = e.id;
+    }
+    return s;
+}
+
+void InferenceQueue::close() {
+    std::lock_guard<std::mutex> guard(lock);
+    closed = true;
+    workAvailable.notify_all();
+    jobEnded.notify_all();
+}
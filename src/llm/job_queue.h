@@ -0,0 +1,134 @@
+#ifndef LLM_JOB_QUEUE_H
+#define LLM_JOB_QUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+// Jobs held at once: queued, running, and finished ones not yet collected
+#define INFERENCE_QUEUE_DEPTH 4
+
+// Higher runs first; FIFO within a priority
+enum JobPriority : uint8_t {
+    JOB_BACKGROUND,             // Nobody is watching (prefetch, batch analysis)
+    JOB_NORMAL,                 // Web requests
+    JOB_INTERACTIVE             // Someone is waiting on the device
+};
+
+enum InferenceState : uint8_t {
+    INFER_FREE,
+    INFER_QUEUED,
+    INFER_RUNNING,
+    INFER_DONE,
+    INFER_CANCELLED
+};
+
+// Why submit() returned 0
+enum SubmitError : uint8_t {
+    SUBMIT_OK,
+    SUBMIT_FULL,                // No free entry and nothing of lower priority queued
+    SUBMIT_CLOSED
+};
+
+// What the worker runs
+struct InferenceJob {
+    uint32_t id;
+    uint8_t kind;               // Caller-defined
+    JobPriority priority;
+    int maxTokens;
+    std::string input;
+    uint64_t waitedUs;          // Submit to start
+};
+
+struct QueueStats {
+    uint32_t submitted;
+    uint32_t coalesced;         // Submits answered with an identical job's id
+    uint32_t rejected;          // Queue full
+    uint32_t displaced;         // Queued jobs dropped for higher-priority ones
+    uint32_t cancelled;
+    uint32_t completed;
+    int queued;                 // Waiting now
+    uint32_t running;           // Job id, 0 if idle
+    uint32_t lastWaitMs;        // Queue latency: submit to start
+    uint32_t maxWaitMs;
+    uint32_t avgWaitMs;
+};
+
+// Bounded priority queue in front of the single inference worker.
+//
+// Submitting a job whose key matches one still queued or running returns
+// that job's id (raising its priority if needed) instead of running the
+// same prompt twice. When the queue is full, a job displaces the newest
+// queued job of the lowest lower priority, or is rejected. Queued jobs are
+// dropped by cancel(); a running job is only marked, the worker stops it
+// through the generator's cancel flag.
+//
+// A submitter that will wait() for the output says so at submit time, so
+// the output is kept until it is collected even if the job finishes
+// first. Ids are never 0 and double as token stream ids.
+class InferenceQueue {
+public:
+    InferenceQueue();
+
+    // Returns the job id, or 0 (see *error)
+    uint32_t submit(uint64_t key, uint8_t kind, JobPriority priority, const char* input,
+                    size_t len, int maxTokens, bool willWait = false,
+                    SubmitError* error = nullptr);
+
+    // Worker: block until there is a job (highest priority first) and mark
+    // it running. False once the queue is closed.
+    bool next(InferenceJob& job);
+
+    // Worker: the running job ended
+    void complete(uint32_t id, const char* output, size_t len, bool cancelled);
+
+    // Block until job `id` ends and copy its output. False if it was
+    // cancelled, is unknown or `timeoutMs` passed. Only for submitters
+    // that passed willWait.
+    bool wait(uint32_t id, std::string& output, uint32_t timeoutMs);
+
+    // Dropped if queued; marked if running (returns INFER_RUNNING, the
+    // caller stops the generation). INFER_FREE if there is no such job.
+    InferenceState cancel(uint32_t id);
+
+    InferenceState getState(uint32_t id) const;
+    bool isCancelRequested(uint32_t id) const;
+    QueueStats getStats() const;
+
+    // Wake the worker and every waiter; later submits fail
+    void close();
+
+private:
+    struct Entry {
+        InferenceState state;
+        uint32_t id;
+        uint64_t key;
+        uint8_t kind;
+        JobPriority priority;
+        int maxTokens;
+        int waiters;            // Submitters that will collect the output
+        bool cancelRequested;   // Running job asked to stop
+        uint32_t seq;           // Submission order
+        uint64_t submittedUs;
+        std::string text;       // Input while queued, output once done
+    };
+
+    Entry entries[INFERENCE_QUEUE_DEPTH];
+    mutable std::mutex lock;
+    std::condition_variable workAvailable;
+    std::condition_variable jobEnded;
+    uint32_t nextId;
+    uint32_t nextSeq;
+    bool closed;
+    QueueStats stats;
+    uint64_t totalWaitUs;
+    uint32_t started;
+
+    Entry* find(uint32_t id);
+    const Entry* find(uint32_t id) const;
+    void release(Entry& e);
+};
+
+#endif // LLM_JOB_QUEUE_H
@@ -0,0 +1,452 @@
+#include "json_grammar.h"
+#include "platform.h"
+#include <math.h>
+#include <string.h>
+
+// Phases within a member's value
+enum : uint8_t {
+    PH_OPEN,                            // Nothing of the value yet
+    PH_BODY,                            // Inside a string / option / digits
+    PH_FIRST,                           // Array: after '['
+    PH_NEXT,                            // Array: after an item's closing quote
+    PH_ITEM                             // Array: after ','
+};
+
+static bool isStringChar(uint8_t c) {
+    return c >= 0x20 && c < 0x7f && c != '"' && c != '\\';
+}
+
+static void nextOp(GrammarState& s) {
+    s.op++;
+    s.phase = PH_OPEN;
+    s.items = 0;
+    s.pos = 0;
+    s.options = 0;
+}
+
+JsonGrammar::JsonGrammar()
+    : tokenizer(nullptr), vocabSize(0), order(nullptr), plain(nullptr) {
+    clear();
+    memset(buckets, 0, sizeof(buckets));
+}
+
+JsonGrammar::~JsonGrammar() {
+    unbind();
+}
+
+void JsonGrammar::clear() {
+    memset(ops, 0, sizeof(ops));
+    memset(options, 0, sizeof(options));
+    opCount = 0;
+    optionCount = 0;
+    poolUsed = 0;
+    memberCount = 0;
+    reset();
+}
+
+bool JsonGrammar::addMember(const char* name, OpType type, int len, int maxItems) {
+    size_t nameLen = strlen(name);
+    if (opCount + 2 > GRAMMAR_MAX_OPS || poolUsed + nameLen + 4 > GRAMMAR_TEXT_MAX ||
+        len <= 0 || len > 0xffff || maxItems > 0xff) {
+        return false;
+    }
+
+    // Key literal: {"name": or ,"name":
+    Op& key = ops[opCount++];
+    key.type = OP_LITERAL;
+    key.member = memberCount;
+    key.text = poolUsed;
+    key.len = nameLen + 4;
+    pool[poolUsed++] = memberCount == 0 ? '{' : ',';
+    pool[poolUsed++] = '"';
+    memcpy(pool + poolUsed, name, nameLen);
+    poolUsed += nameLen;
+    pool[poolUsed++] = '"';
+    pool[poolUsed++] = ':';
+
+    Op& value = ops[opCount++];
+    value.type = type;
+    value.member = memberCount++;
+    value.maxItems = maxItems;
+    value.text = type == OP_ENUM ? optionCount : 0;
+    value.len = type == OP_ENUM ? 0 : len;
+    return true;
+}
+
+bool JsonGrammar::addString(const char* name, int maxLen) {
+    return addMember(name, OP_STRING, maxLen, 0);
+}
+
+bool JsonGrammar::addEnum(const char* name) {
+    return addMember(name, OP_ENUM, 1, 0);
+}
+
+bool JsonGrammar::addOption(const char* text) {
+    size_t len = strlen(text);
+    if (opCount == 0 || ops[opCount - 1].type != OP_ENUM || ops[opCount - 1].len >= 32 ||
+        optionCount >= GRAMMAR_MAX_OPTIONS || poolUsed + len > GRAMMAR_TEXT_MAX) {
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (!isStringChar((uint8_t)text[i])) return false;
+    }
+
+    options[optionCount].text = poolUsed;
+    options[optionCount].len = len;
+    optionCount++;
+    memcpy(pool + poolUsed, text, len);
+    poolUsed += len;
+    ops[opCount - 1].len++;
+    return true;
+}
+
+bool JsonGrammar::addInt(const char* name, int maxDigits) {
+    return addMember(name, OP_INT, maxDigits, 0);
+}
+
+bool JsonGrammar::addStringArray(const char* name, int maxItems, int maxLen) {
+    return maxItems > 0 && addMember(name, OP_STRING_ARRAY, maxLen, maxItems);
+}
+
+int JsonGrammar::getMemberCount() const {
+    return memberCount;
+}
+
+int JsonGrammar::findMember(const char* name) const {
+    size_t len = strlen(name);
+    for (int i = 0; i < opCount; i++) {
+        const Op& op = ops[i];
+        if (op.type == OP_LITERAL && op.len == len + 4 &&
+            memcmp(pool + op.text + 2, name, len) == 0) {
+            return op.member;
+        }
+    }
+    return -1;
+}
+
+uint32_t JsonGrammar::getHash() const {
+    uint32_t h = 2166136261u;
+    auto mix = [&h](const void* data, size_t len) {
+        const uint8_t* p = (const uint8_t*)data;
+        for (size_t i = 0; i < len; i++) h = (h ^ p[i]) * 16777619u;
+    };
+    mix(ops, opCount * sizeof(Op));
+    mix(options, optionCount * sizeof(Option));
+    mix(pool, poolUsed);
+    return h;
+}
+
+// Piece text as generated: <0xXX> byte tokens are one raw byte
+const char* JsonGrammar::tokenText(int token, size_t* len, char* byte) const {
+    const char* text = tokenizer->getPiece(token, len);
+    if (text && *len == 6 && text[0] == '<' && text[1] == '0' && text[2] == 'x' && text[5] == '>') {
+        auto hex = [](char c) { return c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10; };
+        *byte = (char)(hex(text[3]) << 4 | hex(text[4]));
+        *len = 1;
+        return byte;
+    }
+    return text;
+}
+
+bool JsonGrammar::bind(const Tokenizer& tok) {
+    unbind();
+    int n = tok.getVocabSize();
+    order = (int32_t*)llmAlloc(n * sizeof(int32_t));
+    plain = (uint8_t*)llmAlloc(n);
+    if (!order || !plain) {
+        unbind();
+        return false;
+    }
+    tokenizer = &tok;
+    vocabSize = n;
+
+    // Bucket by first byte; BOS/EOS/unknown and empty pieces go last and
+    // are always masked
+    int32_t counts[257] = {0};
+    for (int t = 0; t < n; t++) {
+        size_t len;
+        char byte;
+        const char* text = tokenText(t, &len, &byte);
+        bool special = t == 0 || t == TOKEN_BOS || t == TOKEN_EOS || !text || len == 0;
+        counts[special ? 256 : (uint8_t)text[0]]++;
+
+        plain[t] = !special;
+        for (size_t i = 0; i < len && plain[t]; i++) plain[t] = isStringChar((uint8_t)text[i]);
+    }
+
+    int32_t at = 0;
+    for (int b = 0; b < 257; b++) {
+        buckets[b] = at;
+        at += counts[b];
+    }
+    int32_t fill[257];
+    memcpy(fill, buckets, sizeof(fill));
+    for (int t = 0; t < n; t++) {
+        size_t len;
+        char byte;
+        const char* text = tokenText(t, &len, &byte);
+        bool special = t == 0 || t == TOKEN_BOS || t == TOKEN_EOS || !text || len == 0;
+        order[fill[special ? 256 : (uint8_t)text[0]]++] = t;
+    }
+    reset();
+    return true;
+}
+
+void JsonGrammar::unbind() {
+    if (order) llmFree(order);
+    if (plain) llmFree(plain);
+    order = nullptr;
+    plain = nullptr;
+    tokenizer = nullptr;
+    vocabSize = 0;
+}
+
+bool JsonGrammar::isBound() const {
+    return order != nullptr;
+}
+
+size_t JsonGrammar::getTableSize() const {
+    return order ? vocabSize * (sizeof(int32_t) + 1) + sizeof(buckets) : 0;
+}
+
+void JsonGrammar::reset() {
+    memset(&state, 0, sizeof(state));
+}
+
+bool JsonGrammar::isComplete() const {
+    return state.op > opCount;
+}
+
+// One character; false leaves `s` unusable
+bool JsonGrammar::accept(GrammarState& s, uint8_t c) const {
+    while (s.op < opCount) {
+        const Op& op = ops[s.op];
+        switch (op.type) {
+            case OP_LITERAL:
+                if (c != (uint8_t)pool[op.text + s.pos]) return false;
+                if (++s.pos == op.len) nextOp(s);
+                return true;
+
+            case OP_STRING:
+                if (s.phase == PH_OPEN) {
+                    if (c != '"') return false;
+                    s.phase = PH_BODY;
+                    return true;
+                }
+                if (c == '"') {
+                    nextOp(s);
+                    return true;
+                }
+                if (!isStringChar(c) || s.pos >= op.len) return false;
+                s.pos++;
+                return true;
+
+            case OP_ENUM: {
+                if (s.phase == PH_OPEN) {
+                    if (c != '"') return false;
+                    s.phase = PH_BODY;
+                    s.options = op.len >= 32 ? 0xffffffffu : (1u << op.len) - 1;
+                    return true;
+                }
+                // Options whose text continues with c (or ends here on '"')
+                uint32_t left = 0;
+                for (int i = 0; i < op.len; i++) {
+                    if (!(s.options >> i & 1)) continue;
+                    const Option& o = options[op.text + i];
+                    bool match = c == '"' ? o.len == s.pos
+                                          : o.len > s.pos && (uint8_t)pool[o.text + s.pos] == c;
+                    if (match) left |= 1u << i;
+                }
+                if (!left) return false;
+                if (c == '"') {
+                    nextOp(s);
+                } else {
+                    s.options = left;
+                    s.pos++;
+                }
+                return true;
+            }
+
+            case OP_INT:
+                if (c >= '0' && c <= '9') {
+                    if (s.pos >= op.len) return false;
+                    s.phase = PH_BODY;
+                    s.pos = c == '0' && s.pos == 0 ? op.len : s.pos + 1;   // No leading zeros
+                    return true;
+                }
+                if (s.phase != PH_BODY) return false;
+                nextOp(s);
+                continue;                           // c belongs to what follows
+
+            case OP_STRING_ARRAY:
+                switch (s.phase) {
+                    case PH_OPEN:
+                        if (c != '[') return false;
+                        s.phase = PH_FIRST;
+                        return true;
+                    case PH_FIRST:
+                    case PH_NEXT:
+                        if (c == ']') {
+                            nextOp(s);
+                            return true;
+                        }
+                        if (s.phase == PH_FIRST && c == '"') {
+                            s.phase = PH_BODY;
+                            return true;
+                        }
+                        if (s.phase == PH_FIRST || c != ',' || s.items >= op.maxItems) return false;
+                        s.phase = PH_ITEM;
+                        return true;
+                    case PH_ITEM:
+                        if (c != '"') return false;
+                        s.phase = PH_BODY;
+                        s.pos = 0;
+                        return true;
+                    default:
+                        if (c == '"') {
+                            s.items++;
+                            s.phase = PH_NEXT;
+                            return true;
+                        }
+                        if (!isStringChar(c) || s.pos >= op.len) return false;
+                        s.pos++;
+                        return true;
+                }
+        }
+    }
+    if (s.op == opCount && c == '}') {
+        s.op++;
+        return true;
+    }
+    return false;
+}
+
+bool JsonGrammar::acceptText(GrammarState& s, const char* text, size_t len) const {
+    for (size_t i = 0; i < len; i++) {
+        if (!accept(s, (uint8_t)text[i])) return false;
+    }
+    return true;
+}
+
+// Characters left in the string being written, -1 outside a string
+int JsonGrammar::stringRoom(const GrammarState& s) const {
+    if (s.op >= opCount || s.phase != PH_BODY) return -1;
+    const Op& op = ops[s.op];
+    if (op.type != OP_STRING && op.type != OP_STRING_ARRAY) return -1;
+    return op.len - s.pos;
+}
+
+bool JsonGrammar::mask(float* logits) const {
+    if (!order) return true;
+
+    bool any = false;
+    int room = stringRoom(state);
+    for (int b = 0; b < 256; b++) {
+        int32_t from = buckets[b];
+        int32_t to = buckets[b + 1];
+        if (from == to) continue;
+
+        GrammarState first = state;
+        if (!accept(first, (uint8_t)b)) {
+            for (int32_t i = from; i < to; i++) logits[order[i]] = -INFINITY;
+            continue;
+        }
+        for (int32_t i = from; i < to; i++) {
+            int token = order[i];
+            size_t len;
+            char byte;
+            const char* text = tokenText(token, &len, &byte);
+            bool fits;
+            if (room >= 0 && plain[token]) {
+                fits = (int)len <= room;            // Stays inside the string
+            } else {
+                GrammarState s = first;
+                fits = acceptText(s, text + 1, len - 1);
+            }
+            if (fits) {
+                any = true;
+            } else {
+                logits[token] = -INFINITY;
+            }
+        }
+    }
+    for (int32_t i = buckets[256]; i < vocabSize; i++) logits[order[i]] = -INFINITY;
+    return any;
+}
+
+bool JsonGrammar::advance(int token) {
+    if (!order || token < 0 || token >= vocabSize) return false;
+    size_t len;
+    char byte;
+    const char* text = tokenText(token, &len, &byte);
+    return acceptText(state, text, len);
+}
+
+size_t JsonGrammar::finish(char* out, size_t outLen) {
+    size_t n = 0;
+    while (state.op <= opCount) {
+        char c = '}';
+        if (state.op < opCount) {
+            const Op& op = ops[state.op];
+            switch (op.type) {
+                case OP_LITERAL:
+                    c = pool[op.text + state.pos];
+                    break;
+                case OP_STRING:
+                    c = '"';
+                    break;
+                case OP_ENUM:
+                    c = '"';
+                    if (state.phase == PH_BODY) {
+                        // Complete the shortest option still matching
+                        int best = -1;
+                        for (int i = 0; i < op.len; i++) {
+                            if ((state.options >> i & 1) &&
+                                (best < 0 || options[op.text + i].len < options[op.text + best].len)) {
+                                best = i;
+                            }
+                        }
+                        if (best >= 0 && options[op.text + best].len > state.pos) {
+                            c = pool[options[op.text + best].text + state.pos];
+                        }
+                    }
+                    break;
+                case OP_INT:
+                    if (state.phase == PH_BODY) {
+                        nextOp(state);
+                        continue;
+                    }
+                    c = '0';
+                    break;
+                case OP_STRING_ARRAY:
+                    c = state.phase == PH_OPEN ? '[' :
+                        state.phase == PH_FIRST || state.phase == PH_NEXT ? ']' : '"';
+                    break;
+            }
+        }
+        if (!accept(state, (uint8_t)c)) break;  // Enum without options
+        if (n + 1 < outLen) out[n++] = c;
+    }
+    if (outLen > 0) out[n] = '\0';
+    return n;
+}
+
+bool JsonGrammar::parse(const char* text, size_t len, ValueFn onValue, void* ctx) const {
+    GrammarState s;
+    memset(&s, 0, sizeof(s));
+    size_t start = 0;
+    for (size_t i = 0; i < len; i++) {
+        GrammarState before = s;
+        if (!accept(s, (uint8_t)text[i])) return false;
+
+        // A value starts on entering the body (after the quote, or at the
+        // first digit) and ends on leaving it
+        bool wasIn = before.op < opCount && before.phase == PH_BODY;
+        bool nowIn = s.op == before.op && s.phase == PH_BODY;
+        if (!wasIn && nowIn) start = ops[s.op].type == OP_INT ? i : i + 1;
+        if (wasIn && !nowIn && onValue) {
+            onValue(ctx, ops[before.op].member, before.items, text + start, i - start);
+        }
+    }
+    return s.op > opCount;
+}
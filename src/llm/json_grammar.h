@@ -0,0 +1,129 @@
+#ifndef LLM_JSON_GRAMMAR_H
+#define LLM_JSON_GRAMMAR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "tokenizer.h"
+
+// Schema limits
+#define GRAMMAR_MAX_OPS 24              // Two per member (key literal, value)
+#define GRAMMAR_MAX_OPTIONS 32          // Enum options, all enums together
+#define GRAMMAR_TEXT_MAX 768            // Key literals and option text
+
+// Where the automaton is: in member `op`, phase and position within it
+struct GrammarState {
+    uint8_t op;
+    uint8_t phase;
+    uint8_t items;                      // Array: strings closed so far
+    uint16_t pos;                       // Chars into the literal, string or option
+    uint32_t options;                   // Enum: options still matching
+};
+
+// A JSON object of fixed members, in order, as a character automaton:
+//
+//   {"name":"...","type":"<one of>","rooms":123,"fields":["...","..."]}
+//
+// Strings are printable ASCII without quotes or escapes, bounded in
+// length; integers are bounded in digits; arrays hold bounded strings.
+// Output is compact (no whitespace), so no tokens go to layout.
+//
+// During generation mask() sets the logit of every token whose text the
+// automaton can't take next to -inf, and advance() feeds the sampled
+// token. Tokens are bucketed by first byte at bind(): a bucket whose
+// first byte is refused is masked without looking at its tokens, and
+// inside a string tokens of plain text are checked by length alone, so
+// a step costs far less than walking every token's text.
+//
+// parse() runs the same automaton over finished text and reports each
+// value, so generated (or cached) output is read back without a JSON
+// library. Neither mask() nor parse() allocates.
+class JsonGrammar {
+public:
+    JsonGrammar();
+    ~JsonGrammar();
+
+    // Schema. Members are matched in the order added; false if a limit
+    // is reached.
+    void clear();
+    bool addString(const char* name, int maxLen);
+    bool addEnum(const char* name);
+    bool addOption(const char* text);   // To the last enum
+    bool addInt(const char* name, int maxDigits);
+    bool addStringArray(const char* name, int maxItems, int maxLen);
+
+    int getMemberCount() const;
+    int findMember(const char* name) const;
+    uint32_t getHash() const;           // Of the schema, for cache keys
+
+    // Token tables for `tokenizer` (which must outlive the grammar)
+    bool bind(const Tokenizer& tokenizer);
+    void unbind();
+    bool isBound() const;
+    size_t getTableSize() const;
+
+    // Generation: reset() at the start, then per step mask() the logits
+    // (false if no token fits, which a well-formed schema never causes)
+    // and advance() with the sampled token
+    void reset();
+    bool mask(float* logits) const;
+    bool advance(int token);
+    bool isComplete() const;
+
+    // Shortest text that closes the object from where generation stopped
+    // (open string closed, remaining members empty or 0). The state moves
+    // to complete. Returns the length written (NUL-terminated).
+    size_t finish(char* out, size_t outLen);
+
+    // Called for every value in parse(): member index, array item (0 for
+    // scalars), raw text without quotes
+    typedef void (*ValueFn)(void* ctx, int member, int item, const char* text, size_t len);
+
+    // True if `text` is one complete object of this schema
+    bool parse(const char* text, size_t len, ValueFn onValue, void* ctx) const;
+
+private:
+    enum OpType : uint8_t {
+        OP_LITERAL,
+        OP_STRING,
+        OP_ENUM,
+        OP_INT,
+        OP_STRING_ARRAY
+    };
+
+    struct Op {
+        OpType type;
+        uint8_t member;
+        uint8_t maxItems;
+        uint16_t text;                  // Literal: pool offset; enum: first option
+        uint16_t len;                   // Literal length; enum option count; max chars
+    };
+
+    struct Option {
+        uint16_t text;
+        uint16_t len;
+    };
+
+    Op ops[GRAMMAR_MAX_OPS];
+    Option options[GRAMMAR_MAX_OPTIONS];
+    char pool[GRAMMAR_TEXT_MAX];
+    int opCount;
+    int optionCount;
+    int poolUsed;
+    int memberCount;
+
+    const Tokenizer* tokenizer;
+    int vocabSize;
+    int32_t* order;                     // Token ids by first byte, then never-allowed ones
+    uint8_t* plain;                     // Token text is all string-safe characters
+    int32_t buckets[258];               // First-byte bucket b is order[buckets[b]..buckets[b+1])
+
+    GrammarState state;
+
+    bool addMember(const char* name, OpType type, int len, int maxItems);
+    bool accept(GrammarState& s, uint8_t c) const;
+    bool acceptText(GrammarState& s, const char* text, size_t len) const;
+    const char* tokenText(int token, size_t* len, char* byte) const;
+    int stringRoom(const GrammarState& s) const;
+};
+
+#endif // LLM_JSON_GRAMMAR_H
@@ -0,0 +1,303 @@
+#include "kernels.h"
+#include <math.h>
+#include <string.h>
+
+#if !defined(HOST_BUILD) && defined(CONFIG_IDF_TARGET_ESP32S3)
+#define KERNELS_PIE 1
+#endif
+
+#if defined(HOST_BUILD) && (defined(__x86_64__) || defined(__i386__))
+#define KERNELS_AVX2 1
+#include <immintrin.h>
+#endif
+
+// Shared row loops: int32 group dots from Dot, fp32 accumulation in group
+// order (identical in every implementation). Always inlined so the dot
+// inlines too, including into target("avx2") wrappers.
+#define KERNEL_INLINE inline __attribute__((always_inline))
+
+template <int32_t (*Dot)(const int8_t*, const int8_t*, int)>
+static KERNEL_INLINE void matvecQ8Rows(float* out, const int8_t* xq, const float* xs,
+                                       const int8_t* wq, const float* ws, int n, int d, int gs) {
+    int groups = n / gs;
+    for (int i = 0; i < d; i++) {
+        const int8_t* row = wq + (size_t)i * n;
+        const float* rowScale = ws + (size_t)i * groups;
+        float val = 0;
+        for (int g = 0; g < groups; g++) {
+            int32_t ival = Dot(xq + g * gs, row + g * gs, gs);
+            val += (float)ival * rowScale[g] * xs[g];
+        }
+        out[i] = val;
+    }
+}
+
+template <int32_t (*Dot)(const int8_t*, const uint8_t*, int)>
+static KERNEL_INLINE void matvecQ4Rows(float* out, const int8_t* xq, const float* xs,
+                                       const uint8_t* wq, const float* ws, int n, int d, int gs) {
+    int groups = n / gs;
+    for (int i = 0; i < d; i++) {
+        const uint8_t* row = wq + (size_t)i * n / 2;
+        const float* rowScale = ws + (size_t)i * groups;
+        float val = 0;
+        for (int g = 0; g < groups; g++) {
+            int32_t ival = Dot(xq + g * gs, row + g * gs / 2, gs);
+            val += (float)ival * rowScale[g] * xs[g];
+        }
+        out[i] = val;
+    }
+}
+
+// ---- Scalar reference ----
+
+static KERNEL_INLINE int32_t dotQ8Scalar(const int8_t* a, const int8_t* b, int n) {
+    int32_t sum = 0;
+    for (int i = 0; i < n; i++) sum += (int32_t)a[i] * (int32_t)b[i];
+    return sum;
+}
+
+// n is a multiple of KERNEL_Q4_BLOCK
+static KERNEL_INLINE int32_t dotQ4Scalar(const int8_t* a, const uint8_t* b, int n) {
+    int32_t sum = 0;
+    for (int block = 0; block < n; block += KERNEL_Q4_BLOCK) {
+        const int8_t* x = a + block;
+        const uint8_t* w = b + block / 2;
+        for (int j = 0; j < KERNEL_Q4_BLOCK / 2; j++) {
+            sum += (int32_t)x[j] * ((w[j] & 0x0F) - 8);
+            sum += (int32_t)x[j + 16] * ((w[j] >> 4) - 8);
+        }
+    }
+    return sum;
+}
+
+static int32_t dotQ8ScalarEntry(const int8_t* a, const int8_t* b, int n) {
+    return dotQ8Scalar(a, b, n);
+}
+
+static void matvecQ8Scalar(float* out, const int8_t* xq, const float* xs,
+                           const int8_t* wq, const float* ws, int n, int d, int gs) {
+    matvecQ8Rows<dotQ8Scalar>(out, xq, xs, wq, ws, n, d, gs);
+}
+
+static void matvecQ4Scalar(float* out, const int8_t* xq, const float* xs,
+                           const uint8_t* wq, const float* ws, int n, int d, int gs) {
+    matvecQ4Rows<dotQ4Scalar>(out, xq, xs, wq, ws, n, d, gs);
+}
+
+static const MatvecKernels scalarKernels = {
+    "scalar", dotQ8ScalarEntry, matvecQ8Scalar, matvecQ4Scalar,
+};
+
+// ---- x86 AVX2 (host) ----
+
+#ifdef KERNELS_AVX2
+
+#define KERNEL_AVX2 __attribute__((target("avx2")))
+
+KERNEL_AVX2 static KERNEL_INLINE int32_t sumLanes(__m256i v) {
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+    return _mm_cvtsi128_si32(s);
+}
+
+// Widening to int16 keeps every product exact (maddubs would saturate
+// on -128)
+KERNEL_AVX2 static KERNEL_INLINE __m256i madd16(__m128i a, __m128i b) {
+    return _mm256_madd_epi16(_mm256_cvtepi8_epi16(a), _mm256_cvtepi8_epi16(b));
+}
+
+KERNEL_AVX2 static inline int32_t dotQ8Avx2(const int8_t* a, const int8_t* b, int n) {
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc = _mm256_add_epi32(acc, madd16(_mm_loadu_si128((const __m128i*)(a + i)),
+                                           _mm_loadu_si128((const __m128i*)(b + i))));
+    }
+    int32_t sum = sumLanes(acc);
+    for (; i < n; i++) sum += (int32_t)a[i] * (int32_t)b[i];
+    return sum;
+}
+
+KERNEL_AVX2 static inline int32_t dotQ4Avx2(const int8_t* a, const uint8_t* b, int n) {
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i bias = _mm_set1_epi8(8);
+    __m256i acc = _mm256_setzero_si256();
+    for (int block = 0; block < n; block += KERNEL_Q4_BLOCK) {
+        __m128i packed = _mm_loadu_si128((const __m128i*)(b + block / 2));
+        __m128i lo = _mm_sub_epi8(_mm_and_si128(packed, mask), bias);
+        __m128i hi = _mm_sub_epi8(_mm_and_si128(_mm_srli_epi16(packed, 4), mask), bias);
+        acc = _mm256_add_epi32(acc, madd16(_mm_loadu_si128((const __m128i*)(a + block)), lo));
+        acc = _mm256_add_epi32(acc, madd16(_mm_loadu_si128((const __m128i*)(a + block + 16)), hi));
+    }
+    return sumLanes(acc);
+}
+
+KERNEL_AVX2 static int32_t dotQ8Avx2Entry(const int8_t* a, const int8_t* b, int n) {
+    return dotQ8Avx2(a, b, n);
+}
+
+KERNEL_AVX2 static void matvecQ8Avx2(float* out, const int8_t* xq, const float* xs,
+                                     const int8_t* wq, const float* ws, int n, int d, int gs) {
+    matvecQ8Rows<dotQ8Avx2>(out, xq, xs, wq, ws, n, d, gs);
+}
+
+KERNEL_AVX2 static void matvecQ4Avx2(float* out, const int8_t* xq, const float* xs,
+                                     const uint8_t* wq, const float* ws, int n, int d, int gs) {
+    matvecQ4Rows<dotQ4Avx2>(out, xq, xs, wq, ws, n, d, gs);
+}
+
+static const MatvecKernels avx2Kernels = {
+    "avx2", dotQ8Avx2Entry, matvecQ8Avx2, matvecQ4Avx2,
+};
+
+#endif
+
+// ---- ESP32-S3 PIE (device) ----
+
+#ifdef KERNELS_PIE
+
+// 16 int8 lanes multiplied and summed into the 40-bit ACCX accumulator.
+// EE.VLD.128 needs 16-byte aligned addresses; misaligned or ragged
+// inputs take the scalar loop.
+static int32_t dotQ8Pie(const int8_t* a, const int8_t* b, int n) {
+    if (((uintptr_t)a | (uintptr_t)b | (uintptr_t)n) & 15) return dotQ8Scalar(a, b, n);
+
+    int32_t sum;
+    int blocks = n / 16;
+    __asm__ volatile(
+        "ee.zero.accx\n"
+        "loopnez %[blocks], 1f\n"
+        "ee.vld.128.ip q0, %[a], 16\n"
+        "ee.vld.128.ip q1, %[b], 16\n"
+        "ee.vmulas.s8.accx q0, q1\n"
+        "1:\n"
+        "rur.accx_0 %[sum]\n"
+        : [a] "+r"(a), [b] "+r"(b), [sum] "=r"(sum)
+        : [blocks] "r"(blocks)
+        : "memory");
+    return sum;
+}
+
+// Nibbles are unpacked into an aligned block, then dotted with PIE
+static int32_t dotQ4Pie(const int8_t* a, const uint8_t* b, int n) {
+    int8_t block[KERNEL_Q4_BLOCK] __attribute__((aligned(16)));
+    int32_t sum = 0;
+    for (int at = 0; at < n; at += KERNEL_Q4_BLOCK) {
+        const uint8_t* w = b + at / 2;
+        for (int j = 0; j < KERNEL_Q4_BLOCK / 2; j++) {
+            block[j] = (int8_t)((w[j] & 0x0F) - 8);
+            block[j + 16] = (int8_t)((w[j] >> 4) - 8);
+        }
+        sum += dotQ8Pie(a + at, block, KERNEL_Q4_BLOCK);
+    }
+    return sum;
+}
+
+static void matvecQ8Pie(float* out, const int8_t* xq, const float* xs,
+                        const int8_t* wq, const float* ws, int n, int d, int gs) {
+    matvecQ8Rows<dotQ8Pie>(out, xq, xs, wq, ws, n, d, gs);
+}
+
+static void matvecQ4Pie(float* out, const int8_t* xq, const float* xs,
+                        const uint8_t* wq, const float* ws, int n, int d, int gs) {
+    matvecQ4Rows<dotQ4Pie>(out, xq, xs, wq, ws, n, d, gs);
+}
+
+static const MatvecKernels pieKernels = {
+    "pie", dotQ8Pie, matvecQ8Pie, matvecQ4Pie,
+};
+
+#endif
+
+// ---- Dispatch ----
+
+static const MatvecKernels* const implementations[] = {
+    &scalarKernels,
+#ifdef KERNELS_AVX2
+    &avx2Kernels,
+#endif
+#ifdef KERNELS_PIE
+    &pieKernels,
+#endif
+};
+
+static const int implementationCount = sizeof(implementations) / sizeof(implementations[0]);
+
+static bool supported(const MatvecKernels* k) {
+#ifdef KERNELS_AVX2
+    if (k == &avx2Kernels) return __builtin_cpu_supports("avx2");
+#endif
+    (void)k;
+    return true;
+}
+
+const MatvecKernels* Kernels::current = nullptr;
+
+const MatvecKernels& Kernels::active() {
+    if (!current) {
+        current = &scalarKernels;
+        for (int i = 0; i < implementationCount; i++) {
+            if (supported(implementations[i])) current = implementations[i];
+        }
+    }
+    return *current;
+}
+
+const MatvecKernels& Kernels::scalar() {
+    return scalarKernels;
+}
+
+int Kernels::count() {
+    int n = 0;
+    for (int i = 0; i < implementationCount; i++) {
+        if (supported(implementations[i])) n++;
+    }
+    return n;
+}
+
+const MatvecKernels& Kernels::get(int index) {
+    for (int i = 0; i < implementationCount; i++) {
+        if (supported(implementations[i]) && index-- == 0) return *implementations[i];
+    }
+    return scalarKernels;
+}
+
+bool Kernels::select(const char* name) {
+    for (int i = 0; i < implementationCount; i++) {
+        if (strcmp(implementations[i]->name, name) == 0 && supported(implementations[i])) {
+            current = implementations[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+void Kernels::quantizeQ8(int8_t* q, float* s, const float* in, int n, int gs) {
+    for (int group = 0; group < n / gs; group++) {
+        const float* v = in + group * gs;
+
+        float wmax = 0;
+        for (int i = 0; i < gs; i++) {
+            float a = fabsf(v[i]);
+            if (a > wmax) wmax = a;
+        }
+
+        float scale = wmax / 127.0f;
+        float inv = scale > 0 ? 1.0f / scale : 0;
+        s[group] = scale;
+        for (int i = 0; i < gs; i++) {
+            q[group * gs + i] = (int8_t)roundf(v[i] * inv);
+        }
+    }
+}
+
+void Kernels::packQ4(uint8_t* out, const int8_t* values, int n) {
+    for (int block = 0; block < n; block += KERNEL_Q4_BLOCK) {
+        const int8_t* v = values + block;
+        uint8_t* w = out + block / 2;
+        for (int j = 0; j < KERNEL_Q4_BLOCK / 2; j++) {
+            w[j] = (uint8_t)((v[j] + 8) | ((v[j + 16] + 8) << 4));
+        }
+    }
+}
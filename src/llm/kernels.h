@@ -0,0 +1,59 @@
+#ifndef LLM_KERNELS_H
+#define LLM_KERNELS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Quantized matrix-vector kernels, the inner loop of inference.
+//
+// Weights are row-major with one fp32 scale per group of groupSize
+// values; activations are quantized the same way (quantizeQ8). Each row
+// is the sum over groups of int32 dot(x, w) * wScale * xScale, accumulated
+// in group order. Every implementation computes the exact int32 group
+// dots and then runs that same float sequence, so all of them are
+// bit-exact against the scalar reference.
+//
+// int4 weights pack each 32-value block into 16 bytes: byte j holds value
+// j in its low nibble and value j + 16 in its high nibble, both stored as
+// value + 8 (range -8..7). Q4 needs groupSize to be a multiple of 32.
+
+#define KERNEL_Q4_BLOCK 32
+
+struct MatvecKernels {
+    const char* name;
+
+    // Sum of a[i] * b[i]
+    int32_t (*dotQ8)(const int8_t* a, const int8_t* b, int n);
+
+    // out (d) = W (d, n) @ x (n)
+    void (*matvecQ8)(float* out, const int8_t* xq, const float* xs,
+                     const int8_t* wq, const float* ws, int n, int d, int groupSize);
+    void (*matvecQ4)(float* out, const int8_t* xq, const float* xs,
+                     const uint8_t* wq, const float* ws, int n, int d, int groupSize);
+};
+
+class Kernels {
+public:
+    // Fastest implementation this build and CPU supports: ESP32-S3 PIE on
+    // the device, AVX2 on x86 hosts that have it, scalar otherwise
+    static const MatvecKernels& active();
+    static const MatvecKernels& scalar();
+
+    // All implementations usable here (scalar first), for benchmarks
+    static int count();
+    static const MatvecKernels& get(int index);
+
+    // Force an implementation by name; false if unknown or unsupported
+    static bool select(const char* name);
+
+    // Per-group symmetric int8 quantization of n values
+    static void quantizeQ8(int8_t* q, float* s, const float* in, int n, int groupSize);
+
+    // Pack int8 values in -8..7 into the Q4 block layout (n / 2 bytes)
+    static void packQ4(uint8_t* out, const int8_t* values, int n);
+
+private:
+    static const MatvecKernels* current;
+};
+
+#endif // LLM_KERNELS_H
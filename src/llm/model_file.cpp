@@ -0,0 +1,149 @@
+#include "model_file.h"
+#include "platform.h"
+#include <string.h>
+
+#ifndef HOST_BUILD
+#include <esp_rom_crc.h>
+#endif
+
+#ifdef HOST_BUILD
+// Byte-at-a-time table CRC (reflected 0xEDB88320, as zlib)
+static uint32_t crcTable[256];
+
+static void buildCrcTable() {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        crcTable[i] = c;
+    }
+}
+#endif
+
+uint32_t ModelFile::crc32(uint32_t crc, const void* data, size_t len) {
+#ifdef HOST_BUILD
+    if (crcTable[1] == 0) buildCrcTable();
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) crc = crcTable[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+#else
+    // ROM routine: same polynomial and conditioning as zlib
+    return esp_rom_crc32_le(crc, (const uint8_t*)data, len);
+#endif
+}
+
+bool ModelFile::getEntry(const uint8_t* base, size_t size, uint32_t index, ModelTensorEntry& out) {
+    ModelFileHeader h;
+    memcpy(&h, base, sizeof(h));
+    if (index >= h.tensorCount) return false;
+
+    if (h.version == 1) {
+        uint64_t at = h.tableOffset + (uint64_t)index * sizeof(ModelTensorEntryV1);
+        if (at + sizeof(ModelTensorEntryV1) > size) return false;
+        ModelTensorEntryV1 e;
+        memcpy(&e, base + at, sizeof(e));
+        memset(&out, 0, sizeof(out));
+        out.kind = e.kind;
+        out.layer = e.layer;
+        out.type = e.type;
+        out.offset = e.offset;
+        out.bytes = e.bytes;
+        return true;
+    }
+
+    uint64_t at = h.tableOffset + (uint64_t)index * sizeof(ModelTensorEntry);
+    if (at + sizeof(ModelTensorEntry) > size) return false;
+    memcpy(&out, base + at, sizeof(out));
+    return true;
+}
+
+const uint8_t* ModelFile::findTensor(const uint8_t* base, size_t size, ModelTensorKind kind,
+                                     size_t* bytes) {
+    if (size < sizeof(ModelFileHeader)) return nullptr;
+    ModelFileHeader h;
+    memcpy(&h, base, sizeof(h));
+    if (h.magic != MODEL_FILE_MAGIC) return nullptr;
+
+    ModelTensorEntry e;
+    for (uint32_t i = 0; getEntry(base, size, i, e); i++) {
+        if (e.kind != kind) continue;
+        if ((uint64_t)e.offset + e.bytes > size) return nullptr;
+        *bytes = e.bytes;
+        return base + e.offset;
+    }
+    return nullptr;
+}
+
+static bool failCheck(ModelFileCheck& out, uint64_t start, const char* error) {
+    out.error = error;
+    out.timeUs = llmMicros() - start;
+    return false;
+}
+
+bool ModelFile::verify(const uint8_t* base, size_t size, ModelVerifyLevel level,
+                       ModelFileCheck& out) {
+    uint64_t start = llmMicros();
+    memset(&out, 0, sizeof(out));
+    out.badTensor = -1;
+
+    if (!base || size < sizeof(ModelFileHeader)) return failCheck(out, start, "model file too small");
+    ModelFileHeader h;
+    memcpy(&h, base, sizeof(h));
+    out.version = h.version;
+    out.tensorCount = h.tensorCount;
+    if (h.magic != MODEL_FILE_MAGIC) return failCheck(out, start, "not a packed model (bad magic)");
+    if (h.version < 1 || h.version > MODEL_FILE_VERSION) {
+        return failCheck(out, start, "unsupported model file version");
+    }
+    if (h.fileSize > size) return failCheck(out, start, "model file truncated");
+
+    size_t entrySize = h.version == 1 ? sizeof(ModelTensorEntryV1) : sizeof(ModelTensorEntry);
+    uint64_t tableBytes = (uint64_t)h.tensorCount * entrySize;
+    if (h.tensorCount > MODEL_FILE_MAX_TENSORS || h.tableOffset % 4 != 0 ||
+        h.tableOffset + tableBytes > h.fileSize) {
+        return failCheck(out, start, "bad tensor table");
+    }
+
+    if (h.version >= 2) {
+        if (h.tableOffset < sizeof(ModelFileHeader) + sizeof(ModelFileInfo)) {
+            return failCheck(out, start, "bad tensor table");
+        }
+        uint8_t head[sizeof(ModelFileHeader) + sizeof(ModelFileInfo)];
+        memcpy(head, base, sizeof(head));
+        ModelFileInfo info;
+        memcpy(&info, head + sizeof(ModelFileHeader), sizeof(info));
+        memset(head + sizeof(ModelFileHeader) + offsetof(ModelFileInfo, headerCrc), 0,
+               sizeof(info.headerCrc));
+
+        out.checksummed = true;
+        out.headerCrc = info.headerCrc;
+        out.bytesChecked = sizeof(head) + tableBytes;
+        if (crc32(0, head, sizeof(head)) != info.headerCrc) {
+            return failCheck(out, start, "header checksum mismatch");
+        }
+        if (crc32(0, base + h.tableOffset, tableBytes) != info.tableCrc) {
+            return failCheck(out, start, "tensor table checksum mismatch");
+        }
+        if (info.quantBits != 8 || info.quantScheme != MODEL_QUANT_SYMMETRIC) {
+            return failCheck(out, start, "unsupported quantization");
+        }
+    }
+
+    ModelTensorEntry e;
+    for (uint32_t i = 0; getEntry(base, size, i, e); i++) {
+        if (e.offset % MODEL_FILE_ALIGN != 0 || (uint64_t)e.offset + e.bytes > h.fileSize) {
+            out.badTensor = i;
+            return failCheck(out, start, "bad tensor entry");
+        }
+        if (level == MODEL_VERIFY_FULL && h.version >= 2) {
+            if (crc32(0, base + e.offset, e.bytes) != e.crc) {
+                out.badTensor = i;
+                return failCheck(out, start, "tensor checksum mismatch");
+            }
+            out.bytesChecked += e.bytes;
+        }
+    }
+
+    out.timeUs = llmMicros() - start;
+    return true;
+}
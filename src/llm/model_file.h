@@ -0,0 +1,161 @@
+#ifndef LLM_MODEL_FILE_H
+#define LLM_MODEL_FILE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Packed model file ("CPLM"): everything the engine needs to run a model,
+// laid out for in-place use from a memory map. Nothing is parsed or
+// reshaped at load: the tables give each tensor's offset, and every
+// tensor starts on a MODEL_FILE_ALIGN boundary, so the mapped file is
+// used directly as weight storage. All fields are little-endian.
+//
+//   0    ModelFileHeader (64 bytes)    hyperparameters, table location
+//   64   ModelFileInfo (64 bytes)      checksums, quantization, RoPE/norm
+//   128  ModelTensorEntry[tensorCount] (32 bytes each)
+//   ..   tensors, each at a 64-byte aligned offset, zero padding between
+//
+// Weights are int8, symmetric, with one fp32 scale per groupSize values
+// along a row (value = q * scale). A quantized weight is two entries of
+// the same kind and layer: TENSOR_Q8 values and TENSOR_F32 scales. Norm
+// weights are plain fp32. TENSOR_VOCAB holds the llama2.c tokenizer.bin
+// bytes, so the file carries its own vocabulary.
+//
+// Integrity: headerCrc covers header and info, tableCrc the tensor table,
+// and each entry's crc its tensor (CRC-32, as zlib's crc32). Checking
+// the first two costs microseconds; the tensor CRCs read the whole file.
+//
+// Version 1 files (no info block, 16-byte entries without shapes or
+// checksums, no vocab) still load. tools/pack_model.py writes version 2
+// from llama2.c checkpoints and checks existing files (--verify).
+
+#define MODEL_FILE_MAGIC 0x4d4c5043         // "CPLM"
+#define MODEL_FILE_VERSION 2
+#define MODEL_FILE_ALIGN 64
+#define MODEL_FILE_MAX_TENSORS 4096
+
+#define MODEL_FLAG_SHARED_CLASSIFIER 0x01
+
+#define MODEL_QUANT_SYMMETRIC 0             // q * scale, no zero point
+
+struct ModelFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    int32_t dim;
+    int32_t hiddenDim;
+    int32_t nLayers;
+    int32_t nHeads;
+    int32_t nKvHeads;
+    int32_t vocabSize;
+    int32_t seqLen;
+    int32_t groupSize;
+    uint32_t flags;             // MODEL_FLAG_*
+    uint32_t tensorCount;
+    uint64_t tableOffset;       // From the start of the file
+    uint64_t fileSize;          // Header + table + tensors, padded
+};
+
+// Follows the header from version 2 on
+struct ModelFileInfo {
+    uint32_t headerCrc;         // Header + info, with this field zero
+    uint32_t tableCrc;          // tensorCount entries at tableOffset
+    uint8_t quantBits;          // 8
+    uint8_t quantScheme;        // MODEL_QUANT_*
+    uint16_t reserved0;
+    float ropeTheta;            // RoPE base frequency
+    float normEps;              // RMSNorm epsilon
+    uint32_t maxTokenLen;       // Longest vocab piece, 0 without a vocab
+    uint32_t sourceCrc;         // Of the checkpoint it was converted from
+    uint32_t reserved[3];
+    char name[24];              // Source file name, NUL-padded
+};
+
+// Which weight a table entry holds
+enum ModelTensorKind : uint16_t {
+    TENSOR_RMS_ATT = 0,         // fp32 (layers, dim), one entry
+    TENSOR_RMS_FFN = 1,         // fp32 (layers, dim), one entry
+    TENSOR_RMS_FINAL = 2,       // fp32 (dim)
+    TENSOR_TOKEN_EMBEDDING = 3, // (vocab, dim)
+    TENSOR_WQ = 4,              // Per layer from here on, (out, in)
+    TENSOR_WK = 5,
+    TENSOR_WV = 6,
+    TENSOR_WO = 7,
+    TENSOR_W1 = 8,
+    TENSOR_W2 = 9,
+    TENSOR_W3 = 10,
+    TENSOR_CLASSIFIER = 11,     // Absent when the classifier is shared
+    TENSOR_VOCAB = 12,          // tokenizer.bin bytes (version 2)
+};
+
+enum ModelTensorType : uint16_t {
+    TENSOR_F32 = 0,
+    TENSOR_Q8 = 1,
+    TENSOR_BYTES = 2,           // Opaque (vocab)
+};
+
+struct ModelTensorEntry {
+    uint16_t kind;              // ModelTensorKind
+    uint16_t layer;
+    uint16_t type;              // ModelTensorType
+    uint16_t groupSize;         // Q8 values and their scales; 0 otherwise
+    uint32_t offset;            // From the start of the file
+    uint32_t bytes;
+    uint32_t rows;              // Shape in elements (scales: cols / group);
+    uint32_t cols;              // bytes x 1 for TENSOR_BYTES
+    uint32_t crc;               // CRC-32 of the tensor's bytes
+    uint32_t reserved;
+};
+
+// Version 1 table entry
+struct ModelTensorEntryV1 {
+    uint16_t kind;
+    uint16_t layer;
+    uint16_t type;
+    uint16_t reserved;
+    uint32_t offset;
+    uint32_t bytes;
+};
+
+static_assert(sizeof(ModelFileHeader) == 64, "ModelFileHeader must be 64 bytes");
+static_assert(sizeof(ModelFileInfo) == 64, "ModelFileInfo must be 64 bytes");
+static_assert(sizeof(ModelTensorEntry) == 32, "ModelTensorEntry must be 32 bytes");
+static_assert(sizeof(ModelTensorEntryV1) == 16, "ModelTensorEntryV1 must be 16 bytes");
+
+// How much of a file verify() reads
+enum ModelVerifyLevel : uint8_t {
+    MODEL_VERIFY_HEADER,        // Header, info and table (microseconds)
+    MODEL_VERIFY_FULL           // And every tensor (the whole file)
+};
+
+struct ModelFileCheck {
+    uint32_t version;
+    uint32_t tensorCount;
+    uint32_t headerCrc;         // 0 for version 1
+    bool checksummed;           // Version 2: CRCs were there to check
+    int badTensor;              // Table index whose CRC failed, -1 if none
+    uint64_t bytesChecked;
+    uint64_t timeUs;
+    const char* error;          // nullptr when the file passed
+};
+
+// Reading packed files without loading them
+class ModelFile {
+public:
+    // Structure and checksums up to `level`. Version 1 files have no
+    // checksums; their structure is still checked.
+    static bool verify(const uint8_t* base, size_t size, ModelVerifyLevel level,
+                       ModelFileCheck& out);
+
+    // Table entry `index` in the version 2 layout (version 1 entries are
+    // widened; their shape, group and crc are 0). False past the table.
+    static bool getEntry(const uint8_t* base, size_t size, uint32_t index, ModelTensorEntry& out);
+
+    // First tensor of `kind`, nullptr if the file has none
+    static const uint8_t* findTensor(const uint8_t* base, size_t size, ModelTensorKind kind,
+                                     size_t* bytes);
+
+    // zlib-compatible CRC-32, chained through `crc` (0 to start)
+    static uint32_t crc32(uint32_t crc, const void* data, size_t len);
+};
+
+#endif // LLM_MODEL_FILE_H
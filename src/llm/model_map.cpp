@@ -0,0 +1,164 @@
+#include "model_map.h"
+#include "model_file.h"
+#include "platform.h"
+#include <string.h>
+
+#ifdef HOST_BUILD
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <unistd.h>
+#else
+#include <esp_idf_version.h>
+#include <esp_partition.h>
+#if ESP_IDF_VERSION_MAJOR >= 5
+#define MODEL_MMAP_DATA ESP_PARTITION_MMAP_DATA
+#define modelMunmap esp_partition_munmap
+typedef esp_partition_mmap_handle_t ModelMmapHandle;
+#else
+#include <esp_spi_flash.h>
+#define MODEL_MMAP_DATA SPI_FLASH_MMAP_DATA
+#define modelMunmap spi_flash_munmap
+typedef spi_flash_mmap_handle_t ModelMmapHandle;
+#endif
+#endif
+
+ModelMap::ModelMap() : base(nullptr), length(0), mapTimeUs(0), error(nullptr) {
+#ifdef HOST_BUILD
+    mappedLength = 0;
+#else
+    handle = 0;
+#endif
+}
+
+ModelMap::~ModelMap() {
+    unmap();
+}
+
+bool ModelMap::fail(const char* message) {
+    unmap();
+    error = message;
+    return false;
+}
+
+#ifdef HOST_BUILD
+
+bool ModelMap::mapFile(const char* path) {
+    unmap();
+    error = nullptr;
+    uint64_t start = llmMicros();
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return fail("cannot open model file");
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(ModelFileHeader)) {
+        close(fd);
+        return fail("model file too small");
+    }
+
+    void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // The mapping keeps its own reference
+    if (p == MAP_FAILED) return fail("mmap failed");
+
+    base = (const uint8_t*)p;
+    length = st.st_size;
+    mappedLength = st.st_size;
+    mapTimeUs = llmMicros() - start;
+    return true;
+}
+
+void ModelMap::unmap() {
+    if (base) munmap((void*)base, mappedLength);
+    base = nullptr;
+    length = 0;
+    mappedLength = 0;
+}
+
+// Pages of the mapping present in this process (Rss of its smaps entry);
+// untouched weights are not counted even when the file is cached
+size_t ModelMap::residentBytes() const {
+    if (!base) return 0;
+
+    FILE* f = fopen("/proc/self/smaps", "r");
+    if (!f) return 0;
+
+    char line[256];
+    bool inMapping = false;
+    size_t rssKb = 0;
+    while (fgets(line, sizeof(line), f)) {
+        unsigned long start, end;
+        if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+            inMapping = start == (uintptr_t)base;
+        } else if (inMapping && sscanf(line, "Rss: %zu kB", &rssKb) == 1) {
+            break;
+        }
+    }
+    fclose(f);
+    return rssKb * 1024;
+}
+
+#else
+
+bool ModelMap::mapPartition(const char* label) {
+    unmap();
+    error = nullptr;
+    uint64_t start = llmMicros();
+
+    const esp_partition_t* part = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (!part) return fail("model partition not found");
+
+    // Map only as much of the partition as the model uses: MMU pages
+    // are shared with the firmware's own rodata
+    ModelFileHeader h;
+    if (esp_partition_read(part, 0, &h, sizeof(h)) != ESP_OK) return fail("partition read failed");
+    if (h.magic != MODEL_FILE_MAGIC) return fail("partition holds no packed model");
+    if (h.fileSize < sizeof(h) || h.fileSize > part->size) return fail("model larger than partition");
+
+    const void* p = nullptr;
+    ModelMmapHandle mapping;
+    if (esp_partition_mmap(part, 0, h.fileSize, MODEL_MMAP_DATA, &p, &mapping) != ESP_OK) {
+        return fail("esp_partition_mmap failed (MMU pages exhausted?)");
+    }
+
+    base = (const uint8_t*)p;
+    length = h.fileSize;
+    handle = mapping;
+    mapTimeUs = llmMicros() - start;
+    return true;
+}
+
+void ModelMap::unmap() {
+    if (base) modelMunmap(handle);
+    base = nullptr;
+    length = 0;
+    handle = 0;
+}
+
+size_t ModelMap::residentBytes() const {
+    return 0;
+}
+
+#endif
+
+bool ModelMap::isMapped() const {
+    return base != nullptr;
+}
+
+const uint8_t* ModelMap::data() const {
+    return base;
+}
+
+size_t ModelMap::size() const {
+    return length;
+}
+
+uint64_t ModelMap::getMapTimeUs() const {
+    return mapTimeUs;
+}
+
+const char* ModelMap::getError() const {
+    return error ? error : "";
+}
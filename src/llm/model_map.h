@@ -0,0 +1,48 @@
+#ifndef LLM_MODEL_MAP_H
+#define LLM_MODEL_MAP_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Read-only memory map of a packed model file, so Transformer::load uses
+// the weights in place instead of copying them to RAM. On the device the
+// source is a flash data partition (esp_partition_mmap through the cache
+// MMU); on the host it is a regular file (mmap).
+class ModelMap {
+public:
+    ModelMap();
+    ~ModelMap();
+
+#ifdef HOST_BUILD
+    bool mapFile(const char* path);
+#else
+    // Maps the model at the start of the data partition with this label
+    bool mapPartition(const char* label);
+#endif
+    void unmap();
+
+    bool isMapped() const;
+    const uint8_t* data() const;
+    size_t size() const;
+    uint64_t getMapTimeUs() const;
+    const char* getError() const;
+
+    // Bytes of the mapping currently held in RAM. Flash mappings read
+    // through the cache and hold none; on the host, pages touched so far.
+    size_t residentBytes() const;
+
+private:
+    const uint8_t* base;
+    size_t length;
+    uint64_t mapTimeUs;
+    const char* error;
+#ifdef HOST_BUILD
+    size_t mappedLength;
+#else
+    uint32_t handle;
+#endif
+
+    bool fail(const char* message);
+};
+
+#endif // LLM_MODEL_MAP_H
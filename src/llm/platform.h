@@ -0,0 +1,52 @@
+#ifndef LLM_PLATFORM_H
+#define LLM_PLATFORM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// The inference core (transformer, tokenizer, sampler) is plain C++ so it
+// builds for the device and for host benchmarks. These are the only
+// platform hooks it needs.
+
+// Alignment of weight tensors and activation buffers (a cache line on
+// the host, PSRAM burst size on the S3)
+#define LLM_ALIGN 64
+
+#ifdef HOST_BUILD
+#include <stdlib.h>
+#include <chrono>
+
+static inline uint64_t llmMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static inline void* llmAlloc(size_t size) {
+    size = (size + LLM_ALIGN - 1) & ~(size_t)(LLM_ALIGN - 1);
+    return aligned_alloc(LLM_ALIGN, size);
+}
+
+static inline void llmFree(void* p) {
+    free(p);
+}
+#else
+#include <esp_timer.h>
+#include <esp_heap_caps.h>
+
+static inline uint64_t llmMicros() {
+    return esp_timer_get_time();
+}
+
+// Large buffers go to PSRAM when there is any, internal RAM otherwise
+static inline void* llmAlloc(size_t size) {
+    void* p = heap_caps_aligned_alloc(LLM_ALIGN, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!p) p = heap_caps_aligned_alloc(LLM_ALIGN, size, MALLOC_CAP_8BIT);
+    return p;
+}
+
+static inline void llmFree(void* p) {
+    heap_caps_free(p);
+}
+#endif
+
+#endif // LLM_PLATFORM_H
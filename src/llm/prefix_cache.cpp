@@ -0,0 +1,115 @@
+#include "prefix_cache.h"
+#include "transformer.h"
+#include "tokenizer.h"
+#include "platform.h"
+#include <string.h>
+
+PrefixCache::PrefixCache() : entryCount(0), hits(0), misses(0), reusedTokens(0) {
+    memset(entries, 0, sizeof(entries));
+}
+
+PrefixCache::~PrefixCache() {
+    clear();
+}
+
+bool PrefixCache::add(Transformer& model, const Tokenizer& tokenizer, const char* text) {
+    if (!tokenizer.isLoaded() || !model.isLoaded()) return false;
+
+    int* tokens = model.getTokenBuffer();
+    int count = tokenizer.encode(text, true, false, tokens, model.getConfig().seqLen);
+    return addTokens(model, tokens, count);
+}
+
+bool PrefixCache::addTokens(Transformer& model, const int* tokens, int count) {
+    if (!model.isLoaded() || entryCount >= PREFIX_CACHE_MAX_ENTRIES || count <= 0 ||
+        count >= model.getConfig().seqLen) {
+        return false;
+    }
+
+    Entry e;
+    e.count = count;
+    e.kvBytes = model.getKvSnapshotSize(count);
+    e.tokens = (int*)llmAlloc(count * sizeof(int));
+    e.kv = llmAlloc(e.kvBytes);
+    if (!e.tokens || !e.kv) {
+        if (e.tokens) llmFree(e.tokens);
+        if (e.kv) llmFree(e.kv);
+        return false;
+    }
+    memcpy(e.tokens, tokens, count * sizeof(int));
+
+    for (int pos = 0; pos < count; pos++) {
+        if (!model.forward(tokens[pos], pos)) {
+            llmFree(e.tokens);
+            llmFree(e.kv);
+            return false;
+        }
+    }
+    model.saveKv(e.kv, count);
+
+    entries[entryCount++] = e;
+    return true;
+}
+
+void PrefixCache::clear() {
+    for (int i = 0; i < entryCount; i++) {
+        llmFree(entries[i].tokens);
+        llmFree(entries[i].kv);
+    }
+    memset(entries, 0, sizeof(entries));
+    entryCount = 0;
+    hits = misses = reusedTokens = 0;
+}
+
+int PrefixCache::restore(Transformer& model, const int* tokens, int count) {
+    // Longest common token prefix with any entry
+    int best = -1;
+    int bestLen = 0;
+    for (int i = 0; i < entryCount; i++) {
+        const Entry& e = entries[i];
+        int limit = e.count < count - 1 ? e.count : count - 1;
+        int len = 0;
+        while (len < limit && e.tokens[len] == tokens[len]) len++;
+        if (len > bestLen) {
+            best = i;
+            bestLen = len;
+        }
+    }
+
+    // Every prompt shares BOS; that alone is not a hit
+    if (best < 0 || bestLen < 2) {
+        misses++;
+        return 0;
+    }
+
+    const Entry& e = entries[best];
+    model.restoreKv(e.kv, e.count, bestLen);
+
+    hits++;
+    reusedTokens += bestLen;
+    return bestLen;
+}
+
+int PrefixCache::getCount() const {
+    return entryCount;
+}
+
+size_t PrefixCache::getBytes() const {
+    size_t total = 0;
+    for (int i = 0; i < entryCount; i++) {
+        total += entries[i].kvBytes + entries[i].count * sizeof(int);
+    }
+    return total;
+}
+
+uint32_t PrefixCache::getHits() const {
+    return hits;
+}
+
+uint32_t PrefixCache::getMisses() const {
+    return misses;
+}
+
+uint32_t PrefixCache::getReusedTokens() const {
+    return reusedTokens;
+}
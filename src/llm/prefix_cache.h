@@ -0,0 +1,58 @@
+#ifndef LLM_PREFIX_CACHE_H
+#define LLM_PREFIX_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+class Transformer;
+class Tokenizer;
+
+// Registered prompt prefixes held at once
+#define PREFIX_CACHE_MAX_ENTRIES 4
+
+// KV state of fixed prompt prefixes. Each registered prefix is encoded
+// (BOS first, as Generator does) and run through the model once; its KV
+// cache positions are kept in a snapshot. A prompt that starts with the
+// same tokens restores the snapshot instead of recomputing those
+// positions. Matching is on token ids, so a prefix whose last token
+// merges differently in the full prompt still reuses everything before
+// that token.
+class PrefixCache {
+public:
+    PrefixCache();
+    ~PrefixCache();
+
+    // Run `text` through the model and keep its KV state. Returns false
+    // when the table is full, the prefix doesn't fit the context or
+    // memory runs out. Overwrites the model's KV cache.
+    bool add(Transformer& model, const Tokenizer& tokenizer, const char* text);
+    bool addTokens(Transformer& model, const int* tokens, int count);
+    void clear();
+
+    // Restore the longest cached prefix of the prompt, leaving at least
+    // its last token to run (it produces the first logits). Returns the
+    // number of positions restored; 0 if no entry matches.
+    int restore(Transformer& model, const int* tokens, int count);
+
+    int getCount() const;
+    size_t getBytes() const;            // Snapshots and token ids
+    uint32_t getHits() const;
+    uint32_t getMisses() const;
+    uint32_t getReusedTokens() const;   // Positions restored instead of computed
+
+private:
+    struct Entry {
+        int* tokens;
+        int count;
+        void* kv;                       // Transformer::saveKv snapshot
+        size_t kvBytes;
+    };
+
+    Entry entries[PREFIX_CACHE_MAX_ENTRIES];
+    int entryCount;
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t reusedTokens;
+};
+
+#endif // LLM_PREFIX_CACHE_H
@@ -0,0 +1,41 @@
+#ifndef LLM_PROMPTS_H
+#define LLM_PROMPTS_H
+
+// Fixed preambles of the engine's prompts. Every prompt starts with one
+// of these, so their KV state is computed once at model load and restored
+// per call (prefix_cache.h); changing the text only costs a re-encode.
+
+#define PROMPT_ANALYSIS_PREFIX \
+    "Analyze this captive portal page. Answer in JSON with:\n" \
+    "venueName, venueType (hotel, airport, cafe, etc.),\n" \
+    "estimatedRooms (rooms/users if detectable, else 0),\n" \
+    "formFields (required fields), securityIssues, recommendations.\n" \
+    "\n" \
+    "Page:\n"
+
+#define PROMPT_ANALYSIS_SUFFIX "\n\nJSON:"
+
+#define PROMPT_ENUM_PREFIX "Given a captive portal with these fields: "
+#define PROMPT_ENUM_SUFFIX "\n\nSuggest the best enumeration strategy:"
+
+#define PROMPT_INTERPRET_PREFIX "Given the context: "
+#define PROMPT_INTERPRET_MIDDLE "\nInterpret this response: "
+#define PROMPT_INTERPRET_SUFFIX "\nWhat does this tell us?"
+
+// Budget for the page digest (html_digest.h) in analysis prompts.
+// Digests of real portal pages fit well inside; the old raw-HTML prompt
+// took up to 2000 characters, mostly markup and <head>.
+#define PROMPT_DIGEST_MAX 768
+
+// Shape of the analysis answer. Generation is constrained to it
+// (json_grammar.h): compact JSON with these members in this order,
+// venueType one of the venue labels of the analysis rules or "Unknown".
+// Bounds keep the longest possible answer near LLM_MAX_TOKENS.
+#define ANALYSIS_NAME_MAX 40            // venueName characters
+#define ANALYSIS_ROOMS_DIGITS 4         // estimatedRooms
+#define ANALYSIS_ITEM_MAX 32            // Characters per array item
+#define ANALYSIS_FIELDS_MAX 5           // formFields items
+#define ANALYSIS_ISSUES_MAX 3           // securityIssues items
+#define ANALYSIS_ADVICE_MAX 2           // recommendations items
+
+#endif // LLM_PROMPTS_H
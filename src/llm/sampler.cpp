@@ -0,0 +1,129 @@
+#include "sampler.h"
+#include "platform.h"
+#include "arena_plan.h"
+#include <algorithm>
+#include <math.h>
+
+Sampler::Sampler()
+    : vocabSize(0), temperature(0), topP(0), rngState(1), probIndex(nullptr),
+      ownsScratch(false) {}
+
+Sampler::~Sampler() {
+    release();
+}
+
+bool Sampler::configure(int vocab, float temp, float p, uint64_t seed, ArenaPlan* shared) {
+    if (shared) {
+        release();
+        if (!shared->add("probIndex", (void**)&probIndex, vocab * sizeof(ProbIndex),
+                         ARENA_OUTPUT)) {
+            return false;
+        }
+    } else if (vocab != vocabSize || !probIndex || !ownsScratch) {
+        release();
+        probIndex = (ProbIndex*)llmAlloc(vocab * sizeof(ProbIndex));
+        if (!probIndex) return false;
+        ownsScratch = true;
+    }
+    vocabSize = vocab;
+    temperature = temp;
+    topP = p;
+    rngState = seed ? seed : 1;
+    return true;
+}
+
+void Sampler::release() {
+    if (probIndex && ownsScratch) llmFree(probIndex);
+    probIndex = nullptr;
+    ownsScratch = false;
+    vocabSize = 0;
+}
+
+void Sampler::setTemperature(float temp) {
+    temperature = temp;
+}
+
+void Sampler::setTopP(float p) {
+    topP = p;
+}
+
+// xorshift* (llama2.c)
+float Sampler::randomFloat() {
+    rngState ^= rngState >> 12;
+    rngState ^= rngState << 25;
+    rngState ^= rngState >> 27;
+    uint32_t bits = (uint32_t)((rngState * 0x2545F4914F6CDD1Dull) >> 32);
+    return (bits >> 8) / 16777216.0f;
+}
+
+int Sampler::argmax(const float* values, int n) {
+    int best = 0;
+    for (int i = 1; i < n; i++) {
+        if (values[i] > values[best]) best = i;
+    }
+    return best;
+}
+
+int Sampler::sampleMultinomial(const float* probs, float coin) const {
+    float cdf = 0;
+    for (int i = 0; i < vocabSize; i++) {
+        cdf += probs[i];
+        if (coin < cdf) return i;
+    }
+    return vocabSize - 1;  // Rounding
+}
+
+int Sampler::sampleTopP(const float* probs, float coin) {
+    // Tokens below (1 - topP) / (n - 1) can't be in the nucleus; dropping
+    // them first keeps the sort short
+    float cutoff = (1.0f - topP) / (vocabSize - 1);
+    int n = 0;
+    for (int i = 0; i < vocabSize; i++) {
+        if (probs[i] >= cutoff) {
+            probIndex[n].index = i;
+            probIndex[n].prob = probs[i];
+            n++;
+        }
+    }
+    std::sort(probIndex, probIndex + n,
+              [](const ProbIndex& a, const ProbIndex& b) { return a.prob > b.prob; });
+
+    // Smallest prefix whose mass exceeds topP
+    float cumulative = 0;
+    int last = n - 1;
+    for (int i = 0; i < n; i++) {
+        cumulative += probIndex[i].prob;
+        if (cumulative > topP) {
+            last = i;
+            break;
+        }
+    }
+
+    float r = coin * cumulative;
+    float cdf = 0;
+    for (int i = 0; i <= last; i++) {
+        cdf += probIndex[i].prob;
+        if (r < cdf) return probIndex[i].index;
+    }
+    return probIndex[last].index;
+}
+
+int Sampler::sample(float* logits) {
+    if (temperature <= 0 || !probIndex) return argmax(logits, vocabSize);
+
+    // Softmax at temperature
+    float maxVal = logits[0];
+    for (int i = 1; i < vocabSize; i++) {
+        if (logits[i] > maxVal) maxVal = logits[i];
+    }
+    float sum = 0;
+    for (int i = 0; i < vocabSize; i++) {
+        logits[i] = expf((logits[i] - maxVal) / temperature);
+        sum += logits[i];
+    }
+    for (int i = 0; i < vocabSize; i++) logits[i] /= sum;
+
+    float coin = randomFloat();
+    if (topP <= 0 || topP >= 1) return sampleMultinomial(logits, coin);
+    return sampleTopP(logits, coin);
+}
@@ -0,0 +1,48 @@
+#ifndef LLM_SAMPLER_H
+#define LLM_SAMPLER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+class ArenaPlan;
+
+// Picks the next token from the logits: greedy at temperature 0,
+// otherwise softmax with optional top-p (nucleus) truncation
+class Sampler {
+public:
+    Sampler();
+    ~Sampler();
+
+    // With `shared`, the top-p scratch is added to that plan (live in
+    // ARENA_OUTPUT) instead of allocated; sample() needs it bound
+    bool configure(int vocabSize, float temperature, float topP, uint64_t seed,
+                   ArenaPlan* shared = nullptr);
+    void release();
+
+    void setTemperature(float temperature);
+    void setTopP(float topP);
+
+    // May overwrite the logits
+    int sample(float* logits);
+
+    static int argmax(const float* values, int n);
+
+private:
+    struct ProbIndex {
+        float prob;
+        int index;
+    };
+
+    int vocabSize;
+    float temperature;
+    float topP;
+    uint64_t rngState;
+    ProbIndex* probIndex;               // Top-p scratch (vocabSize)
+    bool ownsScratch;                   // False when carved from a shared arena
+
+    float randomFloat();
+    int sampleMultinomial(const float* probs, float coin) const;
+    int sampleTopP(const float* probs, float coin);
+};
+
+#endif // LLM_SAMPLER_H
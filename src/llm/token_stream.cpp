@@ -0,0 +1,134 @@
+#include "token_stream.h"
+#include "platform.h"
+
+uint32_t TokenStream::nowMs() {
+    return (uint32_t)(llmMicros() / 1000);
+}
+
+TokenStream::TokenStream()
+    : id(0), written(0), state(STREAM_IDLE), cancelFlag(false), tokens(0),
+      firstVisibleMs(0), elapsedMs(0), startMs(0) {
+    for (auto& c : ring) c.store(0, std::memory_order_relaxed);
+}
+
+uint32_t TokenStream::begin(uint32_t streamId) {
+    // Reset before publishing the new id, so a reader that sees the id
+    // never sees the previous generation's byte count
+    written.store(0, std::memory_order_relaxed);
+    tokens.store(0, std::memory_order_relaxed);
+    firstVisibleMs.store(0, std::memory_order_relaxed);
+    elapsedMs.store(0, std::memory_order_relaxed);
+    cancelFlag.store(false, std::memory_order_relaxed);
+    startMs.store(nowMs(), std::memory_order_relaxed);
+
+    uint32_t next = streamId ? streamId : id.load(std::memory_order_relaxed) + 1;
+    if (next == 0) next = 1;            // 0 means "none" to cancel()
+    id.store(next, std::memory_order_release);
+    state.store(STREAM_RUNNING, std::memory_order_release);
+    return next;
+}
+
+void TokenStream::write(const char* text, size_t len) {
+    uint32_t w = written.load(std::memory_order_relaxed);
+    bool visible = false;
+    for (size_t i = 0; i < len; i++) {
+        char c = text[i];
+        ring[(w + i) % TOKEN_STREAM_BYTES].store(c, std::memory_order_relaxed);
+        if (c != ' ' && c != '\n' && c != '\t' && c != '\r') visible = true;
+    }
+    written.store(w + len, std::memory_order_release);
+    tokens.fetch_add(1, std::memory_order_relaxed);
+
+    if (visible && firstVisibleMs.load(std::memory_order_relaxed) == 0) {
+        uint32_t ms = nowMs() - startMs.load(std::memory_order_relaxed);
+        firstVisibleMs.store(ms > 0 ? ms : 1, std::memory_order_relaxed);
+    }
+}
+
+void TokenStream::finish() {
+    elapsedMs.store(nowMs() - startMs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    bool cancelled = cancelFlag.load(std::memory_order_relaxed);
+    state.store(cancelled ? STREAM_CANCELLED : STREAM_DONE, std::memory_order_release);
+}
+
+size_t TokenStream::read(StreamCursor& cursor, char* out, size_t outLen) const {
+    if (outLen == 0) return 0;
+    out[0] = '\0';
+
+    for (int attempt = 0; attempt < 4; attempt++) {
+        uint32_t current = id.load(std::memory_order_acquire);
+        if (cursor.id != current) {
+            cursor.id = current;
+            cursor.offset = 0;
+        }
+
+        uint32_t w = written.load(std::memory_order_acquire);
+        if (w < cursor.offset) cursor.offset = 0;   // Raced a begin()
+        if (w - cursor.offset > TOKEN_STREAM_BYTES) cursor.offset = w - TOKEN_STREAM_BYTES;
+
+        size_t n = w - cursor.offset;
+        if (n > outLen - 1) n = outLen - 1;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = ring[(cursor.offset + i) % TOKEN_STREAM_BYTES].load(std::memory_order_relaxed);
+        }
+        out[n] = '\0';
+
+        // Valid unless a new generation started or the writer lapped the
+        // bytes while they were copied
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint32_t after = written.load(std::memory_order_relaxed);
+        if (id.load(std::memory_order_relaxed) == current && after >= cursor.offset &&
+            after - cursor.offset <= TOKEN_STREAM_BYTES) {
+            cursor.offset += n;
+            return n;
+        }
+    }
+
+    out[0] = '\0';
+    return 0;
+}
+
+bool TokenStream::cancel(uint32_t streamId) {
+    if (state.load(std::memory_order_acquire) != STREAM_RUNNING) return false;
+    if (streamId != 0 && streamId != id.load(std::memory_order_acquire)) return false;
+    cancelFlag.store(true, std::memory_order_release);
+    return true;
+}
+
+const std::atomic<bool>* TokenStream::getCancelFlag() const {
+    return &cancelFlag;
+}
+
+uint32_t TokenStream::getId() const {
+    return id.load(std::memory_order_acquire);
+}
+
+TokenStreamState TokenStream::getState() const {
+    return (TokenStreamState)state.load(std::memory_order_acquire);
+}
+
+const char* TokenStream::getStateName(TokenStreamState s) {
+    switch (s) {
+        case STREAM_RUNNING: return "running";
+        case STREAM_DONE: return "done";
+        case STREAM_CANCELLED: return "cancelled";
+        default: return "idle";
+    }
+}
+
+uint32_t TokenStream::getWritten() const {
+    return written.load(std::memory_order_acquire);
+}
+
+int TokenStream::getTokens() const {
+    return tokens.load(std::memory_order_relaxed);
+}
+
+uint32_t TokenStream::getFirstVisibleMs() const {
+    return firstVisibleMs.load(std::memory_order_relaxed);
+}
+
+uint32_t TokenStream::getElapsedMs() const {
+    if (getState() == STREAM_RUNNING) return nowMs() - startMs.load(std::memory_order_relaxed);
+    return elapsedMs.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,77 @@
+#ifndef LLM_TOKEN_STREAM_H
+#define LLM_TOKEN_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Generated text kept for readers that fall behind. A reader more than
+// this far behind skips ahead (LLM_MAX_TOKENS tokens rarely exceed it).
+#define TOKEN_STREAM_BYTES 2048
+
+// Lifecycle of one generation
+enum TokenStreamState : uint8_t {
+    STREAM_IDLE,
+    STREAM_RUNNING,
+    STREAM_DONE,
+    STREAM_CANCELLED
+};
+
+// A reader's position: which generation, how many bytes consumed
+struct StreamCursor {
+    uint32_t id;
+    uint32_t offset;
+};
+
+// Single-writer ring of generated text. The inferring task writes each
+// token's text as it is sampled; the UI, web handlers and anything else
+// read from any task with their own StreamCursor, so a consumer sees text
+// while generation is still running. Nothing is allocated or locked:
+// readers that are overtaken by the writer skip to the oldest text still
+// in the ring.
+//
+// cancel() may be called from any task; the generation loop polls
+// getCancelFlag() before every forward pass.
+class TokenStream {
+public:
+    TokenStream();
+
+    // Writer side: exactly one generation at a time. begin() returns the
+    // new stream id: `id` (e.g. the inference job's), or the next one if 0.
+    uint32_t begin(uint32_t id = 0);
+    void write(const char* text, size_t len);
+    void finish();
+
+    // Reader side: any task. Copies text past the cursor (NUL-terminated,
+    // at most outLen - 1 bytes) and advances it. A cursor from an older
+    // generation restarts at the beginning of the current one.
+    size_t read(StreamCursor& cursor, char* out, size_t outLen) const;
+
+    // Stop generation `id` (0: whichever is running) after the current
+    // forward pass. False if it is not running.
+    bool cancel(uint32_t id = 0);
+    const std::atomic<bool>* getCancelFlag() const;
+
+    uint32_t getId() const;
+    TokenStreamState getState() const;
+    static const char* getStateName(TokenStreamState state);
+    uint32_t getWritten() const;        // Bytes of text so far
+    int getTokens() const;
+    uint32_t getFirstVisibleMs() const; // begin() to first non-blank text, 0 before
+    uint32_t getElapsedMs() const;      // begin() to finish() (or now)
+
+private:
+    std::atomic<char> ring[TOKEN_STREAM_BYTES];
+    std::atomic<uint32_t> id;
+    std::atomic<uint32_t> written;
+    std::atomic<uint8_t> state;
+    std::atomic<bool> cancelFlag;
+    std::atomic<int> tokens;
+    std::atomic<uint32_t> firstVisibleMs;
+    std::atomic<uint32_t> elapsedMs;
+    std::atomic<uint32_t> startMs;
+
+    static uint32_t nowMs();
+};
+
+#endif // LLM_TOKEN_STREAM_H
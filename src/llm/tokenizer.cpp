@@ -0,0 +1,323 @@
+#include "tokenizer.h"
+#include "platform.h"
+#include "arena_plan.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SYMBOL_CAPACITY (TOKENIZER_MAX_SYMBOLS + 2)  // + BOS and the dummy space
+#define HEAP_CAPACITY (3 * SYMBOL_CAPACITY)             // n - 1 initial pairs + 2 per merge
+
+// FNV-1a
+static uint32_t hashText(const char* text, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)text[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static uint32_t hashPair(int32_t left, int32_t right) {
+    uint64_t key = ((uint64_t)(uint32_t)left << 32) | (uint32_t)right;
+    key *= 0x9E3779B97F4A7C15ull;
+    return (uint32_t)(key >> 32);
+}
+
+// Power of two with room for `count` entries at <= 50% load
+static uint32_t tableSize(size_t count) {
+    uint32_t size = 16;
+    while (size < count * 2) size <<= 1;
+    return size;
+}
+
+Tokenizer::Tokenizer()
+    : pieceMask(0), mergeMask(0), maxPieceLen(0), spaceId(-1),
+      scratch(nullptr), symbols(nullptr), heap(nullptr) {}
+
+Tokenizer::~Tokenizer() {
+    unload();
+}
+
+bool Tokenizer::load(const void* data, size_t size, int vocabSize, ArenaPlan* shared) {
+    unload();
+
+    const uint8_t* p = (const uint8_t*)data;
+    const uint8_t* end = p + size;
+    if (!p || size < 4 || vocabSize <= 0) return false;
+
+    int32_t maxLen;
+    memcpy(&maxLen, p, 4);
+    p += 4;
+    if (maxLen <= 0 || maxLen > TOKENIZER_MAX_PIECE) return false;
+    maxPieceLen = maxLen;
+
+    pieces.resize(vocabSize);
+    for (int i = 0; i < vocabSize; i++) {
+        int32_t len;
+        if (end - p < 8) {
+            unload();
+            return false;
+        }
+        memcpy(&pieces[i].score, p, 4);
+        memcpy(&len, p + 4, 4);
+        p += 8;
+        if (len < 0 || len > maxLen || end - p < len) {
+            unload();
+            return false;
+        }
+        pieces[i].text = (const char*)p;
+        pieces[i].len = len;
+        p += len;
+    }
+
+    // Text index; the lowest id wins for duplicate texts
+    uint32_t slots = tableSize(vocabSize);
+    pieceIndex.assign(slots, -1);
+    pieceMask = slots - 1;
+    for (int i = 0; i < vocabSize; i++) {
+        if (lookup(pieces[i].text, pieces[i].len) >= 0) continue;
+        uint32_t at = hashText(pieces[i].text, pieces[i].len) & pieceMask;
+        while (pieceIndex[at] >= 0) at = (at + 1) & pieceMask;
+        pieceIndex[at] = i;
+    }
+    spaceId = lookup(" ", 1);
+
+    buildMergeIndex();
+
+    size_t symbolBytes = SYMBOL_CAPACITY * sizeof(Symbol);
+    if (shared) {
+        if (!shared->add("symbols", (void**)&symbols, symbolBytes, ARENA_ENCODE) ||
+            !shared->add("mergeHeap", (void**)&heap, HEAP_CAPACITY * sizeof(Candidate),
+                         ARENA_ENCODE)) {
+            unload();
+            return false;
+        }
+        return true;
+    }
+    scratch = (uint8_t*)llmAlloc(symbolBytes + HEAP_CAPACITY * sizeof(Candidate));
+    if (!scratch) {
+        unload();
+        return false;
+    }
+    symbols = (Symbol*)scratch;
+    heap = (Candidate*)(scratch + symbolBytes);
+
+    return true;
+}
+
+// Every way a piece splits into two pieces is a merge producing it, as
+// the reference loop would find by looking up the concatenation
+void Tokenizer::buildMergeIndex() {
+    std::vector<Merge> found;
+    for (int id = 0; id < (int)pieces.size(); id++) {
+        const Piece& piece = pieces[id];
+        if (piece.score <= TOKENIZER_NO_MERGE || lookup(piece.text, piece.len) != id) continue;
+        for (uint32_t split = 1; split < piece.len; split++) {
+            int left = lookup(piece.text, split);
+            if (left < 0) continue;
+            int right = lookup(piece.text + split, piece.len - split);
+            if (right < 0) continue;
+            Merge m = {left, right, id};
+            found.push_back(m);
+        }
+    }
+
+    uint32_t slots = tableSize(found.size());
+    Merge empty = {-1, -1, -1};
+    mergeIndex.assign(slots, empty);
+    mergeMask = slots - 1;
+    for (const Merge& m : found) {
+        uint32_t at = hashPair(m.left, m.right) & mergeMask;
+        while (mergeIndex[at].left >= 0) at = (at + 1) & mergeMask;
+        mergeIndex[at] = m;
+    }
+}
+
+void Tokenizer::unload() {
+    std::vector<Piece>().swap(pieces);
+    std::vector<int32_t>().swap(pieceIndex);
+    std::vector<Merge>().swap(mergeIndex);
+    pieceMask = mergeMask = 0;
+    maxPieceLen = 0;
+    spaceId = -1;
+    if (scratch) llmFree(scratch);
+    scratch = nullptr;
+    symbols = nullptr;
+    heap = nullptr;
+}
+
+bool Tokenizer::isLoaded() const {
+    return !pieces.empty();
+}
+
+int Tokenizer::getVocabSize() const {
+    return pieces.size();
+}
+
+size_t Tokenizer::getIndexSize() const {
+    size_t bytes = pieceIndex.size() * sizeof(int32_t) + mergeIndex.size() * sizeof(Merge);
+    if (scratch) bytes += SYMBOL_CAPACITY * sizeof(Symbol) + HEAP_CAPACITY * sizeof(Candidate);
+    return bytes;
+}
+
+int Tokenizer::lookup(const char* text, size_t len) const {
+    if (pieceIndex.empty()) return -1;
+    uint32_t at = hashText(text, len) & pieceMask;
+    for (int32_t id; (id = pieceIndex[at]) >= 0; at = (at + 1) & pieceMask) {
+        const Piece& piece = pieces[id];
+        if (piece.len == len && memcmp(piece.text, text, len) == 0) return id;
+    }
+    return -1;
+}
+
+int Tokenizer::findMerge(int left, int right) const {
+    uint32_t at = hashPair(left, right) & mergeMask;
+    for (; mergeIndex[at].left >= 0; at = (at + 1) & mergeMask) {
+        const Merge& m = mergeIndex[at];
+        if (m.left == left && m.right == right) return m.merged;
+    }
+    return -1;
+}
+
+const char* Tokenizer::getPiece(int token, size_t* len) const {
+    if (token < 0 || token >= (int)pieces.size()) {
+        *len = 0;
+        return "";
+    }
+    *len = pieces[token].len;
+    return pieces[token].text;
+}
+
+float Tokenizer::getScore(int token) const {
+    return token >= 0 && token < (int)pieces.size() ? pieces[token].score : 0;
+}
+
+// Higher score first; the leftmost pair on ties, as the reference scan
+static inline bool before(const float aScore, int aPos, const float bScore, int bPos) {
+    return aScore > bScore || (aScore == bScore && aPos < bPos);
+}
+
+// Queue the pair starting at symbol `pos` if it merges
+void Tokenizer::pushCandidate(int& heapSize, int pos) const {
+    int next = symbols[pos].next;
+    if (next < 0) return;
+    int merged = findMerge(symbols[pos].id, symbols[next].id);
+    if (merged < 0) return;
+
+    Candidate c = {pieces[merged].score, pos, symbols[pos].id, symbols[next].id};
+    int i = heapSize++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!before(c.score, c.pos, heap[parent].score, heap[parent].pos)) break;
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = c;
+}
+
+int Tokenizer::encode(const char* text, bool bos, bool eos, int* tokens, int capacity) const {
+    if (pieces.empty() || !symbols || capacity <= 0) return 0;
+
+    // Symbols: BOS, SentencePiece's dummy space in front of non-empty
+    // text, then one per UTF-8 codepoint, or per byte (+3, after <unk>
+    // <s> </s>) for codepoints not in the vocabulary
+    int n = 0;
+    if (bos) symbols[n++].id = TOKEN_BOS;
+    if (text[0] != '\0' && spaceId >= 0) symbols[n++].id = spaceId;
+
+    for (const char* c = text; *c && n < SYMBOL_CAPACITY; ) {
+        size_t len = 1;
+        while (len < 4 && (c[len] & 0xC0) == 0x80) len++;
+
+        int id = lookup(c, len);
+        if (id >= 0) {
+            symbols[n++].id = id;
+        } else {
+            for (size_t i = 0; i < len && n < SYMBOL_CAPACITY; i++) {
+                symbols[n++].id = (uint8_t)c[i] + 3;
+            }
+        }
+        c += len;
+    }
+
+    for (int i = 0; i < n; i++) {
+        symbols[i].prev = i - 1;
+        symbols[i].next = i + 1 < n ? i + 1 : -1;
+    }
+
+    int heapSize = 0;
+    for (int i = 0; i + 1 < n; i++) pushCandidate(heapSize, i);
+
+    // Merge the best pair until none is left. Entries whose symbols
+    // changed since they were queued are stale and skipped (a symbol's
+    // id only ever grows into a longer piece, so the ids identify it).
+    while (heapSize > 0) {
+        Candidate top = heap[0];
+        Candidate last = heap[--heapSize];
+        int i = 0;
+        while (true) {
+            int child = 2 * i + 1;
+            if (child >= heapSize) break;
+            if (child + 1 < heapSize &&
+                before(heap[child + 1].score, heap[child + 1].pos, heap[child].score, heap[child].pos)) {
+                child++;
+            }
+            if (!before(heap[child].score, heap[child].pos, last.score, last.pos)) break;
+            heap[i] = heap[child];
+            i = child;
+        }
+        if (heapSize > 0) heap[i] = last;
+
+        Symbol& left = symbols[top.pos];
+        if (left.id != top.left || left.next < 0) continue;
+        Symbol& right = symbols[left.next];
+        if (right.id != top.right) continue;
+
+        left.id = findMerge(top.left, top.right);
+        left.next = right.next;
+        if (right.next >= 0) symbols[right.next].prev = top.pos;
+        right.id = -1;
+
+        if (left.prev >= 0) pushCandidate(heapSize, left.prev);
+        pushCandidate(heapSize, top.pos);
+    }
+
+    int limit = eos ? capacity - 1 : capacity;
+    int count = 0;
+    for (int i = n > 0 ? 0 : -1; i >= 0 && count < limit; i = symbols[i].next) {
+        tokens[count++] = symbols[i].id;
+    }
+    if (eos) tokens[count++] = TOKEN_EOS;
+    return count;
+}
+
+size_t Tokenizer::decode(int prev, int token, char* out, size_t outLen) const {
+    if (outLen == 0) return 0;
+    out[0] = '\0';
+    if (token < 0 || token >= (int)pieces.size()) return 0;
+
+    const Piece& piece = pieces[token];
+    const char* text = piece.text;
+    size_t len = piece.len;
+
+    if (prev == TOKEN_BOS && len > 0 && text[0] == ' ') {
+        text++;
+        len--;
+    }
+
+    // Raw byte tokens look like <0x0A>
+    unsigned int byte;
+    if (len == 6 && text[0] == '<' && text[1] == '0' && text[2] == 'x' && text[5] == '>') {
+        char hex[3] = {text[3], text[4], 0};
+        if (sscanf(hex, "%02x", &byte) == 1) {
+            out[0] = (char)byte;
+            out[outLen > 1 ? 1 : 0] = '\0';
+            return outLen > 1 ? 1 : 0;
+        }
+    }
+
+    if (len >= outLen) len = outLen - 1;
+    memcpy(out, text, len);
+    out[len] = '\0';
+    return len;
+}
@@ -0,0 +1,114 @@
+#ifndef LLM_TOKENIZER_H
+#define LLM_TOKENIZER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+class ArenaPlan;
+
+// Special tokens of Llama-family vocabularies
+#define TOKEN_BOS 1
+#define TOKEN_EOS 2
+
+// Longest vocabulary entry accepted (llama2.c vocabularies use < 64)
+#define TOKENIZER_MAX_PIECE 128
+
+// Most symbols (codepoints, or bytes without a piece) one encode() call
+// merges; text beyond is cut off. Covers any engine prompt with room to
+// spare (an analysis prompt carries at most PROMPT_DIGEST_MAX characters
+// of page digest).
+#define TOKENIZER_MAX_SYMBOLS 3072
+
+// Merges scoring at or below this never happen (SentencePiece convention)
+#define TOKENIZER_NO_MERGE -1e10f
+
+// SentencePiece-style BPE tokenizer over a llama2.c tokenizer.bin:
+// int32 max_token_length, then per token: float score, int32 length,
+// bytes. Piece text is read in place from the file buffer (flash or
+// PSRAM); load() builds two hash indexes next to it: piece text -> id,
+// and (left id, right id) -> merged id for every piece that splits into
+// two pieces.
+//
+// encode() merges with a priority queue over a linked list of symbols,
+// O(n log n), in scratch sized at load, so it never allocates. It picks
+// the same merges as the reference quadratic loop (best score first,
+// leftmost on ties).
+class Tokenizer {
+public:
+    Tokenizer();
+    ~Tokenizer();
+
+    // The buffer must outlive the tokenizer. With `shared`, the encode
+    // scratch is added to that plan (live in ARENA_ENCODE only) instead
+    // of allocated; encode() works once the caller binds it.
+    bool load(const void* data, size_t size, int vocabSize, ArenaPlan* shared = nullptr);
+    void unload();
+
+    bool isLoaded() const;
+    int getVocabSize() const;
+    size_t getIndexSize() const;        // Hash indexes + private encode scratch, bytes
+
+    // Encode text, optionally wrapped in BOS/EOS. Tokens beyond
+    // `capacity` are cut off. Returns the token count. Not reentrant
+    // (shares the scratch).
+    int encode(const char* text, bool bos, bool eos, int* tokens, int capacity) const;
+
+    // Text of `token` when it follows `prev` (the leading space after BOS
+    // is dropped, <0xXX> byte tokens become raw bytes). Writes a
+    // NUL-terminated string and returns its length.
+    size_t decode(int prev, int token, char* out, size_t outLen) const;
+
+    // Id of the piece with exactly this text, -1 if none
+    int lookup(const char* text, size_t len) const;
+
+    // Piece text and score, for reference implementations and tools
+    const char* getPiece(int token, size_t* len) const;
+    float getScore(int token) const;
+
+private:
+    struct Piece {
+        const char* text;               // Not NUL-terminated
+        uint32_t len;
+        float score;
+    };
+
+    struct Merge {
+        int32_t left;                   // -1: empty slot
+        int32_t right;
+        int32_t merged;
+    };
+
+    // encode() scratch: symbols in a linked list, candidate pairs in a
+    // binary heap (stale entries are skipped when popped)
+    struct Symbol {
+        int32_t id;
+        int32_t prev;
+        int32_t next;
+    };
+
+    struct Candidate {
+        float score;
+        int32_t pos;                    // Left symbol
+        int32_t left;
+        int32_t right;
+    };
+
+    std::vector<Piece> pieces;
+    std::vector<int32_t> pieceIndex;    // Open addressing by text hash, -1 empty
+    std::vector<Merge> mergeIndex;      // Open addressing by pair hash
+    uint32_t pieceMask;
+    uint32_t mergeMask;
+    int maxPieceLen;
+    int spaceId;
+
+    uint8_t* scratch;                   // Owned, nullptr when in a shared arena
+    Symbol* symbols;
+    Candidate* heap;
+
+    void buildMergeIndex();
+    int findMerge(int left, int right) const;
+    void pushCandidate(int& heapSize, int pos) const;
+};
+
+#endif // LLM_TOKENIZER_H
@@ -0,0 +1,529 @@
+#include "transformer.h"
+#include "platform.h"
+#include "model_file.h"
+#include "arena_plan.h"
+#include "kernels.h"
+#include "worker_pool.h"
+#include <math.h>
+#include <string.h>
+
+// Sequential reader over the checkpoint's tensor area
+struct CheckpointReader {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool ok;
+
+    const uint8_t* take(size_t bytes) {
+        if (!ok || (size_t)(end - p) < bytes) {
+            ok = false;
+            return nullptr;
+        }
+        const uint8_t* at = p;
+        p += bytes;
+        return at;
+    }
+
+    const float* floats(size_t count) {
+        const uint8_t* at = take(count * sizeof(float));
+        if (at && ((uintptr_t)at & (sizeof(float) - 1))) ok = false;  // Xtensa faults on these
+        return (const float*)at;
+    }
+
+    QTensor qtensor(size_t count, int groupSize) {
+        QTensor t;
+        t.q = (const int8_t*)take(count);
+        t.s = floats(count / groupSize);
+        return t;
+    }
+};
+
+Transformer::Transformer()
+    : error(nullptr), pool(nullptr), rmsAtt(nullptr), rmsFfn(nullptr), rmsFinal(nullptr),
+      arena(nullptr), arenaSize(0), kvCacheSize(0), x(nullptr), tokenBuffer(nullptr) {
+    memset(&config, 0, sizeof(config));
+    tokenEmbedding.q = nullptr;
+    tokenEmbedding.s = nullptr;
+    classifier = tokenEmbedding;
+}
+
+Transformer::~Transformer() {
+    unload();
+}
+
+bool Transformer::fail(const char* message) {
+    unload();
+    error = message;
+    return false;
+}
+
+bool Transformer::load(const void* data, size_t size, int maxSeqLen, ArenaPlan* shared) {
+    unload();
+    error = nullptr;
+
+    const uint8_t* base = (const uint8_t*)data;
+    uint32_t magic = 0;
+    if (base && size >= 4) memcpy(&magic, base, 4);
+
+    bool ok;
+    if (magic == MODEL_FILE_MAGIC) {
+        ok = loadModelFile(base, size);
+    } else if (magic == CHECKPOINT_MAGIC) {
+        ok = loadCheckpoint(base, size);
+    } else {
+        ok = fail("unknown model format (bad magic)");
+    }
+    if (!ok) return false;
+
+    if (maxSeqLen > 0 && maxSeqLen < config.seqLen) config.seqLen = maxSeqLen;
+    if (shared) return planArena(*shared) || fail("arena plan full");
+
+    ArenaPlan own;
+    if (!planArena(own)) return fail("arena plan full");
+    arenaSize = own.plan();
+    arena = (uint8_t*)llmAlloc(arenaSize);
+    if (!arena) return fail("out of memory for activations");
+    memset(arena, 0, arenaSize);
+    own.bind(arena);
+
+    return true;
+}
+
+bool Transformer::checkConfig() {
+    const TransformerConfig& p = config;
+    if (p.dim <= 0 || p.hiddenDim <= 0 || p.nLayers <= 0 || p.nHeads <= 0 ||
+        p.nKvHeads <= 0 || p.vocabSize <= 0 || p.seqLen <= 0 || p.groupSize <= 0) {
+        return fail("bad hyperparameters");
+    }
+    if (p.dim % p.nHeads != 0 || p.nHeads % p.nKvHeads != 0 || (p.dim / p.nHeads) % 2 != 0) {
+        return fail("bad head layout");
+    }
+    if (p.dim % p.groupSize != 0 || p.hiddenDim % p.groupSize != 0) {
+        return fail("group size does not divide the model width");
+    }
+    return true;
+}
+
+bool Transformer::loadCheckpoint(const uint8_t* base, size_t size) {
+    if (size < CHECKPOINT_HEADER_SIZE) return fail("checkpoint too small");
+
+    int32_t version;
+    memcpy(&version, base + 4, 4);
+    if (version != CHECKPOINT_VERSION_Q8) return fail("unsupported checkpoint version");
+
+    // Header fields are packed, so copy them out
+    int32_t dims[7];
+    memcpy(dims, base + 8, sizeof(dims));
+    config.dim = dims[0];
+    config.hiddenDim = dims[1];
+    config.nLayers = dims[2];
+    config.nHeads = dims[3];
+    config.nKvHeads = dims[4];
+    config.vocabSize = dims[5];
+    config.seqLen = dims[6];
+    config.sharedClassifier = base[36] != 0;
+    memcpy(&config.groupSize, base + 37, 4);
+    if (!checkConfig()) return false;
+
+    const TransformerConfig& p = config;
+    size_t dim = p.dim;
+    size_t hidden = p.hiddenDim;
+    size_t kvDim = dim * p.nKvHeads / p.nHeads;
+    size_t layers = p.nLayers;
+    int gs = p.groupSize;
+
+    CheckpointReader r = {base + CHECKPOINT_HEADER_SIZE, base + size, true};
+    rmsAtt = r.floats(layers * dim);
+    rmsFfn = r.floats(layers * dim);
+    rmsFinal = r.floats(dim);
+    tokenEmbedding = r.qtensor((size_t)p.vocabSize * dim, gs);
+
+    std::vector<QTensor>* tensors[] = {&wq, &wk, &wv, &wo, &w1, &w2, &w3};
+    size_t counts[] = {dim * dim, dim * kvDim, dim * kvDim, dim * dim,
+                       dim * hidden, hidden * dim, dim * hidden};
+    for (int t = 0; t < 7; t++) {
+        tensors[t]->resize(layers);
+        for (size_t l = 0; l < layers; l++) {
+            (*tensors[t])[l] = r.qtensor(counts[t], gs);
+        }
+    }
+
+    classifier = p.sharedClassifier ? tokenEmbedding : r.qtensor((size_t)p.vocabSize * dim, gs);
+
+    if (!r.ok) return fail("checkpoint truncated or misaligned");
+    return true;
+}
+
+bool Transformer::loadModelFile(const uint8_t* base, size_t size) {
+    if (size < sizeof(ModelFileHeader)) return fail("model file too small");
+
+    ModelFileHeader h;
+    memcpy(&h, base, sizeof(h));
+    if (h.version < 1 || h.version > MODEL_FILE_VERSION) return fail("unsupported model file version");
+    if (h.fileSize > size) return fail("model file truncated");
+    size_t entrySize = h.version == 1 ? sizeof(ModelTensorEntryV1) : sizeof(ModelTensorEntry);
+    if (h.tensorCount > MODEL_FILE_MAX_TENSORS || h.tableOffset % 4 != 0 ||
+        h.tableOffset + (uint64_t)h.tensorCount * entrySize > size) {
+        return fail("bad tensor table");
+    }
+    if (h.version >= 2) {
+        ModelFileInfo info;
+        if (size < sizeof(h) + sizeof(info)) return fail("model file too small");
+        memcpy(&info, base + sizeof(h), sizeof(info));
+        if (info.quantBits != 8 || info.quantScheme != MODEL_QUANT_SYMMETRIC) {
+            return fail("unsupported quantization");
+        }
+        if (info.ropeTheta != TRANSFORMER_ROPE_THETA || info.normEps != TRANSFORMER_NORM_EPS) {
+            return fail("model needs another RoPE base or norm epsilon");
+        }
+    }
+
+    config.dim = h.dim;
+    config.hiddenDim = h.hiddenDim;
+    config.nLayers = h.nLayers;
+    config.nHeads = h.nHeads;
+    config.nKvHeads = h.nKvHeads;
+    config.vocabSize = h.vocabSize;
+    config.seqLen = h.seqLen;
+    config.groupSize = h.groupSize;
+    config.sharedClassifier = (h.flags & MODEL_FLAG_SHARED_CLASSIFIER) != 0;
+    if (!checkConfig()) return false;
+
+    const TransformerConfig& p = config;
+    size_t dim = p.dim;
+    size_t hidden = p.hiddenDim;
+    size_t kvDim = dim * p.nKvHeads / p.nHeads;
+    size_t layers = p.nLayers;
+    size_t vocab = p.vocabSize;
+
+    // Expected element count of each kind; per-layer kinds are looked up
+    // once per layer
+    size_t counts[] = {layers * dim, layers * dim, dim, vocab * dim,
+                       dim * dim, dim * kvDim, dim * kvDim, dim * dim,
+                       dim * hidden, hidden * dim, dim * hidden, vocab * dim};
+
+    std::vector<QTensor>* perLayer[] = {&wq, &wk, &wv, &wo, &w1, &w2, &w3};
+    for (auto* t : perLayer) {
+        t->resize(layers);
+        for (auto& w : *t) w.q = nullptr, w.s = nullptr;
+    }
+
+    ModelTensorEntry e;
+    for (uint32_t i = 0; ModelFile::getEntry(base, size, i, e); i++) {
+        if (e.kind > TENSOR_CLASSIFIER) continue;  // Vocab, and newer kinds
+
+        bool quantized = e.type == TENSOR_Q8;
+        size_t count = counts[e.kind];
+        size_t expected = quantized ? count : count * sizeof(float);
+        bool scales = e.type == TENSOR_F32 && e.kind > TENSOR_RMS_FINAL;
+        if (scales) expected = count / p.groupSize * sizeof(float);
+        if (e.offset % MODEL_FILE_ALIGN != 0 || (uint64_t)e.offset + e.bytes > size ||
+            e.bytes != expected || e.type > TENSOR_Q8) {
+            return fail("bad tensor entry");
+        }
+
+        // Version 2 entries state shape and group; they must agree
+        if (h.version >= 2) {
+            size_t elements = (size_t)e.rows * e.cols;
+            bool grouped = quantized || scales;
+            if (elements != (scales ? count / p.groupSize : count) ||
+                e.groupSize != (grouped ? p.groupSize : 0)) {
+                return fail("tensor shape does not match the header");
+            }
+        }
+
+        const uint8_t* at = base + e.offset;
+        if (e.kind <= TENSOR_RMS_FINAL) {
+            if (quantized) return fail("norm weights must be fp32");
+            const float** norms[] = {&rmsAtt, &rmsFfn, &rmsFinal};
+            *norms[e.kind] = (const float*)at;
+            continue;
+        }
+
+        QTensor* t;
+        if (e.kind == TENSOR_TOKEN_EMBEDDING) {
+            t = &tokenEmbedding;
+        } else if (e.kind == TENSOR_CLASSIFIER) {
+            t = &classifier;
+        } else {
+            if (e.layer >= layers) return fail("bad tensor layer");
+            t = &(*perLayer[e.kind - TENSOR_WQ])[e.layer];
+        }
+        if (quantized) t->q = (const int8_t*)at;
+        else t->s = (const float*)at;
+    }
+
+    if (p.sharedClassifier) classifier = tokenEmbedding;
+
+    bool complete = rmsAtt && rmsFfn && rmsFinal && tokenEmbedding.q && tokenEmbedding.s &&
+                    classifier.q && classifier.s;
+    for (auto* t : perLayer) {
+        for (const auto& w : *t) complete = complete && w.q && w.s;
+    }
+    if (!complete) return fail("model file is missing tensors");
+
+    return true;
+}
+
+// Lifetimes follow forward(): x and the quantized input carry across
+// blocks, the rest is local to attention, the feed-forward block or the
+// output head
+bool Transformer::planArena(ArenaPlan& plan) {
+    const TransformerConfig& p = config;
+    size_t dim = p.dim;
+    size_t hidden = p.hiddenDim;
+    size_t kvDim = dim * p.nKvHeads / p.nHeads;
+    size_t kv = (size_t)p.nLayers * p.seqLen * kvDim * sizeof(float);
+    const uint8_t layer = ARENA_ATTENTION | ARENA_FFN;
+
+    struct Slot {
+        const char* name;
+        void** ptr;
+        size_t bytes;
+        uint8_t phases;
+    } slots[] = {
+        {"x", (void**)&x, dim * sizeof(float), layer | ARENA_OUTPUT},
+        {"xb", (void**)&xb, dim * sizeof(float), layer},
+        {"xb2", (void**)&xb2, dim * sizeof(float), ARENA_ATTENTION},
+        {"hb", (void**)&hb, hidden * sizeof(float), ARENA_FFN},
+        {"hb2", (void**)&hb2, hidden * sizeof(float), ARENA_FFN},
+        {"q", (void**)&q, dim * sizeof(float), ARENA_ATTENTION},
+        {"att", (void**)&att, (size_t)p.nHeads * p.seqLen * sizeof(float), ARENA_ATTENTION},
+        {"logits", (void**)&logits, (size_t)p.vocabSize * sizeof(float), ARENA_OUTPUT},
+        {"xq.q", (void**)&xq.q, dim, layer | ARENA_OUTPUT},
+        {"xq.s", (void**)&xq.s, dim / p.groupSize * sizeof(float), layer | ARENA_OUTPUT},
+        {"hq.q", (void**)&hq.q, hidden, ARENA_FFN},
+        {"hq.s", (void**)&hq.s, hidden / p.groupSize * sizeof(float), ARENA_FFN},
+        {"tokens", (void**)&tokenBuffer, (size_t)p.seqLen * sizeof(int), ARENA_ALWAYS},
+        {"keyCache", (void**)&keyCache, kv, ARENA_ALWAYS},
+        {"valueCache", (void**)&valueCache, kv, ARENA_ALWAYS},
+    };
+
+    for (const auto& slot : slots) {
+        if (!plan.add(slot.name, slot.ptr, slot.bytes, slot.phases)) return false;
+    }
+    kvCacheSize = 2 * kv;
+    return true;
+}
+
+void Transformer::unload() {
+    if (arena) llmFree(arena);
+    arena = nullptr;
+    arenaSize = 0;
+    x = nullptr;
+    tokenBuffer = nullptr;
+    kvCacheSize = 0;
+
+    std::vector<QTensor>* tensors[] = {&wq, &wk, &wv, &wo, &w1, &w2, &w3};
+    for (auto* t : tensors) std::vector<QTensor>().swap(*t);
+
+    rmsAtt = rmsFfn = rmsFinal = nullptr;
+    tokenEmbedding.q = nullptr;
+    tokenEmbedding.s = nullptr;
+    classifier = tokenEmbedding;
+}
+
+bool Transformer::isLoaded() const {
+    return x != nullptr;
+}
+
+const TransformerConfig& Transformer::getConfig() const {
+    return config;
+}
+
+void Transformer::setPool(WorkerPool* workers) {
+    pool = workers;
+}
+
+const char* Transformer::getError() const {
+    return error ? error : "";
+}
+
+int* Transformer::getTokenBuffer() {
+    return x ? tokenBuffer : nullptr;
+}
+
+size_t Transformer::getArenaSize() const {
+    return arenaSize;
+}
+
+size_t Transformer::getKvCacheSize() const {
+    return kvCacheSize;
+}
+
+size_t Transformer::getKvSnapshotSize(int positions) const {
+    size_t kvDim = (size_t)config.dim * config.nKvHeads / config.nHeads;
+    return 2 * (size_t)config.nLayers * positions * kvDim * sizeof(float);
+}
+
+// Snapshot layout: every layer's keys, then every layer's values
+bool Transformer::saveKv(void* out, int positions) const {
+    if (!x || positions < 0 || positions > config.seqLen) return false;
+
+    size_t kvDim = (size_t)config.dim * config.nKvHeads / config.nHeads;
+    size_t layerStride = (size_t)config.seqLen * kvDim;
+    size_t bytes = positions * kvDim * sizeof(float);
+    const float* caches[] = {keyCache, valueCache};
+    uint8_t* at = (uint8_t*)out;
+    for (const float* cache : caches) {
+        for (int l = 0; l < config.nLayers; l++) {
+            memcpy(at, cache + l * layerStride, bytes);
+            at += bytes;
+        }
+    }
+    return true;
+}
+
+bool Transformer::restoreKv(const void* in, int saved, int positions) {
+    if (!x || positions < 0 || positions > saved || saved > config.seqLen) return false;
+
+    size_t kvDim = (size_t)config.dim * config.nKvHeads / config.nHeads;
+    size_t layerStride = (size_t)config.seqLen * kvDim;
+    size_t savedBytes = saved * kvDim * sizeof(float);
+    size_t bytes = positions * kvDim * sizeof(float);
+    float* caches[] = {keyCache, valueCache};
+    const uint8_t* at = (const uint8_t*)in;
+    for (float* cache : caches) {
+        for (int l = 0; l < config.nLayers; l++) {
+            memcpy(cache + l * layerStride, at, bytes);
+            at += savedBytes;
+        }
+    }
+    return true;
+}
+
+void Transformer::quantize(QBuffer& out, const float* in, int n) const {
+    Kernels::quantizeQ8(out.q, out.s, in, n, config.groupSize);
+}
+
+// out (d) = W (d, n) @ in (n)
+void Transformer::matmul(float* out, const QBuffer& in, const QTensor& w, int n, int d) const {
+    if (pool) {
+        pool->matvecQ8(Kernels::active(), out, in.q, in.s, w.q, w.s, n, d, config.groupSize);
+    } else {
+        Kernels::active().matvecQ8(out, in.q, in.s, w.q, w.s, n, d, config.groupSize);
+    }
+}
+
+void Transformer::embed(float* out, int token) const {
+    int dim = config.dim;
+    int gs = config.groupSize;
+    const int8_t* row = tokenEmbedding.q + (size_t)token * dim;
+    const float* scale = tokenEmbedding.s + (size_t)token * dim / gs;
+    for (int i = 0; i < dim; i++) {
+        out[i] = row[i] * scale[i / gs];
+    }
+}
+
+void Transformer::rmsnorm(float* out, const float* in, const float* weight, int n) {
+    float ss = 0;
+    for (int i = 0; i < n; i++) ss += in[i] * in[i];
+    ss = 1.0f / sqrtf(ss / n + TRANSFORMER_NORM_EPS);
+    for (int i = 0; i < n; i++) out[i] = weight[i] * (ss * in[i]);
+}
+
+void Transformer::softmax(float* v, int n) {
+    float maxVal = v[0];
+    for (int i = 1; i < n; i++) {
+        if (v[i] > maxVal) maxVal = v[i];
+    }
+    float sum = 0;
+    for (int i = 0; i < n; i++) {
+        v[i] = expf(v[i] - maxVal);
+        sum += v[i];
+    }
+    for (int i = 0; i < n; i++) v[i] /= sum;
+}
+
+float* Transformer::forward(int token, int pos) {
+    const TransformerConfig& p = config;
+    if (!x || token < 0 || token >= p.vocabSize || pos < 0 || pos >= p.seqLen) {
+        return nullptr;
+    }
+
+    int dim = p.dim;
+    int hidden = p.hiddenDim;
+    int kvDim = dim * p.nKvHeads / p.nHeads;
+    int kvMul = p.nHeads / p.nKvHeads;
+    int headSize = dim / p.nHeads;
+    float attScale = 1.0f / sqrtf((float)headSize);
+
+    embed(x, token);
+
+    for (int l = 0; l < p.nLayers; l++) {
+        // Attention: this position's key and value go straight into the cache
+        rmsnorm(xb, x, rmsAtt + (size_t)l * dim, dim);
+
+        size_t layerOffset = (size_t)l * p.seqLen * kvDim;
+        float* k = keyCache + layerOffset + (size_t)pos * kvDim;
+        float* v = valueCache + layerOffset + (size_t)pos * kvDim;
+
+        quantize(xq, xb, dim);
+        matmul(q, xq, wq[l], dim, dim);
+        matmul(k, xq, wk[l], dim, kvDim);
+        matmul(v, xq, wv[l], dim, kvDim);
+
+        // RoPE: rotate each (even, odd) pair of q and k by a position angle
+        for (int i = 0; i < dim; i += 2) {
+            int headDim = i % headSize;
+            float freq = 1.0f / powf(TRANSFORMER_ROPE_THETA, headDim / (float)headSize);
+            float angle = pos * freq;
+            float fcr = cosf(angle);
+            float fci = sinf(angle);
+            int rotations = i < kvDim ? 2 : 1;
+            for (int r = 0; r < rotations; r++) {
+                float* vec = r == 0 ? q : k;
+                float v0 = vec[i];
+                float v1 = vec[i + 1];
+                vec[i] = v0 * fcr - v1 * fci;
+                vec[i + 1] = v0 * fci + v1 * fcr;
+            }
+        }
+
+        for (int h = 0; h < p.nHeads; h++) {
+            const float* qh = q + h * headSize;
+            float* scores = att + (size_t)h * p.seqLen;
+            size_t headOffset = layerOffset + (size_t)(h / kvMul) * headSize;
+
+            for (int t = 0; t <= pos; t++) {
+                const float* kt = keyCache + headOffset + (size_t)t * kvDim;
+                float score = 0;
+                for (int i = 0; i < headSize; i++) score += qh[i] * kt[i];
+                scores[t] = score * attScale;
+            }
+            softmax(scores, pos + 1);
+
+            float* out = xb + h * headSize;
+            memset(out, 0, headSize * sizeof(float));
+            for (int t = 0; t <= pos; t++) {
+                const float* vt = valueCache + headOffset + (size_t)t * kvDim;
+                float a = scores[t];
+                for (int i = 0; i < headSize; i++) out[i] += a * vt[i];
+            }
+        }
+
+        quantize(xq, xb, dim);
+        matmul(xb2, xq, wo[l], dim, dim);
+        for (int i = 0; i < dim; i++) x[i] += xb2[i];
+
+        // Feed-forward: w2(silu(w1 x) * w3 x)
+        rmsnorm(xb, x, rmsFfn + (size_t)l * dim, dim);
+        quantize(xq, xb, dim);
+        matmul(hb, xq, w1[l], dim, hidden);
+        matmul(hb2, xq, w3[l], dim, hidden);
+
+        for (int i = 0; i < hidden; i++) {
+            float val = hb[i];
+            val *= 1.0f / (1.0f + expf(-val));
+            hb[i] = val * hb2[i];
+        }
+
+        quantize(hq, hb, hidden);
+        matmul(xb, hq, w2[l], hidden, dim);
+        for (int i = 0; i < dim; i++) x[i] += xb[i];
+    }
+
+    rmsnorm(x, x, rmsFinal, dim);
+    quantize(xq, x, dim);
+    matmul(logits, xq, classifier, dim, p.vocabSize);
+    return logits;
+}
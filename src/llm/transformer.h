@@ -0,0 +1,141 @@
+#ifndef LLM_TRANSFORMER_H
+#define LLM_TRANSFORMER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+class WorkerPool;
+class ArenaPlan;
+
+// llama2.c int8 checkpoint ("ak42", version 2): 256-byte header, fp32
+// norm weights, then group-quantized int8 tensors (values then scales)
+#define CHECKPOINT_MAGIC 0x616b3432
+#define CHECKPOINT_VERSION_Q8 2
+#define CHECKPOINT_HEADER_SIZE 256
+
+// Fixed by the llama2.c architecture; packed files state theirs and are
+// refused if they differ
+#define TRANSFORMER_ROPE_THETA 10000.0f
+#define TRANSFORMER_NORM_EPS 1e-5f
+
+// Hyperparameters of a Llama-architecture model
+struct TransformerConfig {
+    int32_t dim;            // Embedding width
+    int32_t hiddenDim;      // FFN width
+    int32_t nLayers;
+    int32_t nHeads;
+    int32_t nKvHeads;       // < nHeads for grouped-query attention
+    int32_t vocabSize;
+    int32_t seqLen;         // Context length (capped at load)
+    int32_t groupSize;      // Quantization group
+    bool sharedClassifier;  // Output head reuses the token embedding
+};
+
+// Group-quantized int8 tensor: q[i] * s[i / groupSize]
+struct QTensor {
+    const int8_t* q;
+    const float* s;
+};
+
+// Quantized activation vector (rewritten before every matmul)
+struct QBuffer {
+    int8_t* q;
+    float* s;
+};
+
+// Llama-style decoder (RMSNorm, RoPE, grouped-query attention, SwiGLU)
+// over an int8 checkpoint, llama2.c runq-style: activations are quantized
+// per group before each matmul so the inner loops are int8 x int8
+// (kernels.h).
+//
+// Weights are read in place from the checkpoint buffer. All activations
+// and the KV cache come from one arena planned at load (arena_plan.h):
+// buffers only live in the attention or the feed-forward block share
+// memory with each other and with the logits, so forward() never
+// allocates and the arena is smaller than the buffers it holds.
+class Transformer {
+public:
+    Transformer();
+    ~Transformer();
+
+    // Parse a model held in memory (which must outlive the model): a
+    // packed CPLM file (model_file.h), e.g. memory-mapped, or a llama2.c
+    // int8 checkpoint. maxSeqLen > 0 caps the context, and with it the KV
+    // cache. With `shared`, the run state is added to that plan instead
+    // of a private arena; the model is usable once the caller binds it.
+    bool load(const void* data, size_t size, int maxSeqLen = 0, ArenaPlan* shared = nullptr);
+    void unload();
+
+    bool isLoaded() const;
+    const TransformerConfig& getConfig() const;
+    const char* getError() const;
+
+    // Split matvecs across this pool (nullptr: run on the caller)
+    void setPool(WorkerPool* pool);
+
+    // Run one token at position pos; returns the logits (vocabSize)
+    float* forward(int token, int pos);
+
+    // Scratch for the token ids of the current generation (seqLen), part
+    // of the arena so a generation allocates nothing
+    int* getTokenBuffer();
+
+    size_t getArenaSize() const;        // Private arena, bytes (0 when shared)
+    size_t getKvCacheSize() const;
+
+    // Snapshots of the KV cache for positions [0, positions), so a shared
+    // prompt prefix is computed once: the size, a copy out, and a copy
+    // back of the first `positions` of a `saved`-position snapshot (one
+    // memcpy per layer and cache). forward() from `positions` on then
+    // matches a run that computed the prefix itself.
+    size_t getKvSnapshotSize(int positions) const;
+    bool saveKv(void* out, int positions) const;
+    bool restoreKv(const void* in, int saved, int positions);
+
+private:
+    TransformerConfig config;
+    const char* error;
+    WorkerPool* pool;
+
+    // Weights (views into the checkpoint)
+    const float* rmsAtt;                // (layer, dim)
+    const float* rmsFfn;                // (layer, dim)
+    const float* rmsFinal;              // (dim)
+    QTensor tokenEmbedding;             // (vocab, dim)
+    QTensor classifier;                 // (vocab, dim)
+    std::vector<QTensor> wq, wk, wv, wo, w1, w2, w3;
+
+    // Run state, carved from the arena (owned unless the plan was shared)
+    uint8_t* arena;
+    size_t arenaSize;
+    size_t kvCacheSize;
+    float* x;                           // Residual stream (dim)
+    float* xb;                          // Normed / attention output (dim)
+    float* xb2;                         // Projection output (dim)
+    float* hb;                          // FFN gate (hiddenDim)
+    float* hb2;                         // FFN up (hiddenDim)
+    float* q;                           // Query (dim)
+    float* att;                         // Scores (nHeads, seqLen)
+    float* logits;                      // (vocabSize)
+    float* keyCache;                    // (layer, seqLen, kvDim)
+    float* valueCache;                  // (layer, seqLen, kvDim)
+    QBuffer xq;                         // Quantized dim-sized input
+    QBuffer hq;                         // Quantized hiddenDim-sized input
+    int* tokenBuffer;                   // (seqLen)
+
+    bool fail(const char* message);
+    bool checkConfig();
+    bool loadCheckpoint(const uint8_t* base, size_t size);
+    bool loadModelFile(const uint8_t* base, size_t size);
+    bool planArena(ArenaPlan& plan);
+
+    void quantize(QBuffer& out, const float* in, int n) const;
+    void matmul(float* out, const QBuffer& in, const QTensor& w, int n, int d) const;
+    void embed(float* out, int token) const;
+
+    static void rmsnorm(float* out, const float* in, const float* weight, int n);
+    static void softmax(float* v, int n);
+};
+
+#endif // LLM_TRANSFORMER_H
@@ -0,0 +1,237 @@
+#include "worker_pool.h"
+#include "kernels.h"
+
+#ifdef HOST_BUILD
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+struct PoolSignal {
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+static inline void yieldThread() {
+    std::this_thread::yield();
+}
+#else
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static inline void cpuRelax() {}
+
+static inline void yieldThread() {
+    taskYIELD();
+}
+#endif
+
+// Busy-wait step: pause at first, then give the CPU away so an
+// oversubscribed pool (more threads than cores) still makes progress
+static inline void waitStep(int& spins) {
+    if (++spins < WORKER_POOL_YIELD_AFTER) cpuRelax();
+    else yieldThread();
+}
+
+WorkerPool::WorkerPool()
+    : threads(1), jobFn(nullptr), jobCtx(nullptr), jobRows(0),
+      generation(0), pending(0), stopping(false), signal(nullptr) {
+    for (auto& w : workers) {
+        w.pool = this;
+        w.index = 0;
+        w.handle.store(nullptr);
+        w.sleeping.store(false);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    stop();
+}
+
+bool WorkerPool::start(int count, int core) {
+    stop();
+    if (count < 1) count = 1;
+    if (count > WORKER_POOL_MAX_THREADS) count = WORKER_POOL_MAX_THREADS;
+
+    stopping.store(false);
+    generation.store(0);
+    pending.store(0);
+
+#ifdef HOST_BUILD
+    (void)core;
+    signal = new PoolSignal();
+#endif
+
+    threads = 1;
+    for (int i = 0; i < count - 1; i++) {
+        Worker& w = workers[i];
+        w.index = i + 1;
+        w.sleeping.store(false);
+#ifdef HOST_BUILD
+        w.handle.store(new std::thread(workerMain, &w));
+#else
+        TaskHandle_t task = nullptr;
+        BaseType_t created = xTaskCreatePinnedToCore(
+            workerMain, "llm_worker", WORKER_POOL_STACK, &w, WORKER_POOL_PRIORITY,
+            &task, core < 0 ? tskNO_AFFINITY : core);
+        if (created != pdPASS) break;
+        w.handle.store(task);
+#endif
+        threads++;
+    }
+    return threads == count;
+}
+
+void WorkerPool::stop() {
+    if (threads > 1) {
+        stopping.store(true);
+        for (int i = 0; i < threads - 1; i++) wake(workers[i]);
+
+#ifdef HOST_BUILD
+        for (int i = 0; i < threads - 1; i++) {
+            std::thread* t = (std::thread*)workers[i].handle.load();
+            t->join();
+            delete t;
+        }
+#else
+        // Each worker clears its handle as it exits
+        for (int i = 0; i < threads - 1; i++) {
+            while (workers[i].handle.load() != nullptr) vTaskDelay(1);
+        }
+#endif
+    }
+
+    for (auto& w : workers) w.handle.store(nullptr);
+    threads = 1;
+
+#ifdef HOST_BUILD
+    delete (PoolSignal*)signal;
+#endif
+    signal = nullptr;
+}
+
+int WorkerPool::getThreads() const {
+    return threads;
+}
+
+void WorkerPool::slice(int index, int& begin, int& end) const {
+    begin = (int)((int64_t)jobRows * index / threads);
+    end = (int)((int64_t)jobRows * (index + 1) / threads);
+}
+
+void WorkerPool::run(int rows, RangeFn fn, void* ctx) {
+    if (threads <= 1 || rows < WORKER_POOL_MIN_ROWS) {
+        fn(ctx, 0, rows);
+        return;
+    }
+
+    jobFn = fn;
+    jobCtx = ctx;
+    jobRows = rows;
+    pending.store(threads - 1, std::memory_order_relaxed);
+    generation.fetch_add(1);  // Publishes the job (seq_cst pairs with sleep())
+    for (int i = 0; i < threads - 1; i++) wake(workers[i]);
+
+    int begin, end;
+    slice(0, begin, end);
+    fn(ctx, begin, end);
+
+    // Barrier: slices are roughly equal, so the wait is short
+    int spins = 0;
+    while (pending.load(std::memory_order_acquire) != 0) waitStep(spins);
+}
+
+void WorkerPool::workerMain(void* arg) {
+    Worker* w = (Worker*)arg;
+    w->pool->work(*w);
+#ifndef HOST_BUILD
+    w->handle.store(nullptr);
+    vTaskDelete(nullptr);
+#endif
+}
+
+void WorkerPool::work(Worker& w) {
+    uint32_t seen = 0;
+    while (true) {
+        uint32_t current;
+        int spins = 0;
+        while ((current = generation.load(std::memory_order_acquire)) == seen &&
+               !stopping.load(std::memory_order_relaxed)) {
+            if (spins < WORKER_POOL_SPINS) {
+                waitStep(spins);
+            } else {
+                sleep(w, seen);
+                spins = 0;
+            }
+        }
+        if (stopping.load()) return;
+
+        seen = current;
+        int begin, end;
+        slice(w.index, begin, end);
+        jobFn(jobCtx, begin, end);
+        pending.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+// The sleeping flag and the generation are both seq_cst: either run()
+// sees the flag and wakes the worker, or the worker sees the new job
+// before blocking
+void WorkerPool::sleep(Worker& w, uint32_t seen) {
+#ifdef HOST_BUILD
+    PoolSignal* s = (PoolSignal*)signal;
+    std::unique_lock<std::mutex> lock(s->mutex);
+    w.sleeping.store(true);
+    s->cv.wait(lock, [&]() { return generation.load() != seen || stopping.load(); });
+    w.sleeping.store(false);
+#else
+    w.sleeping.store(true);
+    if (generation.load() == seen && !stopping.load()) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+    w.sleeping.store(false);
+#endif
+}
+
+void WorkerPool::wake(Worker& w) {
+    if (!w.sleeping.load() && !stopping.load()) return;
+#ifdef HOST_BUILD
+    PoolSignal* s = (PoolSignal*)signal;
+    std::lock_guard<std::mutex> lock(s->mutex);
+    s->cv.notify_all();
+#else
+    TaskHandle_t task = (TaskHandle_t)w.handle.load();
+    if (task) xTaskNotifyGive(task);
+#endif
+}
+
+struct MatvecJob {
+    const MatvecKernels* kernels;
+    float* out;
+    const int8_t* xq;
+    const float* xs;
+    const int8_t* wq;
+    const float* ws;
+    int n;
+    int groupSize;
+};
+
+static void matvecRange(void* ctx, int begin, int end) {
+    const MatvecJob* job = (const MatvecJob*)ctx;
+    size_t n = job->n;
+    job->kernels->matvecQ8(job->out + begin, job->xq, job->xs,
+                           job->wq + begin * n, job->ws + begin * n / job->groupSize,
+                           job->n, end - begin, job->groupSize);
+}
+
+void WorkerPool::matvecQ8(const MatvecKernels& kernels, float* out, const int8_t* xq,
+                          const float* xs, const int8_t* wq, const float* ws,
+                          int n, int d, int groupSize) {
+    MatvecJob job = {&kernels, out, xq, xs, wq, ws, n, groupSize};
+    run(d, matvecRange, &job);
+}
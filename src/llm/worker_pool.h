@@ -0,0 +1,92 @@
+#ifndef LLM_WORKER_POOL_H
+#define LLM_WORKER_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Most threads a pool runs (the caller counts as one)
+#define WORKER_POOL_MAX_THREADS 8
+
+// Polls of the job counter before an idle worker sleeps. Matvecs within
+// a token arrive microseconds apart, so host workers stay awake through a
+// forward pass. Device workers give up sooner so the idle task on their
+// core still runs (the task watchdog checks it).
+#ifdef HOST_BUILD
+#define WORKER_POOL_SPINS 20000
+#else
+#define WORKER_POOL_SPINS 2000
+#endif
+
+// Polls before a waiting thread starts yielding its core instead of
+// pausing, so pools larger than the core count degrade gracefully
+#define WORKER_POOL_YIELD_AFTER 256
+
+// Device worker tasks
+#define WORKER_POOL_STACK 4096
+#define WORKER_POOL_PRIORITY 1
+
+// Below this many rows a matvec runs on the caller alone; the wake-up
+// and barrier would cost more than the split saves
+#define WORKER_POOL_MIN_ROWS 64
+
+struct MatvecKernels;
+
+// Fixed pool that splits row ranges across threads: the calling thread
+// takes the first slice and threads - 1 workers the rest, then everyone
+// meets at a barrier. Workers are created once (pinned FreeRTOS tasks on
+// the device, std::threads on the host); dispatching a job allocates
+// nothing.
+class WorkerPool {
+public:
+    // Work on rows [begin, end)
+    typedef void (*RangeFn)(void* ctx, int begin, int end);
+
+    WorkerPool();
+    ~WorkerPool();
+
+    // threads includes the caller; 1 runs everything inline. On the
+    // device workers are pinned to core `core` (< 0: any core).
+    bool start(int threads, int core = -1);
+    void stop();
+
+    int getThreads() const;
+
+    // Split `rows` across the pool and return once all slices are done.
+    // Not reentrant: one caller at a time.
+    void run(int rows, RangeFn fn, void* ctx);
+
+    // out (d) = W (d, n) @ x (n), rows split across the pool
+    void matvecQ8(const MatvecKernels& kernels, float* out, const int8_t* xq, const float* xs,
+                  const int8_t* wq, const float* ws, int n, int d, int groupSize);
+
+private:
+    struct Worker {
+        WorkerPool* pool;
+        int index;
+        std::atomic<void*> handle;  // std::thread* / TaskHandle_t
+        std::atomic<bool> sleeping;
+    };
+
+    int threads;
+    Worker workers[WORKER_POOL_MAX_THREADS - 1];
+
+    // Current job, published by the generation bump
+    RangeFn jobFn;
+    void* jobCtx;
+    int jobRows;
+    std::atomic<uint32_t> generation;
+    std::atomic<int> pending;
+    std::atomic<bool> stopping;
+
+    void* signal;                   // Host: mutex + condition variable
+
+    static void workerMain(void* arg);
+    void work(Worker& worker);
+    void sleep(Worker& worker, uint32_t seen);
+    void wake(Worker& worker);
+
+    void slice(int index, int& begin, int& end) const;
+};
+
+#endif // LLM_WORKER_POOL_H
@@ -5,6 +5,7 @@
 #include "core/scanner.h"
 #include "core/power.h"
 #include "core/enumerator.h"
+#include "core/enum_job.h"
 #include "display/ui.h"
 #include "display/effects.h"
 #include "web/server.h"
@@ -102,6 +103,9 @@ void setup() {
         #endif
     }
 
+    // Analysis rules before the web server can ask for them
+    LLMEngine::loadRules(PORTAL_RULES_PATH);
+
     // Start web server/AP FIRST (before scanner init)
     // The AP must be up before scanning starts
     if (startWebServer) {
@@ -128,6 +132,12 @@ void setup() {
     // Initialize enumerator with wordlists
     Enumerator::init();
 
+    // Pick up any enumeration job interrupted by a reset or deep sleep
+    EnumJob::init();
+
+    // Portal analyses cached before the last reboot
+    LLMEngine::initAnalysisCache();
+
     // Initialize LLM engine if enabled
     if (startLLM) {
         #if LLM_ENABLED
@@ -214,6 +224,10 @@ void loop() {
         }
     }
 
+    #if WEB_SERVER_ENABLED
+    WebServer::update();
+    #endif
+
     // Update display at 20fps
     if (millis() - lastUIUpdate > ANIMATION_FRAME_DELAY) {
         lastUIUpdate = millis();
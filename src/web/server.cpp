@@ -2,24 +2,23 @@
 #include "config.h"
 #include "core/scanner.h"
 #include "core/enumerator.h"
+#include "core/enum_job.h"
+#include "core/portal_classifier.h"
 #include "display/ui.h"
+#include "llm/engine.h"
 #include <WiFi.h>
 #include <SPIFFS.h>
+#include <SD.h>
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
 
 // Static member initialization
 AsyncWebServer WebServer::server(WEB_SERVER_PORT);
+AsyncEventSource WebServer::llmEvents("/api/llm/events");
 bool WebServer::running = false;
 String WebServer::apSSID = "";
 String WebServer::apIP = "";
 
-// Enumeration progress tracking
-static int enumCurrent = 0;
-static int enumTotal = 0;
-static String enumStatus = "";
-static bool enumComplete = false;
-
 void WebServer::init() {
     if (running) return;
 
@@ -43,7 +42,13 @@ void WebServer::init() {
     server.on("/api/analyze", HTTP_GET, handleAnalyze);
     server.on("/api/enumerate", HTTP_GET, handleEnumerate);
     server.on("/api/enum/progress", HTTP_GET, handleEnumProgress);
+    server.on("/api/enum/result", HTTP_GET, handleEnumResult);
+    server.on("/api/enum/cancel", HTTP_GET, handleEnumCancel);
+    server.on("/api/enum/resume", HTTP_GET, handleEnumResume);
+    server.on("/api/enum/log", HTTP_GET, handleEnumLog);
     server.on("/api/llm", HTTP_GET, handleLLM);
+    server.on("/api/llm/cancel", HTTP_GET, handleLLMCancel);
+    server.addHandler(&llmEvents);
     server.on("/api/screenshot", HTTP_GET, handleScreenshot);
 
     // Debug endpoints for testing
@@ -112,6 +117,61 @@ void WebServer::setupAP() {
     }
 }
 
+// LLM text is pushed as server-sent events: "start" (stream id), "token"
+// (new text, possibly several tokens), "done" (JSON summary), and "reset"
+// (all text so far, replacing what a client shows) when a client joins
+// mid-generation.
+void WebServer::update() {
+    static StreamCursor cursor = {0, 0};
+    static uint8_t lastState = STREAM_IDLE;
+    static size_t lastClients = 0;
+    static char text[TOKEN_STREAM_BYTES + 1];
+    if (!running) return;
+
+    size_t clients = llmEvents.count();
+    size_t previousClients = lastClients;
+    lastClients = clients;
+    if (clients == 0) return;
+
+    // A new client gets all text so far; "reset" replaces what the others
+    // already show with the same text. Token events carry at most 256 bytes.
+    const TokenStream& stream = LLMEngine::getStream();
+    bool joined = clients > previousClients;
+    if (joined) cursor.offset = 0;
+
+    uint32_t id = cursor.id;
+    size_t n = stream.read(cursor, text, joined ? sizeof(text) : 257);
+    if (cursor.id != id || joined) {     // Newcomers learn whose text follows
+        char start[16];
+        snprintf(start, sizeof(start), "%u", (unsigned)cursor.id);
+        llmEvents.send(start, "start", millis());
+        lastState = STREAM_RUNNING;
+    }
+    if (joined) {
+        llmEvents.send(text, "reset", millis());
+        lastState = STREAM_RUNNING;     // Repeat "done" for the newcomer
+    } else if (n > 0) {
+        llmEvents.send(text, "token", millis());
+    }
+
+    // Report the end once all its text has gone out
+    TokenStreamState state = stream.getState();
+    bool ended = state == STREAM_DONE || state == STREAM_CANCELLED;
+    if (ended && state != lastState && cursor.offset == stream.getWritten()) {
+        JsonDocument doc;
+        doc["id"] = cursor.id;
+        doc["state"] = TokenStream::getStateName(state);
+        doc["tokens"] = stream.getTokens();
+        doc["firstTextMs"] = stream.getFirstVisibleMs();
+        doc["totalMs"] = stream.getElapsedMs();
+
+        String summary;
+        serializeJson(doc, summary);
+        llmEvents.send(summary.c_str(), "done", millis());
+        lastState = state;
+    }
+}
+
 void WebServer::stop() {
     if (!running) return;
 
@@ -148,6 +208,55 @@ void WebServer::handleStatus(AsyncWebServerRequest* request) {
     doc["networkCount"] = Scanner::getNetworkCount();
     doc["portalCount"] = Scanner::getPortalCount();
 
+    JsonObject llm = doc["llm"].to<JsonObject>();
+    llm["ready"] = LLMEngine::isReady();
+    if (LLMEngine::isReady()) {
+        llm["mapped"] = LLMEngine::isModelMapped();
+        llm["modelBytes"] = LLMEngine::getModelSize();
+        llm["residentBytes"] = LLMEngine::getResidentSize();
+        llm["loadMs"] = LLMEngine::getLoadTimeMs();
+        llm["verifyMs"] = LLMEngine::getVerifyTimeMs();
+        llm["arenaBytes"] = LLMEngine::getArenaSize();
+        llm["arenaUnsharedBytes"] = LLMEngine::getArenaUnsharedSize();
+
+        const PrefixCache& prefixes = LLMEngine::getPrefixCache();
+        llm["prefixHits"] = prefixes.getHits();
+        llm["prefixMisses"] = prefixes.getMisses();
+        llm["prefixTokensReused"] = prefixes.getReusedTokens();
+
+        const TokenStream& stream = LLMEngine::getStream();
+        JsonObject gen = llm["stream"].to<JsonObject>();
+        gen["id"] = stream.getId();
+        gen["state"] = TokenStream::getStateName(stream.getState());
+        gen["tokens"] = stream.getTokens();
+        gen["firstTextMs"] = stream.getFirstVisibleMs();
+        gen["elapsedMs"] = stream.getElapsedMs();
+
+        QueueStats stats = LLMEngine::getQueueStats();
+        JsonObject queue = llm["queue"].to<JsonObject>();
+        queue["depth"] = INFERENCE_QUEUE_DEPTH;
+        queue["queued"] = stats.queued;
+        queue["running"] = stats.running;
+        queue["submitted"] = stats.submitted;
+        queue["coalesced"] = stats.coalesced;
+        queue["rejected"] = stats.rejected;
+        queue["displaced"] = stats.displaced;
+        queue["refused"] = LLMEngine::getRefusedJobs();
+        queue["cancelled"] = stats.cancelled;
+        queue["completed"] = stats.completed;
+        queue["waitMs"] = stats.lastWaitMs;
+        queue["waitMsAvg"] = stats.avgWaitMs;
+        queue["waitMsMax"] = stats.maxWaitMs;
+    }
+
+    AnalysisCache& analyses = LLMEngine::getAnalysisCache();
+    JsonObject cache = doc["analysisCache"].to<JsonObject>();
+    cache["entries"] = analyses.getCount();
+    cache["hits"] = analyses.getHits();
+    cache["storeHits"] = analyses.getStoreHits();
+    cache["misses"] = analyses.getMisses();
+    cache["evictions"] = analyses.getEvictions();
+
     // Include network list
     JsonArray networks = doc["networks"].to<JsonArray>();
     for (auto& net : Scanner::getNetworks()) {
@@ -295,26 +404,121 @@ void WebServer::handleEnumerate(AsyncWebServerRequest* request) {
         return;
     }
 
-    // Reset progress
-    enumCurrent = 0;
-    enumTotal = maxAttempts;
-    enumStatus = "Starting...";
-    enumComplete = false;
+    // Only one job at a time; the candidate sets are shared
+    if (EnumJob::isRunning()) {
+        JsonDocument doc;
+        doc["error"] = "Enumeration already running";
+        doc["jobId"] = EnumJob::getId();
+
+        String response;
+        serializeJson(doc, response);
+        request->send(409, "application/json", response);
+        return;
+    }
+
+    // Optional room pattern, e.g. pattern=%F%2R:1-40:1-60
+    if (request->hasParam("pattern")) {
+        CandidateSpec spec;
+        if (!CandidateGen::parse(request->getParam("pattern")->value().c_str(), spec)) {
+            request->send(400, "application/json", "{\"error\":\"Invalid pattern\"}");
+            return;
+        }
+        Enumerator::useRoomPattern(spec);
+    } else {
+        Enumerator::useDefaultRoomPatterns();
+    }
 
-    // Set progress callback
-    Enumerator::setProgressCallback([](int current, int total, const String& status) {
-        enumCurrent = current;
-        enumTotal = total;
-        enumStatus = status;
-    });
+    // Optional request rate ceiling in attempts/sec, e.g. rate=1.5
+    if (request->hasParam("rate")) {
+        float rate = request->getParam("rate")->value().toFloat();
+        if (rate <= 0) {
+            request->send(400, "application/json", "{\"error\":\"Invalid rate\"}");
+            return;
+        }
+        Enumerator::setMaxRate(rate);
+    } else {
+        Enumerator::setMaxRate(ENUM_MAX_RATE);
+    }
 
-    // Run enumeration
-    EnumResult result = Enumerator::enumerate(target, maxAttempts);
-    enumComplete = true;
+    // Run enumeration in the background; poll /api/enum/progress
+    uint32_t jobId = EnumJob::start(*target, maxAttempts);
+    if (jobId == 0) {
+        request->send(500, "application/json", "{\"error\":\"Failed to start job\"}");
+        return;
+    }
 
-    // Build response
     JsonDocument doc;
     doc["success"] = true;
+    doc["jobId"] = jobId;
+    doc["state"] = EnumJob::getStateName();
+
+    String response;
+    serializeJson(doc, response);
+    request->send(202, "application/json", response);
+}
+
+// Returns false (and sends 404) if a job param names a stale job
+static bool checkJobParam(AsyncWebServerRequest* request) {
+    if (request->hasParam("job") &&
+        (uint32_t)request->getParam("job")->value().toInt() != EnumJob::getId()) {
+        request->send(404, "application/json", "{\"error\":\"Job not found\"}");
+        return false;
+    }
+    return true;
+}
+
+void WebServer::handleEnumProgress(AsyncWebServerRequest* request) {
+    if (!checkJobParam(request)) return;
+
+    // One snapshot so current/total/successes/status always agree
+    EnumProgressSnapshot progress;
+    EnumJob::getProgress(progress);
+
+    JsonDocument doc;
+    doc["jobId"] = EnumJob::getId();
+    doc["state"] = EnumJob::getStateName();
+    doc["current"] = progress.current;
+    doc["total"] = progress.total;
+    doc["successes"] = progress.successes;
+    doc["status"] = EnumJob::isRunning() && progress.status[0] ?
+        progress.status : EnumJob::getStateName();
+    doc["complete"] = !EnumJob::isRunning();
+    doc["resumable"] = EnumJob::hasCheckpoint();
+
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+void WebServer::handleEnumResult(AsyncWebServerRequest* request) {
+    if (!checkJobParam(request)) return;
+
+    JsonDocument doc;
+    doc["jobId"] = EnumJob::getId();
+    doc["state"] = EnumJob::getStateName();
+
+    // Hits are readable while the job is still running
+    JsonArray hits = doc["hits"].to<JsonArray>();
+    int hitCount = EnumJob::getHitCount();
+    for (int i = 0; i < hitCount; i++) {
+        const EnumHit& hit = EnumJob::getHit(i);
+        JsonObject hObj = hits.add<JsonObject>();
+        hObj["room"] = hit.room;
+        hObj["name"] = hit.name;
+    }
+
+    if (EnumJob::isRunning() || EnumJob::getState() == JOB_IDLE) {
+        doc["complete"] = false;
+
+        String response;
+        serializeJson(doc, response);
+        request->send(202, "application/json", response);
+        return;
+    }
+
+    const EnumResult& result = EnumJob::getResult();
+    doc["complete"] = true;
+    doc["success"] = EnumJob::getState() != JOB_FAILED;
     doc["totalAttempts"] = result.totalAttempts;
     doc["successfulAttempts"] = result.successfulAttempts;
     doc["failedAttempts"] = result.failedAttempts;
@@ -333,23 +537,71 @@ void WebServer::handleEnumerate(AsyncWebServerRequest* request) {
         patterns.add(p);
     }
 
+    // Every attempt of the run, for offline analysis
+    doc["loggedAttempts"] = EnumJob::getLoggedCount();
+    doc["attemptLog"] = EnumJob::getLogPath().length() > 0;
+
     String response;
     serializeJson(doc, response);
     request->send(200, "application/json", response);
 }
 
-void WebServer::handleEnumProgress(AsyncWebServerRequest* request) {
+void WebServer::handleEnumLog(AsyncWebServerRequest* request) {
+    if (!checkJobParam(request)) return;
+
+    String path = EnumJob::getLogPath();
+    if (path.length() == 0) {
+        request->send(404, "application/json", "{\"error\":\"No attempt log (SD card required)\"}");
+        return;
+    }
+
+    // Binary records; decode with tools/decode_attempts.py
+    request->send(SD, path, "application/octet-stream", true);
+}
+
+void WebServer::handleEnumCancel(AsyncWebServerRequest* request) {
+    uint32_t jobId = EnumJob::getId();
+    if (request->hasParam("job")) {
+        jobId = request->getParam("job")->value().toInt();
+    }
+
     JsonDocument doc;
-    doc["current"] = enumCurrent;
-    doc["total"] = enumTotal;
-    doc["status"] = enumStatus;
-    doc["complete"] = enumComplete;
+    doc["jobId"] = jobId;
+    doc["success"] = EnumJob::cancel(jobId);
+    doc["state"] = EnumJob::getStateName();
 
     String response;
     serializeJson(doc, response);
     request->send(200, "application/json", response);
 }
 
+void WebServer::handleEnumResume(AsyncWebServerRequest* request) {
+    if (EnumJob::isRunning()) {
+        request->send(409, "application/json", "{\"error\":\"Enumeration already running\"}");
+        return;
+    }
+
+    uint32_t jobId = EnumJob::resume();
+    if (jobId == 0) {
+        request->send(404, "application/json", "{\"error\":\"No resumable job\"}");
+        return;
+    }
+
+    EnumProgressSnapshot progress;
+    EnumJob::getProgress(progress);
+
+    JsonDocument doc;
+    doc["success"] = true;
+    doc["jobId"] = jobId;
+    doc["state"] = EnumJob::getStateName();
+    doc["current"] = progress.current;
+    doc["total"] = progress.total;
+
+    String response;
+    serializeJson(doc, response);
+    request->send(202, "application/json", response);
+}
+
 void WebServer::handleLLM(AsyncWebServerRequest* request) {
     if (!request->hasParam("ssid")) {
         request->send(400, "application/json", "{\"error\":\"Missing ssid parameter\"}");
@@ -376,40 +628,97 @@ void WebServer::handleLLM(AsyncWebServerRequest* request) {
         return;
     }
 
-    // Analyze form fields
-    auto fields = Enumerator::analyzePortalForm(target->portalHtml);
+    // The summary and the model's text depend only on the page, so a
+    // portal analysed before (also before a reboot) is answered from the
+    // analysis cache without parsing its form again
+    AnalysisCache& cache = LLMEngine::getAnalysisCache();
+    uint64_t pageHash = AnalysisCache::hashPage(target->portalHtml.c_str(),
+                                                target->portalHtml.length());
+    // Rules can change on flash and the classifier with retraining; all
+    // three go through FNV so no two components can cancel out
+    uint64_t components[3] = {pageHash, LLMEngine::getRules().getHash(),
+                              PortalClassifier::getModelHash()};
+    uint64_t summaryKey = AnalysisCache::hashPage((const char*)components, sizeof(components));
+    static char cached[ANALYSIS_CACHE_VALUE + 1];   // Handlers run on the async_tcp task only
 
-    // TODO: Integrate actual LLM inference
-    // For now, return analyzed form structure
+    String response;
+    bool hit = cache.lookup(summaryKey, ANALYZER_PATTERN, cached, sizeof(cached)) >= 0;
+    if (hit) {
+        response = cached;
+    } else {
+        response = summarizePortal(target->portalHtml, target->portalUrl);
+        cache.insert(summaryKey, ANALYZER_PATTERN, response.c_str(), response.length());
+    }
+    target->analyzed = true;
+
+    // With a model loaded, its own analysis comes from the cache or is
+    // generated in the background and streamed over /api/llm/events. A
+    // page the classifier is sure of only goes to the model with force=1.
+    // (Classifying again costs microseconds, less than reading it back.)
+    bool force = request->hasParam("force") && request->getParam("force")->value() == "1";
+    ClassifierResult predicted;
+    PortalClassifier::classify(target->portalHtml.c_str(), target->portalHtml.length(), predicted);
+    bool classified = PortalClassifier::isConfident(predicted);
+    JsonDocument extra;
+    extra["ssid"] = target->ssid;
+    extra["cached"] = hit;
+    if (LLMEngine::getCachedAnalysis(pageHash, cached, sizeof(cached)) >= 0) {
+        extra["streamId"] = 0;
+        extra["modelText"] = (const char*)cached;
+    } else if (classified && !force) {
+        extra["streamId"] = 0;
+    } else {
+        // Asked for by the user, so interactive like the UI's: on battery
+        // admit() only takes interactive jobs
+        extra["streamId"] = LLMEngine::startAnalysis(target->portalHtml, JOB_INTERACTIVE);
+    }
+
+    // Per-request fields (the SSID too: another network may serve the same
+    // page) are appended to the cached summary object
+    String tail;
+    serializeJson(extra, tail);
+    response.setCharAt(response.length() - 1, ',');
+    response += tail.c_str() + 1;
+
+    #if DEBUG_SERIAL
+    Serial.printf("[WEB] LLM summary %s (cache: %u hits, %u misses)\n",
+                  hit ? "cached" : "computed", cache.getHits(), cache.getMisses());
+    #endif
+
+    request->send(200, "application/json", response);
+}
+
+// The pattern-based /api/llm summary as a JSON object
+String WebServer::summarizePortal(const String& portalHtml, const String& url) {
+    auto fields = Enumerator::analyzePortalForm(portalHtml, url);
 
     JsonDocument doc;
     doc["success"] = true;
-    doc["ssid"] = target->ssid;
 
-    // Detect venue type from HTML hints
-    String html = target->portalHtml;
-    html.toLowerCase();
-
-    if (html.indexOf("hotel") >= 0 || html.indexOf("room") >= 0) {
-        doc["venueType"] = "Hotel/Hospitality";
-    } else if (html.indexOf("airport") >= 0 || html.indexOf("flight") >= 0) {
-        doc["venueType"] = "Airport";
-    } else if (html.indexOf("cafe") >= 0 || html.indexOf("coffee") >= 0) {
-        doc["venueType"] = "Cafe/Restaurant";
-    } else if (html.indexOf("hospital") >= 0 || html.indexOf("patient") >= 0) {
-        doc["venueType"] = "Healthcare";
-    } else if (html.indexOf("conference") >= 0 || html.indexOf("event") >= 0) {
-        doc["venueType"] = "Conference/Event";
-    } else {
-        doc["venueType"] = "Unknown";
+    // Venue type from the analysis rules (one pass over the page)
+    const PortalRules& rules = LLMEngine::getRules();
+    RuleMatch match;
+    rules.evaluate(portalHtml.c_str(), portalHtml.length(), match);
+    doc["venueType"] = match.venue >= 0 ? rules.getLabel(match.venue) : "Unknown";
+
+    // Venue and login type from the trained classifier; its venue wins
+    // when it is sure
+    ClassifierResult predicted;
+    PortalClassifier::classify(portalHtml.c_str(), portalHtml.length(), predicted);
+    bool classified = PortalClassifier::isConfident(predicted);
+    if (classified && predicted.venue != PortalClassifier::getUnknownVenue()) {
+        doc["venueType"] = PortalClassifier::getVenueLabel(predicted.venue);
     }
+    doc["authType"] = PortalClassifier::getAuthLabel(predicted.auth);
+    doc["confidence"] = (int)(predicted.confidence() * 100);
+    doc["classified"] = classified;
 
     // Extract venue name hints
     // Look for title tag
-    int titleStart = target->portalHtml.indexOf("<title>");
-    int titleEnd = target->portalHtml.indexOf("</title>");
+    int titleStart = portalHtml.indexOf("<title>");
+    int titleEnd = portalHtml.indexOf("</title>");
     if (titleStart >= 0 && titleEnd > titleStart) {
-        doc["venueName"] = target->portalHtml.substring(titleStart + 7, titleEnd);
+        doc["venueName"] = portalHtml.substring(titleStart + 7, titleEnd);
     } else {
         doc["venueName"] = "Unknown";
     }
@@ -454,7 +763,28 @@ void WebServer::handleLLM(AsyncWebServerRequest* request) {
 
     doc["analysis"] = analysis;
 
-    target->analyzed = true;
+    String response;
+    serializeJson(doc, response);
+    return response;
+}
+
+void WebServer::handleLLMCancel(AsyncWebServerRequest* request) {
+    uint32_t streamId = 0;
+    if (request->hasParam("stream")) {
+        streamId = request->getParam("stream")->value().toInt();
+    }
+
+    // A queued job is dropped before it produces a stream
+    const TokenStream& stream = LLMEngine::getStream();
+    bool success = LLMEngine::cancel(streamId);
+    JsonDocument doc;
+    doc["streamId"] = streamId ? streamId : stream.getId();
+    doc["success"] = success;
+    if (streamId == 0 || streamId == stream.getId()) {
+        doc["state"] = TokenStream::getStateName(stream.getState());
+    } else {
+        doc["state"] = success ? "cancelled" : "unknown";
+    }
 
     String response;
     serializeJson(doc, response);
@@ -12,8 +12,12 @@ public:
     static String getIP();
     static String getAPSSID();
 
+    // Push new LLM stream text to event-source clients (call from loop())
+    static void update();
+
 private:
     static AsyncWebServer server;
+    static AsyncEventSource llmEvents;
     static bool running;
     static String apSSID;
     static String apIP;
@@ -25,7 +29,12 @@ private:
     static void handleAnalyze(AsyncWebServerRequest* request);
     static void handleEnumerate(AsyncWebServerRequest* request);
     static void handleEnumProgress(AsyncWebServerRequest* request);
+    static void handleEnumResult(AsyncWebServerRequest* request);
+    static void handleEnumCancel(AsyncWebServerRequest* request);
+    static void handleEnumResume(AsyncWebServerRequest* request);
+    static void handleEnumLog(AsyncWebServerRequest* request);
     static void handleLLM(AsyncWebServerRequest* request);
+    static void handleLLMCancel(AsyncWebServerRequest* request);
     static void handleNetworks(AsyncWebServerRequest* request);
     static void handleScreenshot(AsyncWebServerRequest* request);
     static void handleTestPortal(AsyncWebServerRequest* request);  // Debug: inject test portal
@@ -33,6 +42,7 @@ private:
 
     // Utility
     static String getContentType(const String& filename);
+    static String summarizePortal(const String& html, const String& url);
     static void setupAP();
 };
 
@@ -0,0 +1,262 @@
+#!/usr/bin/env python3
+"""
+Captured Portal - Attempt Log Decoder
+Turns the binary enumeration attempt logs written to SD
+(/logs/attempts-<job>.bin, or /api/enum/log) into CSV or JSON.
+
+Records store candidate ordinals, not strings. Pass the room pattern the
+job used (--pattern) and/or the candidate lists (--rooms, --names) to
+render them back into room numbers and surnames.
+
+`-f priors` turns the hits into candidate priors (floor, room and surname
+counts) for /wordlists/priors.txt; files from several engagements can be
+concatenated.
+"""
+
+import argparse
+import csv
+import json
+import re
+import struct
+import sys
+from collections import Counter
+
+MAGIC = 0x4C415043          # "CPAL"
+HEADER = struct.Struct('<IHHII')
+RECORD = struct.Struct('<IIIIhHHBB')
+NO_CANDIDATE = 0xFFFFFFFF
+
+FLAG_SUCCESS = 0x01
+FLAG_RETRY_AFTER = 0x02
+
+FIELDS = ['index', 'offset_ms', 'room_ordinal', 'name_ordinal', 'room', 'name',
+          'http_code', 'latency_ms', 'body_len', 'body_hash', 'success', 'retry_after']
+
+
+def parse_range(text):
+    first, _, last = text.partition('-')
+    return int(first), int(last or first)
+
+
+class RoomPattern:
+    """Same mask language as CandidateGen: %F, %R, %nR, %L, %%"""
+
+    def __init__(self, spec):
+        parts = spec.split(':')
+        if len(parts) < 3:
+            raise ValueError('expected mask:floors:rooms[:letters]')
+        self.mask = parts[0]
+        self.floors = parse_range(parts[1])
+        self.rooms = parse_range(parts[2])
+        letters = parts[3] if len(parts) > 3 else 'A'
+        first, _, last = letters.partition('-')
+        self.letters = (ord(first), ord(last or first))
+
+    def count(self):
+        return ((self.letters[1] - self.letters[0] + 1) *
+                (self.floors[1] - self.floors[0] + 1) *
+                (self.rooms[1] - self.rooms[0] + 1))
+
+    def at(self, ordinal):
+        rooms = self.rooms[1] - self.rooms[0] + 1
+        floors = self.floors[1] - self.floors[0] + 1
+        room = self.rooms[0] + ordinal % rooms
+        rest = ordinal // rooms
+        floor = self.floors[0] + rest % floors
+        letter = chr(self.letters[0] + rest // floors)
+
+        out = []
+        i = 0
+        mask = self.mask
+        while i < len(mask):
+            c = mask[i]
+            if c != '%':
+                out.append(c)
+                i += 1
+                continue
+            i += 1
+            width = 0
+            if i < len(mask) and mask[i] in '123456789':
+                width = int(mask[i])
+                i += 1
+            token = mask[i] if i < len(mask) else ''
+            if token == 'F':
+                out.append(str(floor))
+            elif token == 'R':
+                out.append(str(room).zfill(width))
+            elif token == 'L':
+                out.append(letter)
+            elif token == '%':
+                out.append('%')
+            i += 1
+        return ''.join(out)
+
+
+class Candidates:
+    """Pattern values first, then list entries, like a CandidateSet"""
+
+    def __init__(self, pattern=None, words=None):
+        self.pattern = RoomPattern(pattern) if pattern else None
+        self.words = words or []
+
+    def at(self, ordinal):
+        if ordinal == NO_CANDIDATE:
+            return ''
+        if self.pattern:
+            if ordinal < self.pattern.count():
+                return self.pattern.at(ordinal)
+            ordinal -= self.pattern.count()
+        if ordinal < len(self.words):
+            return self.words[ordinal]
+        return None
+
+
+def read_list(path):
+    if not path:
+        return []
+    with open(path) as f:
+        return [line.strip() for line in f
+                if line.strip() and not line.startswith('#')]
+
+
+def decode(path, rooms, names):
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    if len(data) < HEADER.size:
+        raise ValueError('file too short for a header')
+
+    magic, version, record_size, job_id, _ = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError('not an attempt log (bad magic)')
+    if version != 1 or record_size != RECORD.size:
+        raise ValueError(f'unsupported log version {version} / record size {record_size}')
+
+    records = []
+    first_start = None
+    count = (len(data) - HEADER.size) // RECORD.size   # Ignore a torn tail
+    for i in range(count):
+        (room_ord, name_ord, start_ms, body_hash, code, latency,
+         body_len, flags, _) = RECORD.unpack_from(data, HEADER.size + i * RECORD.size)
+        if first_start is None:
+            first_start = start_ms
+        records.append({
+            'index': i,
+            'offset_ms': (start_ms - first_start) & 0xFFFFFFFF,
+            'room_ordinal': None if room_ord == NO_CANDIDATE else room_ord,
+            'name_ordinal': None if name_ord == NO_CANDIDATE else name_ord,
+            'room': rooms.at(room_ord),
+            'name': names.at(name_ord),
+            'http_code': code,
+            'latency_ms': latency,
+            'body_len': body_len,
+            'body_hash': f'{body_hash:08x}',
+            'success': bool(flags & FLAG_SUCCESS),
+            'retry_after': bool(flags & FLAG_RETRY_AFTER),
+        })
+
+    return job_id, records
+
+
+def summarize(job_id, records, out):
+    if not records:
+        print(f'Job {job_id}: no attempts', file=out)
+        return
+
+    latencies = sorted(r['latency_ms'] for r in records)
+    codes = Counter(r['http_code'] for r in records)
+    bodies = Counter((r['http_code'], r['body_hash']) for r in records)
+    hits = [r for r in records if r['success']]
+    span = records[-1]['offset_ms'] / 1000.0
+
+    print(f'Job {job_id}: {len(records)} attempts over {span:.0f}s, {len(hits)} hits', file=out)
+    print(f'Latency ms: p50 {latencies[len(latencies) // 2]}, '
+          f'p95 {latencies[int(len(latencies) * 0.95)]}, max {latencies[-1]}', file=out)
+    print('Status codes: ' + ', '.join(f'{c}: {n}' for c, n in codes.most_common()), file=out)
+
+    # Distinct responses: a verdict heuristic that flags most of one
+    # response class as success is worth a second look
+    print('Distinct responses (code, body hash, count, hits):', file=out)
+    for (code, body_hash), n in bodies.most_common(10):
+        hit_count = sum(1 for r in hits if r['http_code'] == code and r['body_hash'] == body_hash)
+        print(f'  {code:>4} {body_hash} {n:>8} {hit_count:>6}', file=out)
+
+
+def split_room(room):
+    """Floor and position on the floor, as CandidatePriors::splitRoom"""
+    runs = re.findall(r'[0-9]+', room or '')
+    if not runs or len(runs[-1]) > 9:
+        return None
+    number = int(runs[-1])
+    if number >= 10000:
+        return None
+    return number // 100, number % 100
+
+
+def write_priors(job_id, records, out):
+    floors = Counter()
+    rooms = Counter()
+    names = Counter()
+    for r in records:
+        if not r['success']:
+            continue
+        split = split_room(r['room'])
+        if split:
+            floors[split[0]] += 1
+            rooms[split[1]] += 1
+        if r['name']:
+            names[r['name']] += 1
+
+    print(f'# Candidate priors from attempt log of job {job_id}', file=out)
+    for floor, n in sorted(floors.items()):
+        print(f'floor {floor} {n}', file=out)
+    for room, n in sorted(rooms.items()):
+        print(f'room {room} {n}', file=out)
+    for name, n in names.most_common():
+        print(f'name {name} {n}', file=out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode Captured Portal attempt logs')
+    parser.add_argument('log', help='attempts-<job>.bin')
+    parser.add_argument('-f', '--format', choices=['csv', 'json', 'summary', 'priors'], default='csv')
+    parser.add_argument('-o', '--output', help='output file (default: stdout)')
+    parser.add_argument('--pattern', help='room pattern the job used, e.g. %%F%%2R:1-40:1-60')
+    parser.add_argument('--rooms', help='room list (after the pattern, one per line)')
+    parser.add_argument('--names', help='surname list in candidate order, one per line')
+    parser.add_argument('--hits', action='store_true', help='only attempts judged successful')
+    args = parser.parse_args()
+
+    try:
+        rooms = Candidates(args.pattern, read_list(args.rooms))
+        names = Candidates(None, read_list(args.names))
+        job_id, records = decode(args.log, rooms, names)
+    except (OSError, ValueError) as e:
+        print(f'Error: {e}', file=sys.stderr)
+        return 1
+
+    if args.hits:
+        records = [r for r in records if r['success']]
+
+    out = open(args.output, 'w', newline='') if args.output else sys.stdout
+    try:
+        if args.format == 'csv':
+            writer = csv.DictWriter(out, fieldnames=FIELDS)
+            writer.writeheader()
+            writer.writerows(records)
+        elif args.format == 'json':
+            json.dump({'job': job_id, 'attempts': records}, out, indent=2)
+            out.write('\n')
+        elif args.format == 'priors':
+            write_priors(job_id, records, out)
+        else:
+            summarize(job_id, records, out)
+    finally:
+        if out is not sys.stdout:
+            out.close()
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,424 @@
+#!/usr/bin/env python3
+"""
+Captured Portal - Model Packer
+Converts a llama2.c checkpoint into the packed CPLM container of
+src/llm/model_file.h: a header with the hyperparameters, an info block
+with checksums and quantization metadata, a tensor table with shapes, and
+every tensor on a 64-byte boundary so the firmware uses the weights in
+place from a memory-mapped flash partition. With --tokenizer the vocab
+goes into the same file.
+
+Accepted checkpoints:
+  - export.py --version 2 ("ak42" int8), copied as they are
+  - export.py --version 1 ("ak42" fp32) and legacy run.c checkpoints,
+    quantized to int8 with one scale per --group-size values
+
+    python3 tools/pack_model.py stories260K.bin model.cplm --tokenizer tok512.bin
+    python3 tools/pack_model.py --verify model.cplm
+    esptool.py write_flash 0x810000 model.cplm     # "model" partition
+
+The offset is the "model" partition in partitions_model.csv.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+import zlib
+from array import array
+
+CHECKPOINT_MAGIC = 0x616B3432   # "ak42"
+CHECKPOINT_VERSION_F32 = 1
+CHECKPOINT_VERSION_Q8 = 2
+CHECKPOINT_HEADER_SIZE = 256
+
+MODEL_FILE_MAGIC = 0x4D4C5043   # "CPLM"
+MODEL_FILE_VERSION = 2
+MODEL_FILE_ALIGN = 64
+FLAG_SHARED_CLASSIFIER = 0x01
+QUANT_SYMMETRIC = 0
+
+# Must match TRANSFORMER_ROPE_THETA / TRANSFORMER_NORM_EPS (llama2.c values)
+ROPE_THETA = 10000.0
+NORM_EPS = 1e-5
+
+HEADER = struct.Struct('<II8iIIQQ')
+INFO = struct.Struct('<IIBBHffII3I24s')
+ENTRY = struct.Struct('<HHHHIIIIII')
+ENTRY_V1 = struct.Struct('<HHHHII')
+INFO_CRC_OFFSET = HEADER.size   # headerCrc is the first info field
+
+(RMS_ATT, RMS_FFN, RMS_FINAL, TOKEN_EMBEDDING, WQ, WK, WV, WO,
+ W1, W2, W3, CLASSIFIER, VOCAB) = range(13)
+F32, Q8, BYTES = 0, 1, 2
+
+KIND_NAMES = ['rms_att', 'rms_ffn', 'rms_final', 'embedding', 'wq', 'wk', 'wv', 'wo',
+              'w1', 'w2', 'w3', 'classifier', 'vocab']
+
+
+def align(n):
+    return (n + MODEL_FILE_ALIGN - 1) & ~(MODEL_FILE_ALIGN - 1)
+
+
+class Tensor:
+    def __init__(self, kind, layer, kind_type, group, rows, cols, blob):
+        self.kind = kind
+        self.layer = layer
+        self.type = kind_type
+        self.group = group
+        self.rows = rows
+        self.cols = cols
+        self.blob = blob
+
+
+def floats(blob):
+    values = array('f')
+    values.frombytes(blob)
+    if sys.byteorder != 'little':
+        values.byteswap()
+    return values
+
+
+def float_bytes(values):
+    values = array('f', values)
+    if sys.byteorder != 'little':
+        values.byteswap()
+    return values.tobytes()
+
+
+def quantize(values, group):
+    """Symmetric int8 with one scale per group, as llama2.c export.py"""
+    q = array('b', bytes(len(values)))
+    scales = array('f', bytes(len(values) // group * 4))
+    for g in range(len(values) // group):
+        start = g * group
+        chunk = values[start:start + group]
+        scale = max(max(chunk), -min(chunk)) / 127.0
+        scales[g] = scale
+        if scale > 0:
+            inv = 1.0 / scale
+            q[start:start + group] = array('b', (max(-127, min(127, round(v * inv)))
+                                                 for v in chunk))
+    return q.tobytes(), float_bytes(scales)
+
+
+def shapes(c):
+    """(kind, rows, cols) of each per-layer matrix, (out, in), in file order"""
+    dim, hidden = c['dim'], c['hidden']
+    kv_dim = dim * c['kv_heads'] // c['heads']
+    return [(WQ, dim, dim), (WK, kv_dim, dim), (WV, kv_dim, dim), (WO, dim, dim),
+            (W1, hidden, dim), (W2, dim, hidden), (W3, hidden, dim)]
+
+
+def check_config(c):
+    if min(c['dim'], c['hidden'], c['layers'], c['heads'], c['kv_heads'],
+           c['vocab'], c['seq_len']) <= 0:
+        raise ValueError('bad hyperparameters')
+    if c['dim'] % c['heads'] != 0 or c['heads'] % c['kv_heads'] != 0:
+        raise ValueError('bad head counts')
+
+
+class Reader:
+    def __init__(self, data, pos):
+        self.data = data
+        self.pos = pos
+
+    def take(self, size):
+        if self.pos + size > len(self.data):
+            raise ValueError('checkpoint truncated')
+        blob = self.data[self.pos:self.pos + size]
+        self.pos += size
+        return blob
+
+
+def read_q8(data):
+    """export.py --version 2: int8 weights, copied without requantizing"""
+    dim, hidden, layers, heads, kv_heads, vocab, seq_len = struct.unpack_from('<7i', data, 8)
+    shared = data[36] != 0
+    group = struct.unpack_from('<i', data, 37)[0]
+    c = dict(dim=dim, hidden=hidden, layers=layers, heads=heads, kv_heads=kv_heads,
+             vocab=vocab, seq_len=seq_len, group=group, shared=shared)
+    check_config(c)
+    if group <= 0 or dim % group != 0 or hidden % group != 0:
+        raise ValueError('bad group size')
+
+    r = Reader(data, CHECKPOINT_HEADER_SIZE)
+    tensors = []
+
+    def qtensor(kind, layer, rows, cols):
+        tensors.append(Tensor(kind, layer, Q8, group, rows, cols, r.take(rows * cols)))
+        tensors.append(Tensor(kind, layer, F32, group, rows, cols // group,
+                              r.take(rows * cols // group * 4)))
+
+    tensors.append(Tensor(RMS_ATT, 0, F32, 0, layers, dim, r.take(layers * dim * 4)))
+    tensors.append(Tensor(RMS_FFN, 0, F32, 0, layers, dim, r.take(layers * dim * 4)))
+    tensors.append(Tensor(RMS_FINAL, 0, F32, 0, 1, dim, r.take(dim * 4)))
+    qtensor(TOKEN_EMBEDDING, 0, vocab, dim)
+    for kind, rows, cols in shapes(c):
+        for layer in range(layers):
+            qtensor(kind, layer, rows, cols)
+    if not shared:
+        qtensor(CLASSIFIER, 0, vocab, dim)
+    return c, tensors
+
+
+def pick_group(c, group):
+    # Halve until it divides every row, as export.py does
+    while group > 1 and (c['dim'] % group != 0 or c['hidden'] % group != 0):
+        group //= 2
+    return group
+
+
+def quantized_tensors(c, weights, group):
+    """weights: {(kind, layer): fp32 blob} of a float checkpoint"""
+    layers, dim = c['layers'], c['dim']
+    tensors = [Tensor(RMS_ATT, 0, F32, 0, layers, dim, weights[(RMS_ATT, 0)]),
+               Tensor(RMS_FFN, 0, F32, 0, layers, dim, weights[(RMS_FFN, 0)]),
+               Tensor(RMS_FINAL, 0, F32, 0, 1, dim, weights[(RMS_FINAL, 0)])]
+
+    def qtensor(kind, layer, rows, cols):
+        q, s = quantize(floats(weights[(kind, layer)]), group)
+        tensors.append(Tensor(kind, layer, Q8, group, rows, cols, q))
+        tensors.append(Tensor(kind, layer, F32, group, rows, cols // group, s))
+
+    qtensor(TOKEN_EMBEDDING, 0, c['vocab'], dim)
+    for kind, rows, cols in shapes(c):
+        for layer in range(layers):
+            qtensor(kind, layer, rows, cols)
+    if not c['shared']:
+        qtensor(CLASSIFIER, 0, c['vocab'], dim)
+    return tensors
+
+
+def read_f32(data, group):
+    """export.py --version 1: fp32 in the same order as version 2"""
+    dim, hidden, layers, heads, kv_heads, vocab, seq_len = struct.unpack_from('<7i', data, 8)
+    c = dict(dim=dim, hidden=hidden, layers=layers, heads=heads, kv_heads=kv_heads,
+             vocab=vocab, seq_len=seq_len, shared=data[36] != 0)
+    check_config(c)
+    c['group'] = pick_group(c, group)
+
+    r = Reader(data, CHECKPOINT_HEADER_SIZE)
+    weights = {(RMS_ATT, 0): r.take(layers * dim * 4),
+               (RMS_FFN, 0): r.take(layers * dim * 4),
+               (RMS_FINAL, 0): r.take(dim * 4),
+               (TOKEN_EMBEDDING, 0): r.take(vocab * dim * 4)}
+    for kind, rows, cols in shapes(c):
+        for layer in range(layers):
+            weights[(kind, layer)] = r.take(rows * cols * 4)
+    if not c['shared']:
+        weights[(CLASSIFIER, 0)] = r.take(vocab * dim * 4)
+    return c, quantized_tensors(c, weights, c['group'])
+
+
+def read_legacy(data, group):
+    """run.c checkpoint: 7 ints, then fp32 weights grouped by kind across
+    layers; a negative vocab size means a separate classifier"""
+    if len(data) < 28:
+        raise ValueError('checkpoint too small')
+    dim, hidden, layers, heads, kv_heads, vocab, seq_len = struct.unpack_from('<7i', data, 0)
+    c = dict(dim=dim, hidden=hidden, layers=layers, heads=heads, kv_heads=kv_heads,
+             vocab=abs(vocab), seq_len=seq_len, shared=vocab > 0)
+    check_config(c)
+    c['group'] = pick_group(c, group)
+    head_size = dim // heads
+
+    r = Reader(data, 28)
+    weights = {(TOKEN_EMBEDDING, 0): r.take(c['vocab'] * dim * 4),
+               (RMS_ATT, 0): r.take(layers * dim * 4)}
+    per_layer = {kind: (rows, cols) for kind, rows, cols in shapes(c)}
+
+    def stacked(kind):
+        rows, cols = per_layer[kind]
+        for layer in range(layers):
+            weights[(kind, layer)] = r.take(rows * cols * 4)
+
+    for kind in (WQ, WK, WV, WO):
+        stacked(kind)
+    weights[(RMS_FFN, 0)] = r.take(layers * dim * 4)
+    for kind in (W1, W2, W3):
+        stacked(kind)
+    weights[(RMS_FINAL, 0)] = r.take(dim * 4)
+    r.take(seq_len * head_size // 2 * 4 * 2)    # freq_cis_real/imag, unused
+    if not c['shared']:
+        weights[(CLASSIFIER, 0)] = r.take(c['vocab'] * dim * 4)
+    return c, quantized_tensors(c, weights, c['group'])
+
+
+def read_checkpoint(data, group):
+    """Returns (config, [Tensor]) in llama2.c version 2 order"""
+    if len(data) >= CHECKPOINT_HEADER_SIZE:
+        magic, version = struct.unpack_from('<Ii', data, 0)
+        if magic == CHECKPOINT_MAGIC:
+            if version == CHECKPOINT_VERSION_Q8:
+                return read_q8(data)
+            if version == CHECKPOINT_VERSION_F32:
+                return read_f32(data, group)
+            raise ValueError(f'unsupported checkpoint version {version}')
+    return read_legacy(data, group)
+
+
+def vocab_tensor(blob, vocab):
+    """tokenizer.bin: max_token_length, then (score, len, bytes) per token"""
+    if len(blob) < 4:
+        raise ValueError('tokenizer too small')
+    pos = 4
+    for _ in range(vocab):
+        if pos + 8 > len(blob):
+            raise ValueError('tokenizer has fewer tokens than the model vocab')
+        pos += 8 + struct.unpack_from('<i', blob, pos + 4)[0]
+    if pos > len(blob):
+        raise ValueError('tokenizer truncated')
+    max_len = struct.unpack_from('<I', blob, 0)[0]
+    return Tensor(VOCAB, 0, BYTES, 0, len(blob), 1, blob), max_len
+
+
+def pack(c, tensors, max_token_len, source_crc, name):
+    table_offset = HEADER.size + INFO.size
+    offset = align(table_offset + len(tensors) * ENTRY.size)
+    entries = []
+    for t in tensors:
+        entries.append(ENTRY.pack(t.kind, t.layer, t.type, t.group, offset, len(t.blob),
+                                  t.rows, t.cols, zlib.crc32(t.blob), 0))
+        offset = align(offset + len(t.blob))
+    if offset >= 1 << 32:
+        raise ValueError('model too large for 32-bit tensor offsets')
+    table = b''.join(entries)
+
+    header = HEADER.pack(MODEL_FILE_MAGIC, MODEL_FILE_VERSION,
+                         c['dim'], c['hidden'], c['layers'], c['heads'], c['kv_heads'],
+                         c['vocab'], c['seq_len'], c['group'],
+                         FLAG_SHARED_CLASSIFIER if c['shared'] else 0,
+                         len(tensors), table_offset, offset)
+
+    def info(header_crc):
+        return INFO.pack(header_crc, zlib.crc32(table), 8, QUANT_SYMMETRIC, 0,
+                         ROPE_THETA, NORM_EPS, max_token_len, source_crc, 0, 0, 0,
+                         name.encode()[:23])
+
+    head = header + info(0)
+    head = header + info(zlib.crc32(head))
+
+    out = bytearray(offset)
+    out[0:len(head)] = head
+    out[table_offset:table_offset + len(table)] = table
+    for i, t in enumerate(tensors):
+        at = ENTRY.unpack_from(table, i * ENTRY.size)[4]
+        out[at:at + len(t.blob)] = t.blob
+    return bytes(out)
+
+
+def verify(data):
+    """Same checks as ModelFile::verify at MODEL_VERIFY_FULL"""
+    if len(data) < HEADER.size:
+        raise ValueError('model file too small')
+    h = HEADER.unpack_from(data, 0)
+    magic, version, tensor_count, table_offset, file_size = h[0], h[1], h[11], h[12], h[13]
+    if magic != MODEL_FILE_MAGIC:
+        raise ValueError('not a packed model (bad magic)')
+    if version < 1 or version > MODEL_FILE_VERSION:
+        raise ValueError(f'unsupported model file version {version}')
+    if file_size > len(data):
+        raise ValueError('model file truncated')
+    entry = ENTRY_V1 if version == 1 else ENTRY
+    table_bytes = tensor_count * entry.size
+    if table_offset % 4 != 0 or table_offset + table_bytes > file_size:
+        raise ValueError('bad tensor table')
+
+    if version >= 2:
+        head = bytearray(data[:HEADER.size + INFO.size])
+        info = INFO.unpack_from(head, HEADER.size)
+        head[INFO_CRC_OFFSET:INFO_CRC_OFFSET + 4] = bytes(4)
+        if zlib.crc32(head) != info[0]:
+            raise ValueError('header checksum mismatch')
+        if zlib.crc32(data[table_offset:table_offset + table_bytes]) != info[1]:
+            raise ValueError('tensor table checksum mismatch')
+        if info[2] != 8 or info[3] != QUANT_SYMMETRIC:
+            raise ValueError('unsupported quantization')
+
+    for i in range(tensor_count):
+        e = entry.unpack_from(data, table_offset + i * entry.size)
+        offset, size = e[4], e[5]
+        label = f'tensor {i} ({KIND_NAMES[e[0]] if e[0] < len(KIND_NAMES) else e[0]}, layer {e[1]})'
+        if offset % MODEL_FILE_ALIGN != 0 or offset + size > file_size:
+            raise ValueError(f'bad entry for {label}')
+        if version >= 2 and zlib.crc32(data[offset:offset + size]) != e[8]:
+            raise ValueError(f'checksum mismatch in {label}')
+    return h, (INFO.unpack_from(data, HEADER.size) if version >= 2 else None)
+
+
+def print_config(c):
+    print(f"dim {c['dim']}, hidden {c['hidden']}, {c['layers']} layers, "
+          f"{c['heads']}/{c['kv_heads']} heads, vocab {c['vocab']}, ctx {c['seq_len']}, "
+          f"group {c['group']}")
+
+
+def run_verify(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    start = time.time()
+    h, info = verify(data)
+    elapsed = (time.time() - start) * 1000
+    print_config(dict(dim=h[2], hidden=h[3], layers=h[4], heads=h[5], kv_heads=h[6],
+                      vocab=h[7], seq_len=h[8], group=h[9]))
+    if info:
+        name = info[12].rstrip(b'\0').decode(errors='replace')
+        print(f"version {h[1]}, {h[11]} tensors, header crc {info[0]:08x}, "
+              f"source '{name}' ({info[8]:08x}), vocab {'yes' if info[7] else 'no'}")
+    else:
+        print(f'version {h[1]}, {h[11]} tensors, no checksums')
+    print(f'{path}: ok ({len(data)} bytes checked in {elapsed:.0f} ms)')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Pack a llama2.c checkpoint for mmap')
+    parser.add_argument('checkpoint', help='llama2.c checkpoint (export.py v1/v2 or legacy), '
+                        'or the file to check with --verify')
+    parser.add_argument('output', nargs='?', help='packed model (.cplm)')
+    parser.add_argument('--tokenizer', help='llama2.c tokenizer.bin to embed')
+    parser.add_argument('--group-size', type=int, default=64,
+                        help='quantization group for fp32 checkpoints (default: 64)')
+    parser.add_argument('--verify', action='store_true',
+                        help='check structure and every checksum of a packed model')
+    parser.add_argument('--partition-size', type=lambda s: int(s, 0), default=0x7E0000,
+                        help='warn if the model exceeds this (default: partitions_model.csv)')
+    args = parser.parse_args()
+
+    try:
+        if args.verify:
+            run_verify(args.checkpoint)
+            return 0
+        if not args.output:
+            parser.error('output is required unless --verify')
+        if args.group_size <= 0:
+            parser.error('--group-size must be positive')
+
+        with open(args.checkpoint, 'rb') as f:
+            data = f.read()
+        config, tensors = read_checkpoint(data, args.group_size)
+        max_token_len = 0
+        if args.tokenizer:
+            with open(args.tokenizer, 'rb') as f:
+                vocab, max_token_len = vocab_tensor(f.read(), config['vocab'])
+            tensors.append(vocab)
+        packed = pack(config, tensors, max_token_len, zlib.crc32(data),
+                      os.path.basename(args.checkpoint))
+        verify(packed)
+        with open(args.output, 'wb') as f:
+            f.write(packed)
+    except (OSError, ValueError) as e:
+        print(f'Error: {e}', file=sys.stderr)
+        return 1
+
+    print_config(config)
+    print(f"{len(tensors)} tensors{', vocab embedded' if args.tokenizer else ''}, "
+          f'{len(packed)} bytes -> {args.output}')
+    if len(packed) > args.partition_size:
+        print(f'Warning: larger than the model partition ({args.partition_size} bytes)',
+              file=sys.stderr)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
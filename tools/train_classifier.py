@@ -0,0 +1,496 @@
+#!/usr/bin/env python3
+"""
+Captured Portal - Portal Classifier Trainer
+Trains the venue-type and auth-type classifier that LLMEngine runs before
+the model (src/core/portal_classifier.cpp) and exports its int8 weights as
+src/core/portal_classifier_model.h.
+
+The classifier is softmax regression over hashed word features: every
+lowercase [a-z0-9] run of 2..24 characters in the page, outside <script>
+and <style> blocks, hashed with FNV-1a into CLASSIFIER_FEATURES buckets
+and counted once (words inside <input> tags hash apart from body text).
+features() below must stay in step with PortalClassifier::extract(); the
+exported header carries a check vector that bench-classifier verifies.
+
+    python3 tools/train_classifier.py                  # generated pages only
+    python3 tools/train_classifier.py --data pages.jsonl
+
+--data adds real captures, one JSON object per line:
+{"html": "...", "venue": "Airport", "auth": "Email"} with labels from the
+lists below. Pages served by tools/test_portal.py are never trained on;
+they are reported as a held-out test.
+"""
+
+import argparse
+import json
+import math
+import random
+import sys
+from pathlib import Path
+
+FEATURES = 512
+MAX_WORD = 24
+
+# Venue labels of the default analysis rules (core/portal_rules.cpp), then
+# everything else
+VENUES = ['Hotel/Resort', 'Airport', 'Healthcare Facility', 'Cafe/Restaurant',
+          'Conference Center', 'Educational Institution', 'Library', 'Unknown']
+AUTHS = ['Room + surname', 'Email', 'Access code', 'Phone (SMS)', 'Click-through',
+         'Username + password']
+
+CHECK_TEXT = ('<title>Grand Hotel</title><style>.room{color:red}</style>'
+              '<script>var email=1;</script><input name="room_number" type="text">')
+
+OUT_PATH = Path(__file__).parent.parent / 'src' / 'core' / 'portal_classifier_model.h'
+
+
+# ---------------------------------------------------------------------------
+# Features (mirror of PortalClassifier::extract)
+# ---------------------------------------------------------------------------
+
+def fnv1a(data):
+    h = 2166136261
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def features(html):
+    """Sorted bucket indices present in the page"""
+    text = html.encode('utf-8', 'replace').lower()
+    n = len(text)
+    out = set()
+
+    def emit(start, end, in_input):
+        if 2 <= end - start <= MAX_WORD:
+            # Words inside <input ...> (names, types, placeholders) are their
+            # own features: they say more about the login than body text
+            out.add(fnv1a((b'@' if in_input else b'') + text[start:end]) & (FEATURES - 1))
+
+    pos = 0
+    start = -1
+    in_input = False
+    while pos < n:
+        c = text[pos]
+        if (48 <= c <= 57) or (97 <= c <= 122):
+            if start < 0:
+                start = pos
+            pos += 1
+            continue
+        if start >= 0:
+            emit(start, pos, in_input)
+            start = -1
+        if c == 0x3E:   # '>'
+            in_input = False
+        elif c == 0x3C:   # '<'
+            skipped = False
+            for tag in (b'script', b'style'):
+                if text.startswith(tag, pos + 1):
+                    close = text.find(b'</' + tag, pos + 1 + len(tag))
+                    pos = n if close < 0 else close + 2 + len(tag)
+                    skipped = True
+                    break
+            if skipped:
+                continue
+            in_input = text.startswith(b'input', pos + 1)
+        pos += 1
+    if start >= 0:
+        emit(start, n, in_input)
+    return sorted(out)
+
+
+# ---------------------------------------------------------------------------
+# Generated training pages
+# ---------------------------------------------------------------------------
+
+VENUE_WORDS = {
+    'Hotel/Resort': (['Grand', 'Seaside', 'Harbor', 'Royal', 'Parkview', 'Alpine', 'Sunset'],
+                     ['Hotel', 'Resort', 'Inn', 'Suites', 'Lodge', 'Resort & Spa'],
+                     ['Welcome, guest. Enjoy your stay.', 'Need help? Call the front desk.',
+                      'Late check-out is available on request.', 'Complimentary internet for hotel guests.',
+                      'Premium speed for suite guests.']),
+    'Airport': (['Metro', 'Capital', 'Lakeside', 'Northern', 'Bay'],
+                ['International Airport', 'Airport', 'Terminal 2', 'Regional Airport'],
+                ['Free WiFi for travellers in all terminals.', 'Check your flight status at the gate.',
+                 'Airline lounges have separate access.', 'Enjoy 60 minutes free before your flight.']),
+    'Healthcare Facility': (['Memorial', 'St. Mary', 'Valley', 'Riverside', 'County'],
+                            ['Hospital', 'Medical Center', 'Clinic', 'Health'],
+                            ['Guest network for patients and visitors.', 'Visiting hours are 9am to 8pm.',
+                             'Please do not use this network for medical devices.',
+                             'Patient and visitor internet access.']),
+    'Cafe/Restaurant': (['Bean', 'Corner', 'Daily Grind', 'Blue Door', 'Old Town'],
+                        ['Cafe', 'Coffee House', 'Bistro', 'Restaurant', 'Espresso Bar'],
+                        ['Ask your barista for today\'s code.', 'Free WiFi with any purchase.',
+                         'Try our seasonal coffee menu.', 'Enjoy your meal and stay connected.']),
+    'Conference Center': (['TechConf', 'DevSummit', 'Global Expo', 'Future Forum', 'BuildCon'],
+                          ['2024', 'Convention Center', 'Conference', 'Summit', 'Expo Hall'],
+                          ['Attendee WiFi for all event halls.', 'Your badge ID is printed on your badge.',
+                           'Sessions start at 9:00 in the main hall.',
+                           'Exhibitors use the separate exhibitor network.']),
+    'Educational Institution': (['State', 'Westfield', 'Northgate', 'Lincoln', 'Oakridge'],
+                                ['University', 'College', 'High School', 'Campus'],
+                                ['Guest access for campus visitors.', 'Students use eduroam instead.',
+                                 'Faculty and staff sign in with their university account.',
+                                 'Library and lecture halls are covered.']),
+    'Library': (['Public', 'City', 'Central', 'Memorial', 'County'],
+                ['Library', 'Public Library', 'Library Branch'],
+                ['Sign in with your library card.', 'Borrow books, e-books and more.',
+                 'Computers are available for patrons.', 'Quiet study rooms upstairs.']),
+    'Unknown': (['Central', 'Riverside', 'Downtown', 'City', 'Metro', 'Harbour'],
+                ['Mall', 'Fitness', 'Station', 'Stadium', 'Park', 'Plaza', 'Free WiFi', 'Guest Network'],
+                ['Free public internet access.', 'Enjoy your visit.', 'Shops open 10am to 9pm.',
+                 'Connect to get online.', 'Brought to you by the city.']),
+}
+
+# Per auth type: alternative field groups; each field is (name, label, type,
+# example placeholder)
+AUTH_FIELDS = {
+    'Room + surname': [
+        [('room_number', 'Room Number', 'text', 'e.g. 101'), ('room', 'Room', 'text', '1204'),
+         ('roomno', 'Room No.', 'text', 'e.g., 101'), ('patient_room', 'Patient Room', 'text', 'e.g. ICU2'),
+         ('rm', 'Room #', 'text', 'Your room')],
+        [('last_name', 'Last Name', 'text', 'As on your booking'), ('surname', 'Surname', 'text', 'Smith'),
+         ('guest_name', 'Guest Name', 'text', 'Your full name'),
+         ('visitor_name', 'Visitor Name', 'text', 'Your full name'),
+         ('lastname', 'Family Name', 'text', 'Family name'), ('name', 'Name', 'text', 'Your name')],
+    ],
+    'Email': [
+        [('email', 'Email Address', 'email', 'you@example.com'), ('mail', 'E-mail', 'email', 'Enter your email'),
+         ('user_email', 'Your email', 'email', 'name@mail.com')],
+    ],
+    'Access code': [
+        [('access_code', 'Access Code', 'text', 'e.g. AB12CD'), ('voucher', 'Voucher Code', 'text', 'XXXX-XXXX'),
+         ('code', 'Code', 'text', 'Code from your receipt'), ('badge_id', 'Badge ID', 'text', 'TC001'),
+         ('wifi_password', 'WiFi Password', 'password', 'Password'),
+         ('passcode', 'Passcode', 'password', 'Today\'s passcode')],
+    ],
+    'Phone (SMS)': [
+        [('phone', 'Mobile Number', 'tel', '+1 555 0100'), ('mobile', 'Phone Number', 'tel', 'Your mobile'),
+         ('msisdn', 'Cell Phone', 'tel', '07700 900123')],
+    ],
+    'Click-through': [],
+    'Username + password': [
+        [('username', 'Username', 'text', 'Username'), ('user', 'User ID', 'text', 'jdoe'),
+         ('student_id', 'Student ID', 'text', 'S1234567'),
+         ('card_number', 'Library Card Number', 'text', '14 digits on your card'),
+         ('login', 'Login', 'text', 'Your account')],
+        [('password', 'Password', 'password', 'Password'), ('pin', 'PIN', 'password', '4-digit PIN'),
+         ('pass', 'Password', 'password', '********')],
+    ],
+}
+
+# Optional extras that don't change the auth type
+AUTH_EXTRAS = {
+    'Email': [('full_name', 'Full Name', 'text', 'Your full name'),
+              ('first_name', 'First Name', 'text', 'First name')],
+    'Access code': [('email', 'Email', 'email', 'attendee@email.com'),
+                    ('email', 'Email (optional)', 'email', 'you@example.com')],
+    'Phone (SMS)': [('country', 'Country', 'text', 'Country code')],
+}
+
+AUTH_PHRASES = {
+    'Room + surname': ['Enter your room number and last name as on your reservation.'],
+    'Email': ['Enter your email to get online.', 'We may send you offers by email.'],
+    'Access code': ['Enter the access code you received.', 'Codes are valid for 24 hours.'],
+    'Phone (SMS)': ['We will text you a one-time code.', 'Standard SMS rates may apply.'],
+    'Click-through': ['No registration needed.', 'Press Connect to get online.',
+                      'Just accept the terms and connect.'],
+    'Username + password': ['Sign in with your account.', 'Forgot your password? Ask at the desk.'],
+}
+
+VENDORS = ['Nomadix Access Gateway', 'Cisco Meraki', 'Aruba ClearPass', 'UniFi Hotspot',
+           'Mikrotik Hotspot', 'Purple WiFi', 'Cloudi-Fi']
+# Terms wording shows up whatever the login, so it's shared by every type
+TERMS = ['By connecting, you agree to our terms of service and privacy policy.',
+         'By connecting you accept the terms of use.',
+         'Use of this service is subject to our acceptable use policy.',
+         'Free WiFi for 2 hours per day.']
+NOTICES = ['<strong>Notice:</strong> This network is for guests only.',
+           '<em>Please</em> read our acceptable use policy before connecting.',
+           '<small>Access is limited to 2 hours per device.</small>',
+           '<strong>Security:</strong> never share your details with anyone.',
+           '<b>Tip:</b> forget this network when you leave.',
+           'Need assistance? Visit our help page or call support.']
+BUTTONS = ['Connect', 'Connect to WiFi', 'Get Online', 'Continue', 'Sign In', 'Access Network']
+CSS = ['body { font-family: Arial, sans-serif; background: #f5f5f5; }',
+       '.container { max-width: 400px; margin: 0 auto; padding: 30px; }',
+       'input { width: 100%; padding: 12px; border: 1px solid #ddd; }',
+       'button { background: #2196F3; color: white; border: none; }',
+       '.room-card { display: none; } .email-row { margin: 4px; }']
+SCRIPTS = ['function validate(f) { return f.email.value.length > 0; }',
+           'var room = document.getElementById("room"); if (room) room.focus();',
+           'document.querySelectorAll(".plan").forEach(function (p) { p.onclick = null; });',
+           'window.dataLayer = window.dataLayer || []; function gtag(){dataLayer.push(arguments);}']
+
+
+def venue_name(rng, venue):
+    first, second, _ = VENUE_WORDS[venue]
+    return f'{rng.choice(first)} {rng.choice(second)}'
+
+
+def field_html(rng, name, label, kind, example):
+    field_id = name if rng.random() < 0.5 else f'f{rng.randint(1, 9)}'
+    placeholder = rng.choice([label, example, f'Enter your {label.lower()}'])
+    html = f'<input type="{kind}" id="{field_id}" name="{name}" placeholder="{placeholder}" required>\n'
+    if rng.random() < 0.25:
+        return html                     # Placeholder only
+    return f'<label for="{field_id}">{label}</label>\n' + html
+
+
+def generate_page(rng, venue, auth):
+    name = venue_name(rng, venue)
+    phrases = VENUE_WORDS[venue][2]
+    title = rng.choice([f'{name} - Guest WiFi', f'{name} | Internet Access', f'Welcome to {name}',
+                        f'{name} WiFi'])
+    if rng.random() < 0.15:
+        title = rng.choice(['Guest WiFi', 'Internet Access', 'WiFi Login'])   # Venue only in the body
+
+    parts = ['<!DOCTYPE html>\n<html>\n<head>\n', f'<title>{title}</title>\n',
+             '<meta name="viewport" content="width=device-width, initial-scale=1">\n']
+    if rng.random() < 0.4:
+        parts.append(f'<meta name="generator" content="{rng.choice(VENDORS)}">\n')
+    if rng.random() < 0.7:
+        parts.append('<style>\n' + '\n'.join(rng.sample(CSS, rng.randint(1, len(CSS)))) + '\n</style>\n')
+    if rng.random() < 0.5:
+        parts.append('<script>\n' + '\n'.join(rng.sample(SCRIPTS, rng.randint(1, 2))) + '\n</script>\n')
+    parts.append('</head>\n<body>\n<div class="container">\n')
+    parts.append(f'<h1>{name if rng.random() < 0.8 else "Welcome"}</h1>\n')
+    for phrase in rng.sample(phrases, rng.randint(1, 2)):
+        parts.append(f'<p>{phrase}</p>\n')
+    if rng.random() < 0.1:
+        # A mention of another venue type (hotel airport shuttle, campus cafe)
+        other = rng.choice([v for v in VENUES if v != venue and v != 'Unknown'])
+        parts.append(f'<p>{rng.choice(VENUE_WORDS[other][2])}</p>\n')
+    parts.append(f'<p>{rng.choice(AUTH_PHRASES[auth])}</p>\n')
+
+    action = rng.choice(['/login', '/portal/auth', '/guest/s/default/', '/cgi-bin/login'])
+    parts.append(f'<form method="{rng.choice(["POST", "post"])}" action="{action}">\n')
+    if rng.random() < 0.5:
+        parts.append(f'<input type="hidden" name="csrf_token" value="{rng.getrandbits(64):016x}">\n')
+    if rng.random() < 0.3:
+        parts.append('<input type="hidden" name="mac" value="aa:bb:cc:dd:ee:ff">\n')
+    for group in AUTH_FIELDS[auth]:
+        parts.append(field_html(rng, *rng.choice(group)))
+    extras = AUTH_EXTRAS.get(auth, [])
+    if extras and rng.random() < 0.5:
+        parts.append(field_html(rng, *rng.choice(extras)))
+    if auth == 'Click-through' or rng.random() < 0.5:
+        parts.append('<input type="checkbox" name="terms" required> I accept the terms of service\n')
+    parts.append(f'<button type="submit">{rng.choice(BUTTONS)}</button>\n</form>\n')
+    if rng.random() < 0.5:
+        parts.append(f'<div class="{rng.choice(["notice", "info", "terms"])}">{rng.choice(NOTICES)}</div>\n')
+    if rng.random() < 0.6:
+        parts.append(f'<p class="terms">{rng.choice(TERMS)}</p>\n')
+    if rng.random() < 0.5:
+        parts.append(f'<footer>Powered by {rng.choice(VENDORS)}</footer>\n')
+    parts.append('</div>\n</body>\n</html>\n')
+    return ''.join(parts)
+
+
+def generate(rng, per_class):
+    pages = []
+    for venue in VENUES:
+        for auth in AUTHS:
+            for _ in range(per_class):
+                pages.append((generate_page(rng, venue, auth), venue, auth))
+    rng.shuffle(pages)
+    return pages
+
+
+def test_portal_pages():
+    """Pages of tools/test_portal.py with their labels (never trained on)"""
+    labels = {
+        'hotel': ('Hotel/Resort', 'Room + surname'),
+        'airport': ('Airport', 'Email'),
+        'cafe': ('Cafe/Restaurant', 'Access code'),
+        'conference': ('Conference Center', 'Access code'),
+        'hospital': ('Healthcare Facility', 'Room + surname'),
+    }
+    sys.path.insert(0, str(Path(__file__).parent))
+    try:
+        from test_portal import PORTAL_TEMPLATES
+    except ImportError:
+        return []
+    return [(key, t['html'], *labels[key]) for key, t in PORTAL_TEMPLATES.items() if key in labels]
+
+
+# ---------------------------------------------------------------------------
+# Softmax regression
+# ---------------------------------------------------------------------------
+
+def softmax(scores):
+    top = max(scores)
+    exps = [math.exp(s - top) for s in scores]
+    total = sum(exps)
+    return [e / total for e in exps]
+
+
+def train(samples, classes, epochs, rate, l2, rng):
+    """samples: [(features, label index)]. Returns (weights[f][c], bias[c])"""
+    weights = [[0.0] * classes for _ in range(FEATURES)]
+    bias = [0.0] * classes
+    order = list(range(len(samples)))
+    for epoch in range(epochs):
+        rng.shuffle(order)
+        step = rate / (1 + epoch * 0.5)
+        for i in order:
+            feats, label = samples[i]
+            scores = bias[:]
+            for f in feats:
+                row = weights[f]
+                for c in range(classes):
+                    scores[c] += row[c]
+            probs = softmax(scores)
+            for c in range(classes):
+                grad = probs[c] - (1.0 if c == label else 0.0)
+                bias[c] -= step * grad
+                for f in feats:
+                    weights[f][c] -= step * (grad + l2 * weights[f][c])
+    return weights, bias
+
+
+def quantize(weights):
+    top = max(abs(w) for row in weights for w in row) or 1.0
+    scale = top / 127.0
+    return [[max(-127, min(127, round(w / scale))) for w in row] for row in weights], scale
+
+
+def predict(qweights, scale, bias, feats):
+    classes = len(bias)
+    sums = [0] * classes
+    for f in feats:
+        row = qweights[f]
+        for c in range(classes):
+            sums[c] += row[c]
+    probs = softmax([bias[c] + sums[c] * scale for c in range(classes)])
+    best = max(range(classes), key=lambda c: probs[c])
+    return best, probs[best]
+
+
+def accuracy(model, samples):
+    if not samples:
+        return 0.0
+    hits = sum(1 for feats, label in samples if predict(*model, feats)[0] == label)
+    return hits / len(samples)
+
+
+# ---------------------------------------------------------------------------
+# Export
+# ---------------------------------------------------------------------------
+
+def c_array(values, per_line=24):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append('    ' + ', '.join(str(v) for v in values[i:i + per_line]) + ',')
+    return '\n'.join(lines)
+
+
+def export(path, venue_model, auth_model, summary):
+    check = features(CHECK_TEXT)
+
+    def head(prefix, labels, model):
+        qweights, scale, bias = model
+        flat = [w for row in qweights for w in row]
+        return '\n'.join([
+            f'static const char* const classifier{prefix}Labels[] = {{',
+            '    ' + ', '.join(json.dumps(label) for label in labels) + ',',
+            '};',
+            f'static const float classifier{prefix}Scale = {scale:.9g}f;',
+            f'static const float classifier{prefix}Bias[] = {{',
+            '    ' + ', '.join(f'{b:.6g}f' for b in bias) + ',',
+            '};',
+            f'static const int8_t classifier{prefix}Weights[CLASSIFIER_FEATURES * {len(labels)}] = {{',
+            c_array(flat),
+            '};',
+        ])
+
+    heads = head('Venue', VENUES, venue_model) + '\n\n' + head('Auth', AUTHS, auth_model)
+    text = '\n'.join([
+        '// Generated by tools/train_classifier.py - do not edit.',
+        f'// {summary}',
+        '#ifndef PORTAL_CLASSIFIER_MODEL_H',
+        '#define PORTAL_CLASSIFIER_MODEL_H',
+        '',
+        '#include <stdint.h>',
+        '',
+        f'#define CLASSIFIER_FEATURES {FEATURES}',
+        f'#define CLASSIFIER_MAX_WORD {MAX_WORD}',
+        f'#define CLASSIFIER_VENUES {len(VENUES)}',
+        f'#define CLASSIFIER_AUTHS {len(AUTHS)}',
+        f'#define CLASSIFIER_MODEL_HASH 0x{fnv1a(heads.encode()):08x}u   // Of the tables below, for cache keys',
+        '',
+        '// Buckets the trainer extracts from this text (bench-classifier checks',
+        '// that PortalClassifier agrees)',
+        f'#define CLASSIFIER_CHECK_TEXT {json.dumps(CHECK_TEXT)}',
+        f'#define CLASSIFIER_CHECK_COUNT {len(check)}',
+        f'#define CLASSIFIER_CHECK_SUM {sum(check)}',
+        '',
+        heads,
+        '',
+        '#endif // PORTAL_CLASSIFIER_MODEL_H',
+        '',
+    ])
+    path.write_text(text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Train and export the portal classifier')
+    parser.add_argument('--data', help='JSONL of labeled pages (html, venue, auth) to add')
+    parser.add_argument('--per-class', type=int, default=40,
+                        help='generated pages per venue/auth pair (default 40)')
+    parser.add_argument('--epochs', type=int, default=10)
+    parser.add_argument('--l2', type=float, default=0.01, help='weight decay (default 0.01)')
+    parser.add_argument('--seed', type=int, default=7)
+    parser.add_argument('-o', '--output', default=str(OUT_PATH), help='header to write')
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    pages = generate(rng, args.per_class)
+    if args.data:
+        with open(args.data) as f:
+            for line_no, line in enumerate(f, 1):
+                if not line.strip():
+                    continue
+                item = json.loads(line)
+                if item['venue'] not in VENUES or item['auth'] not in AUTHS:
+                    sys.exit(f'{args.data}:{line_no}: unknown label {item["venue"]!r}/{item["auth"]!r}')
+                pages.append((item['html'], item['venue'], item['auth']))
+        rng.shuffle(pages)
+
+    split = len(pages) * 4 // 5
+    feats = [features(html) for html, _, _ in pages]
+    venue_samples = [(f, VENUES.index(v)) for f, (_, v, _) in zip(feats, pages)]
+    auth_samples = [(f, AUTHS.index(a)) for f, (_, _, a) in zip(feats, pages)]
+
+    models = {}
+    for head, samples, classes in (('venue', venue_samples, len(VENUES)),
+                                   ('auth', auth_samples, len(AUTHS))):
+        weights, bias = train(samples[:split], classes, args.epochs, 0.2, args.l2, rng)
+        qweights, scale = quantize(weights)
+        models[head] = (qweights, scale, bias)
+        print(f'{head:5}: train {accuracy(models[head], samples[:split]):6.1%}, '
+              f'validation {accuracy(models[head], samples[split:]):6.1%} (int8 weights)')
+
+    tests = test_portal_pages()
+    hits = 0
+    for key, html, venue, auth in tests:
+        f = features(html)
+        v, vc = predict(*models['venue'], f)
+        a, ac = predict(*models['auth'], f)
+        ok = VENUES[v] == venue and AUTHS[a] == auth
+        hits += ok
+        print(f'  test_portal {key:11} {VENUES[v]:24} {vc:5.0%}  {AUTHS[a]:20} {ac:5.0%}  '
+              f'{"ok" if ok else "expected " + venue + " / " + auth}')
+
+    size = FEATURES * (len(VENUES) + len(AUTHS))
+    summary = (f'{split} training pages (seed {args.seed}'
+               f'{", plus " + Path(args.data).name if args.data else ""}), '
+               f'validation venue {accuracy(models["venue"], venue_samples[split:]):.1%}, '
+               f'auth {accuracy(models["auth"], auth_samples[split:]):.1%}; '
+               f'test_portal.py {hits}/{len(tests)}')
+    export(Path(args.output), models['venue'], models['auth'], summary)
+    print(f'Wrote {args.output}: {size} weight bytes')
+
+
+if __name__ == '__main__':
+    main()